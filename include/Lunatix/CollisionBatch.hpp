@@ -0,0 +1,193 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef COLLISIONBATCH_HPP_INCLUDED
+#define COLLISIONBATCH_HPP_INCLUDED
+
+/**
+*   @file CollisionBatch.hpp
+*   @brief The collision detection between a shape and many shapes
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*   The shapes are packed in arrays of coordinates (one array per coordinate),
+*   so one shape is checked against several shapes at the same time
+*   with the SIMD instructions of the processor (SSE2 or AVX2), if they are available.
+*
+*   The result is a bitmask: the bit i of mask[i / 64] is set
+*   if the shape collides with the i-th shape of the array.
+*   Each function gives the same result as the function of Physics.hpp it replaces.
+*/
+
+#include <Lunatix/Hitbox.hpp>
+#include <vector>
+#include <cstdint>
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+/**
+*   @struct BoxArray
+*   @brief Packed AABBs
+*/
+struct BoxArray final
+{
+    std::vector<float> x;   /**< X position of every box */
+    std::vector<float> y;   /**< Y position of every box */
+    std::vector<float> w;   /**< Width of every box      */
+    std::vector<float> h;   /**< Height of every box     */
+
+    /**
+    *   @fn void push(const FloatingBox& box)
+    *   @param [in] box The box to add at the end of the array
+    */
+    void push( const FloatingBox& box );
+    /**
+    *   @fn void set(const size_t index, const FloatingBox& box) noexcept
+    *   @param [in] index The index of the box (< size())
+    *   @param [in] box The new box
+    */
+    void set( const size_t index, const FloatingBox& box ) noexcept;
+    /**
+    *   @fn FloatingBox get(const size_t index) const noexcept
+    *   @param [in] index The index of the box (< size())
+    *   @return The box
+    */
+    FloatingBox get( const size_t index ) const noexcept;
+    /**
+    *   @fn size_t size() const noexcept
+    *   @return The number of boxes
+    */
+    size_t size() const noexcept;
+    /**
+    *   @fn void clear() noexcept
+    */
+    void clear() noexcept;
+};
+
+/**
+*   @struct CircleArray
+*   @brief Packed circles
+*/
+struct CircleArray final
+{
+    std::vector<float> x;   /**< X position of every center */
+    std::vector<float> y;   /**< Y position of every center */
+    std::vector<float> r;   /**< Radius of every circle     */
+
+    /**
+    *   @fn void push(const Circle& circle)
+    *   @param [in] circle The circle to add at the end of the array
+    */
+    void push( const Circle& circle );
+    /**
+    *   @fn void set(const size_t index, const Circle& circle) noexcept
+    *   @param [in] index The index of the circle (< size())
+    *   @param [in] circle The new circle
+    */
+    void set( const size_t index, const Circle& circle ) noexcept;
+    /**
+    *   @fn Circle get(const size_t index) const noexcept
+    *   @param [in] index The index of the circle (< size())
+    *   @return The circle
+    */
+    Circle get( const size_t index ) const noexcept;
+    /**
+    *   @fn size_t size() const noexcept
+    *   @return The number of circles
+    */
+    size_t size() const noexcept;
+    /**
+    *   @fn void clear() noexcept
+    */
+    void clear() noexcept;
+};
+
+
+/**
+*   @fn size_t collisionBoxBatch(const FloatingBox& box, const BoxArray& boxes, std::vector<uint64_t>& mask)
+*
+*   Check the collision between an AABB and every AABB of an array
+*
+*   @param [in] box The AABB
+*   @param [in] boxes The array of AABBs
+*   @param [out] mask The bitmask of the collisions
+*
+*   @return The number of AABBs that collide with box
+*   @note See collisionBox()
+*/
+size_t collisionBoxBatch( const FloatingBox& box, const BoxArray& boxes,
+                          std::vector<uint64_t>& mask );
+/**
+*   @fn size_t collisionCircleBatch(const Circle& circle, const CircleArray& circles, std::vector<uint64_t>& mask)
+*
+*   Check the collision between a circle and every circle of an array
+*
+*   @param [in] circle The circle
+*   @param [in] circles The array of circles
+*   @param [out] mask The bitmask of the collisions
+*
+*   @return The number of circles that collide with circle
+*   @note See collisionCircle()
+*/
+size_t collisionCircleBatch( const Circle& circle, const CircleArray& circles,
+                             std::vector<uint64_t>& mask );
+/**
+*   @fn size_t collisionCircleBoxBatch(const Circle& circle, const BoxArray& boxes, std::vector<uint64_t>& mask)
+*
+*   Check the collision between a circle and every AABB of an array
+*
+*   @param [in] circle The circle
+*   @param [in] boxes The array of AABBs
+*   @param [out] mask The bitmask of the collisions
+*
+*   @return The number of AABBs that collide with the circle
+*   @note See collisionCircleBox()
+*/
+size_t collisionCircleBoxBatch( const Circle& circle, const BoxArray& boxes,
+                                std::vector<uint64_t>& mask );
+/**
+*   @fn size_t collisionPointBoxBatch(const FloatPosition& p, const BoxArray& boxes, std::vector<uint64_t>& mask)
+*
+*   Check if a point is in every AABB of an array
+*
+*   @param [in] p The point
+*   @param [in] boxes The array of AABBs
+*   @param [out] mask The bitmask of the collisions
+*
+*   @return The number of AABBs that contain the point
+*   @note See collisionPointBox()
+*/
+size_t collisionPointBoxBatch( const FloatPosition& p, const BoxArray& boxes,
+                               std::vector<uint64_t>& mask );
+/**
+*   @fn size_t collisionPointCircleBatch(const FloatPosition& p, const CircleArray& circles, std::vector<uint64_t>& mask)
+*
+*   Check if a point is in every circle of an array
+*
+*   @param [in] p The point
+*   @param [in] circles The array of circles
+*   @param [out] mask The bitmask of the collisions
+*
+*   @return The number of circles that contain the point
+*   @note See collisionPointCircle()
+*/
+size_t collisionPointCircleBatch( const FloatPosition& p, const CircleArray& circles,
+                                  std::vector<uint64_t>& mask );
+
+}   // Physics
+
+}   // lx
+
+#endif // COLLISIONBATCH_HPP_INCLUDED
@@ -0,0 +1,184 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef COLLISIONMASK_HPP_INCLUDED
+#define COLLISIONMASK_HPP_INCLUDED
+
+/**
+*   @file CollisionMask.hpp
+*   @brief The pixel-perfect collision detection
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*   A collision mask is a 1-bit image: a bit is set if the pixel is solid.
+*   The bits of a row are packed in 64-bit words, so the masks are compared
+*   64 pixels at the same time.
+*
+*   A mask can cover a block of scale × scale pixels per bit (downsampled mask):
+*   a bit is set if one of the pixels of the block is solid.
+*   A downsampled mask is smaller, so it is faster to check,
+*   and it never misses a collision of the full-size mask.
+*
+*   See lx::Graphics::BufferedImage::generateCollisionMask() to get the mask of an image.
+*/
+
+#include <Lunatix/Hitbox.hpp>
+#include <vector>
+#include <cstdint>
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+/**
+*   @class CollisionMask
+*   @brief A packed 1-bit collision mask
+*/
+class CollisionMask final
+{
+    int m_width;
+    int m_height;
+    int m_scale;
+    size_t m_words_per_row;
+    std::vector<uint64_t> m_bits;
+    // Bounds of the solid bits [x0, x1) × [y0, y1), empty if x0 >= x1
+    int m_x0, m_y0, m_x1, m_y1;
+
+    friend bool collisionMask( const CollisionMask& a, const FloatPosition& pa,
+                               const CollisionMask& b, const FloatPosition& pb ) noexcept;
+    friend bool collisionMaskBox( const CollisionMask& mask, const FloatPosition& p,
+                                  const FloatingBox& box ) noexcept;
+
+    void updateBounds_() noexcept;
+
+public:
+
+    /**
+    *   @fn CollisionMask() noexcept
+    *   Create an empty mask
+    */
+    CollisionMask() noexcept;
+    /**
+    *   @fn CollisionMask(const int width, const int height, const int scale = 1)
+    *
+    *   Create a mask where no bit is set
+    *
+    *   @param [in] width The number of bits of a row
+    *   @param [in] height The number of rows
+    *   @param [in] scale The size of the block of pixels covered by a bit
+    *
+    *   @exception std::invalid_argument If a dimension is negative, or if scale < 1
+    */
+    CollisionMask( const int width, const int height, const int scale = 1 );
+
+    /**
+    *   @fn void set(const int x, const int y, const bool solid) noexcept
+    *
+    *   @param [in] x The column of the bit
+    *   @param [in] y The row of the bit
+    *   @param [in] solid The value of the bit
+    *
+    *   @note Nothing is done if the bit is out of the mask
+    */
+    void set( const int x, const int y, const bool solid ) noexcept;
+    /**
+    *   @fn bool get(const int x, const int y) const noexcept
+    *
+    *   @param [in] x The column of the bit
+    *   @param [in] y The row of the bit
+    *
+    *   @return TRUE if the bit is set, FALSE otherwise or if the bit is out of the mask
+    */
+    bool get( const int x, const int y ) const noexcept;
+
+    /**
+    *   @fn CollisionMask downsample(const int factor) const
+    *
+    *   Create a smaller mask, a bit of this mask covers factor × factor bits of the current one
+    *
+    *   @param [in] factor The factor (>= 1)
+    *   @return The downsampled mask
+    *
+    *   @exception std::invalid_argument If factor < 1
+    */
+    CollisionMask downsample( const int factor ) const;
+
+    /**
+    *   @fn int getWidth() const noexcept
+    *   @return The number of bits of a row
+    */
+    int getWidth() const noexcept;
+    /**
+    *   @fn int getHeight() const noexcept
+    *   @return The number of rows
+    */
+    int getHeight() const noexcept;
+    /**
+    *   @fn int getScale() const noexcept
+    *   @return The size of the block of pixels covered by a bit
+    */
+    int getScale() const noexcept;
+    /**
+    *   @fn FloatingBox getBoundingBox(const FloatPosition& p) const noexcept
+    *
+    *   @param [in] p The position of the top-left corner of the mask, in pixels
+    *   @return The bounding box of the solid pixels, in pixels (width 0 if there is none)
+    */
+    FloatingBox getBoundingBox( const FloatPosition& p ) const noexcept;
+    /**
+    *   @fn size_t count() const noexcept
+    *   @return The number of bits that are set
+    */
+    size_t count() const noexcept;
+
+    ~CollisionMask() = default;
+};
+
+
+/**
+*   @fn bool collisionMask(const CollisionMask& a, const FloatPosition& pa, const CollisionMask& b, const FloatPosition& pb) noexcept
+*
+*   Check if two masks have a solid pixel at the same place
+*
+*   @param [in] a The first mask
+*   @param [in] pa The position of the top-left corner of the first mask, in pixels
+*   @param [in] b The second mask
+*   @param [in] pb The position of the top-left corner of the second mask, in pixels
+*
+*   @return TRUE if they collide, FALSE otherwise
+*
+*   @note The pixels are squares, two pixels that only touch each other do not collide
+*         (like collisionBox())
+*   @note Only the part where the bounding boxes of the solid pixels overlap is checked
+*/
+bool collisionMask( const CollisionMask& a, const FloatPosition& pa,
+                    const CollisionMask& b, const FloatPosition& pb ) noexcept;
+/**
+*   @fn bool collisionMaskBox(const CollisionMask& mask, const FloatPosition& p, const FloatingBox& box) noexcept
+*
+*   Check if a mask has a solid pixel in an AABB
+*
+*   @param [in] mask The mask
+*   @param [in] p The position of the top-left corner of the mask, in pixels
+*   @param [in] box The AABB
+*
+*   @return TRUE if they collide, FALSE otherwise
+*/
+bool collisionMaskBox( const CollisionMask& mask, const FloatPosition& p,
+                       const FloatingBox& box ) noexcept;
+
+}   // Physics
+
+}   // lx
+
+#endif // COLLISIONMASK_HPP_INCLUDED
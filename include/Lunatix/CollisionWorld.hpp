@@ -0,0 +1,305 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef COLLISIONWORLD_HPP_INCLUDED
+#define COLLISIONWORLD_HPP_INCLUDED
+
+/**
+*   @file CollisionWorld.hpp
+*   @brief The broad phase of the collision detection
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*/
+
+#include <Lunatix/Hitbox.hpp>
+#include <Lunatix/Raycast.hpp>
+#include <Lunatix/Proxy.hpp>
+#include <memory>
+#include <cstdint>
+#include <vector>
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+class Polygon;
+class CollisionWorld_;
+
+/**
+*   @struct CollisionFilter
+*   @brief The layers of a proxy
+*
+*   Two proxies A and B can collide if (A.category & B.mask) != 0
+*   and (B.category & A.mask) != 0.
+*   For example, the bullets of the enemies (category 0x0004) do not hit the enemies
+*   (category 0x0002) if their mask is ~0x0002u.
+*
+*   @note The filters are used by CollisionWorld::findPairs() and
+*         CollisionWorld::findCollisions(), the queries (points, boxes, circles,
+*         segments and rays) return the proxies of every layer
+*/
+struct CollisionFilter final
+{
+    uint32_t category;  /**< The layers the proxy belongs to (usually one bit) */
+    uint32_t mask;      /**< The layers the proxy can collide with              */
+};
+
+/// Every proxy is in the layer 1 and collides with every layer by default
+const CollisionFilter DEFAULT_FILTER = { 0x0001u, 0xFFFFFFFFu };
+
+/**
+*   @class CollisionWorld
+*   @brief The broad phase of the collision detection
+*
+*   A collision world stores shapes (boxes, circles and polygons), called proxies,
+*   in a uniform grid. Each shape is registered in every cell its bounding box overlaps,
+*   so looking for the shapes near another one only visits a few cells
+*   instead of every shape of the world.
+*
+*   The cells are stored in a hash table, so the world has no bounds.
+*   The size of a cell should be about the size of the common shapes:
+*   smaller cells make the big shapes occupy a lot of them,
+*   bigger cells put a lot of shapes in the same cell.
+*
+*   @note A polygon is not copied, it must be alive as long as it is in the world.
+*         When it moves, CollisionWorld::updatePolygon() must be called.
+*   @note The queries can be called by several threads at the same time,
+*         as long as no thread modifies the world or its polygons.
+*         addPolygon() and updatePolygon() fill the caches of the polygon
+*         (see Polygon), so the queries only read it.
+*/
+class CollisionWorld final
+{
+    std::unique_ptr<CollisionWorld_> m_cwimpl;
+
+    CollisionWorld( const CollisionWorld& ) = delete;
+    CollisionWorld& operator =( const CollisionWorld& ) = delete;
+
+public:
+
+    /**
+    *   @fn explicit CollisionWorld(const float cell_size)
+    *   @param [in] cell_size The width and height of a cell (> 0)
+    *   @exception std::invalid_argument If the size of the cell is not positive
+    */
+    explicit CollisionWorld( const float cell_size );
+
+    /**
+    *   @fn ProxyID addBox(const FloatingBox& box, void * user_data = nullptr, const CollisionFilter& filter = DEFAULT_FILTER)
+    *
+    *   @param [in] box The box
+    *   @param [in] user_data Any data of the application, associated to the proxy
+    *   @param [in] filter The layers of the proxy
+    *
+    *   @return The identifier of the proxy
+    */
+    ProxyID addBox( const FloatingBox& box, void * user_data = nullptr,
+                    const CollisionFilter& filter = DEFAULT_FILTER );
+    /**
+    *   @fn ProxyID addCircle(const Circle& circle, void * user_data = nullptr, const CollisionFilter& filter = DEFAULT_FILTER)
+    *
+    *   @param [in] circle The circle
+    *   @param [in] user_data Any data of the application, associated to the proxy
+    *   @param [in] filter The layers of the proxy
+    *
+    *   @return The identifier of the proxy
+    */
+    ProxyID addCircle( const Circle& circle, void * user_data = nullptr,
+                       const CollisionFilter& filter = DEFAULT_FILTER );
+    /**
+    *   @fn ProxyID addPolygon(const Polygon& poly, void * user_data = nullptr, const CollisionFilter& filter = DEFAULT_FILTER)
+    *
+    *   @param [in] poly The polygon, it is not copied
+    *   @param [in] user_data Any data of the application, associated to the proxy
+    *   @param [in] filter The layers of the proxy
+    *
+    *   @return The identifier of the proxy
+    *   @exception PolygonException If the polygon has less than 3 sides
+    */
+    ProxyID addPolygon( const Polygon& poly, void * user_data = nullptr,
+                        const CollisionFilter& filter = DEFAULT_FILTER );
+
+    /**
+    *   @fn void updateBox(const ProxyID id, const FloatingBox& box) noexcept
+    *
+    *   Move or resize a box
+    *
+    *   @param [in] id The identifier of the box
+    *   @param [in] box The new box
+    *
+    *   @note The proxy only changes its cells if its bounding box
+    *         moved to other cells, so small moves are cheap
+    */
+    void updateBox( const ProxyID id, const FloatingBox& box ) noexcept;
+    /**
+    *   @fn void updateCircle(const ProxyID id, const Circle& circle) noexcept
+    *
+    *   Move or resize a circle
+    *
+    *   @param [in] id The identifier of the circle
+    *   @param [in] circle The new circle
+    */
+    void updateCircle( const ProxyID id, const Circle& circle ) noexcept;
+    /**
+    *   @fn void updatePolygon(const ProxyID id)
+    *
+    *   Take into account the new position of a polygon
+    *
+    *   @param [in] id The identifier of the polygon
+    *   @exception PolygonException If the polygon has less than 3 sides
+    */
+    void updatePolygon( const ProxyID id );
+    /**
+    *   @fn bool remove(const ProxyID id) noexcept
+    *
+    *   Remove a proxy from the world.
+    *   Its identifier may be reused by a new proxy.
+    *
+    *   @param [in] id The identifier of the proxy
+    *   @return TRUE if the proxy was removed, FALSE if it did not exist
+    */
+    bool remove( const ProxyID id ) noexcept;
+
+    /**
+    *   @fn void * getUserData(const ProxyID id) const noexcept
+    *   @param [in] id The identifier of the proxy
+    *   @return The data of the application associated to the proxy,
+    *          a null pointer if the proxy does not exist
+    */
+    void * getUserData( const ProxyID id ) const noexcept;
+    /**
+    *   @fn void setFilter(const ProxyID id, const CollisionFilter& filter) noexcept
+    *   @param [in] id The identifier of the proxy
+    *   @param [in] filter The new layers of the proxy
+    */
+    void setFilter( const ProxyID id, const CollisionFilter& filter ) noexcept;
+    /**
+    *   @fn CollisionFilter getFilter(const ProxyID id) const noexcept
+    *   @param [in] id The identifier of the proxy
+    *   @return The layers of the proxy, {0, 0} if the proxy does not exist
+    */
+    CollisionFilter getFilter( const ProxyID id ) const noexcept;
+    /**
+    *   @fn size_t size() const noexcept
+    *   @return The number of proxies in the world
+    */
+    size_t size() const noexcept;
+
+    /**
+    *   @fn void findPairs(std::vector<ProxyPair>& pairs) const
+    *
+    *   Find every pair of proxies whose bounding boxes overlap
+    *   and whose layers can collide (see CollisionFilter)
+    *
+    *   @param [out] pairs The candidate pairs, every pair is reported once
+    *
+    *   @note The shapes of a pair may not collide,
+    *         CollisionWorld::collide() checks the exact shapes
+    *   @note The filtered pairs are rejected before their bounding boxes are checked,
+    *         and a proxy whose mask rejects every proxy of a cell skips the cell
+    */
+    void findPairs( std::vector<ProxyPair>& pairs ) const;
+    /**
+    *   @fn void findCollisions(std::vector<ProxyPair>& pairs) const
+    *
+    *   Find every pair of proxies whose exact shapes collide
+    *   and whose layers can collide (see CollisionFilter)
+    *
+    *   @param [out] pairs The colliding pairs, every pair is reported once
+    *
+    *   @note The exact shapes are only checked for the pairs given by findPairs()
+    */
+    void findCollisions( std::vector<ProxyPair>& pairs ) const;
+    /**
+    *   @fn bool collide(const ProxyID a, const ProxyID b) const
+    *
+    *   Check the collision between the exact shapes of two proxies
+    *
+    *   @param [in] a The first proxy
+    *   @param [in] b The second proxy
+    *
+    *   @return TRUE if there is a collision, FALSE otherwise
+    */
+    bool collide( const ProxyID a, const ProxyID b ) const;
+
+    /**
+    *   @fn void queryPoint(const FloatPosition& p, std::vector<ProxyID>& result) const
+    *
+    *   Find the proxies that contain a point
+    *
+    *   @param [in] p The point
+    *   @param [out] result The proxies, in increasing order
+    */
+    void queryPoint( const FloatPosition& p, std::vector<ProxyID>& result ) const;
+    /**
+    *   @fn void queryBox(const FloatingBox& box, std::vector<ProxyID>& result) const
+    *
+    *   Find the proxies that collide with a box
+    *
+    *   @param [in] box The box
+    *   @param [out] result The proxies, in increasing order
+    */
+    void queryBox( const FloatingBox& box, std::vector<ProxyID>& result ) const;
+    /**
+    *   @fn void queryCircle(const Circle& circle, std::vector<ProxyID>& result) const
+    *
+    *   Find the proxies that collide with a circle
+    *
+    *   @param [in] circle The circle
+    *   @param [out] result The proxies, in increasing order
+    */
+    void queryCircle( const Circle& circle, std::vector<ProxyID>& result ) const;
+
+    /**
+    *   @fn ProxyID segmentCast(const Segment& s, RayHit& hit) const
+    *
+    *   Find the first proxy entered by a segment
+    *
+    *   The cells are visited along the segment, from s.p to s.q,
+    *   and the search stops at the first cell where a proxy is hit,
+    *   so a short segment or a segment that hits an obstacle early only
+    *   looks at a few proxies. An empty result means a clear line of sight.
+    *
+    *   @param [in] s The segment
+    *   @param [out] hit The point where the segment enters the proxy, if there is one
+    *
+    *   @return The proxy, NULL_PROXY if the segment does not enter any proxy
+    *
+    *   @note A proxy that contains s.p is ignored (see Raycast.hpp)
+    */
+    ProxyID segmentCast( const Segment& s, RayHit& hit ) const;
+    /**
+    *   @fn ProxyID rayCast(const FloatPosition& origin, const Vector2D& direction, const float length, RayHit& hit) const
+    *
+    *   Find the first proxy entered by a ray
+    *
+    *   @param [in] origin The origin of the ray
+    *   @param [in] direction The direction of the ray (not null)
+    *   @param [in] length The maximal distance from the origin
+    *   @param [out] hit The point where the ray enters the proxy, if there is one.
+    *               hit.fraction × length is the distance from the origin
+    *
+    *   @return The proxy, NULL_PROXY if the ray does not enter any proxy
+    */
+    ProxyID rayCast( const FloatPosition& origin, const Vector2D& direction,
+                     const float length, RayHit& hit ) const;
+
+    ~CollisionWorld();
+};
+
+}   // Physics
+
+}   // lx
+
+#endif // COLLISIONWORLD_HPP_INCLUDED
@@ -0,0 +1,198 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef DYNAMICAABBTREE_HPP_INCLUDED
+#define DYNAMICAABBTREE_HPP_INCLUDED
+
+/**
+*   @file DynamicAABBTree.hpp
+*   @brief The dynamic bounding volume hierarchy
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*/
+
+#include <Lunatix/Hitbox.hpp>
+#include <Lunatix/Proxy.hpp>
+#include <memory>
+#include <vector>
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+class Polygon;
+class DynamicAABBTree_;
+
+/**
+*   @class DynamicAABBTree
+*   @brief A balanced tree of bounding boxes
+*
+*   Every proxy is a leaf of a binary tree, and every node of the tree
+*   contains the bounding boxes of its children. Looking for the proxies
+*   in a region only visits the branches that overlap it,
+*   whatever the size of the proxies, so the tree fits scenes where
+*   big and small shapes are mixed. A uniform grid (CollisionWorld) is faster
+*   when all the shapes have about the same size.
+*
+*   The tree stores a fattened box for each proxy: the bounding box
+*   of the shape, extended by a margin and in the direction of the movement.
+*   As long as the shape moves inside its fattened box, the tree is not modified.
+*   The tree is balanced after each insertion and removal.
+*
+*   The tree only works on bounding boxes: a pair or a query reports
+*   the proxies whose bounding boxes overlap, not the proxies whose shapes collide.
+*
+*   @note The queries can be called by several threads at the same time,
+*         as long as no thread modifies the tree. They only read the boxes
+*         stored in the tree, never the shapes.
+*/
+class DynamicAABBTree final
+{
+    std::unique_ptr<DynamicAABBTree_> m_timpl;
+
+    DynamicAABBTree( const DynamicAABBTree& ) = delete;
+    DynamicAABBTree& operator =( const DynamicAABBTree& ) = delete;
+
+public:
+
+    /**
+    *   @fn explicit DynamicAABBTree(const float margin = 4.0f)
+    *   @param [in] margin The space added around every bounding box
+    */
+    explicit DynamicAABBTree( const float margin = 4.0f );
+
+    /**
+    *   @fn ProxyID addBox(const FloatingBox& box, void * user_data = nullptr)
+    *
+    *   @param [in] box The box
+    *   @param [in] user_data Any data of the application, associated to the proxy
+    *
+    *   @return The identifier of the proxy
+    */
+    ProxyID addBox( const FloatingBox& box, void * user_data = nullptr );
+    /**
+    *   @fn ProxyID addCircle(const Circle& circle, void * user_data = nullptr)
+    *
+    *   @param [in] circle The circle
+    *   @param [in] user_data Any data of the application, associated to the proxy
+    *
+    *   @return The identifier of the proxy
+    */
+    ProxyID addCircle( const Circle& circle, void * user_data = nullptr );
+    /**
+    *   @fn ProxyID addPolygon(const Polygon& poly, void * user_data = nullptr)
+    *
+    *   @param [in] poly The polygon, only its enclosing box is stored
+    *   @param [in] user_data Any data of the application, associated to the proxy
+    *
+    *   @return The identifier of the proxy
+    *   @exception PolygonException If the polygon has less than 3 sides
+    */
+    ProxyID addPolygon( const Polygon& poly, void * user_data = nullptr );
+
+    /**
+    *   @fn bool moveBox(const ProxyID id, const FloatingBox& box, const Vector2D& v) noexcept
+    *
+    *   @param [in] id The identifier of the proxy
+    *   @param [in] box The new box
+    *   @param [in] v The movement of the box since the last update,
+    *                 the fattened box is extended in this direction
+    *
+    *   @return TRUE if the proxy was reinserted in the tree,
+    *          FALSE if the box is still in its fattened box (or if the proxy does not exist)
+    */
+    bool moveBox( const ProxyID id, const FloatingBox& box, const Vector2D& v ) noexcept;
+    /**
+    *   @fn bool moveCircle(const ProxyID id, const Circle& circle, const Vector2D& v) noexcept
+    *
+    *   @param [in] id The identifier of the proxy
+    *   @param [in] circle The new circle
+    *   @param [in] v The movement of the circle since the last update
+    *
+    *   @return TRUE if the proxy was reinserted in the tree, FALSE otherwise
+    */
+    bool moveCircle( const ProxyID id, const Circle& circle, const Vector2D& v ) noexcept;
+    /**
+    *   @fn bool movePolygon(const ProxyID id, const Polygon& poly, const Vector2D& v)
+    *
+    *   @param [in] id The identifier of the proxy
+    *   @param [in] poly The polygon at its new position
+    *   @param [in] v The movement of the polygon since the last update
+    *
+    *   @return TRUE if the proxy was reinserted in the tree, FALSE otherwise
+    *   @exception PolygonException If the polygon has less than 3 sides
+    */
+    bool movePolygon( const ProxyID id, const Polygon& poly, const Vector2D& v );
+    /**
+    *   @fn bool remove(const ProxyID id) noexcept
+    *
+    *   @param [in] id The identifier of the proxy
+    *   @return TRUE if the proxy was removed, FALSE if it did not exist
+    */
+    bool remove( const ProxyID id ) noexcept;
+
+    /**
+    *   @fn void * getUserData(const ProxyID id) const noexcept
+    *   @param [in] id The identifier of the proxy
+    *   @return The data of the application associated to the proxy,
+    *          a null pointer if the proxy does not exist
+    */
+    void * getUserData( const ProxyID id ) const noexcept;
+    /**
+    *   @fn size_t size() const noexcept
+    *   @return The number of proxies in the tree
+    */
+    size_t size() const noexcept;
+    /**
+    *   @fn int getHeight() const noexcept
+    *   @return The height of the tree (0 if it has one proxy, -1 if it is empty)
+    */
+    int getHeight() const noexcept;
+
+    /**
+    *   @fn void findPairs(std::vector<ProxyPair>& pairs) const
+    *
+    *   Find every pair of proxies whose bounding boxes overlap
+    *
+    *   @param [out] pairs The pairs, sorted, every pair is reported once
+    */
+    void findPairs( std::vector<ProxyPair>& pairs ) const;
+    /**
+    *   @fn void queryBox(const FloatingBox& box, std::vector<ProxyID>& result) const
+    *
+    *   Find the proxies whose bounding boxes overlap a region
+    *
+    *   @param [in] box The region
+    *   @param [out] result The proxies, in increasing order
+    */
+    void queryBox( const FloatingBox& box, std::vector<ProxyID>& result ) const;
+    /**
+    *   @fn void queryRay(const Segment& s, std::vector<ProxyID>& result) const
+    *
+    *   Find the proxies whose bounding boxes are crossed by a segment
+    *
+    *   @param [in] s The segment, from s.p to s.q
+    *   @param [out] result The proxies, sorted by the distance
+    *                between s.p and the point where the segment enters their box
+    */
+    void queryRay( const Segment& s, std::vector<ProxyID>& result ) const;
+
+    ~DynamicAABBTree();
+};
+
+}   // Physics
+
+}   // lx
+
+#endif // DYNAMICAABBTREE_HPP_INCLUDED
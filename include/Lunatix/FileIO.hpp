@@ -297,6 +297,63 @@ public:
 };
 
 
+class MappedFile_;
+
+/**
+*   @class MappedFile
+*   @brief A read-only file mapped in memory
+*
+*   The content of the file is accessible as a block of memory,
+*   without copying it: the pages are loaded by the system when they are read.
+*   It is useful to load big binary files (like baked data) in constant time.
+*
+*   @note On the systems that do not support the mapping of files,
+*         the file is read into memory
+*/
+class MappedFile final
+{
+    std::unique_ptr<MappedFile_> m_mimpl;
+
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile& operator =( const MappedFile& ) = delete;
+
+public:
+
+    /**
+    *   @fn explicit MappedFile(const std::string& filename)
+    *   @param [in] filename The file to map
+    *   @exception IOException If the file cannot be opened or mapped
+    */
+    explicit MappedFile( const std::string& filename );
+    /**
+    *   @fn explicit MappedFile(const UTF8string& filename)
+    *   @param [in] filename The file to map
+    *   @exception IOException If the file cannot be opened or mapped
+    */
+    explicit MappedFile( const UTF8string& filename );
+
+    /**
+    *   @fn const void * data() const noexcept
+    *   @return The content of the file, aligned at least on 8 bytes.
+    *          It is valid as long as the object exists.
+    *          A null pointer if the file is empty.
+    */
+    const void * data() const noexcept;
+    /**
+    *   @fn size_t size() const noexcept
+    *   @return The size of the file, in bytes
+    */
+    size_t size() const noexcept;
+    /**
+    *   @fn const char * getFilename() const noexcept
+    *   @return The name of the file
+    */
+    const char * getFilename() const noexcept;
+
+    ~MappedFile();
+};
+
+
 /**
 *   @fn AbstractFile& operator <<(AbstractFile& f, const char s[]) noexcept
 *
@@ -0,0 +1,176 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef GJK_HPP_INCLUDED
+#define GJK_HPP_INCLUDED
+
+/**
+*   @file GJK.hpp
+*   @brief The narrow phase of the collision detection between convex shapes
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*   GJK (Gilbert-Johnson-Keerthi) checks the collision between two convex shapes.
+*   EPA (Expanding Polytope Algorithm) gives the penetration depth and the normal
+*   of the collision, then the contact points are found by clipping the edges.
+*   A circle has an exact test against a circle or the edges of a polygon.
+*
+*   See — http://www.dyn4j.org/2010/04/gjk-gilbert-johnson-keerthi/
+*   See — http://www.dyn4j.org/2010/05/epa-expanding-polytope-algorithm/
+*/
+
+#include <Lunatix/Hitbox.hpp>
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+class Polygon;
+
+/**
+*   @class ConvexShape
+*   @brief A reference to a convex shape (box, circle, polygon or array of points)
+*
+*   It can be implicitly built from a FloatingBox, a Circle or a Polygon,
+*   so every function of the narrow phase accepts any of them.
+*
+*   @note The polygon and the points are not copied,
+*         they must be alive as long as the shape is used
+*   @note If the polygon is not convex, its convex hull is used
+*/
+class ConvexShape final
+{
+    enum class Type : short
+    {
+        BOX, CIRCLE, POLYGON, POINTS
+    };
+
+    Type m_type;
+    FloatingBox m_box;
+    Circle m_circle;
+    const Polygon * m_poly;
+    const FloatPosition * m_points;
+    unsigned long m_nb_points;
+
+public:
+
+    /**
+    *   @fn ConvexShape(const FloatingBox& box) noexcept
+    *   @param [in] box The box
+    */
+    ConvexShape( const FloatingBox& box ) noexcept;
+    /**
+    *   @fn ConvexShape(const Circle& circle) noexcept
+    *   @param [in] circle The circle
+    */
+    ConvexShape( const Circle& circle ) noexcept;
+    /**
+    *   @fn ConvexShape(const Polygon& poly)
+    *   @param [in] poly The polygon
+    *   @exception PolygonException If the polygon has less than 3 sides
+    */
+    ConvexShape( const Polygon& poly );
+    /**
+    *   @fn ConvexShape(const FloatPosition * points, const unsigned long n) noexcept
+    *   @param [in] points The vertices of a convex polygon
+    *   @param [in] n The number of vertices (> 0)
+    */
+    ConvexShape( const FloatPosition * points, const unsigned long n ) noexcept;
+
+    /**
+    *   @fn FloatingBox getEnclosingBox() const noexcept
+    *   @return The axis-aligned bounding box of the shape
+    */
+    FloatingBox getEnclosingBox() const noexcept;
+    /**
+    *   @fn const Circle * getCircle() const noexcept
+    *   @return The circle, a null pointer if the shape is not a circle
+    */
+    const Circle * getCircle() const noexcept;
+    /**
+    *   @fn unsigned long numberOfVertices() const noexcept
+    *   @return The number of vertices, 0 for a circle
+    */
+    unsigned long numberOfVertices() const noexcept;
+    /**
+    *   @fn FloatPosition getVertex(const unsigned long index) const
+    *   @param [in] index The index of the vertex (< numberOfVertices())
+    *   @return The vertex
+    */
+    FloatPosition getVertex( const unsigned long index ) const;
+    /**
+    *   @fn FloatPosition support(const Vector2D& d) const
+    *
+    *   Get the farthest point of the shape in a direction
+    *
+    *   @param [in] d The direction
+    *   @return The point
+    */
+    FloatPosition support( const Vector2D& d ) const;
+
+    ~ConvexShape() = default;
+};
+
+
+/**
+*   @struct ContactManifold
+*   @brief The description of a collision between two shapes
+*
+*   Moving the first shape by -(normal × depth) separates the two shapes.
+*/
+struct ContactManifold final
+{
+    Vector2D normal;            /**< Unit normal, from the first shape to the second one */
+    float depth;                /**< Penetration depth                                    */
+    unsigned int nb_points;     /**< Number of contact points (1 or 2)                    */
+    FloatPosition points[2];    /**< Contact points                                       */
+};
+
+
+/**
+*   @fn bool collisionGJK(const ConvexShape& a, const ConvexShape& b, const bool touching = false)
+*
+*   Check the collision between two convex shapes
+*
+*   @param [in] a The first shape
+*   @param [in] b The second shape
+*   @param [in] touching TRUE: two shapes that only touch each other collide,
+*          like in the collision functions of Physics.hpp.
+*          FALSE (default): they do not collide, like in contactGJK()
+*
+*   @return TRUE if there is a collision, FALSE otherwise
+*
+*   @note Complexity: O(m + n) for each iteration, the number of iterations is small.
+*         m and n are the number of vertices of the shapes
+*/
+bool collisionGJK( const ConvexShape& a, const ConvexShape& b, const bool touching = false );
+/**
+*   @fn bool contactGJK(const ConvexShape& a, const ConvexShape& b, ContactManifold& manifold)
+*
+*   Check the collision between two convex shapes and describe it
+*
+*   @param [in] a The first shape
+*   @param [in] b The second shape
+*   @param [out] manifold The description of the collision, if there is one
+*
+*   @return TRUE if there is a collision, FALSE otherwise
+*
+*   @note The contact points of a circle and a polygon are on the polygon
+*/
+bool contactGJK( const ConvexShape& a, const ConvexShape& b, ContactManifold& manifold );
+
+}   // Physics
+
+}   // lx
+
+#endif // GJK_HPP_INCLUDED
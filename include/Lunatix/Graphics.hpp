@@ -25,6 +25,9 @@
 */
 
 #include "Texture.hpp"
+#include "SpriteBatch.hpp"
+#include "TextureAtlas.hpp"
+#include "ImagePipeline.hpp"
 #include "OpenGL.hpp"
 #include "TrueTypeFont.hpp"
 #include "Window.hpp"
@@ -0,0 +1,181 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef IMAGEPIPELINE_HPP_INCLUDED
+#define IMAGEPIPELINE_HPP_INCLUDED
+
+/**
+*   @file ImagePipeline.hpp
+*   @brief The image processing pipeline
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*   A pipeline records the operations to do on a buffered image,
+*   then applies them with as few passes over the image as possible:
+*
+*       image.pipeline().tint( c ).blur( 3 ).premultiply().apply();
+*
+*   The per-pixel operations (colour matrix, tint, grayscale, negative,
+*   premultiplication) are fused: consecutive colour matrices are combined
+*   into one matrix, and all of them are done on a pixel while it is in
+*   the cache. A blur starts a new pass: the image is processed by tiles,
+*   with a separable kernel, and the per-pixel operations around the blur
+*   are done in the same pass.
+*/
+
+#include <Lunatix/Texture.hpp>
+#include <memory>
+
+
+namespace lx
+{
+
+namespace Graphics
+{
+
+class ImagePipeline_;
+
+/**
+*   @struct ColourMatrix
+*   @brief A 4 × 5 colour matrix
+*
+*   The channels are in [0, 1], the row *i* of the matrix gives the channel *i*
+*   (red, green, blue, alpha) of the new colour:
+*
+*       c'[i] = m[i][0] × R + m[i][1] × G + m[i][2] × B + m[i][3] × A + m[i][4]
+*
+*   The result is clamped to [0, 1] when the image is written.
+*/
+struct ColourMatrix final
+{
+    float m[4][5];
+};
+
+/// The identity matrix
+const ColourMatrix IDENTITY_MATRIX = { { { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f }
+    }
+};
+
+
+/**
+*   @class ImagePipeline
+*   @brief A sequence of operations on a buffered image
+*
+*   The pipeline is created by BufferedImage::pipeline(), nothing is done
+*   on the image until apply() is called.
+*
+*   @note The image must be alive until apply() is called
+*/
+class ImagePipeline final
+{
+    friend class BufferedImage;
+    std::unique_ptr<ImagePipeline_> m_pimpl;
+
+    explicit ImagePipeline( BufferedImage& image );
+    ImagePipeline( const ImagePipeline& ) = delete;
+    ImagePipeline& operator =( const ImagePipeline& ) = delete;
+
+public:
+
+    ImagePipeline( ImagePipeline&& p ) noexcept;
+
+    /**
+    *   @fn ImagePipeline& colourMatrix(const ColourMatrix& matrix)
+    *   Transform the colour of every pixel
+    *   @param [in] matrix The colour matrix
+    *   @return The pipeline
+    */
+    ImagePipeline& colourMatrix( const ColourMatrix& matrix );
+    /**
+    *   @fn ImagePipeline& tint(const Colour& colour)
+    *   Multiply the colour of every pixel by a colour (alpha included)
+    *   @param [in] colour The colour
+    *   @return The pipeline
+    */
+    ImagePipeline& tint( const Colour& colour );
+    /**
+    *   @fn ImagePipeline& grayscale()
+    *   Convert the image to grayscale (Rec. 709 weights)
+    *   @return The pipeline
+    */
+    ImagePipeline& grayscale();
+    /**
+    *   @fn ImagePipeline& negative()
+    *   Invert the colours of the image
+    *   @return The pipeline
+    */
+    ImagePipeline& negative();
+    /**
+    *   @fn ImagePipeline& premultiply()
+    *
+    *   Multiply the colour of every pixel by its alpha value
+    *
+    *   @return The pipeline
+    *   @note A blurred image with transparent areas looks better
+    *         if it is premultiplied before the blur
+    */
+    ImagePipeline& premultiply();
+
+    /**
+    *   @fn ImagePipeline& blur(const int radius)
+    *
+    *   Box blur, every pixel becomes the average of the (2 × radius + 1)²
+    *   pixels around it. The pixels out of the image are the ones of the edges.
+    *
+    *   @param [in] radius The radius of the blur, 0 does nothing
+    *   @return The pipeline
+    *   @exception std::invalid_argument If radius < 0
+    */
+    ImagePipeline& blur( const int radius );
+    /**
+    *   @fn ImagePipeline& gaussianBlur(const float sigma)
+    *
+    *   Gaussian blur, the radius of the kernel is ⌈3 × sigma⌉
+    *
+    *   @param [in] sigma The standard deviation of the gaussian (in pixels), 0 does nothing
+    *   @return The pipeline
+    *   @exception std::invalid_argument If sigma < 0
+    */
+    ImagePipeline& gaussianBlur( const float sigma );
+
+    /**
+    *   @fn size_t numberOfPasses() const noexcept
+    *   @return The number of passes over the image apply() will do:
+    *          one per blur, one if there are only per-pixel operations,
+    *          and 0 if the pipeline is empty
+    */
+    size_t numberOfPasses() const noexcept;
+
+    /**
+    *   @fn BufferedImage& apply()
+    *
+    *   Apply the operations on the image, then clear the pipeline
+    *
+    *   @return The image
+    *   @exception std::bad_alloc If the buffers of a pass cannot be allocated,
+    *             the image may be partially processed
+    *   @note A big image is processed on the worker pool
+    *         (see lx::Multithreading::getWorkerPool())
+    *   @note An image whose format is not a 32-bit format with 8-bit channels
+    *         is converted to RGBA8888, processed, then converted back
+    */
+    BufferedImage& apply();
+
+    ~ImagePipeline();
+};
+
+}   // Graphics
+
+}   // lx
+
+#endif // IMAGEPIPELINE_HPP_INCLUDED
@@ -52,8 +52,20 @@
 // Physics
 #include <Lunatix/Particle.hpp>
 #include <Lunatix/ParticleSystem.hpp>
+#include <Lunatix/ParticleEmitter.hpp>
 #include <Lunatix/Physics.hpp>
 #include <Lunatix/Polygon.hpp>
+#include <Lunatix/Proxy.hpp>
+#include <Lunatix/CollisionWorld.hpp>
+#include <Lunatix/DynamicAABBTree.hpp>
+#include <Lunatix/GJK.hpp>
+#include <Lunatix/Sweep.hpp>
+#include <Lunatix/Raycast.hpp>
+#include <Lunatix/PhysicsWorld.hpp>
+#include <Lunatix/CollisionBatch.hpp>
+#include <Lunatix/Vector2DArray.hpp>
+#include <Lunatix/CollisionMask.hpp>
+#include <Lunatix/StaticGeometry.hpp>
 
 // System
 #include <Lunatix/FileIO.hpp>
@@ -20,6 +20,7 @@
 *
 */
 
+#include <Lunatix/Hitbox.hpp>
 #include <memory>
 
 
@@ -33,18 +34,28 @@ namespace Graphics
 class Sprite;
 }
 
-namespace Physics
-{
-struct Vector2D;
-struct FloatingBox;
-}
-
 //  Forward declarations (END)
 
 namespace ParticleEngine
 {
 
+/**
+*   @struct ParticleInfo
+*   @brief The description of a particle
+*
+*   A particle system copies this description into its own storage,
+*   so adding a particle this way does not allocate anything.
+*/
+struct ParticleInfo final
+{
+    lx::Graphics::Sprite * sprite;      /**< The sprite of the particle (not owned) */
+    lx::Physics::FloatingBox box;       /**< Coordinates, width and height          */
+    lx::Physics::Vector2D velocity;     /**< Velocity                               */
+    unsigned int lifetime;              /**< Number of updates before dying         */
+};
+
 class Particle_;
+class ParticleSystem_;
 
 /**
 *   @class Particle
@@ -52,11 +63,14 @@ class Particle_;
 */
 class Particle final
 {
+    friend class ParticleSystem_;
     std::unique_ptr<Particle_> m_pimpl;
 
     Particle( Particle& p ) = delete;
     Particle& operator =( Particle& p ) = delete;
 
+    ParticleInfo getInfo_() const noexcept;
+
 
 public:
 
@@ -76,6 +90,20 @@ public:
     */
     Particle( lx::Graphics::Sprite& sp, const lx::Physics::FloatingBox& b,
               const lx::Physics::Vector2D& v ) noexcept;
+    /**
+    *   @fn Particle(lx::Graphics::Sprite& sp, const lx::Physics::FloatingBox& b,
+    *                  const lx::Physics::Vector2D& v, const unsigned int lifetime) noexcept
+    *
+    *   @param [in] sp The sprite of the particle
+    *   @param [in] b The AABB that contains the coordinates, the width and the height
+    *   @param [in] v The vector that store the velocity
+    *   @param [in] lifetime The number of updates before the particle dies
+    *
+    *   @note The other constructors set a random lifetime between 0 and 15
+    *   @sa ParticleEmitter
+    */
+    Particle( lx::Graphics::Sprite& sp, const lx::Physics::FloatingBox& b,
+              const lx::Physics::Vector2D& v, const unsigned int lifetime ) noexcept;
 
     /**
     *   @fn void update() noexcept
@@ -0,0 +1,141 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef PARTICLEEMITTER_HPP_INCLUDED
+#define PARTICLEEMITTER_HPP_INCLUDED
+
+/**
+*   @file ParticleEmitter.hpp
+*   @brief The Particle emitter
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*/
+
+#include <Lunatix/Hitbox.hpp>
+#include <memory>
+
+
+namespace lx
+{
+
+// Forward declarations
+
+namespace Graphics
+{
+class Sprite;
+}
+
+//  Forward declarations (END)
+
+namespace ParticleEngine
+{
+
+class ParticleSystem;
+class ParticleEmitter_;
+
+/**
+*   @struct EmitterConfig
+*   @brief The description of the particles an emitter spawns
+*
+*   Every particle gets a random position in the spawn area,
+*   a random direction in the cone [direction - spread/2, direction + spread/2],
+*   a random speed in [speed_min, speed_max]
+*   and a random lifetime in [lifetime_min, lifetime_max].
+*
+*   @note The angles are in radians, 0 points to the right,
+*         and a positive angle turns counterclockwise on the screen
+*/
+struct EmitterConfig final
+{
+    lx::Graphics::Sprite * sprite;      /**< The sprite of the particles (not owned)    */
+    lx::Physics::FloatingBox area;      /**< Spawn area                                 */
+    int particle_w;                     /**< Width of a particle                        */
+    int particle_h;                     /**< Height of a particle                       */
+    float rate;                         /**< Particles per update (may be fractional)   */
+    float direction;                    /**< Direction of the cone                      */
+    float spread;                       /**< Angle of the cone                          */
+    float speed_min;                    /**< Minimal speed                              */
+    float speed_max;                    /**< Maximal speed                              */
+    unsigned int lifetime_min;          /**< Minimal lifetime (in updates)              */
+    unsigned int lifetime_max;          /**< Maximal lifetime (in updates)              */
+};
+
+/**
+*   @class ParticleEmitter
+*   @brief The particle emitter
+*
+*   An emitter spawns particles in a particle system according to its configuration.
+*   The particles are written directly into the storage of the system,
+*   so spawning them does not allocate any memory.
+*
+*   @note The particle system must be alive as long as the emitter is used
+*/
+class ParticleEmitter final
+{
+    std::unique_ptr<ParticleEmitter_> m_eimpl;
+
+    ParticleEmitter( const ParticleEmitter& ) = delete;
+    ParticleEmitter& operator =( const ParticleEmitter& ) = delete;
+
+public:
+
+    /**
+    *   @fn ParticleEmitter(ParticleSystem& sys, const EmitterConfig& config)
+    *   @param [in] sys The particle system the particles are spawned in
+    *   @param [in] config The configuration of the emitter
+    */
+    ParticleEmitter( ParticleSystem& sys, const EmitterConfig& config );
+
+    /**
+    *   @fn void setConfig(const EmitterConfig& config) noexcept
+    *   @param [in] config The new configuration
+    */
+    void setConfig( const EmitterConfig& config ) noexcept;
+    /**
+    *   @fn const EmitterConfig& getConfig() const noexcept
+    *   @return The configuration
+    */
+    const EmitterConfig& getConfig() const noexcept;
+    /**
+    *   @fn void setPosition(const lx::Physics::FloatPosition& p) noexcept
+    *   Move the spawn area
+    *   @param [in] p The new position of the spawn area
+    */
+    void setPosition( const lx::Physics::FloatPosition& p ) noexcept;
+
+    /**
+    *   @fn unsigned int burst(const unsigned int n) noexcept
+    *   Spawn particles immediately
+    *
+    *   @param [in] n The number of particles to spawn
+    *   @return The number of particles that were spawned.
+    *          It is less than n if the particle system is full.
+    */
+    unsigned int burst( const unsigned int n ) noexcept;
+    /**
+    *   @fn unsigned int update() noexcept
+    *   Spawn the particles according to the rate
+    *
+    *   If the rate is fractional, the remainder is accumulated over the updates.
+    *   For example, a rate of 0.25 spawns one particle every four updates.
+    *
+    *   @return The number of particles that were spawned
+    */
+    unsigned int update() noexcept;
+
+    ~ParticleEmitter();
+};
+
+}   // ParticleEngine
+
+}   // lx
+
+#endif // PARTICLEEMITTER_HPP_INCLUDED
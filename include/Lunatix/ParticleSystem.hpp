@@ -20,6 +20,7 @@
 *
 */
 
+#include <Lunatix/Particle.hpp>
 #include <memory>
 
 namespace lx
@@ -35,9 +36,39 @@ namespace lx
 namespace ParticleEngine
 {
 
-class Particle;
 class ParticleSystem_;
 
+/**
+*   @enum ParticleKernel
+*   @brief The implementation used to update the particles
+*
+*   The best kernel supported by the CPU is chosen at startup.
+*   Every kernel gives exactly the same results.
+*/
+enum class ParticleKernel : short
+{
+    SCALAR, /**< Portable implementation, one particle at a time    */
+    SSE2,   /**< 4 particles per instruction                        */
+    AVX2    /**< 8 particles per instruction                        */
+};
+
+/**
+*   @fn ParticleKernel getParticleKernel() noexcept
+*   Get the kernel used by every particle system
+*   @return The kernel
+*/
+ParticleKernel getParticleKernel() noexcept;
+/**
+*   @fn bool setParticleKernel(const ParticleKernel kernel) noexcept
+*   Set the kernel used by every particle system
+*
+*   @param [in] kernel The kernel to use
+*   @return TRUE on success, FALSE if the CPU does not support it
+*
+*   @note This function is mainly useful to test the kernels
+*/
+bool setParticleKernel( const ParticleKernel kernel ) noexcept;
+
 /**
 *   @class ParticleSystem
 *   @brief The particle system
@@ -63,9 +94,23 @@ public:
     *
     *   @return TRUE if the system had the particle with succes.
     *          FALSE if the particle is a null pointer or the system cannot add it
+    *
+    *   @note On success, the system takes the ownership of the particle.
+    *         Its data is copied into the internal storage and
+    *         the particle is immediately destroyed.
     */
     bool addParticle( Particle * p ) noexcept;
     /**
+    *   @fn bool addParticle(const ParticleInfo& info) noexcept
+    *   @param [in] info The description of the particle to add
+    *
+    *   @return TRUE if the system had the particle with succes.
+    *          FALSE if the sprite is a null pointer or the system is full
+    *
+    *   @note This function does not allocate any memory
+    */
+    bool addParticle( const ParticleInfo& info ) noexcept;
+    /**
     *   @fn void updateParticles() noexcept
     *   Update the status of the particles
     */
@@ -75,6 +120,17 @@ public:
     *   Display the particles
     */
     void displayParticles() const noexcept;
+    /**
+    *   @fn bool getParticle(const unsigned int index, ParticleInfo& info) const noexcept
+    *   Get the current state of a particle
+    *
+    *   @param [in] index The index of the particle, in [0, nbActiveParticles())
+    *   @param [out] info The description of the particle
+    *
+    *   @return TRUE on success, FALSE if the index is out of range
+    *   @note The index of a particle may change when another particle dies
+    */
+    bool getParticle( const unsigned int index, ParticleInfo& info ) const noexcept;
 
     /**
     *   @fn unsigned int nbEmptyParticles() const noexcept
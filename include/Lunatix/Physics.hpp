@@ -198,6 +198,8 @@ bool intersectLine( const Line& l1, const Line& l2 ) noexcept;
 *   @param [in] poly The polygon
 *
 *   @return TRUE if there is an intersection, FALSE otherwise
+*
+*   @note See Polygon::contains()
 */
 bool collisionPointPoly( const FloatPosition& p, const Polygon& poly );
 /**
@@ -207,6 +209,8 @@ bool collisionPointPoly( const FloatPosition& p, const Polygon& poly );
 *   @param [in] poly The polygon
 *
 *   @return TRUE if there is a collision, FALSE otherwise
+*
+*   @note A concave polygon is checked part by part (see Polygon::numberOfConvexParts())
 */
 bool collisionCirclePoly( const Circle& c, const Polygon& poly );
 /**
@@ -215,7 +219,10 @@ bool collisionCirclePoly( const Circle& c, const Polygon& poly );
 *   @param [in] box The AABB
 *   @param [in] poly The polygon
 *
-*   @return TRUE if there is a collision, FALSE otherwise
+*   @return TRUE if there is a collision, FALSE otherwise.
+*          A box that touches the polygon collides with it.
+*
+*   @note A concave polygon is checked part by part (see Polygon::numberOfConvexParts())
 */
 bool collisionBoxPoly( const FloatingBox& box, const Polygon& poly );
 /**
@@ -224,9 +231,17 @@ bool collisionBoxPoly( const FloatingBox& box, const Polygon& poly );
 *   @param [in] poly1 The first polygon
 *   @param [in] poly2 The second polygon
 *
-*   @return TRUE if there is a collision, FALSE otherwise
+*   @return TRUE if there is a collision, FALSE otherwise.
+*          Two polygons that touch each other (shared edge or vertex) collide,
+*          whether they are convex or not.
 *
 *   @note The function only works on polygons with at least 3 sides.
+*   @note If the two polygons are convex, GJK is used (see collisionGJK()).
+*         Otherwise, every convex part of a polygon whose bounding box overlaps
+*         the bounding box of a part of the other one is checked
+*         by the separating axis theorem.
+*         Every edge of a self-intersecting polygon is tested against
+*         every edge of the other polygon.
 *   @exception std::invalid_argument If a polygon has less than 3 sides
 */
 bool collisionPoly( const Polygon& poly1, const Polygon& poly2 );
@@ -247,6 +262,8 @@ void movePoint( FloatPosition& p, const Vector2D& v ) noexcept;
 *
 *   @param [in] box The AABB to move
 *   @param [in] v The vector that indicates the direction
+*
+*   @note A fast AABB can jump over a thin obstacle, see sweepBox()
 */
 void moveBox( FloatingBox& box, const Vector2D& v ) noexcept;
 /**
@@ -256,6 +273,8 @@ void moveBox( FloatingBox& box, const Vector2D& v ) noexcept;
 *
 *   @param [in] c The circle to move
 *   @param [in] v The vector that indicates the direction
+*
+*   @note A fast circle can jump over a thin obstacle, see sweepCircle()
 */
 void moveCircle( Circle& c, const Vector2D& v ) noexcept;
 /**
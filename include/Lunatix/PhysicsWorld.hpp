@@ -0,0 +1,231 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef PHYSICSWORLD_HPP_INCLUDED
+#define PHYSICSWORLD_HPP_INCLUDED
+
+/**
+*   @file PhysicsWorld.hpp
+*   @brief The simulation of rigid bodies
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*/
+
+#include <Lunatix/Hitbox.hpp>
+#include <memory>
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+class PhysicsWorld_;
+
+/**
+*   @typedef BodyID
+*   @brief The identifier of a body in a physics world
+*/
+using BodyID = unsigned int;
+
+/// Invalid body identifier
+const BodyID NULL_BODY = static_cast<BodyID>( -1 );
+
+/**
+*   @class PhysicsWorld
+*   @brief A world of rigid bodies (boxes and circles)
+*
+*   The world moves its bodies according to their velocity and the gravity,
+*   and separates the bodies that collide. The bodies do not rotate.
+*   The units are the pixel and the second.
+*
+*   The simulation advances by fixed time steps: PhysicsWorld::step()
+*   accumulates the elapsed time and runs as many fixed steps as it contains,
+*   so the result does not depend on the frame rate.
+*
+*   A body that does not move for a while falls asleep, with the bodies it touches
+*   (its island). A sleeping body is neither moved nor checked against the other ones,
+*   so a world of mostly idle bodies is cheap. A body is woken up when it is touched
+*   by an awake body, when the application changes its position or its velocity,
+*   or when the gravity changes.
+*
+*   A body of mass 0 is static: it never moves, but the other bodies collide with it.
+*/
+class PhysicsWorld final
+{
+    std::unique_ptr<PhysicsWorld_> m_pwimpl;
+
+    PhysicsWorld( const PhysicsWorld& ) = delete;
+    PhysicsWorld& operator =( const PhysicsWorld& ) = delete;
+
+public:
+
+    /**
+    *   @fn explicit PhysicsWorld(const float timestep = 1.0f / 60.0f)
+    *   @param [in] timestep The duration of a fixed step, in seconds (> 0)
+    *   @exception std::invalid_argument If the time step is not positive
+    */
+    explicit PhysicsWorld( const float timestep = 1.0f / 60.0f );
+
+    /**
+    *   @fn BodyID addBox(const FloatingBox& box, const float mass, void * user_data = nullptr)
+    *
+    *   @param [in] box The shape of the body
+    *   @param [in] mass The mass of the body, 0 for a static body
+    *   @param [in] user_data Any data of the application, associated to the body
+    *
+    *   @return The identifier of the body
+    */
+    BodyID addBox( const FloatingBox& box, const float mass, void * user_data = nullptr );
+    /**
+    *   @fn BodyID addCircle(const Circle& circle, const float mass, void * user_data = nullptr)
+    *
+    *   @param [in] circle The shape of the body
+    *   @param [in] mass The mass of the body, 0 for a static body
+    *   @param [in] user_data Any data of the application, associated to the body
+    *
+    *   @return The identifier of the body
+    */
+    BodyID addCircle( const Circle& circle, const float mass, void * user_data = nullptr );
+    /**
+    *   @fn bool remove(const BodyID id) noexcept
+    *
+    *   Remove a body, the bodies around it are woken up.
+    *   Its identifier may be reused by a new body.
+    *
+    *   @param [in] id The identifier of the body
+    *   @return TRUE if the body was removed, FALSE if it did not exist
+    */
+    bool remove( const BodyID id ) noexcept;
+
+    /**
+    *   @fn void setGravity(const Vector2D& g) noexcept
+    *   @param [in] g The acceleration of every dynamic body, in pixels/s² (0 by default)
+    *   @note If the gravity changes, every sleeping body is woken up
+    *   @note Complexity: proportional to the number of bodies
+    */
+    void setGravity( const Vector2D& g ) noexcept;
+    /**
+    *   @fn Vector2D getGravity() const noexcept
+    *   @return The gravity
+    */
+    Vector2D getGravity() const noexcept;
+
+    /**
+    *   @fn void setPosition(const BodyID id, const FloatPosition& p) noexcept
+    *
+    *   Teleport a body, and wake it up
+    *
+    *   @param [in] id The identifier of the body
+    *   @param [in] p The new position: the top-left corner of a box, the center of a circle
+    */
+    void setPosition( const BodyID id, const FloatPosition& p ) noexcept;
+    /**
+    *   @fn void setVelocity(const BodyID id, const Vector2D& v) noexcept
+    *
+    *   Set the velocity of a dynamic body, and wake it up
+    *
+    *   @param [in] id The identifier of the body
+    *   @param [in] v The velocity, in pixels/s
+    */
+    void setVelocity( const BodyID id, const Vector2D& v ) noexcept;
+    /**
+    *   @fn void applyImpulse(const BodyID id, const Vector2D& impulse) noexcept
+    *
+    *   Change the velocity of a dynamic body by impulse / mass, and wake it up
+    *
+    *   @param [in] id The identifier of the body
+    *   @param [in] impulse The impulse
+    */
+    void applyImpulse( const BodyID id, const Vector2D& impulse ) noexcept;
+    /**
+    *   @fn void setMaterial(const BodyID id, const float restitution, const float friction) noexcept
+    *
+    *   @param [in] id The identifier of the body
+    *   @param [in] restitution The bounciness, in [0, 1] (0 by default)
+    *   @param [in] friction The friction coefficient, >= 0 (0.2 by default)
+    */
+    void setMaterial( const BodyID id, const float restitution, const float friction ) noexcept;
+
+    /**
+    *   @fn FloatingBox getBox(const BodyID id) const noexcept
+    *   @param [in] id The identifier of the body
+    *   @return The bounding box of the body
+    */
+    FloatingBox getBox( const BodyID id ) const noexcept;
+    /**
+    *   @fn Circle getCircle(const BodyID id) const noexcept
+    *   @param [in] id The identifier of the body
+    *   @return The circle, if the body is a circle. Its bounding circle otherwise
+    */
+    Circle getCircle( const BodyID id ) const noexcept;
+    /**
+    *   @fn Vector2D getVelocity(const BodyID id) const noexcept
+    *   @param [in] id The identifier of the body
+    *   @return The velocity of the body
+    */
+    Vector2D getVelocity( const BodyID id ) const noexcept;
+    /**
+    *   @fn bool isAwake(const BodyID id) const noexcept
+    *   @param [in] id The identifier of the body
+    *   @return TRUE if the body is a dynamic body and is awake, FALSE otherwise
+    */
+    bool isAwake( const BodyID id ) const noexcept;
+    /**
+    *   @fn void * getUserData(const BodyID id) const noexcept
+    *   @param [in] id The identifier of the body
+    *   @return The data of the application associated to the body,
+    *          a null pointer if the body does not exist
+    */
+    void * getUserData( const BodyID id ) const noexcept;
+
+    /**
+    *   @fn size_t size() const noexcept
+    *   @return The number of bodies
+    */
+    size_t size() const noexcept;
+    /**
+    *   @fn size_t numberOfAwakeBodies() const noexcept
+    *   @return The number of dynamic bodies that are awake
+    */
+    size_t numberOfAwakeBodies() const noexcept;
+
+    /**
+    *   @fn unsigned int step(const float dt)
+    *
+    *   Advance the simulation
+    *
+    *   @param [in] dt The elapsed time since the last call, in seconds
+    *   @return The number of fixed steps that were run (8 at most,
+    *          the remaining time is dropped if the application is too slow)
+    *
+    *   @note Complexity: proportional to the number of awake bodies
+    */
+    unsigned int step( const float dt );
+    /**
+    *   @fn float getAlpha() const noexcept
+    *
+    *   Get the part of a fixed step that was not simulated yet,
+    *   to interpolate the position of the bodies between two steps
+    *
+    *   @return A value in [0, 1)
+    */
+    float getAlpha() const noexcept;
+
+    ~PhysicsWorld();
+};
+
+}   // Physics
+
+}   // lx
+
+#endif // PHYSICSWORLD_HPP_INCLUDED
@@ -32,6 +32,7 @@ namespace Physics
 
 struct Vector2D;
 struct FloatPosition;
+class ConvexShape;
 
 /**
 *   @class PolygonException
@@ -59,6 +60,19 @@ class Polygon_;
 /**
 *   @class Polygon
 *   @brief The polygon
+*
+*   A polygon keeps its points in its own space, with a transformation
+*   (translation, rotation and scale). Moving, rotating or scaling a polygon
+*   only changes the transformation, in constant time.
+*   The points in the world, the enclosing box, the centroid and the convexity
+*   are computed the first time they are requested after a modification,
+*   and then cached.
+*
+*   @note Since the cache is updated by the const functions,
+*         a polygon that is modified must not be queried by several threads
+*         at the same time. Calling numberOfConvexParts() once after the modification
+*         updates every cache (getEnclosingBox() does not compute the convex parts).
+*         CollisionWorld::addPolygon() and CollisionWorld::updatePolygon() do it.
 */
 class Polygon final
 {
@@ -79,11 +93,11 @@ public:
     *   Set a new point into the polygon
     *   @param [in] p The new edge to add
     *
-    *   @note 1 - This function is not very efficient it you use it to add multiple points,
-    *             because at each addition of the point,
-    *             the convexity of the polygon is updated.
-    *   @note 2 - Complexity: O(n) if n >= 3, O(1) otherwise,
-    *             **n** is the number of edges of the polygon.
+    *   @note 1 - The point is given in the world. If the polygon is rotated or scaled,
+    *             the transformation is applied to the points first,
+    *             and the polygon gets a neutral rotation and scale.
+    *   @note 2 - Complexity: Amortized O(1) if the polygon is not rotated or scaled,
+    *             O(n) otherwise, **n** is the number of edges of the polygon.
     */
     void addPoint( const FloatPosition& p );
     /**
@@ -94,11 +108,8 @@ public:
     *   @param [in] first Iterator of the structure pointing to the first point
     *   @param [in] last Iterator of the structure pointing to the position after the last point
     *
-    *   @note 1 - This function is efficient because it adds every points in a row
-    *             and calculate the convexity only after the operation
-    *   @note 2 - Complexity: Amortized O(n + m) if n + m > 3, O(m) otherwise,
-    *             **n** is the number of edges of the polygon,
-    *             **m** is the number of points to add.
+    *   @note Complexity: Amortized O(m) if the polygon is not rotated or scaled,
+    *         **m** is the number of points to add.
     */
     template <typename Iterator>
     void addPoints( Iterator first, Iterator last );
@@ -113,8 +124,9 @@ public:
     *
     *   @param [in] index The index of the point
     *
-    *   @return A copy of the point
+    *   @return A copy of the point, in the world
     *
+    *   @note Complexity: O(n) after a modification of the polygon, O(1) otherwise
     *   @exception  PolygonException If the index is out of bounds
     */
     FloatPosition getPoint( const unsigned long index ) const;
@@ -126,7 +138,8 @@ public:
     *
     *   @return The enclosing box
     *
-    *   @note Complexity: O(n) with n > 2. n is the number of vertices in the polygon
+    *   @note Complexity: O(n) after a modification of the polygon, O(1) otherwise.
+    *         n is the number of vertices in the polygon
     *   @exception  PolygonException If the polygon has less than 3 sides
     */
     FloatingBox getEnclosingBox() const;
@@ -137,26 +150,106 @@ public:
     *
     *   @return TRUE if the polygon is convex, false otherwise
     *
-    *   @note Actually, the convexity of the polygon is dynamically evaluated
-    *        each time a new point in added using addPoint() or addPoints().
+    *   @note Actually, the convexity of the polygon is evaluated
+    *        the first time it is requested after the addition of a point.
     *        The result is stored in an internal variable.
+    *        Moving, rotating or scaling the polygon does not change it.
     */
     bool isConvex() const noexcept;
+    /**
+    *   @fn bool contains(const FloatPosition& p) const
+    *
+    *   Check if a point is in the polygon
+    *
+    *   @param [in] p The point
+    *   @return TRUE if the point is in the polygon, FALSE otherwise
+    *          (or if the polygon has less than 3 sides)
+    *
+    *   @note Complexity: O(log n) if the polygon is convex,
+    *         O(n) otherwise (crossing number), n is the number of vertices.
+    *         It is O(n) anyway after a modification of the polygon.
+    *   @note The result is deterministic. A point on an edge of a convex polygon
+    *         is in the polygon, it may not be the case with a non-convex polygon.
+    */
+    bool contains( const FloatPosition& p ) const;
+
+    /**
+    *   @fn unsigned long numberOfConvexParts() const
+    *
+    *   Get the number of convex parts of the polygon
+    *
+    *   A non-convex polygon is split into convex parts (ear clipping,
+    *   then the parts are merged by the Hertel-Mehlhorn algorithm).
+    *   The decomposition is computed the first time it is requested
+    *   after the addition of a point, moving the polygon does not change it.
+    *
+    *   @return The number of convex parts: 1 if the polygon is convex,
+    *          0 if it is self-intersecting or has less than 3 sides
+    *
+    *   @note Complexity: O(n³) in the worst case after the addition of a point
+    *         (each ear is tested against every vertex, and the search restarts
+    *         after each cut), O(n) after a movement, O(1) otherwise
+    */
+    unsigned long numberOfConvexParts() const;
+    /**
+    *   @fn ConvexShape getConvexPart(const unsigned long index) const
+    *
+    *   @param [in] index The index of the part (< numberOfConvexParts())
+    *   @return The convex part, in the world
+    *
+    *   @note The part is valid until the polygon is modified
+    *   @exception std::out_of_range If the index is out of bounds
+    */
+    ConvexShape getConvexPart( const unsigned long index ) const;
 
     /**
     *   @fn void Polygon::move(const Vector2D& v) noexcept
     *   @param [in] v The vector that indicates the direction
-    *   @note Complexity: O(n), n the number of vertices of the polygon
+    *   @note Complexity: O(1)
     */
     void move( const Vector2D& v ) noexcept;
     /**
     *   @fn void moveTo(const FloatPosition& p)
+    *   Move the centroid of the polygon to a position
+    *
     *   @param [in] p The new position
-    *   @note Complexity: O(n), n is the number of vertices of the polygon
+    *   @note Complexity: O(1), except the first time after the addition of a point.
+    *         If the polygon is self-intersecting, the center of the enclosing box is moved,
+    *         that is O(n) after a modification, n is the number of vertices of the polygon.
     *   @exception  PolygonException If the polygon has less than 3 sides
     */
     void moveTo( const FloatPosition& p );
 
+    /**
+    *   @fn void setRotation(const float angle) noexcept
+    *
+    *   Rotate the polygon around its centroid
+    *
+    *   @param [in] angle The angle in radians. A positive angle turns
+    *                   counterclockwise on the screen
+    *   @note Complexity: O(1)
+    */
+    void setRotation( const float angle ) noexcept;
+    /**
+    *   @fn float getRotation() const noexcept
+    *   @return The angle of the rotation, in radians
+    */
+    float getRotation() const noexcept;
+    /**
+    *   @fn void setScale(const float scale) noexcept
+    *
+    *   Scale the polygon from its centroid
+    *
+    *   @param [in] scale The factor (> 0)
+    *   @note Complexity: O(1)
+    */
+    void setScale( const float scale ) noexcept;
+    /**
+    *   @fn float getScale() const noexcept
+    *   @return The scale
+    */
+    float getScale() const noexcept;
+
     ~Polygon();
 };
 
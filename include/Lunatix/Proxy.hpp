@@ -0,0 +1,52 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef PROXY_HPP_INCLUDED
+#define PROXY_HPP_INCLUDED
+
+/**
+*   @file Proxy.hpp
+*   @brief The identifiers of the shapes in a broad phase
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*/
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+/**
+*   @typedef ProxyID
+*   @brief The identifier of a shape in a collision world
+*/
+using ProxyID = unsigned int;
+
+/// Invalid proxy identifier
+const ProxyID NULL_PROXY = static_cast<ProxyID>( -1 );
+
+/**
+*   @struct ProxyPair
+*   @brief Two proxies that may collide (first < second)
+*/
+struct ProxyPair final
+{
+    ProxyID first;      /**< The proxy with the smallest identifier */
+    ProxyID second;     /**< The other proxy                        */
+};
+
+}   // Physics
+
+}   // lx
+
+#endif // PROXY_HPP_INCLUDED
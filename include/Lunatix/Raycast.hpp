@@ -0,0 +1,106 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef RAYCAST_HPP_INCLUDED
+#define RAYCAST_HPP_INCLUDED
+
+/**
+*   @file Raycast.hpp
+*   @brief The intersection between a segment and a shape
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*   A segment cast looks for the first point where a segment,
+*   from s.p to s.q, enters a shape.
+*   A shape that contains the origin of the segment (s.p) is not hit,
+*   so an object can cast a segment from the inside of its own hitbox.
+*
+*   See CollisionWorld::segmentCast() to cast a segment against a set of shapes.
+*/
+
+#include <Lunatix/Hitbox.hpp>
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+class Polygon;
+
+/**
+*   @struct RayHit
+*   @brief The point where a segment enters a shape
+*/
+struct RayHit final
+{
+    FloatPosition point;    /**< The point of the hit                                   */
+    Vector2D normal;        /**< Unit normal of the surface, against the segment        */
+    float fraction;         /**< Position of the point on the segment, in [0, 1]        */
+};
+
+
+/**
+*   @fn bool raycastBox(const Segment& s, const FloatingBox& box, RayHit& hit) noexcept
+*
+*   @param [in] s The segment, from s.p to s.q
+*   @param [in] box The AABB
+*   @param [out] hit The point where the segment enters the AABB, if there is one
+*
+*   @return TRUE if the segment enters the AABB, FALSE otherwise
+*/
+bool raycastBox( const Segment& s, const FloatingBox& box, RayHit& hit ) noexcept;
+/**
+*   @fn bool raycastCircle(const Segment& s, const Circle& circle, RayHit& hit) noexcept
+*
+*   @param [in] s The segment, from s.p to s.q
+*   @param [in] circle The circle
+*   @param [out] hit The point where the segment enters the circle, if there is one
+*
+*   @return TRUE if the segment enters the circle, FALSE otherwise
+*/
+bool raycastCircle( const Segment& s, const Circle& circle, RayHit& hit ) noexcept;
+/**
+*   @fn bool raycastPoly(const Segment& s, const Polygon& poly, RayHit& hit)
+*
+*   @param [in] s The segment, from s.p to s.q
+*   @param [in] poly The polygon, convex or not
+*   @param [out] hit The first point where the segment enters the polygon, if there is one
+*
+*   @return TRUE if the segment enters the polygon, FALSE otherwise
+*
+*   @note A segment that starts in a concave polygon can enter it again
+*         after it goes out of it, this point is reported
+*   @note Complexity: O(n), n is the number of vertices of the polygon
+*   @exception std::invalid_argument If the polygon has less than 3 sides
+*/
+bool raycastPoly( const Segment& s, const Polygon& poly, RayHit& hit );
+/**
+*   @fn bool raycastPoly(const Segment& s, const FloatPosition * points, const unsigned long n, RayHit& hit)
+*
+*   @param [in] s The segment, from s.p to s.q
+*   @param [in] points The vertices of the polygon, convex or not
+*   @param [in] n The number of vertices
+*   @param [out] hit The first point where the segment enters the polygon, if there is one
+*
+*   @return TRUE if the segment enters the polygon, FALSE otherwise
+*
+*   @note Complexity: O(n)
+*   @exception std::invalid_argument If the polygon has less than 3 sides
+*/
+bool raycastPoly( const Segment& s, const FloatPosition * points, const unsigned long n,
+                  RayHit& hit );
+
+}   // Physics
+
+}   // lx
+
+#endif // RAYCAST_HPP_INCLUDED
@@ -0,0 +1,99 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef SPRITEBATCH_HPP_INCLUDED
+#define SPRITEBATCH_HPP_INCLUDED
+
+/**
+*   @file SpriteBatch.hpp
+*   @brief The sprite batch
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*/
+
+#include <Lunatix/ImgRect.hpp>
+#include <memory>
+
+
+namespace lx
+{
+
+namespace Graphics
+{
+
+class Sprite;
+class SpriteBatch_;
+
+/**
+*   @class SpriteBatch
+*   @brief A batch of sprites drawn together
+*
+*   The sprites added in the batch are drawn when the batch is flushed.
+*   They are drawn as in the batching mode of their window
+*   (see lx::Win::Window::setBatching()): they are grouped by texture
+*   and blend mode, and every group is submitted to the renderer
+*   as one piece of geometry (SDL ≥ 2.0.18), or as a sequence of copies.
+*
+*   @note The sprites that use the same texture are drawn in the order
+*         they were added, but the groups are drawn in an unspecified order.
+*   @note A sprite added in the batch must be alive until the batch is flushed
+*   @note The draws recorded by the batching mode of the window
+*         before the flush are not drawn by the flush, they are kept
+*/
+class SpriteBatch final
+{
+    std::unique_ptr<SpriteBatch_> m_bimpl;
+
+    SpriteBatch( const SpriteBatch& ) = delete;
+    SpriteBatch& operator =( const SpriteBatch& ) = delete;
+
+public:
+
+    SpriteBatch();
+
+    /**
+    *   @fn void add(Sprite& sprite, const ImgRect& box) noexcept
+    *   Add a sprite to draw in the batch
+    *
+    *   @param [in] sprite The sprite
+    *   @param [in] box The area where the sprite is drawn
+    *
+    *   @note This function does the same thing as sprite.draw(box),
+    *         except the sprite is drawn when the batch is flushed
+    *         (so the level of detail and the frame of an animated sprite
+    *         are chosen when the batch is flushed)
+    */
+    void add( Sprite& sprite, const ImgRect& box ) noexcept;
+    /**
+    *   @fn void flush() noexcept
+    *   Draw every sprite of the batch, and clear it
+    */
+    void flush() noexcept;
+    /**
+    *   @fn void clear() noexcept
+    *   Remove the sprites from the batch without drawing them
+    */
+    void clear() noexcept;
+
+    /**
+    *   @fn size_t size() const noexcept
+    *   @return The number of sprites in the batch
+    */
+    size_t size() const noexcept;
+
+    ~SpriteBatch();
+};
+
+}   // Graphics
+
+}   // lx
+
+#endif // SPRITEBATCH_HPP_INCLUDED
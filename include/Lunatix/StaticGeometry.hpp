@@ -0,0 +1,183 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef STATICGEOMETRY_HPP_INCLUDED
+#define STATICGEOMETRY_HPP_INCLUDED
+
+/**
+*   @file StaticGeometry.hpp
+*   @brief The baked collision geometry of a level
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*   Building the polygons of a big level point by point, then decomposing them
+*   into convex parts, is slow. The static geometry is computed once by
+*   bakeStaticGeometry(), that writes the polygons, their convex parts
+*   and a bounding volume hierarchy of the parts in a binary file.
+*
+*   At runtime, StaticGeometry maps the file in memory (see lx::FileIO::MappedFile)
+*   and uses its content in place: loading a level is done in constant time,
+*   whatever the number of vertices.
+*
+*   @note The file is written in the byte order of the machine,
+*         it must be baked again for a machine with another byte order
+*/
+
+#include <Lunatix/Hitbox.hpp>
+#include <Lunatix/Raycast.hpp>
+#include <memory>
+#include <vector>
+#include <string>
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+class Polygon;
+class ConvexShape;
+class StaticGeometry_;
+
+/// Invalid polygon index of a static geometry
+const unsigned int NO_POLYGON = static_cast<unsigned int>( -1 );
+
+
+/**
+*   @fn void bakeStaticGeometry(const std::vector<const Polygon *>& polygons, const std::string& filename)
+*
+*   Write the static geometry of a level in a file
+*
+*   @param [in] polygons The polygons, the index of a polygon in the file is its index in the vector
+*   @param [in] filename The file to write
+*
+*   @exception PolygonException If a polygon has less than 3 sides or is self-intersecting
+*   @exception lx::FileIO::IOException If the file cannot be written
+*/
+void bakeStaticGeometry( const std::vector<const Polygon *>& polygons, const std::string& filename );
+
+
+/**
+*   @class StaticGeometry
+*   @brief The static geometry of a level, loaded from a baked file
+*
+*   @note The geometry cannot be modified, so the queries can be called
+*         by several threads at the same time
+*/
+class StaticGeometry final
+{
+    std::unique_ptr<StaticGeometry_> m_sgimpl;
+
+    StaticGeometry( const StaticGeometry& ) = delete;
+    StaticGeometry& operator =( const StaticGeometry& ) = delete;
+
+public:
+
+    /**
+    *   @fn explicit StaticGeometry(const std::string& filename)
+    *
+    *   @param [in] filename The file written by bakeStaticGeometry()
+    *
+    *   @exception lx::FileIO::IOException If the file cannot be mapped,
+    *             or if it is not a valid static geometry file
+    *   @note Complexity: O(n), every index of the file (tree, parts, polygons)
+    *         is checked once, so the queries never read out of the file
+    */
+    explicit StaticGeometry( const std::string& filename );
+
+    /**
+    *   @fn unsigned int numberOfPolygons() const noexcept
+    *   @return The number of polygons
+    */
+    unsigned int numberOfPolygons() const noexcept;
+    /**
+    *   @fn unsigned long numberOfVertices(const unsigned int poly) const
+    *   @param [in] poly The index of the polygon
+    *   @return The number of vertices of the polygon
+    *   @exception std::out_of_range If the index is out of bounds
+    */
+    unsigned long numberOfVertices( const unsigned int poly ) const;
+    /**
+    *   @fn const FloatPosition * getVertices(const unsigned int poly) const
+    *   @param [in] poly The index of the polygon
+    *   @return The vertices of the polygon, valid as long as the geometry exists
+    *   @exception std::out_of_range If the index is out of bounds
+    */
+    const FloatPosition * getVertices( const unsigned int poly ) const;
+    /**
+    *   @fn FloatingBox getEnclosingBox(const unsigned int poly) const
+    *   @param [in] poly The index of the polygon
+    *   @return The bounding box of the polygon
+    *   @exception std::out_of_range If the index is out of bounds
+    */
+    FloatingBox getEnclosingBox( const unsigned int poly ) const;
+
+    /**
+    *   @fn unsigned long numberOfConvexParts() const noexcept
+    *   @return The number of convex parts of every polygon
+    */
+    unsigned long numberOfConvexParts() const noexcept;
+    /**
+    *   @fn ConvexShape getConvexPart(const unsigned long index) const
+    *   @param [in] index The index of the part (< numberOfConvexParts())
+    *   @return The convex part, valid as long as the geometry exists
+    *   @exception std::out_of_range If the index is out of bounds
+    */
+    ConvexShape getConvexPart( const unsigned long index ) const;
+    /**
+    *   @fn unsigned int getPolygonOfPart(const unsigned long index) const
+    *   @param [in] index The index of the part (< numberOfConvexParts())
+    *   @return The index of the polygon the part belongs to
+    *   @exception std::out_of_range If the index is out of bounds
+    */
+    unsigned int getPolygonOfPart( const unsigned long index ) const;
+
+    /**
+    *   @fn void queryPoint(const FloatPosition& p, std::vector<unsigned int>& result) const
+    *
+    *   Find the polygons that contain a point
+    *
+    *   @param [in] p The point
+    *   @param [out] result The polygons, in increasing order
+    */
+    void queryPoint( const FloatPosition& p, std::vector<unsigned int>& result ) const;
+    /**
+    *   @fn void queryShape(const ConvexShape& shape, std::vector<unsigned int>& result) const
+    *
+    *   Find the polygons that collide with a shape (box, circle or convex polygon)
+    *
+    *   @param [in] shape The shape
+    *   @param [out] result The polygons, in increasing order
+    *
+    *   @note The exact test (GJK) is only done on the parts
+    *         whose bounding boxes overlap the box of the shape
+    */
+    void queryShape( const ConvexShape& shape, std::vector<unsigned int>& result ) const;
+    /**
+    *   @fn unsigned int segmentCast(const Segment& s, RayHit& hit) const
+    *
+    *   Find the first polygon crossed by a segment
+    *
+    *   @param [in] s The segment, from s.p to s.q
+    *   @param [out] hit The point where the segment enters the polygon, if there is one
+    *
+    *   @return The index of the polygon, NO_POLYGON if the segment does not enter any polygon
+    */
+    unsigned int segmentCast( const Segment& s, RayHit& hit ) const;
+
+    ~StaticGeometry();
+};
+
+}   // Physics
+
+}   // lx
+
+#endif // STATICGEOMETRY_HPP_INCLUDED
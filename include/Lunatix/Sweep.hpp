@@ -0,0 +1,121 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef SWEEP_HPP_INCLUDED
+#define SWEEP_HPP_INCLUDED
+
+/**
+*   @file Sweep.hpp
+*   @brief The continuous collision detection (swept shapes)
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*   A moving shape is swept along its movement during a frame,
+*   and the time of impact is the first moment it touches the other shape.
+*   One sweep per frame finds the collisions that a fast shape would miss
+*   by jumping over a thin obstacle (tunneling).
+*
+*   The time of impact is a fraction of the movement: the moving shape
+*   touches the other one after a movement of v × time.
+*/
+
+#include <Lunatix/Hitbox.hpp>
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+class Polygon;
+
+/**
+*   @struct TimeOfImpact
+*   @brief The first contact between a moving shape and a static one
+*/
+struct TimeOfImpact final
+{
+    float time;         /**< Fraction of the movement, in [0, 1]                    */
+    Vector2D normal;    /**< Unit normal of the contact, towards the moving shape   */
+};
+
+
+/**
+*   @fn bool sweepBox(const FloatingBox& box, const Vector2D& v, const FloatingBox& target, TimeOfImpact& toi) noexcept
+*
+*   Sweep an AABB against another one
+*
+*   @param [in] box The moving AABB, at its position before the movement
+*   @param [in] v The movement of the AABB
+*   @param [in] target The static AABB
+*   @param [out] toi The time of impact, if there is one
+*
+*   @return TRUE if the AABB hits the target during the movement, FALSE otherwise.
+*          If the two AABBs already collide, the time of impact is 0.
+*
+*   @note Like collisionBox(), two AABBs that only touch each other do not collide
+*/
+bool sweepBox( const FloatingBox& box, const Vector2D& v, const FloatingBox& target,
+               TimeOfImpact& toi ) noexcept;
+/**
+*   @fn bool sweepCircle(const Circle& circle, const Vector2D& v, const Circle& target, TimeOfImpact& toi) noexcept
+*
+*   Sweep a circle against another one
+*
+*   @param [in] circle The moving circle, at its position before the movement
+*   @param [in] v The movement of the circle
+*   @param [in] target The static circle
+*   @param [out] toi The time of impact, if there is one
+*
+*   @return TRUE if the circle hits the target during the movement, FALSE otherwise.
+*          If the two circles already collide, the time of impact is 0.
+*/
+bool sweepCircle( const Circle& circle, const Vector2D& v, const Circle& target,
+                  TimeOfImpact& toi ) noexcept;
+/**
+*   @fn bool sweepCircleBox(const Circle& circle, const Vector2D& v, const FloatingBox& box, TimeOfImpact& toi) noexcept
+*
+*   Sweep a circle against an AABB
+*
+*   @param [in] circle The moving circle, at its position before the movement
+*   @param [in] v The movement of the circle
+*   @param [in] box The static AABB
+*   @param [out] toi The time of impact, if there is one
+*
+*   @return TRUE if the circle hits the AABB during the movement, FALSE otherwise.
+*          If the circle already collides with the AABB, the time of impact is 0.
+*/
+bool sweepCircleBox( const Circle& circle, const Vector2D& v, const FloatingBox& box,
+                     TimeOfImpact& toi ) noexcept;
+/**
+*   @fn bool sweepCirclePoly(const Circle& circle, const Vector2D& v, const Polygon& poly, TimeOfImpact& toi)
+*
+*   Sweep a circle against a polygon, convex or not
+*
+*   @param [in] circle The moving circle, at its position before the movement
+*   @param [in] v The movement of the circle
+*   @param [in] poly The static polygon
+*   @param [out] toi The time of impact, if there is one
+*
+*   @return TRUE if the circle hits the polygon during the movement, FALSE otherwise.
+*          If the circle already collides with the polygon, the time of impact is 0.
+*
+*   @note Complexity: O(n), n is the number of vertices of the polygon
+*   @exception std::invalid_argument If the polygon has less than 3 sides
+*/
+bool sweepCirclePoly( const Circle& circle, const Vector2D& v, const Polygon& poly,
+                      TimeOfImpact& toi );
+
+}   // Physics
+
+}   // lx
+
+#endif // SWEEP_HPP_INCLUDED
@@ -92,6 +92,18 @@ int getCPUCacheLineSize() noexcept;
 */
 int getCPUCount() noexcept;
 /**
+*   @fn bool hasSSE2() noexcept
+*   Check if the CPU has the SSE2 instruction set
+*   @return TRUE if the instruction set is available, FALSE otherwise
+*/
+bool hasSSE2() noexcept;
+/**
+*   @fn bool hasAVX2() noexcept
+*   Check if the CPU has the AVX2 instruction set
+*   @return TRUE if the instruction set is available, FALSE otherwise
+*/
+bool hasAVX2() noexcept;
+/**
 *   @fn int getSystemRAM() noexcept
 *   Get the amount of Random Access Memory (RAM) in the system
 *   @return The amount of RAM configured in the system in Megabytes (MB)
@@ -28,6 +28,7 @@
 
 #include <utility>
 #include <exception>
+#include <memory>
 #include <vector>
 
 
@@ -60,11 +61,19 @@ namespace FileIO
 class FileBuffer;
 }
 
+namespace Physics
+{
+class CollisionMask;
+}
+
 //  Forward declaration (END)
 
 namespace Graphics
 {
 
+class ImagePipeline;
+class ImagePipeline_;
+
 enum class MirrorEffect
 {
     /// Flag to define no mirror while drawing a texture
@@ -75,6 +84,20 @@ enum class MirrorEffect
     VERTICAL   = 2,
 };
 
+/**
+*   @enum ResizeFilter
+*   @brief The filter used to resample an image
+*/
+enum class ResizeFilter
+{
+    /// Average of the pixels covered by a destination pixel (nearest when upscaling)
+    BOX,
+    /// Linear interpolation, stretched when downscaling
+    BILINEAR,
+    /// Lanczos, 3 lobes: sharper, slower
+    LANCZOS3
+};
+
 /// Not supposed to be used
 static constexpr ImgRect RNULL = { { 0, 0 }, 0, 0 };
 
@@ -187,14 +210,29 @@ public:
 class Sprite: public Texture
 {
     friend class BufferedImage;
+    friend class SpriteBatch_;
+    friend class TextureAtlas_;
+
+    // A smaller version of the sprite
+    struct Level_
+    {
+        SDL_Texture * texture;
+        ImgRect area;
+    };
+
     ImgRect m_area;
     UTF8string m_filename;
+    bool m_owner;       // FALSE: the texture belongs to an atlas
+    std::vector<Level_> m_levels;   // Level 1, 2, …, from the largest one
+
+    SDL_Texture * level_( const ImgRect& box, ImgRect& area ) const noexcept;
 
 protected:
 
     Sprite( SDL_Texture * t, lx::Win::Window& w, const UTF8string& filename,
             const ImgRect& area,
-            PixelFormat format = PixelFormat::RGBA8888 );
+            PixelFormat format = PixelFormat::RGBA8888,
+            const bool owner = true );
 
 public:
 
@@ -264,9 +302,30 @@ public:
     *         - MirrorEffect::VERTICAL: Vertical mirror
     *
     *   @note The window is specified at object construction
+    *   @note If the window is in batching mode, the draw is recorded
+    *         and done when the window is updated (see lx::Win::Window::setBatching())
+    *   @note If the sprite has levels of detail, the smallest level
+    *         that is at least as big as the box is drawn
     */
     virtual void draw( const ImgRect& box, const double angle, const MirrorEffect mirror ) noexcept;
 
+    /**
+    *   @fn size_t getNumberOfLevels() const noexcept
+    *   @return The number of levels of detail of the sprite, 1 if it has no mipmap
+    *   @sa BufferedImage::generateMipmappedSprite()
+    */
+    size_t getNumberOfLevels() const noexcept;
+    /**
+    *   @fn size_t getLevel(const ImgRect& box) const noexcept
+    *   Get the level of detail used to draw the sprite in a box
+    *
+    *   @param [in] box The area where the sprite is drawn
+    *   @return The level, in [0, getNumberOfLevels()): 0 is the sprite itself,
+    *          every next level is half as big as the previous one
+    *   @note The level is the smallest one that is at least as big as the box
+    */
+    size_t getLevel( const ImgRect& box ) const noexcept;
+
     /**
     *   @fn UTF8string getFileName() noexcept
     *   Returns the name of the file associated with this texture
@@ -274,7 +333,7 @@ public:
     */
     UTF8string getFileName() noexcept;
 
-    virtual ~Sprite() = default;
+    virtual ~Sprite();
 };
 
 
@@ -287,6 +346,7 @@ public:
 class AnimatedSprite final : public Sprite
 {
     friend class BufferedImage;
+    friend class TextureAtlas_;
     const std::vector<ImgRect> M_COORDINATES;
     const size_t M_NBCOORDINATES;
     lx::Time::Timer m_timer;
@@ -298,7 +358,8 @@ class AnimatedSprite final : public Sprite
     AnimatedSprite( SDL_Texture * t, lx::Win::Window& w,
                     const std::vector<ImgRect>& coord, const uint32_t delay,
                     bool loop, const UTF8string& filename,
-                    PixelFormat format = PixelFormat::RGBA8888 );
+                    PixelFormat format = PixelFormat::RGBA8888,
+                    const bool owner = true );
 
 public:
 
@@ -375,6 +436,8 @@ class BufferedImage final
     friend class lx::Device::Mouse;
     friend class lx::FileIO::FileBuffer;
     friend class lx::Win::Window;
+    friend class TextureAtlas_;
+    friend class ImagePipeline_;
 
     SDL_Surface * m_surface = nullptr;
     UTF8string m_filename;
@@ -386,14 +449,7 @@ class BufferedImage final
                    PixelFormat format = PixelFormat::RGBA8888 );
     BufferedImage( SDL_Surface * s, const std::string& filename,
                    PixelFormat format = PixelFormat::RGBA8888 );
-
-    bool retrieveColours_( const uint32_t pixel, Uint8& r, Uint8& g, Uint8& b, Uint8& a ) const noexcept;
-
-    uint32_t updateGrayscaleColour_( const Uint8 alpha, Uint8 v ) const noexcept;
-    uint32_t updateNegativeColour_( const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a ) const noexcept;
-
-    uint32_t convertGrayscalePixel_( const uint32_t pixel ) const noexcept;
-    uint32_t convertNegativePixel_( const uint32_t pixel ) const noexcept;
+    uint8_t * pixel_( const int x, const int y ) const;
 
 public:
 
@@ -410,15 +466,149 @@ public:
                    PixelFormat format = PixelFormat::RGBA8888 );
 
     /**
-    *   @fn void convertGrayscale() noexcept
+    *   @fn BufferedImage(const int width, const int height, PixelFormat format = PixelFormat::RGBA8888)
+    *   Create a transparent image (black if the format has no alpha channel)
+    *
+    *   @param [in] width The width of the image (> 0)
+    *   @param [in] height The height of the image (> 0)
+    *   @param [in] format The format of the image
+    *
+    *   @exception ImageException On failure
+    *   @note The rows of a 16-bit or 24-bit image are aligned on 4 bytes,
+    *         so they may be padded
+    */
+    BufferedImage( const int width, const int height,
+                   PixelFormat format = PixelFormat::RGBA8888 );
+
+    /**
+    *   @fn BufferedImage& convertGrayscale() noexcept
+    *
+    *   Convert the image to grayscale, the alpha channel is not modified.
+    *   The value of a pixel is (54 × R + 183 × G + 19 × B) / 256 (Rec. 709 weights),
+    *   computed on the channels of the format (4 bits for the 4444 formats).
+    *
+    *   @return The image
+    *   @note The kernel is specialized for the format of the image (SSE2/AVX2 for
+    *         the 32-bit formats), and a big image is converted by bands of rows
+    *         on the worker pool (see lx::Multithreading::getWorkerPool())
     */
     BufferedImage& convertGrayscale() noexcept;
 
     /**
-    *   @fn void convertNegative()
+    *   @fn BufferedImage& convertNegative() noexcept
+    *
+    *   Invert the colours of the image, the alpha channel is not modified
+    *
+    *   @return The image
+    *   @note See convertGrayscale()
     */
     BufferedImage& convertNegative() noexcept;
 
+    /**
+    *   @fn Colour getPixel(const int x, const int y) const
+    *   Get the colour of a pixel
+    *
+    *   @param [in] x The column of the pixel
+    *   @param [in] y The row of the pixel
+    *
+    *   @return The colour, with 8 bits per channel (alpha is 255
+    *          if the format has no alpha channel)
+    *   @exception std::invalid_argument If the pixel is not in the image
+    */
+    Colour getPixel( const int x, const int y ) const;
+    /**
+    *   @fn void setPixel(const int x, const int y, const Colour& c)
+    *   Set the colour of a pixel
+    *
+    *   @param [in] x The column of the pixel
+    *   @param [in] y The row of the pixel
+    *   @param [in] c The colour, converted to the format of the image
+    *
+    *   @exception std::invalid_argument If the pixel is not in the image
+    */
+    void setPixel( const int x, const int y, const Colour& c );
+
+    /**
+    *   @fn ImagePipeline pipeline()
+    *
+    *   Create a pipeline of operations on the image (see ImagePipeline.hpp)
+    *
+    *   @return The pipeline, the operations are applied by ImagePipeline::apply()
+    */
+    ImagePipeline pipeline();
+
+    /**
+    *   @fn BufferedImage * resize(const int width, const int height, const ResizeFilter filter = ResizeFilter::BILINEAR) const
+    *
+    *   Create a resized copy of the image
+    *
+    *   @param [in] width The width of the new image
+    *   @param [in] height The height of the new image
+    *   @param [in] filter The filter used to resample the image
+    *
+    *   @return A new fresh allocated image, in the format of the current one
+    *   @exception std::invalid_argument If width < 1 or height < 1
+    *   @exception ImageException If the new image cannot be created
+    *
+    *   @note The image is resampled in two separable passes (horizontal, then vertical)
+    *         with premultiplied alpha, so the transparent pixels do not darken the edges.
+    *         A big image is resampled by bands of rows on the worker pool.
+    */
+    BufferedImage * resize( const int width, const int height,
+                            const ResizeFilter filter = ResizeFilter::BILINEAR ) const;
+    /**
+    *   @fn std::vector<std::unique_ptr<BufferedImage>> generateMipmaps(const ResizeFilter filter = ResizeFilter::BOX, const size_t max_levels = 0) const
+    *
+    *   Create the mip chain of the image: every level is half the size
+    *   of the previous one, down to 1×1
+    *
+    *   @param [in] filter The filter used to resample every level
+    *   @param [in] max_levels The maximal number of levels, 0: no limit
+    *
+    *   @return The levels, from the largest one (level 1) to the smallest one
+    *   @exception ImageException If a level cannot be created
+    */
+    std::vector<std::unique_ptr<BufferedImage>>
+    generateMipmaps( const ResizeFilter filter = ResizeFilter::BOX,
+                     const size_t max_levels = 0 ) const;
+
+    /**
+    *   @fn Sprite * generateMipmappedSprite(lx::Win::Window& w, const ImgRect& area = RNULL, const ResizeFilter filter = ResizeFilter::BOX) const
+    *
+    *   Create a sprite with levels of detail: the mip chain of the image
+    *   is uploaded with it, and a draw into a box smaller than the area
+    *   of the sprite uses the smallest level that covers the box.
+    *   The renderer does not read a huge texture to draw it tiny,
+    *   and the minified sprite does not flicker.
+    *
+    *   @param [in] w The window to link the sprite to → see *draw()*
+    *   @param [in] area (Optional) Area of the sprite to display
+    *   @param [in] filter The filter used to generate the mip chain
+    *
+    *   @return A new fresh allocated sprite
+    *   @exception ImageException On failure
+    *   @note The levels take a third of the memory of the image
+    */
+    Sprite * generateMipmappedSprite( lx::Win::Window& w, const ImgRect& area = RNULL,
+                                      const ResizeFilter filter = ResizeFilter::BOX ) const;
+
+    /**
+    *   @fn lx::Physics::CollisionMask generateCollisionMask(const uint8_t alpha = 128, const int scale = 1) const
+    *
+    *   Create the collision mask of the image: a pixel is solid
+    *   if its alpha value is at least *alpha*
+    *
+    *   @param [in] alpha The minimal alpha value of a solid pixel
+    *   @param [in] scale The size of the block of pixels covered by a bit of the mask (>= 1),
+    *          a bit is set if one pixel of its block is solid
+    *
+    *   @return The mask, see CollisionMask.hpp
+    *   @exception std::invalid_argument If scale < 1
+    *   @note A format without alpha channel gives a mask where every pixel is solid
+    */
+    lx::Physics::CollisionMask generateCollisionMask( const uint8_t alpha = 128,
+            const int scale = 1 ) const;
+
     /**
     *   @fn Sprite * generateSprite(lx::Win::Window& w, const ImgRect& area) const
     *   Create a sprite from the current buffered image
@@ -0,0 +1,265 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef TEXTUREATLAS_HPP_INCLUDED
+#define TEXTUREATLAS_HPP_INCLUDED
+
+/**
+*   @file TextureAtlas.hpp
+*   @brief The texture atlas
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*   A texture atlas packs many small images into a few big textures (pages).
+*   The sprites generated by the atlas refer to an area of a page,
+*   so the sprites of the same page share their texture: the renderer
+*   does not switch the texture between them, and a SpriteBatch
+*   draws them as a single group.
+*/
+
+#include <Lunatix/Format.hpp>
+#include <Lunatix/ImgRect.hpp>
+#include <Lunatix/utils/utf8_string.hpp>
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+
+namespace lx
+{
+
+namespace Win
+{
+class Window;
+}
+
+namespace Graphics
+{
+
+class Sprite;
+class AnimatedSprite;
+class BufferedImage;
+class TextureAtlas_;
+
+
+/**
+*   @class SkylinePacker
+*   @brief Pack rectangles into a bin (skyline bottom-left)
+*
+*   The packer keeps the top edge (skyline) of the rectangles already placed,
+*   and puts a new rectangle where its top edge is the lowest.
+*   It is fast and gives a good occupancy, especially if the rectangles
+*   are inserted from the highest to the smallest one.
+*/
+class SkylinePacker final
+{
+    struct Node
+    {
+        int x, y, w;
+    };
+
+    int m_width;
+    int m_height;
+    int m_used_width;
+    int m_used_height;
+    long m_area;
+    std::vector<Node> m_skyline;
+
+    int fit_( const size_t i, const int w, const int h ) const noexcept;
+
+public:
+
+    /**
+    *   @fn SkylinePacker(const int width, const int height)
+    *   @param [in] width The width of the bin
+    *   @param [in] height The height of the bin
+    */
+    SkylinePacker( const int width, const int height );
+
+    /**
+    *   @fn bool insert(const int w, const int h, ImgRect& rect)
+    *
+    *   Place a rectangle in the bin
+    *
+    *   @param [in] w The width of the rectangle
+    *   @param [in] h The height of the rectangle
+    *   @param [out] rect The position of the rectangle, if it is placed
+    *
+    *   @return TRUE if the rectangle is placed, FALSE if there is no room for it
+    *   @note Complexity: O(n), n is the number of segments of the skyline
+    */
+    bool insert( const int w, const int h, ImgRect& rect );
+    /**
+    *   @fn void clear() noexcept
+    *   Remove every rectangle from the bin
+    */
+    void clear() noexcept;
+
+    /**
+    *   @fn int getUsedWidth() const noexcept
+    *   @return The right edge of the rightmost rectangle
+    */
+    int getUsedWidth() const noexcept;
+    /**
+    *   @fn int getUsedHeight() const noexcept
+    *   @return The bottom edge of the lowest rectangle
+    */
+    int getUsedHeight() const noexcept;
+    /**
+    *   @fn float getOccupancy() const noexcept
+    *   @return The ratio of the area of the rectangles to the used area of the bin
+    */
+    float getOccupancy() const noexcept;
+
+    ~SkylinePacker() = default;
+};
+
+
+/**
+*   @class TextureAtlas
+*   @brief Many images in a few textures
+*
+*   The images are added into the atlas, then build() packs them into pages
+*   and uploads the pages to the window. After that, the atlas generates
+*   sprites that refer to the images.
+*
+*   @note The sprites generated by the atlas do not own their texture,
+*         the atlas must be alive as long as they are used
+*/
+class TextureAtlas final
+{
+    std::unique_ptr<TextureAtlas_> m_aimpl;
+
+    TextureAtlas( const TextureAtlas& ) = delete;
+    TextureAtlas& operator =( const TextureAtlas& ) = delete;
+
+public:
+
+    /**
+    *   @fn TextureAtlas(lx::Win::Window& w, const int page_width = 2048, const int page_height = 2048, const int padding = 1, PixelFormat format = PixelFormat::RGBA8888)
+    *
+    *   @param [in] w The window the sprites are drawn on
+    *   @param [in] page_width The maximal width of a page
+    *   @param [in] page_height The maximal height of a page
+    *   @param [in] padding The number of transparent pixels between two images,
+    *              so the filtering of a scaled sprite does not take the pixels of its neighbours
+    *   @param [in] format The format of the pages
+    *
+    *   @note The size of a page should not exceed the maximal size of a texture
+    *         of the renderer (usually 4096 or more)
+    */
+    TextureAtlas( lx::Win::Window& w, const int page_width = 2048, const int page_height = 2048,
+                  const int padding = 1, PixelFormat format = PixelFormat::RGBA8888 );
+
+    /**
+    *   @fn void add(const std::string& name, const BufferedImage& image)
+    *
+    *   Add a copy of an image into the atlas
+    *
+    *   @param [in] name The name of the image in the atlas
+    *   @param [in] image The image
+    *
+    *   @exception ImageException If the image is bigger than a page, if the name is already used,
+    *             or if the atlas is already built
+    */
+    void add( const std::string& name, const BufferedImage& image );
+    /**
+    *   @fn void add(const std::string& filename)
+    *
+    *   Load an image into the atlas, its name is the name of the file
+    *
+    *   @param [in] filename The file
+    *   @exception ImageException If the image cannot be loaded, or see add(name, image)
+    */
+    void add( const std::string& filename );
+    /**
+    *   @fn void add(const UTF8string& filename)
+    *
+    *   Load an image into the atlas, its name is the name of the file
+    *
+    *   @param [in] filename The file
+    *   @exception ImageException If the image cannot be loaded, or see add(name, image)
+    */
+    void add( const UTF8string& filename );
+
+    /**
+    *   @fn void build()
+    *
+    *   Pack the images into pages and create the textures of the pages.
+    *   The images are sorted by height before they are packed,
+    *   and every page is cropped to the area used by its images.
+    *
+    *   @exception ImageException If a texture cannot be created
+    *   @note The copies of the images are released after the build
+    */
+    void build();
+
+    /**
+    *   @fn bool contains(const std::string& name) const noexcept
+    *   @param [in] name The name of an image
+    *   @return TRUE if the atlas has an image with this name, FALSE otherwise
+    */
+    bool contains( const std::string& name ) const noexcept;
+    /**
+    *   @fn ImgRect getArea(const std::string& name) const
+    *
+    *   @param [in] name The name of the image
+    *   @return The area of the image in its page, valid after build()
+    *   @exception ImageException If there is no image with this name
+    */
+    ImgRect getArea( const std::string& name ) const;
+    /**
+    *   @fn size_t numberOfPages() const noexcept
+    *   @return The number of textures created by build()
+    */
+    size_t numberOfPages() const noexcept;
+
+    /**
+    *   @fn Sprite * generateSprite(const std::string& name) const
+    *
+    *   @param [in] name The name of the image
+    *   @return A new sprite that displays the image
+    *   @exception ImageException If there is no image with this name, or if the atlas is not built
+    */
+    Sprite * generateSprite( const std::string& name ) const;
+    /**
+    *   @fn Sprite * generateSprite(const std::string& name, const ImgRect& area) const
+    *
+    *   @param [in] name The name of the image
+    *   @param [in] area The area of the image to display, relative to the image
+    *   @return A new sprite that displays a part of the image
+    *   @exception ImageException If there is no image with this name, or if the atlas is not built
+    */
+    Sprite * generateSprite( const std::string& name, const ImgRect& area ) const;
+    /**
+    *   @fn AnimatedSprite * generateAnimatedSprite(const std::string& name, const std::vector<ImgRect>& coord, const uint32_t delay, bool loop) const
+    *
+    *   @param [in] name The name of the sprite sheet
+    *   @param [in] coord The coordinates of each frame, relative to the sprite sheet
+    *   @param [in] delay The delay to display each frame
+    *   @param [in] loop Boolean value that specify if the animation must be looped infinitely
+    *
+    *   @return A new animated sprite
+    *   @exception ImageException If there is no image with this name, or if the atlas is not built
+    */
+    AnimatedSprite * generateAnimatedSprite( const std::string& name,
+            const std::vector<ImgRect>& coord,
+            const uint32_t delay, bool loop ) const;
+
+    ~TextureAtlas();
+};
+
+}   // Graphics
+
+}   // lx
+
+#endif // TEXTUREATLAS_HPP_INCLUDED
@@ -22,6 +22,8 @@
 
 #include <thread>
 #include <future>
+#include <functional>
+#include <memory>
 
 
 /**
@@ -156,6 +158,71 @@ public:
     ~ASyncTask() = default;
 };
 
+class WorkerPool_;
+
+/**
+*   @class WorkerPool
+*   @brief A set of threads that execute parallel loops
+*
+*   The worker threads are started once and sleep between two loops,
+*   so a loop does not pay for the creation of a thread.
+*/
+class WorkerPool final
+{
+    std::unique_ptr<WorkerPool_> m_wpimpl;
+
+    WorkerPool( const WorkerPool& ) = delete;
+    WorkerPool& operator =( const WorkerPool& ) = delete;
+
+public:
+
+    /**
+    *   @fn explicit WorkerPool(const unsigned int nb_workers)
+    *   @param [in] nb_workers The number of worker threads to start
+    *
+    *   @note If the system cannot start every thread,
+    *         the pool works with the threads it could start
+    */
+    explicit WorkerPool( const unsigned int nb_workers );
+
+    /**
+    *   @fn unsigned int nbWorkers() const noexcept
+    *   @return The number of worker threads
+    */
+    unsigned int nbWorkers() const noexcept;
+
+    /**
+    *   @fn void parallelFor(const unsigned int nb_tasks, const std::function<void(unsigned int)>& task)
+    *
+    *   Execute task(0) ... task(nb_tasks - 1) on the worker threads
+    *   and the calling thread, and wait for all of them to be done
+    *
+    *   @param [in] nb_tasks The number of tasks
+    *   @param [in] task The function to execute, with the index of the task
+    *
+    *   @exception If a task throws an exception, the remaining tasks
+    *              are still executed, then the first exception is thrown
+    *
+    *   @note Only one loop can run at a time on a pool,
+    *         a task must not call parallelFor() on its own pool
+    */
+    void parallelFor( const unsigned int nb_tasks,
+                      const std::function<void( unsigned int )>& task );
+
+    ~WorkerPool();
+};
+
+/**
+*   @fn WorkerPool& getWorkerPool()
+*
+*   Get the worker pool shared by the library.
+*   It has one worker per logical core reported by
+*   lx::SystemInfo::getCPUCount(), except the calling thread.
+*
+*   @return The pool
+*/
+WorkerPool& getWorkerPool();
+
 #include "Thread.tpp"
 
 }   // Multithreading
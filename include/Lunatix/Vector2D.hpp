@@ -18,9 +18,12 @@
 *   @brief The vector 2D library
 *   @author Luxon Jean-Pierre(Gumichan01)
 *
+*   The arithmetic operators are defined in this header, so they are inlined.
+*   See Vector2DArray.hpp to process many vectors at the same time.
 */
 
 #include <Lunatix/utils/float.hpp>
+#include <cmath>
 
 namespace lx
 {
@@ -60,7 +63,7 @@ bool operator ==( const Vector2D& u, const Vector2D& v ) noexcept;
 */
 bool operator !=( const Vector2D& u, const Vector2D& v ) noexcept;
 /**
-*   @fn Vector2D operator +(const Vector2D u,const Vector2D v) noexcept
+*   @fn constexpr Vector2D operator +(const Vector2D u,const Vector2D v) noexcept
 *
 *   Addition between two vectors
 *
@@ -69,7 +72,10 @@ bool operator !=( const Vector2D& u, const Vector2D& v ) noexcept;
 *
 *   @return The resulting vector
 */
-Vector2D operator +( const Vector2D u, const Vector2D v ) noexcept;
+inline constexpr Vector2D operator +( const Vector2D u, const Vector2D v ) noexcept
+{
+    return Vector2D{ u.vx + v.vx, u.vy + v.vy };
+}
 /**
 *   @fn Vector2D& operator +=(Vector2D& u, const Vector2D& v) noexcept
 *
@@ -80,9 +86,14 @@ Vector2D operator +( const Vector2D u, const Vector2D v ) noexcept;
 *
 *   @return The resulting vector
 */
-Vector2D& operator +=( Vector2D& u, const Vector2D& v ) noexcept;
+inline Vector2D& operator +=( Vector2D& u, const Vector2D& v ) noexcept
+{
+    u.vx.v += v.vx.v;
+    u.vy.v += v.vy.v;
+    return u;
+}
 /**
-*   @fn Vector2D operator -(const Vector2D u, const Vector2D v) noexcept
+*   @fn constexpr Vector2D operator -(const Vector2D u, const Vector2D v) noexcept
 *
 *   Substraction between two vectors
 *
@@ -91,7 +102,10 @@ Vector2D& operator +=( Vector2D& u, const Vector2D& v ) noexcept;
 *
 *   @return The resulting vector
 */
-Vector2D operator -( const Vector2D u, const Vector2D v ) noexcept;
+inline constexpr Vector2D operator -( const Vector2D u, const Vector2D v ) noexcept
+{
+    return Vector2D{ u.vx - v.vx, u.vy - v.vy };
+}
 /**
 *   @fn Vector2D& operator -=(Vector2D& u, const Vector2D& v) noexcept
 *
@@ -102,9 +116,14 @@ Vector2D operator -( const Vector2D u, const Vector2D v ) noexcept;
 *
 *   @return The resulting vector
 */
-Vector2D& operator -=( Vector2D& u, const Vector2D& v ) noexcept;
+inline Vector2D& operator -=( Vector2D& u, const Vector2D& v ) noexcept
+{
+    u.vx.v -= v.vx.v;
+    u.vy.v -= v.vy.v;
+    return u;
+}
 /**
-*   @fn Vector2D operator -(const Vector2D& v) noexcept
+*   @fn constexpr Vector2D operator -(const Vector2D& v) noexcept
 *
 *   The opposite of the vector
 *
@@ -112,7 +131,10 @@ Vector2D& operator -=( Vector2D& u, const Vector2D& v ) noexcept;
 *
 *   @return The opposite vector
 */
-Vector2D operator -( const Vector2D& v ) noexcept;
+inline constexpr Vector2D operator -( const Vector2D& v ) noexcept
+{
+    return Vector2D{ -v.vx, -v.vy };
+}
 /**
 *   @fn Vector2D& operator ++(Vector2D& v) noexcept
 *
@@ -122,7 +144,12 @@ Vector2D operator -( const Vector2D& v ) noexcept;
 *
 *   @return The incremented vector
 */
-Vector2D& operator ++( Vector2D& v ) noexcept;
+inline Vector2D& operator ++( Vector2D& v ) noexcept
+{
+    v.vx.v += 1.0f;
+    v.vy.v += 1.0f;
+    return v;
+}
 /**
 *   @fn Vector2D operator ++(Vector2D& v,int) noexcept
 *
@@ -132,7 +159,12 @@ Vector2D& operator ++( Vector2D& v ) noexcept;
 *
 *   @return The vector before the incrementation
 */
-Vector2D operator ++( Vector2D& v, int ) noexcept;
+inline Vector2D operator ++( Vector2D& v, int ) noexcept
+{
+    const Vector2D T = v;
+    ++v;
+    return T;
+}
 /**
 *   @fn Vector2D& operator --(Vector2D& v) noexcept
 *
@@ -142,7 +174,12 @@ Vector2D operator ++( Vector2D& v, int ) noexcept;
 *
 *   @return The incremented vector
 */
-Vector2D& operator --( Vector2D& v ) noexcept;
+inline Vector2D& operator --( Vector2D& v ) noexcept
+{
+    v.vx.v -= 1.0f;
+    v.vy.v -= 1.0f;
+    return v;
+}
 /**
 *   @fn Vector2D operator --(Vector2D& v, int) noexcept
 *
@@ -152,9 +189,14 @@ Vector2D& operator --( Vector2D& v ) noexcept;
 *
 *   @return The vector before the incrementation
 */
-Vector2D operator --( Vector2D& v, int ) noexcept;
+inline Vector2D operator --( Vector2D& v, int ) noexcept
+{
+    const Vector2D T = v;
+    --v;
+    return T;
+}
 /**
-*   @fn Vector2D operator *(Vector2D v, float lambda) noexcept
+*   @fn constexpr Vector2D operator *(const Vector2D v, const float lambda) noexcept
 *
 *   Scalar multiplication
 *
@@ -163,9 +205,12 @@ Vector2D operator --( Vector2D& v, int ) noexcept;
 *
 *   @return A new vector after the multiplication
 */
-Vector2D operator *( Vector2D v, float lambda ) noexcept;
+inline constexpr Vector2D operator *( const Vector2D v, const float lambda ) noexcept
+{
+    return Vector2D{ Float{ v.vx.v * lambda }, Float{ v.vy.v * lambda } };
+}
 /**
-*   @fn Vector2D& operator *=(Vector2D& v, float lambda) noexcept
+*   @fn Vector2D& operator *=(Vector2D& v, const float lambda) noexcept
 *
 *   Scalar multiplication -> 'u *= λ' <=> 'u = u * λ'
 *
@@ -174,9 +219,14 @@ Vector2D operator *( Vector2D v, float lambda ) noexcept;
 *
 *   @return A new vector after the multiplication
 */
-Vector2D& operator *=( Vector2D& v, float lambda ) noexcept;
+inline Vector2D& operator *=( Vector2D& v, const float lambda ) noexcept
+{
+    v.vx.v *= lambda;
+    v.vy.v *= lambda;
+    return v;
+}
 /**
-*   @fn Vector2D& operator /(Vector2D v, float lambda) noexcept
+*   @fn constexpr Vector2D operator /(const Vector2D v, const float lambda) noexcept
 *
 *   Scalar division
 *
@@ -185,9 +235,12 @@ Vector2D& operator *=( Vector2D& v, float lambda ) noexcept;
 *
 *   @return The vector after the division
 */
-Vector2D operator /( Vector2D v, float lambda ) noexcept;
+inline constexpr Vector2D operator /( const Vector2D v, const float lambda ) noexcept
+{
+    return Vector2D{ Float{ v.vx.v / lambda }, Float{ v.vy.v / lambda } };
+}
 /**
-*   @fn Vector2D& operator /=(Vector2D& v, float lambda) noexcept
+*   @fn Vector2D& operator /=(Vector2D& v, const float lambda) noexcept
 *
 *   Scalar division -> 'u /= λ' <=> 'u = u / λ'
 *
@@ -196,10 +249,15 @@ Vector2D operator /( Vector2D v, float lambda ) noexcept;
 *
 *   @return The vector after the division
 */
-Vector2D& operator /=( Vector2D& v, float lambda ) noexcept;
+inline Vector2D& operator /=( Vector2D& v, const float lambda ) noexcept
+{
+    v.vx.v /= lambda;
+    v.vy.v /= lambda;
+    return v;
+}
 
 /**
-*   @fn Float scalar_product(const Vector2D& u,const Vector2D& v) noexcept
+*   @fn constexpr Float scalar_product(const Vector2D& u,const Vector2D& v) noexcept
 *
 *   Calculate the scalar product of 2 vectors
 *
@@ -208,9 +266,12 @@ Vector2D& operator /=( Vector2D& v, float lambda ) noexcept;
 *
 *   @return The scalar product
 */
-Float scalar_product( const Vector2D& u, const Vector2D& v ) noexcept;
+inline constexpr Float scalar_product( const Vector2D& u, const Vector2D& v ) noexcept
+{
+    return Float{ u.vx.v * v.vx.v + u.vy.v * v.vy.v };
+}
 /**
-*   @fn Float vector_product(const Vector2D& u, const Vector2D& v) noexcept
+*   @fn constexpr Float vector_product(const Vector2D& u, const Vector2D& v) noexcept
 *
 *   Calculate the vector product of 2 vectors
 *
@@ -219,7 +280,10 @@ Float scalar_product( const Vector2D& u, const Vector2D& v ) noexcept;
 *
 *   @return The vector product
 */
-Float vector_product( const Vector2D& u, const Vector2D& v ) noexcept;
+inline constexpr Float vector_product( const Vector2D& u, const Vector2D& v ) noexcept
+{
+    return Float{ u.vx.v * v.vy.v - v.vx.v * u.vy.v };
+}
 /**
 *   @fn Float vector_norm(const Vector2D& v) noexcept
 *
@@ -227,7 +291,10 @@ Float vector_product( const Vector2D& u, const Vector2D& v ) noexcept;
 *
 *   @return The norm of the vector
 */
-Float vector_norm( const Vector2D& v ) noexcept;
+inline Float vector_norm( const Vector2D& v ) noexcept
+{
+    return Float{ std::sqrt( v.vx.v * v.vx.v + v.vy.v * v.vy.v ) };
+}
 
 /**
 *   @fn bool isNullVector(const Vector2D& v) noexcept
@@ -255,7 +322,13 @@ bool collinear( const Vector2D& u, const Vector2D& v ) noexcept;
 *
 *   @note If the vector is a null vector, then the same vector is returned
 */
-Vector2D& normalize( Vector2D& v ) noexcept;
+inline Vector2D& normalize( Vector2D& v ) noexcept
+{
+    if ( !isNullVector( v ) )
+        v *= 1.0f / vector_norm( v ).v;
+
+    return v;
+}
 
 }   // Physics
 
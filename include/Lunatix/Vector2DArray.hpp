@@ -0,0 +1,147 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+#ifndef VECTOR2DARRAY_HPP_INCLUDED
+#define VECTOR2DARRAY_HPP_INCLUDED
+
+/**
+*   @file Vector2DArray.hpp
+*   @brief Operations on many vectors at the same time
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*   The vectors are packed in two arrays of coordinates (x and y),
+*   so several vectors are processed at the same time
+*   with the SIMD instructions of the processor (SSE2 or AVX2), if they are available.
+*
+*   Each function gives the same result as the function of Vector2D.hpp
+*   applied to every vector of the array.
+*   If two arrays do not have the same size, only the first vectors
+*   of the largest one are processed.
+*/
+
+#include <Lunatix/Vector2D.hpp>
+#include <vector>
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+/**
+*   @struct Vector2DArray
+*   @brief Packed vectors
+*/
+struct Vector2DArray final
+{
+    std::vector<float> x;   /**< X coordinate of every vector */
+    std::vector<float> y;   /**< Y coordinate of every vector */
+
+    /**
+    *   @fn void push(const Vector2D& v)
+    *   @param [in] v The vector to add at the end of the array
+    */
+    void push( const Vector2D& v );
+    /**
+    *   @fn void set(const size_t index, const Vector2D& v) noexcept
+    *   @param [in] index The index of the vector (< size())
+    *   @param [in] v The new vector
+    */
+    void set( const size_t index, const Vector2D& v ) noexcept;
+    /**
+    *   @fn Vector2D get(const size_t index) const noexcept
+    *   @param [in] index The index of the vector (< size())
+    *   @return The vector
+    */
+    Vector2D get( const size_t index ) const noexcept;
+    /**
+    *   @fn void resize(const size_t n)
+    *   @param [in] n The new number of vectors, the new vectors are null vectors
+    */
+    void resize( const size_t n );
+    /**
+    *   @fn size_t size() const noexcept
+    *   @return The number of vectors
+    */
+    size_t size() const noexcept;
+    /**
+    *   @fn void clear() noexcept
+    */
+    void clear() noexcept;
+};
+
+
+/**
+*   @fn void add(Vector2DArray& u, const Vector2DArray& v) noexcept
+*
+*   u[i] += v[i]
+*
+*   @param [in, out] u The vectors that will be modified
+*   @param [in] v The vectors to add
+*/
+void add( Vector2DArray& u, const Vector2DArray& v ) noexcept;
+/**
+*   @fn void addScaled(Vector2DArray& u, const Vector2DArray& v, const float lambda) noexcept
+*
+*   u[i] += v[i] * λ. For example, to move objects: addScaled(positions, velocities, dt)
+*
+*   @param [in, out] u The vectors that will be modified
+*   @param [in] v The vectors to add
+*   @param [in] lambda The scalar value
+*/
+void addScaled( Vector2DArray& u, const Vector2DArray& v, const float lambda ) noexcept;
+/**
+*   @fn void add(Vector2DArray& u, const Vector2D& v) noexcept
+*
+*   u[i] += v. For example, to accelerate objects: add(velocities, gravity * dt)
+*
+*   @param [in, out] u The vectors that will be modified
+*   @param [in] v The vector to add to every vector
+*/
+void add( Vector2DArray& u, const Vector2D& v ) noexcept;
+/**
+*   @fn void scale(Vector2DArray& u, const float lambda) noexcept
+*
+*   u[i] *= λ
+*
+*   @param [in, out] u The vectors that will be modified
+*   @param [in] lambda The scalar value
+*/
+void scale( Vector2DArray& u, const float lambda ) noexcept;
+/**
+*   @fn void scalar_product(const Vector2DArray& u, const Vector2DArray& v, std::vector<float>& result)
+*
+*   @param [in] u The first vectors
+*   @param [in] v The second vectors
+*   @param [out] result The scalar product of u[i] and v[i]
+*/
+void scalar_product( const Vector2DArray& u, const Vector2DArray& v, std::vector<float>& result );
+/**
+*   @fn void vector_norm(const Vector2DArray& u, std::vector<float>& result)
+*
+*   @param [in] u The vectors
+*   @param [out] result The norm of every vector
+*/
+void vector_norm( const Vector2DArray& u, std::vector<float>& result );
+/**
+*   @fn void normalize(Vector2DArray& u) noexcept
+*
+*   @param [in, out] u The vectors to normalize
+*   @note The null vectors are not modified
+*/
+void normalize( Vector2DArray& u ) noexcept;
+
+}   // Physics
+
+}   // lx
+
+#endif // VECTOR2DARRAY_HPP_INCLUDED
@@ -44,8 +44,11 @@ class StreamingTexture;
 class AnimatedSprite;
 class TextTexture;
 class BufferedImage;
+class SpriteBatch_;
+class TextureAtlas_;
 class ImgCoord;
 class ImgRect;
+enum class MirrorEffect;
 }
 
 namespace TrueTypeFont
@@ -204,6 +207,8 @@ class Window final
     friend class lx::Graphics::StreamingTexture;
     friend class lx::Graphics::AnimatedSprite;
     friend class lx::Graphics::TextTexture;
+    friend class lx::Graphics::SpriteBatch_;
+    friend class lx::Graphics::TextureAtlas_;
     friend class lx::TrueTypeFont::Font;
 
     std::unique_ptr<Window_> m_wimpl;
@@ -212,6 +217,12 @@ class Window final
     Window& operator =( Window& w ) = delete;
 
     void * getRenderingSys_() const noexcept;
+    bool queueCopy_( void * texture, const lx::Graphics::ImgRect& area,
+                     const lx::Graphics::ImgRect * box, const double angle,
+                     const lx::Graphics::MirrorEffect mirror ) noexcept;
+    // The draws done between these calls are batched apart (see SpriteBatch)
+    void beginSpriteBatch_() noexcept;
+    void endSpriteBatch_() noexcept;
 
 public:
 
@@ -448,15 +459,75 @@ public:
     *   @fn void update() noexcept
     *   Updates the window's display
     *   @note This function can be used with OpenGL
+    *   @note In batching mode, the recorded sprites are drawn before the update
     */
     void update() noexcept;
     /**
     *   @fn void clearWindow() noexcept
     *   Clear the display of the current window
     *   @note This function can be used with OpenGL
+    *   @note In batching mode, the sprites recorded before the clear are discarded
     */
     void clearWindow() noexcept;
 
+    /**
+    *   @fn void setBatching(const bool batching) noexcept
+    *
+    *   Enable or disable the batching mode.
+    *
+    *   In batching mode, the sprites and the animated sprites are not drawn
+    *   immediately, their draws are recorded. When the window is updated,
+    *   the draws are sorted by layer, texture and blend mode, and the draws
+    *   that use the same texture are submitted to the renderer as one
+    *   piece of geometry (SDL ≥ 2.0.18). The rotated and mirrored sprites
+    *   are expanded to quads, so they are batched too.
+    *
+    *   @param [in] batching TRUE to enable the mode, FALSE to disable it
+    *
+    *   @note Disabling the mode flushes the draws already recorded
+    *   @note The other drawings (lines, rectangles, text, streaming textures,
+    *         SpriteBatch) are still done immediately, so they are below
+    *         the recorded sprites, unless flushBatch() is called before them
+    *   @note A sprite drawn in batching mode must be alive until the batch is flushed
+    */
+    void setBatching( const bool batching ) noexcept;
+    /**
+    *   @fn bool isBatching() const noexcept
+    *   @return TRUE if the window is in batching mode, FALSE otherwise
+    */
+    bool isBatching() const noexcept;
+    /**
+    *   @fn void setDrawLayer(const int layer) noexcept
+    *
+    *   Set the layer of the next sprites drawn in batching mode
+    *
+    *   @param [in] layer The layer, the layers are drawn in increasing order
+    *
+    *   @note In a layer, the sprites that use the same texture are drawn
+    *         in the order they were drawn, but the textures are drawn
+    *         in an unspecified order. Sprites that must overlap
+    *         in a specific order should be put in different layers.
+    */
+    void setDrawLayer( const int layer ) noexcept;
+    /**
+    *   @fn int getDrawLayer() const noexcept
+    *   @return The layer of the next sprites drawn in batching mode (0 by default)
+    */
+    int getDrawLayer() const noexcept;
+    /**
+    *   @fn void flushBatch() noexcept
+    *
+    *   Draw the sprites recorded in batching mode now.
+    *   This function is called by update().
+    */
+    void flushBatch() noexcept;
+    /**
+    *   @fn unsigned int getBatchRenderCalls() const noexcept
+    *   @return The number of calls to the renderer done by the last flush of the batch
+    *   @note The flush of a SpriteBatch is counted as a flush of the batch
+    */
+    unsigned int getBatchRenderCalls() const noexcept;
+
     /**
     *   @fn bool screenshot(const std::string& filename) noexcept
     *
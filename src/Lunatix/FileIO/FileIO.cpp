@@ -26,6 +26,14 @@
 #include <cstdio>
 #include <cerrno>
 
+#if defined( __unix__ ) || defined( __APPLE__ )
+#define LX_MAPPED_FILE
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace lx
 {
 
@@ -365,6 +373,142 @@ TmpFile::~TmpFile()
     m_timpl.reset();
 }
 
+/// MappedFile
+
+/* Private implementation */
+
+class MappedFile_ final
+{
+    std::string _name;
+    const void * m_data;
+    size_t m_size;
+    std::unique_ptr<uint64_t[]> m_buffer;   // Used if the file cannot be mapped
+
+    MappedFile_( const MappedFile_& ) = delete;
+    MappedFile_& operator =( const MappedFile_& ) = delete;
+
+#ifdef LX_MAPPED_FILE
+    void map_()
+    {
+        const std::string STR( "MappedFile: " + _name + " - " );
+        const int FD = ::open( _name.c_str(), O_RDONLY );
+
+        if ( FD == -1 )
+            throw IOException( STR + std::strerror( errno ) );
+
+        struct stat st;
+
+        if ( ::fstat( FD, &st ) == -1 )
+        {
+            const std::string ERR( std::strerror( errno ) );
+            ::close( FD );
+            throw IOException( STR + ERR );
+        }
+
+        m_size = static_cast<size_t>( st.st_size );
+
+        if ( m_size > 0 )
+        {
+            void * p = ::mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, FD, 0 );
+
+            if ( p == MAP_FAILED )
+            {
+                const std::string ERR( std::strerror( errno ) );
+                ::close( FD );
+                throw IOException( STR + ERR );
+            }
+
+            m_data = p;
+        }
+
+        // The mapping stays valid after the file is closed
+        ::close( FD );
+    }
+#else
+    void map_()
+    {
+        File reader( _name, FileMode::RDONLY );
+        const long FSIZE = reader.size();
+
+        if ( FSIZE == -1L )
+            throw IOException( "MappedFile: " + _name + " - cannot get the size of the file" );
+
+        m_size = static_cast<size_t>( FSIZE );
+
+        if ( m_size > 0 )
+        {
+            m_buffer.reset( new uint64_t[( m_size + 7 ) / 8] );
+
+            if ( reader.read( m_buffer.get(), 1, m_size ) != m_size )
+                throw IOException( "MappedFile: " + _name + " - cannot read the entire file" );
+
+            m_data = m_buffer.get();
+        }
+    }
+#endif
+
+public:
+
+    explicit MappedFile_( const std::string& filename )
+        : _name( filename ), m_data( nullptr ), m_size( 0 ), m_buffer( nullptr )
+    {
+        map_();
+    }
+
+    const void * data() const noexcept
+    {
+        return m_data;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    const char * getFilename() const noexcept
+    {
+        return _name.c_str();
+    }
+
+    ~MappedFile_()
+    {
+#ifdef LX_MAPPED_FILE
+        if ( m_data != nullptr )
+            ::munmap( const_cast<void *>( m_data ), m_size );
+#endif
+    }
+};
+
+
+/* Public functions */
+
+MappedFile::MappedFile( const std::string& filename )
+    : m_mimpl( new MappedFile_( filename ) ) {}
+
+MappedFile::MappedFile( const UTF8string& filename )
+    : m_mimpl( new MappedFile_( filename.utf8_sstring() ) ) {}
+
+
+const void * MappedFile::data() const noexcept
+{
+    return m_mimpl->data();
+}
+
+size_t MappedFile::size() const noexcept
+{
+    return m_mimpl->size();
+}
+
+const char * MappedFile::getFilename() const noexcept
+{
+    return m_mimpl->getFilename();
+}
+
+MappedFile::~MappedFile()
+{
+    m_mimpl.reset();
+}
+
 /// Stream
 AbstractFile& operator <<( AbstractFile& f, const char s[] ) noexcept
 {
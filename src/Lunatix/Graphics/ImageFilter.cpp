@@ -0,0 +1,1264 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file ImageFilter.cpp
+*   @brief The implementation of the pixel filters, the pipeline and the resampling of the buffered image
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/ImagePipeline.hpp>
+#include <Lunatix/SystemInfo.hpp>
+#include <Lunatix/Thread.hpp>
+#include <Lunatix/Log.hpp>
+
+#include <SDL2/SDL_surface.h>
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define LX_FILTER_SIMD 1
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+
+using lx::Graphics::PixelFormat;
+
+/*
+*   The grayscale value is computed in fixed point (8 bits):
+*   V = (54 × R + 183 × G + 19 × B) / 256, the weights are the ones of Rec. 709
+*   (0.2126, 0.7152, 0.0722). The sum of the weights is 256, so white stays white,
+*   and every term fits in 16 bits, as required by the SIMD kernels.
+*/
+const uint32_t RED_WEIGHT   = 54;
+const uint32_t GREEN_WEIGHT = 183;
+const uint32_t BLUE_WEIGHT  = 19;
+
+// The images of at least PARALLEL_PIXELS pixels are filtered by bands of BAND_ROWS rows
+const long PARALLEL_PIXELS = 1L << 18;
+const int BAND_ROWS = 64;
+
+// A kernel filters the w pixels of a row
+using RowFn = void ( * )( uint8_t * row, const int w );
+
+
+/*
+*   Layout of a packed format: the position of the channels in the pixel
+*   (the value of the pixel, so it does not depend on the byte order)
+*/
+template <PixelFormat F>
+struct Layout_;
+
+#define LX_PIXEL_LAYOUT( fmt, type, bits, rs, gs, bs )                                  \
+template <>                                                                             \
+struct Layout_<PixelFormat::fmt>                                                        \
+{                                                                                       \
+    using Pixel = type;                                                                 \
+    static constexpr uint32_t MAX = ( 1U << bits ) - 1U;                                \
+    static constexpr int R = rs;                                                        \
+    static constexpr int G = gs;                                                        \
+    static constexpr int B = bs;                                                        \
+    static constexpr uint32_t RGB = ( MAX << rs ) | ( MAX << gs ) | ( MAX << bs );      \
+}
+
+LX_PIXEL_LAYOUT( RGBA8888, uint32_t, 8, 24, 16, 8 );
+LX_PIXEL_LAYOUT( ARGB8888, uint32_t, 8, 16, 8, 0 );
+LX_PIXEL_LAYOUT( BGRA8888, uint32_t, 8, 8, 16, 24 );
+LX_PIXEL_LAYOUT( ABGR8888, uint32_t, 8, 0, 8, 16 );
+LX_PIXEL_LAYOUT( RGBX8888, uint32_t, 8, 24, 16, 8 );
+LX_PIXEL_LAYOUT( BGRX8888, uint32_t, 8, 8, 16, 24 );
+LX_PIXEL_LAYOUT( RGB888,   uint32_t, 8, 16, 8, 0 );
+LX_PIXEL_LAYOUT( BGR888,   uint32_t, 8, 0, 8, 16 );
+LX_PIXEL_LAYOUT( RGBA4444, uint16_t, 4, 12, 8, 4 );
+LX_PIXEL_LAYOUT( ARGB4444, uint16_t, 4, 8, 4, 0 );
+LX_PIXEL_LAYOUT( BGRA4444, uint16_t, 4, 4, 8, 12 );
+LX_PIXEL_LAYOUT( ABGR4444, uint16_t, 4, 0, 4, 8 );
+
+#undef LX_PIXEL_LAYOUT
+
+
+inline uint32_t gray_( const uint32_t r, const uint32_t g, const uint32_t b ) noexcept
+{
+    return ( RED_WEIGHT * r + GREEN_WEIGHT * g + BLUE_WEIGHT * b ) >> 8;
+}
+
+// The channels that are not colours (alpha, padding) are not modified
+template <PixelFormat F>
+void grayscaleScalar_( uint8_t * row, const int w )
+{
+    using L = Layout_<F>;
+    typename L::Pixel * pixels = reinterpret_cast<typename L::Pixel *>( row );
+
+    for ( int x = 0; x < w; ++x )
+    {
+        const uint32_t P = pixels[x];
+        const uint32_t V = gray_( ( P >> L::R ) & L::MAX, ( P >> L::G ) & L::MAX,
+                                  ( P >> L::B ) & L::MAX );
+        pixels[x] = static_cast<typename L::Pixel>( ( P & ~L::RGB )
+                    | ( V << L::R ) | ( V << L::G ) | ( V << L::B ) );
+    }
+}
+
+template <PixelFormat F>
+void negativeScalar_( uint8_t * row, const int w )
+{
+    using L = Layout_<F>;
+    typename L::Pixel * pixels = reinterpret_cast<typename L::Pixel *>( row );
+
+    for ( int x = 0; x < w; ++x )
+        pixels[x] = static_cast<typename L::Pixel>( pixels[x] ^ L::RGB );
+}
+
+// 24-bit formats: ri, gi, bi are the offsets of the channels in the 3 bytes
+template <int ri, int gi, int bi>
+void grayscale24_( uint8_t * row, const int w )
+{
+    for ( int x = 0; x < w; ++x )
+    {
+        uint8_t * p = row + 3 * x;
+        const uint8_t V = static_cast<uint8_t>( gray_( p[ri], p[gi], p[bi] ) );
+        p[0] = p[1] = p[2] = V;
+    }
+}
+
+void negative24_( uint8_t * row, const int w )
+{
+    for ( int i = 0; i < 3 * w; ++i )
+        row[i] = static_cast<uint8_t>( ~row[i] );
+}
+
+#if defined(LX_FILTER_SIMD)
+
+/*
+*   The SIMD kernels filter 4 (SSE2) or 8 (AVX2) 32-bit pixels per iteration.
+*   A channel is extracted in a 32-bit lane, so the product of a channel
+*   and its weight is done with a 16-bit multiplication.
+*   They give the same result as the scalar kernel.
+*/
+template <PixelFormat F>
+__attribute__( ( target( "sse2" ) ) )
+void grayscaleSSE2_( uint8_t * row, const int w )
+{
+    using L = Layout_<F>;
+    const __m128i MAX = _mm_set1_epi32( 0xFF );
+    const __m128i KEEP = _mm_set1_epi32( static_cast<int>( ~L::RGB ) );
+    const __m128i WR = _mm_set1_epi32( RED_WEIGHT );
+    const __m128i WG = _mm_set1_epi32( GREEN_WEIGHT );
+    const __m128i WB = _mm_set1_epi32( BLUE_WEIGHT );
+    int x = 0;
+
+    for ( ; x + 4 <= w; x += 4 )
+    {
+        __m128i * p = reinterpret_cast<__m128i *>( row + 4 * x );
+        const __m128i P = _mm_loadu_si128( p );
+        const __m128i R = _mm_and_si128( _mm_srli_epi32( P, L::R ), MAX );
+        const __m128i G = _mm_and_si128( _mm_srli_epi32( P, L::G ), MAX );
+        const __m128i B = _mm_and_si128( _mm_srli_epi32( P, L::B ), MAX );
+        const __m128i V = _mm_srli_epi32( _mm_add_epi32( _mm_add_epi32( _mm_mullo_epi16( R, WR ),
+                                          _mm_mullo_epi16( G, WG ) ), _mm_mullo_epi16( B, WB ) ), 8 );
+        const __m128i RGB = _mm_or_si128( _mm_or_si128( _mm_slli_epi32( V, L::R ),
+                                          _mm_slli_epi32( V, L::G ) ), _mm_slli_epi32( V, L::B ) );
+        _mm_storeu_si128( p, _mm_or_si128( _mm_and_si128( P, KEEP ), RGB ) );
+    }
+
+    grayscaleScalar_<F>( row + 4 * x, w - x );
+}
+
+template <PixelFormat F>
+__attribute__( ( target( "sse2" ) ) )
+void negativeSSE2_( uint8_t * row, const int w )
+{
+    using L = Layout_<F>;
+    const __m128i RGB = _mm_set1_epi32( static_cast<int>( L::RGB ) );
+    int x = 0;
+
+    for ( ; x + 4 <= w; x += 4 )
+    {
+        __m128i * p = reinterpret_cast<__m128i *>( row + 4 * x );
+        _mm_storeu_si128( p, _mm_xor_si128( _mm_loadu_si128( p ), RGB ) );
+    }
+
+    negativeScalar_<F>( row + 4 * x, w - x );
+}
+
+template <PixelFormat F>
+__attribute__( ( target( "avx2" ) ) )
+void grayscaleAVX2_( uint8_t * row, const int w )
+{
+    using L = Layout_<F>;
+    const __m256i MAX = _mm256_set1_epi32( 0xFF );
+    const __m256i KEEP = _mm256_set1_epi32( static_cast<int>( ~L::RGB ) );
+    const __m256i WR = _mm256_set1_epi32( RED_WEIGHT );
+    const __m256i WG = _mm256_set1_epi32( GREEN_WEIGHT );
+    const __m256i WB = _mm256_set1_epi32( BLUE_WEIGHT );
+    int x = 0;
+
+    for ( ; x + 8 <= w; x += 8 )
+    {
+        __m256i * p = reinterpret_cast<__m256i *>( row + 4 * x );
+        const __m256i P = _mm256_loadu_si256( p );
+        const __m256i R = _mm256_and_si256( _mm256_srli_epi32( P, L::R ), MAX );
+        const __m256i G = _mm256_and_si256( _mm256_srli_epi32( P, L::G ), MAX );
+        const __m256i B = _mm256_and_si256( _mm256_srli_epi32( P, L::B ), MAX );
+        const __m256i V = _mm256_srli_epi32( _mm256_add_epi32(
+                _mm256_add_epi32( _mm256_mullo_epi16( R, WR ), _mm256_mullo_epi16( G, WG ) ),
+                _mm256_mullo_epi16( B, WB ) ), 8 );
+        const __m256i RGB = _mm256_or_si256( _mm256_or_si256( _mm256_slli_epi32( V, L::R ),
+                                             _mm256_slli_epi32( V, L::G ) ),
+                                             _mm256_slli_epi32( V, L::B ) );
+        _mm256_storeu_si256( p, _mm256_or_si256( _mm256_and_si256( P, KEEP ), RGB ) );
+    }
+
+    grayscaleScalar_<F>( row + 4 * x, w - x );
+}
+
+template <PixelFormat F>
+__attribute__( ( target( "avx2" ) ) )
+void negativeAVX2_( uint8_t * row, const int w )
+{
+    using L = Layout_<F>;
+    const __m256i RGB = _mm256_set1_epi32( static_cast<int>( L::RGB ) );
+    int x = 0;
+
+    for ( ; x + 8 <= w; x += 8 )
+    {
+        __m256i * p = reinterpret_cast<__m256i *>( row + 4 * x );
+        _mm256_storeu_si256( p, _mm256_xor_si256( _mm256_loadu_si256( p ), RGB ) );
+    }
+
+    negativeScalar_<F>( row + 4 * x, w - x );
+}
+
+#endif
+
+// The kernel of a 32-bit format, the best one supported by the CPU
+template <PixelFormat F>
+RowFn kernel32_( const bool grayscale ) noexcept
+{
+#if defined(LX_FILTER_SIMD)
+    if ( lx::SystemInfo::hasAVX2() )
+        return grayscale ? grayscaleAVX2_<F> : negativeAVX2_<F>;
+
+    if ( lx::SystemInfo::hasSSE2() )
+        return grayscale ? grayscaleSSE2_<F> : negativeSSE2_<F>;
+#endif
+    return grayscale ? grayscaleScalar_<F> : negativeScalar_<F>;
+}
+
+template <PixelFormat F>
+RowFn kernel16_( const bool grayscale ) noexcept
+{
+    return grayscale ? grayscaleScalar_<F> : negativeScalar_<F>;
+}
+
+// The kernel is chosen once per image, nullptr if the format is not packed
+RowFn kernel_( const uint32_t format, const bool grayscale ) noexcept
+{
+    switch ( static_cast<PixelFormat>( format ) )
+    {
+    case PixelFormat::RGBA8888:
+        return kernel32_<PixelFormat::RGBA8888>( grayscale );
+
+    case PixelFormat::ARGB8888:
+        return kernel32_<PixelFormat::ARGB8888>( grayscale );
+
+    case PixelFormat::BGRA8888:
+        return kernel32_<PixelFormat::BGRA8888>( grayscale );
+
+    case PixelFormat::ABGR8888:
+        return kernel32_<PixelFormat::ABGR8888>( grayscale );
+
+    case PixelFormat::RGBX8888:
+        return kernel32_<PixelFormat::RGBX8888>( grayscale );
+
+    case PixelFormat::BGRX8888:
+        return kernel32_<PixelFormat::BGRX8888>( grayscale );
+
+    case PixelFormat::RGB888:
+        return kernel32_<PixelFormat::RGB888>( grayscale );
+
+    case PixelFormat::BGR888:
+        return kernel32_<PixelFormat::BGR888>( grayscale );
+
+    case PixelFormat::RGBA4444:
+        return kernel16_<PixelFormat::RGBA4444>( grayscale );
+
+    case PixelFormat::ARGB4444:
+        return kernel16_<PixelFormat::ARGB4444>( grayscale );
+
+    case PixelFormat::BGRA4444:
+        return kernel16_<PixelFormat::BGRA4444>( grayscale );
+
+    case PixelFormat::ABGR4444:
+        return kernel16_<PixelFormat::ABGR4444>( grayscale );
+
+    case PixelFormat::RGB24:
+        return grayscale ? grayscale24_<0, 1, 2> : negative24_;
+
+    case PixelFormat::BGR24:
+        return grayscale ? grayscale24_<2, 1, 0> : negative24_;
+
+    default:
+        return nullptr;
+    }
+}
+
+
+// Any other format, pixel by pixel, through SDL_GetRGBA()/SDL_MapRGBA()
+void filterGeneric_( SDL_Surface * surface, const bool grayscale ) noexcept
+{
+    const SDL_PixelFormat * FMT = surface->format;
+    const int BPP = FMT->BytesPerPixel;
+
+    for ( int y = 0; y < surface->h; ++y )
+    {
+        uint8_t * row = static_cast<uint8_t *>( surface->pixels ) + y * surface->pitch;
+
+        for ( int x = 0; x < surface->w; ++x )
+        {
+            uint8_t * p = row + x * BPP;
+            uint32_t pixel = 0;
+            Uint8 r, g, b, a;
+
+            std::memcpy( &pixel, p, static_cast<size_t>( BPP ) );
+
+            if ( SDL_BYTEORDER == SDL_BIG_ENDIAN )
+                pixel >>= ( 4 - BPP ) * 8;
+
+            SDL_GetRGBA( pixel, FMT, &r, &g, &b, &a );
+
+            if ( grayscale )
+                r = g = b = static_cast<Uint8>( gray_( r, g, b ) );
+            else
+            {
+                r = static_cast<Uint8>( 255 - r );
+                g = static_cast<Uint8>( 255 - g );
+                b = static_cast<Uint8>( 255 - b );
+            }
+
+            pixel = SDL_MapRGBA( FMT, r, g, b, a );
+
+            if ( SDL_BYTEORDER == SDL_BIG_ENDIAN )
+                pixel <<= ( 4 - BPP ) * 8;
+
+            std::memcpy( p, &pixel, static_cast<size_t>( BPP ) );
+        }
+    }
+}
+
+
+void filterRows_( SDL_Surface * surface, const RowFn kernel, const int first, const int last )
+{
+    uint8_t * pixels = static_cast<uint8_t *>( surface->pixels );
+
+    // The pitch may be greater than the width × the size of a pixel
+    for ( int y = first; y < last; ++y )
+        kernel( pixels + y * surface->pitch, surface->w );
+}
+
+void filter_( SDL_Surface * surface, const bool grayscale ) noexcept
+{
+    const RowFn KERNEL = kernel_( surface->format->format, grayscale );
+
+    if ( KERNEL == nullptr && ( surface->format->BytesPerPixel < 1
+                                || surface->format->BytesPerPixel > 4 ) )
+    {
+        lx::Log::logCritical( lx::Log::VIDEO, "convert image: Unrecognized format" );
+        return;
+    }
+
+    if ( SDL_MUSTLOCK( surface ) )
+        SDL_LockSurface( surface );
+
+    if ( KERNEL == nullptr )
+        filterGeneric_( surface, grayscale );
+
+    else if ( static_cast<long>( surface->w ) * surface->h < PARALLEL_PIXELS )
+        filterRows_( surface, KERNEL, 0, surface->h );
+
+    else
+    {
+        const unsigned int NB_BANDS = static_cast<unsigned int>( ( surface->h + BAND_ROWS - 1 ) / BAND_ROWS );
+
+        try
+        {
+            lx::Multithreading::getWorkerPool().parallelFor( NB_BANDS,
+                    [&]( unsigned int band ) noexcept
+            {
+                const int FIRST = static_cast<int>( band ) * BAND_ROWS;
+                filterRows_( surface, KERNEL, FIRST, std::min( FIRST + BAND_ROWS, surface->h ) );
+            } );
+        }
+        catch ( std::exception& e )
+        {
+            // The bands cannot throw, so no row was filtered
+            lx::Log::logWarning( lx::Log::VIDEO, "convert image: %s", e.what() );
+            filterRows_( surface, KERNEL, 0, surface->h );
+        }
+    }
+
+    if ( SDL_MUSTLOCK( surface ) )
+        SDL_UnlockSurface( surface );
+}
+
+
+/* Pipeline */
+
+// A pixel of the pipeline: red, green, blue, alpha in [0, 255]
+typedef float Float4 __attribute__( ( vector_size( 16 ) ) );
+
+// The size of the tiles of a blur, in pixels
+const int TILE_SIZE = 64;
+
+enum class StageType
+{
+    MATRIX,
+    PREMULTIPLY,
+    BLUR
+};
+
+struct Stage final
+{
+    StageType type;
+    lx::Graphics::ColourMatrix matrix;
+    std::vector<float> weights;     // The kernel of a blur (2 × radius + 1 weights)
+};
+
+// c' = col[0] × R + col[1] × G + col[2] × B + col[3] × A + col[4], or the premultiplication
+struct PixelOp final
+{
+    bool premultiply;
+    Float4 col[5];
+};
+
+/*
+*   A pass over the image: the operations before the blur (done on the pixels
+*   read by the blur), the blur, and the operations after it.
+*   A pass without blur only has operations before.
+*/
+struct Pass final
+{
+    std::vector<PixelOp> pre;
+    std::vector<float> weights;
+    std::vector<PixelOp> post;
+};
+
+// The channels of a 32-bit format with 8-bit channels
+struct Channels final
+{
+    int r, g, b, a;
+    bool alpha;
+    uint32_t keep;                  // The bits that are not channels
+};
+
+inline bool is8888_( const SDL_PixelFormat * fmt ) noexcept
+{
+    return fmt->BytesPerPixel == 4 && fmt->Rloss == 0 && fmt->Gloss == 0 && fmt->Bloss == 0
+           && ( fmt->Amask == 0 || fmt->Aloss == 0 );
+}
+
+// b ∘ a: the matrix a, then the matrix b
+lx::Graphics::ColourMatrix compose_( const lx::Graphics::ColourMatrix& a,
+                                     const lx::Graphics::ColourMatrix& b ) noexcept
+{
+    lx::Graphics::ColourMatrix r;
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        for ( int j = 0; j < 5; ++j )
+        {
+            float v = j == 4 ? b.m[i][4] : 0.0f;
+
+            for ( int k = 0; k < 4; ++k )
+                v += b.m[i][k] * a.m[k][j];
+
+            r.m[i][j] = v;
+        }
+    }
+
+    return r;
+}
+
+// The matrix works on [0, 1], the pixels are in [0, 255]: only the offset is scaled
+PixelOp matrixOp_( const lx::Graphics::ColourMatrix& m ) noexcept
+{
+    PixelOp op;
+    op.premultiply = false;
+
+    for ( int j = 0; j < 5; ++j )
+    {
+        const float S = j == 4 ? 255.0f : 1.0f;
+        op.col[j] = Float4{ m.m[0][j] * S, m.m[1][j] * S, m.m[2][j] * S, m.m[3][j] * S };
+    }
+
+    return op;
+}
+
+inline Float4 unpack_( const uint32_t p, const Channels& c ) noexcept
+{
+    return Float4{ static_cast<float>( ( p >> c.r ) & 0xFF ), static_cast<float>( ( p >> c.g ) & 0xFF ),
+                   static_cast<float>( ( p >> c.b ) & 0xFF ),
+                   c.alpha ? static_cast<float>( ( p >> c.a ) & 0xFF ) : 255.0f };
+}
+
+inline uint32_t toByte_( const float f ) noexcept
+{
+    return f <= 0.0f ? 0U : ( f >= 255.0f ? 255U : static_cast<uint32_t>( f + 0.5f ) );
+}
+
+inline uint32_t pack_( const Float4 v, const uint32_t old, const Channels& c ) noexcept
+{
+    const uint32_t A = c.alpha ? toByte_( v[3] ) << c.a : 0U;
+    return ( old & c.keep ) | ( toByte_( v[0] ) << c.r ) | ( toByte_( v[1] ) << c.g )
+           | ( toByte_( v[2] ) << c.b ) | A;
+}
+
+inline Float4 applyOps_( Float4 p, const std::vector<PixelOp>& ops ) noexcept
+{
+    for ( const PixelOp& op : ops )
+    {
+        if ( op.premultiply )
+        {
+            const float A = std::min( std::max( p[3], 0.0f ), 255.0f ) / 255.0f;
+            p = p * Float4{ A, A, A, 1.0f };
+        }
+        else
+        {
+            p = op.col[0] * p[0] + op.col[1] * p[1] + op.col[2] * p[2]
+                + op.col[3] * p[3] + op.col[4];
+        }
+    }
+
+    return p;
+}
+
+inline int clamp_( const int v, const int hi ) noexcept
+{
+    return v < 0 ? 0 : ( v > hi ? hi : v );
+}
+
+void pixelRows_( SDL_Surface * surface, const Channels& c, const std::vector<PixelOp>& ops,
+                 const int first, const int last ) noexcept
+{
+    uint8_t * pixels = static_cast<uint8_t *>( surface->pixels );
+
+    for ( int y = first; y < last; ++y )
+    {
+        uint32_t * row = reinterpret_cast<uint32_t *>( pixels + y * surface->pitch );
+
+        for ( int x = 0; x < surface->w; ++x )
+            row[x] = pack_( applyOps_( unpack_( row[x], c ), ops ), row[x], c );
+    }
+}
+
+/*
+*   Blur a tile of the image: the pixels of the tile and the ones around it
+*   (radius pixels) are read from src, then a horizontal and a vertical
+*   pass are done on them. Every tile only uses a few kilobytes,
+*   so the two passes are done in the cache.
+*/
+void blurTile_( const uint8_t * src, SDL_Surface * dst, const Channels& c, const Pass& pass,
+                const int tx, const int ty )
+{
+    const int W = dst->w;
+    const int H = dst->h;
+    const int PITCH = dst->pitch;
+    const int R = static_cast<int>( pass.weights.size() / 2 );
+    const int K = static_cast<int>( pass.weights.size() );
+    const int X0 = tx * TILE_SIZE;
+    const int Y0 = ty * TILE_SIZE;
+    const int TW = std::min( TILE_SIZE, W - X0 );
+    const int TH = std::min( TILE_SIZE, H - Y0 );
+    const int RW = TW + 2 * R;
+    const int RH = TH + 2 * R;
+    const float * WEIGHTS = pass.weights.data();
+
+    std::vector<Float4> in( static_cast<size_t>( RW ) * RH );
+    std::vector<Float4> tmp( static_cast<size_t>( TW ) * RH );
+    std::vector<Float4> acc( static_cast<size_t>( TW ) );
+
+    // The pixels out of the image are the ones of the edges
+    for ( int j = 0; j < RH; ++j )
+    {
+        const uint32_t * ROW = reinterpret_cast<const uint32_t *>( src + clamp_( Y0 - R + j, H - 1 ) * PITCH );
+        Float4 * line = in.data() + j * RW;
+
+        for ( int i = 0; i < RW; ++i )
+            line[i] = applyOps_( unpack_( ROW[clamp_( X0 - R + i, W - 1 )], c ), pass.pre );
+    }
+
+    for ( int j = 0; j < RH; ++j )
+    {
+        const Float4 * LINE = in.data() + j * RW;
+        Float4 * out = tmp.data() + j * TW;
+
+        for ( int i = 0; i < TW; ++i )
+        {
+            Float4 sum = Float4{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+            for ( int k = 0; k < K; ++k )
+                sum += WEIGHTS[k] * LINE[i + k];
+
+            out[i] = sum;
+        }
+    }
+
+    // Line by line, so the inner loop reads contiguous pixels
+    for ( int j = 0; j < TH; ++j )
+    {
+        std::fill( acc.begin(), acc.end(), Float4{ 0.0f, 0.0f, 0.0f, 0.0f } );
+
+        for ( int k = 0; k < K; ++k )
+        {
+            const float WK = WEIGHTS[k];
+            const Float4 * LINE = tmp.data() + ( j + k ) * TW;
+
+            for ( int i = 0; i < TW; ++i )
+                acc[i] += WK * LINE[i];
+        }
+
+        uint32_t * row = reinterpret_cast<uint32_t *>( static_cast<uint8_t *>( dst->pixels )
+                         + ( Y0 + j ) * PITCH ) + X0;
+
+        for ( int i = 0; i < TW; ++i )
+            row[i] = pack_( applyOps_( acc[i], pass.post ), row[i], c );
+    }
+}
+
+// Run the tasks on the worker pool if there are many pixels to process
+void forEach_( const unsigned int n, const bool parallel,
+               const std::function<void( unsigned int )>& task )
+{
+    lx::Multithreading::WorkerPool * pool = nullptr;
+
+    if ( parallel )
+    {
+        try
+        {
+            pool = &lx::Multithreading::getWorkerPool();
+        }
+        catch ( std::exception& e )
+        {
+            lx::Log::logWarning( lx::Log::VIDEO, "image pipeline: %s", e.what() );
+        }
+    }
+
+    if ( pool != nullptr )
+        pool->parallelFor( n, task );
+    else
+    {
+        for ( unsigned int i = 0; i < n; ++i )
+            task( i );
+    }
+}
+
+void runPass_( SDL_Surface * surface, const Channels& c, const Pass& pass )
+{
+    const bool PARALLEL = static_cast<long>( surface->w ) * surface->h >= PARALLEL_PIXELS;
+
+    if ( pass.weights.empty() )
+    {
+        const unsigned int NB_BANDS = static_cast<unsigned int>( ( surface->h + BAND_ROWS - 1 ) / BAND_ROWS );
+
+        forEach_( NB_BANDS, PARALLEL, [&]( unsigned int band ) noexcept
+        {
+            const int FIRST = static_cast<int>( band ) * BAND_ROWS;
+            pixelRows_( surface, c, pass.pre, FIRST, std::min( FIRST + BAND_ROWS, surface->h ) );
+        } );
+        return;
+    }
+
+    // The tiles read the image before the blur, and write their own pixels
+    const uint8_t * PIXELS = static_cast<const uint8_t *>( surface->pixels );
+    const std::vector<uint8_t> SRC( PIXELS, PIXELS + static_cast<size_t>( surface->pitch ) * surface->h );
+    const unsigned int NX = static_cast<unsigned int>( ( surface->w + TILE_SIZE - 1 ) / TILE_SIZE );
+    const unsigned int NY = static_cast<unsigned int>( ( surface->h + TILE_SIZE - 1 ) / TILE_SIZE );
+
+    forEach_( NX * NY, PARALLEL, [&]( unsigned int t )
+    {
+        blurTile_( SRC.data(), surface, c, pass, static_cast<int>( t % NX ), static_cast<int>( t / NX ) );
+    } );
+}
+
+
+/* Resampling */
+
+// The source pixels (and their weight) of every destination pixel of a line
+struct Contributions final
+{
+    int taps;
+    std::vector<int> first;
+    std::vector<float> weights;     // taps weights per destination pixel
+};
+
+float support_( const lx::Graphics::ResizeFilter filter ) noexcept
+{
+    switch ( filter )
+    {
+    case lx::Graphics::ResizeFilter::BOX:
+        return 0.5f;
+
+    case lx::Graphics::ResizeFilter::BILINEAR:
+        return 1.0f;
+
+    default:
+        return 3.0f;
+    }
+}
+
+inline float sinc_( const float x ) noexcept
+{
+    const float PX = static_cast<float>( M_PI ) * x;
+    return std::abs( x ) < 1e-6f ? 1.0f : std::sin( PX ) / PX;
+}
+
+float weight_( const lx::Graphics::ResizeFilter filter, const float x ) noexcept
+{
+    switch ( filter )
+    {
+    case lx::Graphics::ResizeFilter::BOX:
+        return ( x >= -0.5f && x < 0.5f ) ? 1.0f : 0.0f;
+
+    case lx::Graphics::ResizeFilter::BILINEAR:
+        return std::max( 0.0f, 1.0f - std::abs( x ) );
+
+    default:
+        return std::abs( x ) < 3.0f ? sinc_( x ) * sinc_( x / 3.0f ) : 0.0f;
+    }
+}
+
+/*
+*   When the line is reduced, the filter is stretched, so every source pixel
+*   contributes to the result. The pixels out of the line are ignored,
+*   and the weights are normalized.
+*/
+Contributions contributions_( const int src, const int dst, const lx::Graphics::ResizeFilter filter )
+{
+    const float SCALE = static_cast<float>( src ) / static_cast<float>( dst );
+    const float FSCALE = std::max( SCALE, 1.0f );
+    const float SUPPORT = support_( filter ) * FSCALE;
+
+    std::vector<int> lo( static_cast<size_t>( dst ) );
+    std::vector<std::vector<float>> w( static_cast<size_t>( dst ) );
+    int taps = 1;
+
+    for ( int i = 0; i < dst; ++i )
+    {
+        const float CENTER = ( static_cast<float>( i ) + 0.5f ) * SCALE - 0.5f;
+        int first = std::max( 0, static_cast<int>( std::floor( CENTER - SUPPORT ) ) );
+        int last  = std::min( src - 1, static_cast<int>( std::ceil( CENTER + SUPPORT ) ) );
+
+        while ( first < last && weight_( filter, ( static_cast<float>( first ) - CENTER ) / FSCALE ) == 0.0f )
+            ++first;
+
+        while ( last > first && weight_( filter, ( static_cast<float>( last ) - CENTER ) / FSCALE ) == 0.0f )
+            --last;
+
+        std::vector<float>& wi = w[static_cast<size_t>( i )];
+        float sum = 0.0f;
+
+        for ( int j = first; j <= last; ++j )
+        {
+            wi.push_back( weight_( filter, ( static_cast<float>( j ) - CENTER ) / FSCALE ) );
+            sum += wi.back();
+        }
+
+        if ( sum == 0.0f )
+        {
+            // Nearest pixel
+            first = std::min( std::max( 0, static_cast<int>( CENTER + 0.5f ) ), src - 1 );
+            wi.assign( 1, 1.0f );
+            sum = 1.0f;
+        }
+
+        for ( float& v : wi )
+            v /= sum;
+
+        lo[static_cast<size_t>( i )] = first;
+        taps = std::max( taps, static_cast<int>( wi.size() ) );
+    }
+
+    // Every destination pixel has the same number of taps, so the loops are regular
+    Contributions c{ taps, std::vector<int>( static_cast<size_t>( dst ) ),
+                     std::vector<float>( static_cast<size_t>( dst ) * taps, 0.0f ) };
+
+    for ( size_t i = 0; i < static_cast<size_t>( dst ); ++i )
+    {
+        const int FIRST = std::min( lo[i], src - taps );
+        c.first[i] = FIRST;
+        std::copy( w[i].begin(), w[i].end(), c.weights.begin() + i * taps + ( lo[i] - FIRST ) );
+    }
+
+    return c;
+}
+
+inline Float4 premultiplied_( const Float4 p ) noexcept
+{
+    const float A = p[3] / 255.0f;
+    return p * Float4{ A, A, A, 1.0f };
+}
+
+inline Float4 unpremultiplied_( const Float4 p ) noexcept
+{
+    const float A = p[3] > 0.5f ? 255.0f / p[3] : 0.0f;
+    return p * Float4{ A, A, A, 1.0f };
+}
+
+/*
+*   Resample a 32-bit image (8-bit channels) into another one of the same format.
+*   The destination is processed by bands of rows: the source rows used by a band
+*   are resampled horizontally into a buffer, then the buffer is resampled vertically.
+*/
+void resample_( SDL_Surface * src, SDL_Surface * dst, const lx::Graphics::ResizeFilter filter )
+{
+    const SDL_PixelFormat * FMT = src->format;
+    const Channels C{ FMT->Rshift, FMT->Gshift, FMT->Bshift, FMT->Ashift, FMT->Amask != 0, 0U };
+    const Contributions CX = contributions_( src->w, dst->w, filter );
+    const Contributions CY = contributions_( src->h, dst->h, filter );
+    const int DW = dst->w;
+    const unsigned int NB_BANDS = static_cast<unsigned int>( ( dst->h + BAND_ROWS - 1 ) / BAND_ROWS );
+    const bool PARALLEL = std::max( static_cast<long>( src->w ) * src->h,
+                                    static_cast<long>( dst->w ) * dst->h ) >= PARALLEL_PIXELS;
+
+    if ( SDL_MUSTLOCK( src ) )
+        SDL_LockSurface( src );
+
+    if ( SDL_MUSTLOCK( dst ) )
+        SDL_LockSurface( dst );
+
+    try
+    {
+        forEach_( NB_BANDS, PARALLEL, [&]( unsigned int band )
+        {
+            const int Y0 = static_cast<int>( band ) * BAND_ROWS;
+            const int Y1 = std::min( Y0 + BAND_ROWS, dst->h );
+            const int SY0 = CY.first[static_cast<size_t>( Y0 )];
+            const int SY1 = CY.first[static_cast<size_t>( Y1 - 1 )] + CY.taps;
+
+            std::vector<Float4> line( static_cast<size_t>( src->w ) );
+            std::vector<Float4> tmp( static_cast<size_t>( SY1 - SY0 ) * DW );
+
+            for ( int sy = SY0; sy < SY1; ++sy )
+            {
+                const uint32_t * ROW = reinterpret_cast<const uint32_t *>( static_cast<const uint8_t *>( src->pixels )
+                                       + sy * src->pitch );
+                Float4 * out = tmp.data() + static_cast<size_t>( sy - SY0 ) * DW;
+
+                for ( int x = 0; x < src->w; ++x )
+                    line[static_cast<size_t>( x )] = premultiplied_( unpack_( ROW[x], C ) );
+
+                for ( int x = 0; x < DW; ++x )
+                {
+                    const Float4 * IN = line.data() + CX.first[static_cast<size_t>( x )];
+                    const float * W = CX.weights.data() + static_cast<size_t>( x ) * CX.taps;
+                    Float4 sum = Float4{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+                    for ( int k = 0; k < CX.taps; ++k )
+                        sum += W[k] * IN[k];
+
+                    out[x] = sum;
+                }
+            }
+
+            std::vector<Float4> acc( static_cast<size_t>( DW ) );
+
+            for ( int y = Y0; y < Y1; ++y )
+            {
+                const float * W = CY.weights.data() + static_cast<size_t>( y ) * CY.taps;
+                const int FIRST = CY.first[static_cast<size_t>( y )] - SY0;
+                std::fill( acc.begin(), acc.end(), Float4{ 0.0f, 0.0f, 0.0f, 0.0f } );
+
+                for ( int k = 0; k < CY.taps; ++k )
+                {
+                    const float WK = W[k];
+                    const Float4 * IN = tmp.data() + static_cast<size_t>( FIRST + k ) * DW;
+
+                    for ( int x = 0; x < DW; ++x )
+                        acc[static_cast<size_t>( x )] += WK * IN[x];
+                }
+
+                uint32_t * row = reinterpret_cast<uint32_t *>( static_cast<uint8_t *>( dst->pixels ) + y * dst->pitch );
+
+                for ( int x = 0; x < DW; ++x )
+                    row[x] = pack_( unpremultiplied_( acc[static_cast<size_t>( x )] ), 0U, C );
+            }
+        } );
+    }
+    catch ( ... )
+    {
+        if ( SDL_MUSTLOCK( dst ) )
+            SDL_UnlockSurface( dst );
+
+        if ( SDL_MUSTLOCK( src ) )
+            SDL_UnlockSurface( src );
+
+        throw;
+    }
+
+    if ( SDL_MUSTLOCK( dst ) )
+        SDL_UnlockSurface( dst );
+
+    if ( SDL_MUSTLOCK( src ) )
+        SDL_UnlockSurface( src );
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Graphics
+{
+
+BufferedImage& BufferedImage::convertGrayscale() noexcept
+{
+    filter_( m_surface, true );
+    return *this;
+}
+
+BufferedImage& BufferedImage::convertNegative() noexcept
+{
+    filter_( m_surface, false );
+    return *this;
+}
+
+ImagePipeline BufferedImage::pipeline()
+{
+    return ImagePipeline( *this );
+}
+
+BufferedImage * BufferedImage::resize( const int width, const int height,
+                                       const ResizeFilter filter ) const
+{
+    if ( width < 1 || height < 1 )
+        throw std::invalid_argument( "BufferedImage: the size of a resized image must be at least 1×1" );
+
+    // Any other format: RGBA8888, the new image is converted back by its constructor
+    SDL_Surface * tmp = nullptr;
+    SDL_Surface * src = m_surface;
+
+    if ( !is8888_( m_surface->format ) )
+    {
+        tmp = SDL_ConvertSurfaceFormat( m_surface, SDL_PIXELFORMAT_RGBA8888, 0 );
+
+        if ( tmp == nullptr )
+            throw ImageException( std::string( "BufferedImage — Cannot resize: " ) + SDL_GetError() );
+
+        src = tmp;
+    }
+
+    SDL_Surface * dst = SDL_CreateRGBSurfaceWithFormat( 0, width, height, 32, src->format->format );
+
+    if ( dst == nullptr )
+    {
+        SDL_FreeSurface( tmp );
+        throw ImageException( std::string( "BufferedImage — Cannot resize: " ) + SDL_GetError() );
+    }
+
+    try
+    {
+        resample_( src, dst, filter );
+    }
+    catch ( ... )
+    {
+        SDL_FreeSurface( dst );
+        SDL_FreeSurface( tmp );
+        throw;
+    }
+
+    SDL_FreeSurface( tmp );
+    return new BufferedImage( dst, m_filename.utf8_sstring(),
+                              static_cast<PixelFormat>( m_surface->format->format ) );
+}
+
+
+/* ImagePipeline, private implementation */
+
+class ImagePipeline_ final
+{
+    BufferedImage& m_image;
+    std::vector<Stage> m_stages;
+
+    ImagePipeline_( const ImagePipeline_& ) = delete;
+    ImagePipeline_& operator =( const ImagePipeline_& ) = delete;
+
+    // The consecutive matrices are already combined
+    std::vector<Pass> plan_() const
+    {
+        std::vector<Pass> passes;
+        std::vector<PixelOp> ops;
+
+        for ( const Stage& stage : m_stages )
+        {
+            if ( stage.type == StageType::MATRIX )
+                ops.push_back( matrixOp_( stage.matrix ) );
+
+            else if ( stage.type == StageType::PREMULTIPLY )
+                ops.push_back( PixelOp{ true, {} } );
+
+            else
+            {
+                passes.push_back( Pass{ ops, stage.weights, std::vector<PixelOp>() } );
+                ops.clear();
+            }
+        }
+
+        if ( passes.empty() )
+        {
+            if ( !ops.empty() )
+                passes.push_back( Pass{ ops, std::vector<float>(), std::vector<PixelOp>() } );
+        }
+        else
+            passes.back().post = ops;
+
+        return passes;
+    }
+
+    void run_( SDL_Surface * surface, const std::vector<Pass>& passes )
+    {
+        const SDL_PixelFormat * FMT = surface->format;
+        const Channels C{ FMT->Rshift, FMT->Gshift, FMT->Bshift, FMT->Ashift, FMT->Amask != 0,
+                          ~( FMT->Rmask | FMT->Gmask | FMT->Bmask | FMT->Amask ) };
+
+        if ( SDL_MUSTLOCK( surface ) )
+            SDL_LockSurface( surface );
+
+        try
+        {
+            for ( const Pass& pass : passes )
+                runPass_( surface, C, pass );
+        }
+        catch ( ... )
+        {
+            if ( SDL_MUSTLOCK( surface ) )
+                SDL_UnlockSurface( surface );
+
+            throw;
+        }
+
+        if ( SDL_MUSTLOCK( surface ) )
+            SDL_UnlockSurface( surface );
+    }
+
+public:
+
+    explicit ImagePipeline_( BufferedImage& image ) : m_image( image ), m_stages() {}
+
+    void addMatrix( const ColourMatrix& matrix )
+    {
+        if ( !m_stages.empty() && m_stages.back().type == StageType::MATRIX )
+            m_stages.back().matrix = compose_( m_stages.back().matrix, matrix );
+        else
+            m_stages.push_back( Stage{ StageType::MATRIX, matrix, std::vector<float>() } );
+    }
+
+    void addPremultiply()
+    {
+        m_stages.push_back( Stage{ StageType::PREMULTIPLY, IDENTITY_MATRIX, std::vector<float>() } );
+    }
+
+    void addBlur( const std::vector<float>& weights )
+    {
+        if ( weights.size() > 1 )
+            m_stages.push_back( Stage{ StageType::BLUR, IDENTITY_MATRIX, weights } );
+    }
+
+    size_t numberOfPasses() const noexcept
+    {
+        size_t n = 0;
+
+        for ( const Stage& stage : m_stages )
+        {
+            if ( stage.type == StageType::BLUR )
+                ++n;
+        }
+
+        return n == 0 ? ( m_stages.empty() ? 0 : 1 ) : n;
+    }
+
+    BufferedImage& apply()
+    {
+        const std::vector<Pass> PASSES = plan_();
+        m_stages.clear();
+
+        if ( PASSES.empty() )
+            return m_image;
+
+        SDL_Surface * surface = m_image.m_surface;
+
+        if ( is8888_( surface->format ) )
+        {
+            run_( surface, PASSES );
+            return m_image;
+        }
+
+        // Any other format: RGBA8888, then back to the format of the image
+        SDL_Surface * tmp = SDL_ConvertSurfaceFormat( surface, SDL_PIXELFORMAT_RGBA8888, 0 );
+
+        if ( tmp == nullptr )
+        {
+            lx::Log::logCritical( lx::Log::VIDEO, "image pipeline: %s", SDL_GetError() );
+            return m_image;
+        }
+
+        try
+        {
+            run_( tmp, PASSES );
+        }
+        catch ( ... )
+        {
+            SDL_FreeSurface( tmp );
+            throw;
+        }
+
+        SDL_Surface * result = SDL_ConvertSurfaceFormat( tmp, surface->format->format, 0 );
+        SDL_FreeSurface( tmp );
+
+        if ( result == nullptr )
+            lx::Log::logCritical( lx::Log::VIDEO, "image pipeline: %s", SDL_GetError() );
+        else
+        {
+            SDL_FreeSurface( surface );
+            m_image.m_surface = result;
+        }
+
+        return m_image;
+    }
+
+    ~ImagePipeline_() = default;
+};
+
+
+/* ImagePipeline */
+
+ImagePipeline::ImagePipeline( BufferedImage& image )
+    : m_pimpl( new ImagePipeline_( image ) ) {}
+
+ImagePipeline::ImagePipeline( ImagePipeline&& p ) noexcept
+    : m_pimpl( std::move( p.m_pimpl ) ) {}
+
+
+ImagePipeline& ImagePipeline::colourMatrix( const ColourMatrix& matrix )
+{
+    m_pimpl->addMatrix( matrix );
+    return *this;
+}
+
+ImagePipeline& ImagePipeline::tint( const Colour& colour )
+{
+    ColourMatrix m = IDENTITY_MATRIX;
+    m.m[0][0] = static_cast<float>( colour.r ) / 255.0f;
+    m.m[1][1] = static_cast<float>( colour.g ) / 255.0f;
+    m.m[2][2] = static_cast<float>( colour.b ) / 255.0f;
+    m.m[3][3] = static_cast<float>( colour.a ) / 255.0f;
+    return colourMatrix( m );
+}
+
+ImagePipeline& ImagePipeline::grayscale()
+{
+    const float RED_RATIO   = 0.2126f;
+    const float GREEN_RATIO = 0.7152f;
+    const float BLUE_RATIO  = 0.0722f;
+    ColourMatrix m = IDENTITY_MATRIX;
+
+    for ( int i = 0; i < 3; ++i )
+    {
+        m.m[i][0] = RED_RATIO;
+        m.m[i][1] = GREEN_RATIO;
+        m.m[i][2] = BLUE_RATIO;
+    }
+
+    return colourMatrix( m );
+}
+
+ImagePipeline& ImagePipeline::negative()
+{
+    ColourMatrix m = IDENTITY_MATRIX;
+
+    for ( int i = 0; i < 3; ++i )
+    {
+        m.m[i][i] = -1.0f;
+        m.m[i][4] = 1.0f;
+    }
+
+    return colourMatrix( m );
+}
+
+ImagePipeline& ImagePipeline::premultiply()
+{
+    m_pimpl->addPremultiply();
+    return *this;
+}
+
+
+ImagePipeline& ImagePipeline::blur( const int radius )
+{
+    if ( radius < 0 )
+        throw std::invalid_argument( "ImagePipeline: the radius of a blur must be positive" );
+
+    const size_t N = static_cast<size_t>( 2 * radius + 1 );
+    m_pimpl->addBlur( std::vector<float>( N, 1.0f / static_cast<float>( N ) ) );
+    return *this;
+}
+
+ImagePipeline& ImagePipeline::gaussianBlur( const float sigma )
+{
+    if ( sigma < 0.0f )
+        throw std::invalid_argument( "ImagePipeline: sigma must be positive" );
+
+    const int R = static_cast<int>( std::ceil( 3.0f * sigma ) );
+    std::vector<float> weights( static_cast<size_t>( 2 * R + 1 ) );
+    float sum = 0.0f;
+
+    for ( int k = -R; k <= R; ++k )
+    {
+        const float W = std::exp( -static_cast<float>( k * k ) / ( 2.0f * sigma * sigma ) );
+        weights[static_cast<size_t>( k + R )] = W;
+        sum += W;
+    }
+
+    for ( float& w : weights )
+        w /= sum;
+
+    m_pimpl->addBlur( weights );
+    return *this;
+}
+
+
+size_t ImagePipeline::numberOfPasses() const noexcept
+{
+    return m_pimpl->numberOfPasses();
+}
+
+BufferedImage& ImagePipeline::apply()
+{
+    return m_pimpl->apply();
+}
+
+ImagePipeline::~ImagePipeline()
+{
+    m_pimpl.reset();
+}
+
+}   // Graphics
+
+}   // lx
@@ -0,0 +1,155 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file SpriteBatch.cpp
+*   @brief The implementation of the sprite batch
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/SpriteBatch.hpp>
+#include <Lunatix/Texture.hpp>
+#include <Lunatix/Window.hpp>
+#include <Lunatix/Log.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+
+namespace
+{
+
+// A sprite to draw
+struct Entry final
+{
+    lx::Graphics::Sprite * sprite;
+    lx::Graphics::ImgRect box;
+    lx::Win::Window * window;
+};
+
+// Group the sprites by window
+inline bool entryOrder_( const Entry& a, const Entry& b ) noexcept
+{
+    return std::less<lx::Win::Window *>()( a.window, b.window );
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Graphics
+{
+
+/* Private implementation */
+
+/*
+*   The sprites are drawn by the batching mode of their window,
+*   so the grouping and the geometry are the same in both cases
+*/
+class SpriteBatch_ final
+{
+    std::vector<Entry> m_entries;
+
+    SpriteBatch_( const SpriteBatch_& ) = delete;
+    SpriteBatch_& operator =( const SpriteBatch_& ) = delete;
+
+public:
+
+    SpriteBatch_() : m_entries() {}
+
+    void add( Sprite& sprite, const ImgRect& box ) noexcept
+    {
+        try
+        {
+            m_entries.push_back( Entry{ &sprite, box, &sprite._win } );
+        }
+        catch ( std::exception& e )
+        {
+            lx::Log::logWarning( lx::Log::RENDER, "Sprite batch: %s", e.what() );
+            sprite.draw( box );
+        }
+    }
+
+    void flush() noexcept
+    {
+        // The sprites of a window stay in the order they were added
+        std::stable_sort( m_entries.begin(), m_entries.end(), entryOrder_ );
+        size_t first = 0;
+
+        while ( first < m_entries.size() )
+        {
+            lx::Win::Window& win = *m_entries[first].window;
+            size_t last = first;
+
+            win.beginSpriteBatch_();
+
+            while ( last < m_entries.size() && m_entries[last].window == &win )
+            {
+                m_entries[last].sprite->draw( m_entries[last].box );
+                ++last;
+            }
+
+            win.endSpriteBatch_();
+            first = last;
+        }
+
+        m_entries.clear();
+    }
+
+    void clear() noexcept
+    {
+        m_entries.clear();
+    }
+
+    size_t size() const noexcept
+    {
+        return m_entries.size();
+    }
+
+    ~SpriteBatch_() = default;
+};
+
+
+/* Public functions */
+
+SpriteBatch::SpriteBatch() : m_bimpl( new SpriteBatch_() ) {}
+
+void SpriteBatch::add( Sprite& sprite, const ImgRect& box ) noexcept
+{
+    m_bimpl->add( sprite, box );
+}
+
+void SpriteBatch::flush() noexcept
+{
+    m_bimpl->flush();
+}
+
+void SpriteBatch::clear() noexcept
+{
+    m_bimpl->clear();
+}
+
+size_t SpriteBatch::size() const noexcept
+{
+    return m_bimpl->size();
+}
+
+SpriteBatch::~SpriteBatch()
+{
+    m_bimpl.reset();
+}
+
+}   // Graphics
+
+}   // lx
@@ -17,6 +17,7 @@
 */
 
 #include <Lunatix/Texture.hpp>
+#include <Lunatix/CollisionMask.hpp>
 #include <Lunatix/TrueTypeFont.hpp>
 #include <Lunatix/Window.hpp>
 #include <Lunatix/Error.hpp>
@@ -24,7 +25,10 @@
 
 #include <SDL2/SDL_image.h>
 
+#include <algorithm>
 #include <functional>
+#include <stdexcept>
+#include <cstring>
 
 
 namespace
@@ -164,30 +168,36 @@ Texture::~Texture()
 // protected constructor
 Sprite::Sprite( SDL_Texture * t, lx::Win::Window& w,
                 const UTF8string& filename,
-                const ImgRect& area, PixelFormat format )
-    : Texture( t, w, format ), m_area( area ), m_filename( filename ) {}
+                const ImgRect& area, PixelFormat format, const bool owner )
+    : Texture( t, w, format ), m_area( area ), m_filename( filename ),
+      m_owner( owner ), m_levels() {}
 
 Sprite::Sprite( const std::string& filename, lx::Win::Window& w,
                 PixelFormat format )
-    : Texture( filename, w, format ), m_area(), m_filename( filename ) {}
+    : Texture( filename, w, format ), m_area(), m_filename( filename ),
+      m_owner( true ), m_levels() {}
 
 Sprite::Sprite( const std::string& filename, lx::Win::Window& w,
                 const ImgRect& area, PixelFormat format )
     : Texture( filename, w, format ), m_area( area ),
-      m_filename( filename ) {}
+      m_filename( filename ), m_owner( true ), m_levels() {}
 
 Sprite::Sprite( const UTF8string& filename, lx::Win::Window& w,
                 PixelFormat format )
-    : Texture( filename, w, format ), m_area(), m_filename( filename ) {}
+    : Texture( filename, w, format ), m_area(), m_filename( filename ),
+      m_owner( true ), m_levels() {}
 
 Sprite::Sprite( const UTF8string& filename, lx::Win::Window& w,
                 const ImgRect& area, PixelFormat format )
     : Texture( filename, w, format ), m_area( area ),
-      m_filename( filename ) {}
+      m_filename( filename ), m_owner( true ), m_levels() {}
 
 
 void Sprite::draw() noexcept
 {
+    if ( _win.queueCopy_( _texture, m_area, nullptr, 0.0, MirrorEffect::NONE ) )
+        return;
+
     const SDL_Rect SRC_RECT = sdl_rect_( m_area );
     const SDL_Rect * SRC_AREA = isNull_( SRC_RECT ) ? nullptr : &SRC_RECT;
     SDL_RenderCopy( render( _win.getRenderingSys_() ), _texture, SRC_AREA, nullptr );
@@ -206,20 +216,69 @@ void Sprite::draw( const ImgRect& box, const double angle ) noexcept
 
 void Sprite::draw( const ImgRect& box, const double angle, const MirrorEffect mirror ) noexcept
 {
+    ImgRect area;
+    SDL_Texture * texture = level_( box, area );
+
+    if ( _win.queueCopy_( texture, area, &box, -radianToDegree( angle ), mirror ) )
+        return;
+
     const SDL_Rect SDL_RECT = sdl_rect_( box );
-    const SDL_Rect SRC_RECT = sdl_rect_( m_area );
+    const SDL_Rect SRC_RECT = sdl_rect_( area );
     const SDL_Rect * SRC_AREA = isNull_( SRC_RECT ) ? nullptr : &SRC_RECT;
 
-    SDL_RenderCopyEx( render( _win.getRenderingSys_() ), _texture, SRC_AREA, &SDL_RECT,
+    SDL_RenderCopyEx( render( _win.getRenderingSys_() ), texture, SRC_AREA, &SDL_RECT,
                       ( -radianToDegree( angle ) ), nullptr, cast_( mirror ) );
 }
 
+SDL_Texture * Sprite::level_( const ImgRect& box, ImgRect& area ) const noexcept
+{
+    const size_t LEVEL = getLevel( box );
+
+    if ( LEVEL == 0 )
+    {
+        area = m_area;
+        return _texture;
+    }
+
+    area = m_levels[LEVEL - 1].area;
+    return m_levels[LEVEL - 1].texture;
+}
+
+size_t Sprite::getNumberOfLevels() const noexcept
+{
+    return m_levels.size() + 1;
+}
+
+// The smallest level that is at least as big as the box
+size_t Sprite::getLevel( const ImgRect& box ) const noexcept
+{
+    size_t level = 0;
+
+    while ( level < m_levels.size() && m_levels[level].area.w >= box.w
+            && m_levels[level].area.h >= box.h )
+    {
+        ++level;
+    }
+
+    return level;
+}
+
 
 UTF8string Sprite::getFileName() noexcept
 {
     return m_filename;
 }
 
+Sprite::~Sprite()
+{
+    for ( Level_& level : m_levels )
+        SDL_DestroyTexture( level.texture );
+
+    // The texture of an atlas is destroyed by the atlas
+    if ( !m_owner )
+        _texture = nullptr;
+}
+
 
 /** AnimatedSprite */
 
@@ -227,8 +286,9 @@ UTF8string Sprite::getFileName() noexcept
 AnimatedSprite::AnimatedSprite( SDL_Texture * t, lx::Win::Window& w,
                                 const std::vector<ImgRect>& coord,
                                 const uint32_t delay, bool loop,
-                                const UTF8string& filename, PixelFormat format )
-    : Sprite( t, w, filename, RNULL, format ), M_COORDINATES( coord ),
+                                const UTF8string& filename, PixelFormat format,
+                                const bool owner )
+    : Sprite( t, w, filename, RNULL, format, owner ), M_COORDINATES( coord ),
       M_NBCOORDINATES( coord.size() ), m_timer(), m_delay( delay ),
       m_frame( 0 ), m_loop( loop ), m_drawable( true ) {}
 
@@ -287,7 +347,8 @@ void AnimatedSprite::draw( const ImgRect& box, const double angle, const MirrorE
         m_timer.lap();
     }
 
-    if ( m_drawable )
+    if ( m_drawable && !_win.queueCopy_( _texture, M_COORDINATES[m_frame], &box,
+                                         -radianToDegree( angle ), mirror ) )
     {
         const SDL_Rect SDL_RECT = sdl_rect_( box );
         const SDL_Rect COORD = sdl_rect_( M_COORDINATES[m_frame] );
@@ -353,279 +414,121 @@ BufferedImage::BufferedImage( const UTF8string& filename, PixelFormat format )
     : BufferedImage( filename.utf8_sstring(), format ) {}
 
 
-bool BufferedImage::retrieveColours_( const uint32_t pixel, Uint8& r, Uint8& g,
-                                      Uint8& b, Uint8& a ) const noexcept
+BufferedImage::BufferedImage( const int width, const int height, PixelFormat format )
+    : m_surface( nullptr ), m_filename( "" )
 {
-    const PixelFormat fmt = static_cast<PixelFormat>( m_surface->format->format );
-    uint32_t tmp_r, tmp_g, tmp_b, tmp_a;
+    if ( width <= 0 || height <= 0 )
+        throw ImageException( "BufferedImage — Invalid size" );
 
-    switch ( fmt )
-    {
-    case PixelFormat::RGBA8888:
-        tmp_r = ( pixel >> 24 ) & 0xFF;
-        tmp_g = ( pixel >> 16 ) & 0xFF;
-        tmp_b = ( pixel >> 8 ) & 0xFF;
-        tmp_a = pixel & 0xFF;
-        break;
-
-    case PixelFormat::ARGB8888:
-        tmp_a = ( pixel >> 24 ) & 0xFF;
-        tmp_r = ( pixel >> 16 ) & 0xFF;
-        tmp_g = ( pixel >> 8 ) & 0xFF;
-        tmp_b = pixel & 0xFF;
-        break;
-
-    case PixelFormat::BGRA8888:
-        tmp_b = ( pixel >> 24 ) & 0xFF;
-        tmp_g = ( pixel >> 16 ) & 0xFF;
-        tmp_r = ( pixel >> 8 ) & 0xFF;
-        tmp_a = pixel & 0xFF;
-        break;
-
-    case PixelFormat::ABGR8888:
-        tmp_a = ( pixel >> 24 ) & 0xFF;
-        tmp_b = ( pixel >> 16 ) & 0xFF;
-        tmp_g = ( pixel >> 8 ) & 0xFF;
-        tmp_r = pixel & 0xFF;
-        break;
-
-    case PixelFormat::RGBA4444:
-        tmp_r = ( pixel >> 12 ) & 0xFF;
-        tmp_g = ( pixel >> 8 ) & 0xFF;
-        tmp_b = ( pixel >> 4 ) & 0xFF;
-        tmp_a = pixel & 0xFF;
-        break;
-
-    case PixelFormat::ARGB4444:
-        tmp_a = ( pixel >> 12 ) & 0xFF;
-        tmp_r = ( pixel >> 8 ) & 0xFF;
-        tmp_g = ( pixel >> 4 ) & 0xFF;
-        tmp_b = pixel & 0xFF;
-        break;
-
-    case PixelFormat::BGRA4444:
-        tmp_b = ( pixel >> 12 ) & 0xFF;
-        tmp_g = ( pixel >> 8 ) & 0xFF;
-        tmp_r = ( pixel >> 4 ) & 0xFF;
-        tmp_a = pixel & 0xFF;
-        break;
-
-    case PixelFormat::ABGR4444:
-        tmp_a = ( pixel >> 12 ) & 0xFF;
-        tmp_b = ( pixel >> 8 ) & 0xFF;
-        tmp_g = ( pixel >> 4 ) & 0xFF;
-        tmp_r = pixel & 0xFF;
-        break;
-
-    case PixelFormat::RGB24:
-    case PixelFormat::RGB888:
-        tmp_r = ( pixel >> 16 ) & 0xFF;
-        tmp_g = ( pixel >> 8 ) & 0xFF;
-        tmp_b = pixel & 0xFF;
-        break;
-
-    case PixelFormat::BGR24:
-    case PixelFormat::BGR888:
-        tmp_b = ( pixel >> 12 ) & 0xFF;
-        tmp_g = ( pixel >> 8 ) & 0xFF;
-        tmp_r = ( pixel >> 4 ) & 0xFF;
-        break;
-
-    default:
-        return false;
-        break;
-    }
+    m_surface = SDL_CreateRGBSurfaceWithFormat( 0, width, height,
+                SDL_BITSPERPIXEL( u32( format ) ), u32( format ) );
 
-    r = static_cast<uint8_t>( tmp_r );
-    g = static_cast<uint8_t>( tmp_g );
-    b = static_cast<uint8_t>( tmp_b );
-    a = static_cast<uint8_t>( tmp_a );
-    return true;
+    if ( m_surface == nullptr )
+        throw ImageException( std::string( "BufferedImage — " ) + lx::getError() );
 }
 
 
-uint32_t BufferedImage::updateGrayscaleColour_( const Uint8 alpha, const Uint8 v ) const noexcept
+lx::Physics::CollisionMask BufferedImage::generateCollisionMask( const uint8_t alpha,
+        const int scale ) const
 {
-    uint32_t npixel = 0;
-    PixelFormat fmt = static_cast<PixelFormat>( m_surface->format->format );
+    if ( scale < 1 )
+        throw std::invalid_argument( "BufferedImage: the scale of a mask must be at least 1" );
 
-    switch ( fmt )
+    const SDL_PixelFormat * FMT = m_surface->format;
+    // Usual case: 32-bit pixels, read the alpha channel directly
+    const bool DIRECT = FMT->BytesPerPixel == 4 && FMT->Amask != 0;
+    const bool HAS_ALPHA = FMT->Amask != 0 || FMT->palette != nullptr;
+    const int W = m_surface->w;
+    const int H = m_surface->h;
+    lx::Physics::CollisionMask mask( ( W + scale - 1 ) / scale, ( H + scale - 1 ) / scale, scale );
+
+    if ( SDL_MUSTLOCK( m_surface ) )
+        SDL_LockSurface( m_surface );
+
+    for ( int y = 0; y < H; ++y )
     {
-    case PixelFormat::RGBA8888:
-        npixel = static_cast<uint32_t>( ( v << 24 ) | ( v << 16 ) | ( v << 8 ) | alpha );
-        break;
-
-    case PixelFormat::ARGB8888:
-        npixel = static_cast<uint32_t>( ( alpha << 24 ) | ( v << 16 ) | ( v << 8 ) | v );
-        break;
-
-    case PixelFormat::BGRA8888:
-        npixel = static_cast<uint32_t>( ( v << 24 ) | ( v << 16 ) | ( v << 8 ) | alpha );
-        break;
-
-    case PixelFormat::ABGR8888:
-        npixel = static_cast<uint32_t>( ( alpha << 24 ) | ( v << 16 ) | ( v << 8 ) | v );
-        break;
-
-    case PixelFormat::RGBA4444:
-        npixel = static_cast<uint32_t>( ( v << 12 ) | ( v << 8 ) | ( v << 4 ) | alpha );
-        break;
-
-    case PixelFormat::ARGB4444:
-        npixel = static_cast<uint32_t>( ( alpha << 12 ) | ( v << 8 ) | ( v << 4 ) | v );
-        break;
-
-    case PixelFormat::BGRA4444:
-        npixel = static_cast<uint32_t>( ( v << 12 ) | ( v << 8 ) | ( v << 4 ) | alpha );
-        break;
-
-    case PixelFormat::ABGR4444:
-        npixel = static_cast<uint32_t>( ( alpha << 12 ) | ( v << 8 ) | ( v << 4 ) | v );
-        break;
-
-    case PixelFormat::BGR24:
-    case PixelFormat::RGB24:
-    case PixelFormat::BGR888:
-    case PixelFormat::RGB888:
-        npixel = static_cast<uint32_t>( ( v << 16 ) | ( v << 8 ) | v );
-        break;
-
-    default:
-        break;
-    }
+        const Uint8 * row = static_cast<const Uint8 *>( m_surface->pixels ) + y * m_surface->pitch;
 
-    return npixel;
-}
+        for ( int x = 0; x < W; ++x )
+        {
+            bool solid = true;
 
+            if ( DIRECT )
+            {
+                const uint32_t PIXEL = reinterpret_cast<const uint32_t *>( row )[x];
+                solid = ( ( ( PIXEL & FMT->Amask ) >> FMT->Ashift ) << FMT->Aloss ) >= alpha;
+            }
+            else if ( HAS_ALPHA )
+            {
+                const Uint8 * P = row + x * FMT->BytesPerPixel;
+                uint32_t pixel = 0;
+                Uint8 r, g, b, a;
+                std::memcpy( &pixel, P, FMT->BytesPerPixel );
 
-uint32_t BufferedImage::convertGrayscalePixel_( const uint32_t pixel ) const noexcept
-{
-    const float RED_RATIO   = 0.212671f;
-    const float GREEN_RATIO = 0.715160f;
-    const float BLUE_RATIO  = 0.072169f;
+                if ( SDL_BYTEORDER == SDL_BIG_ENDIAN )
+                    pixel >>= ( 4 - FMT->BytesPerPixel ) * 8;
 
-    Uint8 red = 0, green = 0, blue = 0, alpha = 0;
+                SDL_GetRGBA( pixel, FMT, &r, &g, &b, &a );
+                solid = a >= alpha;
+            }
 
-    if ( !retrieveColours_( pixel, red, green, blue, alpha ) )
-    {
-        lx::Log::logCritical( lx::Log::VIDEO, "convert image: Unrecognized format" );
-        return pixel;
+            if ( solid )
+                mask.set( x / scale, y / scale, true );
+        }
     }
 
-    const float R = static_cast<float>( red );
-    const float G = static_cast<float>( green );
-    const float B = static_cast<float>( blue );
+    if ( SDL_MUSTLOCK( m_surface ) )
+        SDL_UnlockSurface( m_surface );
 
-    const Uint8 V = static_cast<Uint8>( RED_RATIO * R + GREEN_RATIO * G + BLUE_RATIO * B );
-    return updateGrayscaleColour_( alpha, V );
+    return mask;
 }
 
-
-uint32_t
-BufferedImage::updateNegativeColour_( const Uint8 r, const Uint8 g,
-                                      const Uint8 b, const Uint8 a ) const noexcept
+// The address of the pixel (x, y), the rows may be padded
+uint8_t * BufferedImage::pixel_( const int x, const int y ) const
 {
-    uint32_t npixel = 0;
-    PixelFormat fmt = static_cast<PixelFormat>( m_surface->format->format );
-
-    switch ( fmt )
-    {
-    case PixelFormat::RGBA8888:
-        npixel = static_cast<uint32_t>( ( r << 24 ) | ( g << 16 ) | ( b << 8 ) | a );
-        break;
-
-    case PixelFormat::ARGB8888:
-        npixel = static_cast<uint32_t>( ( a << 24 ) | ( r << 16 ) | ( g << 8 ) | b );
-        break;
-
-    case PixelFormat::BGRA8888:
-        npixel = static_cast<uint32_t>( ( r << 24 ) | ( g << 16 ) | ( b << 8 ) | a );
-        break;
-
-    case PixelFormat::ABGR8888:
-        npixel = static_cast<uint32_t>( ( a << 24 ) | ( r << 16 ) | ( g << 8 ) | b );
-        break;
-
-    case PixelFormat::RGBA4444:
-        npixel = static_cast<uint32_t>( ( r << 12 ) | ( g << 8 ) | ( b << 4 ) | a );
-        break;
-
-    case PixelFormat::ARGB4444:
-        npixel = static_cast<uint32_t>( ( a << 12 ) | ( r << 8 ) | ( g << 4 ) | b );
-        break;
-
-    case PixelFormat::BGRA4444:
-        npixel = static_cast<uint32_t>( ( b << 12 ) | ( g << 8 ) | ( r << 4 ) | a );
-        break;
-
-    case PixelFormat::ABGR4444:
-        npixel = static_cast<uint32_t>( ( a << 12 ) | ( r << 8 ) | ( g << 4 ) | b );
-        break;
-
-    case PixelFormat::BGR24:
-    case PixelFormat::BGR888:
-        npixel = static_cast<uint32_t>( ( b << 16 ) | ( g << 8 ) | r );
-        break;
-
-    case PixelFormat::RGB24:
-    case PixelFormat::RGB888:
-        npixel = static_cast<uint32_t>( ( r << 16 ) | ( g << 8 ) | b );
-        break;
-
-    default:
-        break;
-    }
+    if ( x < 0 || y < 0 || x >= m_surface->w || y >= m_surface->h )
+        throw std::invalid_argument( "BufferedImage: the pixel is not in the image" );
 
-    return npixel;
+    return static_cast<uint8_t *>( m_surface->pixels ) + y * m_surface->pitch
+           + x * m_surface->format->BytesPerPixel;
 }
 
-
-uint32_t BufferedImage::convertNegativePixel_( const uint32_t pixel ) const noexcept
+Colour BufferedImage::getPixel( const int x, const int y ) const
 {
-    Uint8 red = 0, green = 0, blue = 0, alpha = 0;
-
-    if ( !retrieveColours_( pixel, red, green, blue, alpha ) )
-    {
-        lx::Log::logCritical( lx::Log::VIDEO, "convert image: Unrecognized format" );
-        return pixel;
-    }
+    const int BPP = m_surface->format->BytesPerPixel;
+    uint32_t pixel = 0;
+    Colour c = { 0, 0, 0, 0 };
 
-    const Uint8 MAX_UINT = 255;
-    const std::minus<Uint8> MINUS;
-    const Uint8 R = MINUS( MAX_UINT, red );
-    const Uint8 G = MINUS( MAX_UINT, green );
-    const Uint8 B = MINUS( MAX_UINT, blue );
-
-    return updateNegativeColour_( R, G, B, alpha );
-}
+    if ( SDL_MUSTLOCK( m_surface ) )
+        SDL_LockSurface( m_surface );
 
+    std::memcpy( &pixel, pixel_( x, y ), static_cast<size_t>( BPP ) );
 
-BufferedImage& BufferedImage::convertGrayscale() noexcept
-{
-    const long NBPIXELS = m_surface->w * m_surface->h;
-    uint32_t * pixels = static_cast<uint32_t *>( m_surface->pixels );
+    if ( SDL_MUSTLOCK( m_surface ) )
+        SDL_UnlockSurface( m_surface );
 
-    for ( long i = 0; i < NBPIXELS; ++i )
-    {
-        const uint32_t pixel = pixels[i];
-        pixels[i] = convertGrayscalePixel_( pixel );
-    }
+    if ( SDL_BYTEORDER == SDL_BIG_ENDIAN )
+        pixel >>= ( 4 - BPP ) * 8;
 
-    return *this;
+    SDL_GetRGBA( pixel, m_surface->format, &c.r, &c.g, &c.b, &c.a );
+    return c;
 }
 
-BufferedImage& BufferedImage::convertNegative() noexcept
+void BufferedImage::setPixel( const int x, const int y, const Colour& c )
 {
-    const long NBPIXELS = m_surface->w * m_surface->h;
-    uint32_t * pixels = static_cast<uint32_t *>( m_surface->pixels );
+    const int BPP = m_surface->format->BytesPerPixel;
+    uint32_t pixel = SDL_MapRGBA( m_surface->format, c.r, c.g, c.b, c.a );
 
-    for ( long i = 0; i < NBPIXELS; ++i )
-    {
-        const uint32_t pixel = pixels[i];
-        pixels[i] = convertNegativePixel_( pixel );
-    }
+    if ( SDL_BYTEORDER == SDL_BIG_ENDIAN )
+        pixel <<= ( 4 - BPP ) * 8;
+
+    if ( SDL_MUSTLOCK( m_surface ) )
+        SDL_LockSurface( m_surface );
 
-    return *this;
+    std::memcpy( pixel_( x, y ), &pixel, static_cast<size_t>( BPP ) );
+
+    if ( SDL_MUSTLOCK( m_surface ) )
+        SDL_UnlockSurface( m_surface );
 }
 
 Sprite * BufferedImage::generateSprite( lx::Win::Window& w, const ImgRect& area ) const
@@ -643,6 +546,59 @@ generateAnimatedSprite( lx::Win::Window& w, const std::vector<ImgRect>& coord,
 }
 
 
+std::vector<std::unique_ptr<BufferedImage>>
+BufferedImage::generateMipmaps( const ResizeFilter filter, const size_t max_levels ) const
+{
+    std::vector<std::unique_ptr<BufferedImage>> chain;
+    const BufferedImage * level = this;
+
+    // Every level is computed from the previous one
+    while ( ( level->m_surface->w > 1 || level->m_surface->h > 1 )
+            && ( max_levels == 0 || chain.size() < max_levels ) )
+    {
+        const int W = std::max( 1, level->m_surface->w / 2 );
+        const int H = std::max( 1, level->m_surface->h / 2 );
+        chain.emplace_back( level->resize( W, H, filter ) );
+        level = chain.back().get();
+    }
+
+    return chain;
+}
+
+Sprite * BufferedImage::generateMipmappedSprite( lx::Win::Window& w, const ImgRect& area,
+        const ResizeFilter filter ) const
+{
+    const std::vector<std::unique_ptr<BufferedImage>> CHAIN = generateMipmaps( filter );
+    std::unique_ptr<Sprite> sprite( generateSprite( w, area ) );
+    SDL_Renderer * renderer = render( w.getRenderingSys_() );
+    const bool WHOLE = area.w <= 0 || area.h <= 0;
+    const int W = m_surface->w;
+    const int H = m_surface->h;
+
+    sprite->m_levels.reserve( CHAIN.size() );
+
+    for ( const std::unique_ptr<BufferedImage>& level : CHAIN )
+    {
+        const int LW = level->m_surface->w;
+        const int LH = level->m_surface->h;
+        SDL_Texture * texture = SDL_CreateTextureFromSurface( renderer, level->m_surface );
+
+        if ( texture == nullptr )
+        {
+            lx::Log::logWarning( lx::Log::RENDER, "mipmapped sprite: %s", SDL_GetError() );
+            break;
+        }
+
+        const ImgRect LEVEL_AREA = WHOLE ? ImgRect{ { 0, 0 }, LW, LH } :
+                                   ImgRect{ { area.p.x * LW / W, area.p.y * LH / H },
+                                            std::max( 1, area.w * LW / W ), std::max( 1, area.h * LH / H ) };
+        sprite->m_levels.push_back( Sprite::Level_{ texture, LEVEL_AREA } );
+    }
+
+    return sprite.release();
+}
+
+
 UTF8string BufferedImage::getFileName() noexcept
 {
     return m_filename;
@@ -0,0 +1,452 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file TextureAtlas.cpp
+*   @brief The implementation of the texture atlas
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/TextureAtlas.hpp>
+#include <Lunatix/Texture.hpp>
+#include <Lunatix/Window.hpp>
+
+#include <SDL2/SDL_render.h>
+#include <SDL2/SDL_surface.h>
+#include <SDL2/SDL_pixels.h>
+
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+
+
+namespace
+{
+
+inline SDL_Renderer * render( void * r ) noexcept
+{
+    return static_cast<SDL_Renderer *>( r );
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Graphics
+{
+
+/* SkylinePacker */
+
+SkylinePacker::SkylinePacker( const int width, const int height )
+    : m_width( width ), m_height( height ), m_used_width( 0 ), m_used_height( 0 ),
+      m_area( 0L ), m_skyline()
+{
+    clear();
+}
+
+
+// The lowest y where a rectangle w × h can be put at the left edge of the node i, -1 if it does not fit
+int SkylinePacker::fit_( const size_t i, const int w, const int h ) const noexcept
+{
+    if ( m_skyline[i].x + w > m_width )
+        return -1;
+
+    int y = m_skyline[i].y;
+    int width_left = w;
+
+    for ( size_t j = i; width_left > 0; ++j )
+    {
+        y = std::max( y, m_skyline[j].y );
+
+        if ( y + h > m_height )
+            return -1;
+
+        width_left -= m_skyline[j].w;
+    }
+
+    return y;
+}
+
+
+bool SkylinePacker::insert( const int w, const int h, ImgRect& rect )
+{
+    if ( w <= 0 || h <= 0 )
+        return false;
+
+    const size_t NONE = static_cast<size_t>( -1 );
+    size_t best = NONE;
+    int best_y = 0, best_width = 0;
+
+    // The lowest top edge, then the narrowest segment
+    for ( size_t i = 0; i < m_skyline.size(); ++i )
+    {
+        const int Y = fit_( i, w, h );
+
+        if ( Y >= 0 && ( best == NONE || Y < best_y
+                         || ( Y == best_y && m_skyline[i].w < best_width ) ) )
+        {
+            best = i;
+            best_y = Y;
+            best_width = m_skyline[i].w;
+        }
+    }
+
+    if ( best == NONE )
+        return false;
+
+    rect = ImgRect{ ImgCoord{ m_skyline[best].x, best_y }, w, h };
+    m_skyline.insert( m_skyline.begin() + static_cast<long>( best ), Node{ rect.p.x, best_y + h, w } );
+
+    // The segments under the new one are shortened or removed
+    const int RIGHT = rect.p.x + w;
+    size_t i = best + 1;
+
+    while ( i < m_skyline.size() && m_skyline[i].x < RIGHT )
+    {
+        const int SHRINK = RIGHT - m_skyline[i].x;
+
+        if ( m_skyline[i].w <= SHRINK )
+        {
+            m_skyline.erase( m_skyline.begin() + static_cast<long>( i ) );
+        }
+        else
+        {
+            m_skyline[i].x += SHRINK;
+            m_skyline[i].w -= SHRINK;
+            break;
+        }
+    }
+
+    // Merge the neighbours at the same height
+    for ( size_t j = 0; j + 1 < m_skyline.size(); )
+    {
+        if ( m_skyline[j].y == m_skyline[j + 1].y )
+        {
+            m_skyline[j].w += m_skyline[j + 1].w;
+            m_skyline.erase( m_skyline.begin() + static_cast<long>( j + 1 ) );
+        }
+        else
+            ++j;
+    }
+
+    m_used_width = std::max( m_used_width, RIGHT );
+    m_used_height = std::max( m_used_height, best_y + h );
+    m_area += static_cast<long>( w ) * static_cast<long>( h );
+    return true;
+}
+
+
+void SkylinePacker::clear() noexcept
+{
+    m_skyline.clear();
+    m_skyline.push_back( Node{ 0, 0, m_width } );
+    m_used_width = 0;
+    m_used_height = 0;
+    m_area = 0L;
+}
+
+
+int SkylinePacker::getUsedWidth() const noexcept
+{
+    return m_used_width;
+}
+
+int SkylinePacker::getUsedHeight() const noexcept
+{
+    return m_used_height;
+}
+
+float SkylinePacker::getOccupancy() const noexcept
+{
+    const long USED = static_cast<long>( m_used_width ) * static_cast<long>( m_used_height );
+    return USED == 0L ? 0.0f : static_cast<float>( m_area ) / static_cast<float>( USED );
+}
+
+
+/* TextureAtlas — private implementation */
+
+class TextureAtlas_ final
+{
+    struct Entry
+    {
+        std::string name;
+        SDL_Surface * surface;  // Released after the build
+        size_t page;
+        ImgRect area;
+    };
+
+    lx::Win::Window& m_win;
+    const int M_PAGE_WIDTH;
+    const int M_PAGE_HEIGHT;
+    const int M_PADDING;
+    PixelFormat m_format;
+    std::vector<Entry> m_entries;
+    std::unordered_map<std::string, size_t> m_names;
+    std::vector<SDL_Texture *> m_pages;
+    bool m_built;
+
+    TextureAtlas_( const TextureAtlas_& ) = delete;
+    TextureAtlas_& operator =( const TextureAtlas_& ) = delete;
+
+    const Entry& entry_( const std::string& name ) const
+    {
+        const auto IT = m_names.find( name );
+
+        if ( IT == m_names.end() )
+            throw ImageException( "TextureAtlas: no image called " + name );
+
+        if ( !m_built )
+            throw ImageException( "TextureAtlas: the atlas is not built" );
+
+        return m_entries[IT->second];
+    }
+
+    void releaseSurfaces_() noexcept
+    {
+        for ( Entry& e : m_entries )
+        {
+            SDL_FreeSurface( e.surface );
+            e.surface = nullptr;
+        }
+    }
+
+    // Copy the images of a page in a surface, then create the texture
+    SDL_Texture * createPage_( const size_t page, const int width, const int height ) const
+    {
+        const uint32_t FORMAT = static_cast<uint32_t>( m_format );
+        SDL_Surface * surface = SDL_CreateRGBSurfaceWithFormat( 0, width, height,
+                                SDL_BITSPERPIXEL( FORMAT ), FORMAT );
+
+        if ( surface == nullptr )
+            return nullptr;
+
+        for ( const Entry& e : m_entries )
+        {
+            if ( e.page != page )
+                continue;
+
+            SDL_Rect dst{ e.area.p.x, e.area.p.y, e.area.w, e.area.h };
+            // Copy the alpha channel instead of blending the image
+            SDL_SetSurfaceBlendMode( e.surface, SDL_BLENDMODE_NONE );
+            SDL_BlitSurface( e.surface, nullptr, surface, &dst );
+        }
+
+        SDL_Texture * texture = SDL_CreateTextureFromSurface( render( m_win.getRenderingSys_() ), surface );
+        SDL_FreeSurface( surface );
+        return texture;
+    }
+
+public:
+
+    TextureAtlas_( lx::Win::Window& w, const int page_width, const int page_height,
+                   const int padding, PixelFormat format )
+        : m_win( w ), M_PAGE_WIDTH( page_width ), M_PAGE_HEIGHT( page_height ),
+          M_PADDING( std::max( padding, 0 ) ), m_format( format ), m_entries(), m_names(),
+          m_pages(), m_built( false ) {}
+
+    void add( const std::string& name, const BufferedImage& image )
+    {
+        if ( m_built )
+            throw ImageException( "TextureAtlas: the atlas is already built" );
+
+        if ( m_names.find( name ) != m_names.end() )
+            throw ImageException( "TextureAtlas: the name " + name + " is already used" );
+
+        const int W = image.m_surface->w;
+        const int H = image.m_surface->h;
+
+        if ( W <= 0 || H <= 0 || W > M_PAGE_WIDTH || H > M_PAGE_HEIGHT )
+            throw ImageException( "TextureAtlas: " + name + " is empty or bigger than a page" );
+
+        SDL_Surface * copy = SDL_ConvertSurfaceFormat( image.m_surface,
+                             static_cast<uint32_t>( m_format ), 0 );
+
+        if ( copy == nullptr )
+            throw ImageException( "TextureAtlas: cannot copy " + name );
+
+        m_names.insert( std::make_pair( name, m_entries.size() ) );
+        m_entries.push_back( Entry{ name, copy, 0, ImgRect{ ImgCoord{ 0, 0 }, W, H } } );
+    }
+
+    void build()
+    {
+        if ( m_built )
+            return;
+
+        // From the highest to the smallest image
+        std::vector<size_t> order( m_entries.size() );
+        std::iota( order.begin(), order.end(), 0 );
+        std::sort( order.begin(), order.end(), [this]( const size_t a, const size_t b )
+        {
+            const ImgRect& A = m_entries[a].area;
+            const ImgRect& B = m_entries[b].area;
+            return A.h > B.h || ( A.h == B.h && A.w > B.w );
+        } );
+
+        // The padding is after every image, so an image as big as a page fits in it
+        std::vector<SkylinePacker> packers;
+
+        for ( const size_t I : order )
+        {
+            Entry& e = m_entries[I];
+            ImgRect r;
+            size_t page = 0;
+
+            while ( page < packers.size()
+                    && !packers[page].insert( e.area.w + M_PADDING, e.area.h + M_PADDING, r ) )
+                ++page;
+
+            if ( page == packers.size() )
+            {
+                packers.emplace_back( M_PAGE_WIDTH + M_PADDING, M_PAGE_HEIGHT + M_PADDING );
+                packers.back().insert( e.area.w + M_PADDING, e.area.h + M_PADDING, r );
+            }
+
+            e.page = page;
+            e.area.p = r.p;
+        }
+
+        for ( size_t p = 0; p < packers.size(); ++p )
+        {
+            SDL_Texture * t = createPage_( p, std::min( packers[p].getUsedWidth(), M_PAGE_WIDTH ),
+                                           std::min( packers[p].getUsedHeight(), M_PAGE_HEIGHT ) );
+
+            if ( t == nullptr )
+                throw ImageException( "TextureAtlas: cannot create a page" );
+
+            m_pages.push_back( t );
+        }
+
+        releaseSurfaces_();
+        m_built = true;
+    }
+
+    bool contains( const std::string& name ) const noexcept
+    {
+        return m_names.find( name ) != m_names.end();
+    }
+
+    ImgRect getArea( const std::string& name ) const
+    {
+        return entry_( name ).area;
+    }
+
+    size_t numberOfPages() const noexcept
+    {
+        return m_pages.size();
+    }
+
+    Sprite * generateSprite( const std::string& name, const ImgRect * area ) const
+    {
+        const Entry& E = entry_( name );
+        const ImgRect AREA = area == nullptr ? E.area
+                             : ImgRect{ ImgCoord{ E.area.p.x + area->p.x, E.area.p.y + area->p.y },
+                                        area->w, area->h };
+
+        return new Sprite( m_pages[E.page], m_win, UTF8string( name ), AREA, m_format, false );
+    }
+
+    AnimatedSprite * generateAnimatedSprite( const std::string& name, const std::vector<ImgRect>& coord,
+            const uint32_t delay, bool loop ) const
+    {
+        const Entry& E = entry_( name );
+        std::vector<ImgRect> frames( coord );
+
+        for ( ImgRect& f : frames )
+        {
+            f.p.x += E.area.p.x;
+            f.p.y += E.area.p.y;
+        }
+
+        return new AnimatedSprite( m_pages[E.page], m_win, frames, delay, loop,
+                                   UTF8string( name ), m_format, false );
+    }
+
+    ~TextureAtlas_()
+    {
+        releaseSurfaces_();
+
+        for ( SDL_Texture * t : m_pages )
+            SDL_DestroyTexture( t );
+    }
+};
+
+
+/* TextureAtlas — public functions */
+
+TextureAtlas::TextureAtlas( lx::Win::Window& w, const int page_width, const int page_height,
+                            const int padding, PixelFormat format )
+    : m_aimpl( new TextureAtlas_( w, page_width, page_height, padding, format ) ) {}
+
+
+void TextureAtlas::add( const std::string& name, const BufferedImage& image )
+{
+    m_aimpl->add( name, image );
+}
+
+void TextureAtlas::add( const std::string& filename )
+{
+    const BufferedImage IMAGE( filename );
+    m_aimpl->add( filename, IMAGE );
+}
+
+void TextureAtlas::add( const UTF8string& filename )
+{
+    add( filename.utf8_sstring() );
+}
+
+void TextureAtlas::build()
+{
+    m_aimpl->build();
+}
+
+bool TextureAtlas::contains( const std::string& name ) const noexcept
+{
+    return m_aimpl->contains( name );
+}
+
+ImgRect TextureAtlas::getArea( const std::string& name ) const
+{
+    return m_aimpl->getArea( name );
+}
+
+size_t TextureAtlas::numberOfPages() const noexcept
+{
+    return m_aimpl->numberOfPages();
+}
+
+Sprite * TextureAtlas::generateSprite( const std::string& name ) const
+{
+    return m_aimpl->generateSprite( name, nullptr );
+}
+
+Sprite * TextureAtlas::generateSprite( const std::string& name, const ImgRect& area ) const
+{
+    return m_aimpl->generateSprite( name, &area );
+}
+
+AnimatedSprite * TextureAtlas::generateAnimatedSprite( const std::string& name,
+        const std::vector<ImgRect>& coord,
+        const uint32_t delay, bool loop ) const
+{
+    return m_aimpl->generateAnimatedSprite( name, coord, delay, loop );
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    m_aimpl.reset();
+}
+
+}   // Graphics
+
+}   // lx
@@ -21,10 +21,16 @@
 #include <Lunatix/Error.hpp>
 #include <Lunatix/ImgRect.hpp>
 #include <Lunatix/Hitbox.hpp>
+#include <Lunatix/Log.hpp>
 
 #include <SDL2/SDL_image.h>
+#include <SDL2/SDL_version.h>
 #include <GL/gl.h>
 
+#include <algorithm>
+#include <exception>
+#include <cmath>
+
 
 namespace
 {
@@ -239,6 +245,90 @@ SDL_BlendMode sdlBlend_( const lx::Win::BlendMode& mode ) noexcept
     return m;
 }
 
+
+// A sprite draw recorded in batching mode
+struct DrawCommand final
+{
+    int layer;
+    SDL_Texture * texture;
+    SDL_BlendMode blend;
+    SDL_Rect src;
+    SDL_Rect dst;
+    bool whole;             // The whole texture is drawn (src is ignored)
+    double angle;           // Clockwise, in degrees (as SDL_RenderCopyEx)
+    SDL_RendererFlip flip;
+};
+
+// Sort the draws by layer, texture, then blend mode
+inline bool drawOrder_( const DrawCommand& a, const DrawCommand& b ) noexcept
+{
+    if ( a.layer != b.layer )
+        return a.layer < b.layer;
+
+    if ( a.texture != b.texture )
+        return std::less<SDL_Texture *>()( a.texture, b.texture );
+
+    return a.blend < b.blend;
+}
+
+inline bool sameGroup_( const DrawCommand& a, const DrawCommand& b ) noexcept
+{
+    return a.texture == b.texture && a.blend == b.blend;
+}
+
+#if SDL_VERSION_ATLEAST(2,0,18)
+// Add the quad of a draw in a piece of geometry (tw × th is the size of the texture)
+void expandQuad_( const DrawCommand& c, const float tw, const float th,
+                  std::vector<SDL_Vertex>& vertices, std::vector<int>& indices )
+{
+    const SDL_Color WHITE = { 255, 255, 255, 255 };
+    const SDL_Rect S = c.whole ? SDL_Rect{ 0, 0, static_cast<int>( tw ), static_cast<int>( th ) }
+                       : c.src;
+
+    float u0 = static_cast<float>( S.x ) / tw;
+    float v0 = static_cast<float>( S.y ) / th;
+    float u1 = static_cast<float>( S.x + S.w ) / tw;
+    float v1 = static_cast<float>( S.y + S.h ) / th;
+
+    if ( ( c.flip & SDL_FLIP_HORIZONTAL ) != 0 )
+        std::swap( u0, u1 );
+
+    if ( ( c.flip & SDL_FLIP_VERTICAL ) != 0 )
+        std::swap( v0, v1 );
+
+    // The corners, relative to the centre of the destination
+    const float HW = static_cast<float>( c.dst.w ) / 2.0f;
+    const float HH = static_cast<float>( c.dst.h ) / 2.0f;
+    const float CX = static_cast<float>( c.dst.x ) + HW;
+    const float CY = static_cast<float>( c.dst.y ) + HH;
+    float xs[4] = { -HW, HW, HW, -HW };
+    float ys[4] = { -HH, -HH, HH, HH };
+
+    if ( c.angle != 0.0 )
+    {
+        const double RAD = c.angle * M_PI / 180.0;
+        const float COS = static_cast<float>( std::cos( RAD ) );
+        const float SIN = static_cast<float>( std::sin( RAD ) );
+
+        for ( int i = 0; i < 4; ++i )
+        {
+            const float X = xs[i];
+            xs[i] = X * COS - ys[i] * SIN;
+            ys[i] = X * SIN + ys[i] * COS;
+        }
+    }
+
+    const int BASE = static_cast<int>( vertices.size() );
+    vertices.push_back( SDL_Vertex{ { CX + xs[0], CY + ys[0] }, WHITE, { u0, v0 } } );
+    vertices.push_back( SDL_Vertex{ { CX + xs[1], CY + ys[1] }, WHITE, { u1, v0 } } );
+    vertices.push_back( SDL_Vertex{ { CX + xs[2], CY + ys[2] }, WHITE, { u1, v1 } } );
+    vertices.push_back( SDL_Vertex{ { CX + xs[3], CY + ys[3] }, WHITE, { u0, v1 } } );
+
+    for ( int k : { 0, 1, 2, 0, 2, 3 } )
+        indices.push_back( BASE + k );
+}
+#endif
+
 }
 
 //using namespace lx::Config;
@@ -317,13 +407,29 @@ struct Window_ final
     int original_width       = DEFAULT_WIN_WIDTH;
     int original_height      = DEFAULT_WIN_WIDTH;
     lx::Graphics::ImgRect viewport = { { 0, 0 }, 0, 0 };
+    bool batching            = false;               /* Batching mode                        */
+    int layer                = 0;
+    unsigned int render_calls = 0;                  /* Calls done by the last flush         */
+    std::vector<DrawCommand> commands;
+    std::vector<DrawCommand> held;                  /* Commands put aside by a sprite batch */
+    bool held_batching       = false;
+    int held_layer           = 0;
+#if SDL_VERSION_ATLEAST(2,0,18)
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+#endif
 
     Window_( const Window_& ) = delete;
     Window_& operator =( const Window_& ) = delete;
 
     explicit Window_( const WindowInfo& info ): window( nullptr ),
         renderer( nullptr ), glcontext( nullptr ), original_width( info.w ),
-        original_height( info.h )
+        original_height( info.h ), viewport( { { 0, 0 }, 0, 0 } ), batching( false ),
+        layer( 0 ), render_calls( 0 ), commands(), held(), held_batching( false ),
+        held_layer( 0 )
+#if SDL_VERSION_ATLEAST(2,0,18)
+        , vertices(), indices()
+#endif
     {
         const lx::Config::Configuration& config = lx::Config::Configuration::getInstance();
 
@@ -366,6 +472,150 @@ struct Window_ final
         SDL_SetRenderDrawColor( renderer, r, g, b, a );
     }
 
+    // Draw the commands in [first, last), they use the same texture and blend mode
+    void copyGroup_( const size_t first, const size_t last ) noexcept
+    {
+        for ( size_t i = first; i < last; ++i )
+        {
+            const DrawCommand& c = commands[i];
+            SDL_RenderCopyEx( renderer, c.texture, c.whole ? nullptr : &c.src, &c.dst,
+                              c.angle, nullptr, c.flip );
+            ++render_calls;
+        }
+    }
+
+#if SDL_VERSION_ATLEAST(2,0,18)
+    bool geometryGroup_( const size_t first, const size_t last ) noexcept
+    {
+        int tw = 0, th = 0;
+
+        if ( SDL_QueryTexture( commands[first].texture, nullptr, nullptr, &tw, &th ) != 0
+                || tw == 0 || th == 0 )
+            return false;
+
+        try
+        {
+            vertices.clear();
+            indices.clear();
+
+            for ( size_t i = first; i < last; ++i )
+            {
+                expandQuad_( commands[i], static_cast<float>( tw ),
+                             static_cast<float>( th ), vertices, indices );
+            }
+        }
+        catch ( std::exception& e )
+        {
+            lx::Log::logWarning( lx::Log::RENDER, "Batch: %s", e.what() );
+            return false;
+        }
+
+        if ( SDL_RenderGeometry( renderer, commands[first].texture, vertices.data(),
+                                 static_cast<int>( vertices.size() ), indices.data(),
+                                 static_cast<int>( indices.size() ) ) != 0 )
+            return false;
+
+        ++render_calls;
+        return true;
+    }
+#endif
+
+    void drawGroup_( const size_t first, const size_t last ) noexcept
+    {
+        SDL_Texture * t = commands[first].texture;
+        SDL_BlendMode current = SDL_BLENDMODE_NONE;
+
+        // The blend mode of the texture may have changed after the draws were recorded
+        SDL_GetTextureBlendMode( t, &current );
+
+        if ( current != commands[first].blend )
+            SDL_SetTextureBlendMode( t, commands[first].blend );
+
+#if SDL_VERSION_ATLEAST(2,0,18)
+        if ( !( last - first > 1 && geometryGroup_( first, last ) ) )
+            copyGroup_( first, last );
+#else
+        copyGroup_( first, last );
+#endif
+
+        if ( current != commands[first].blend )
+            SDL_SetTextureBlendMode( t, current );
+    }
+
+    bool record_( SDL_Texture * t, const SDL_Rect& src, const SDL_Rect * dst,
+                  const double angle, const SDL_RendererFlip flip ) noexcept
+    {
+        DrawCommand c{ layer, t, SDL_BLENDMODE_NONE, src, SDL_Rect{ 0, 0, 0, 0 },
+                       src.x == 0 && src.y == 0 && src.w == 0 && src.h == 0, angle, flip };
+
+        SDL_GetTextureBlendMode( t, &c.blend );
+
+        // No destination: the texture fills the viewport
+        if ( dst == nullptr )
+        {
+            SDL_RenderGetViewport( renderer, &c.dst );
+            c.dst.x = 0;
+            c.dst.y = 0;
+        }
+        else
+            c.dst = *dst;
+
+        try
+        {
+            commands.push_back( c );
+        }
+        catch ( std::exception& e )
+        {
+            lx::Log::logWarning( lx::Log::RENDER, "Batch: %s", e.what() );
+            return false;
+        }
+
+        return true;
+    }
+
+    void flushBatch_() noexcept
+    {
+        render_calls = 0;
+
+        if ( commands.empty() )
+            return;
+
+        // The draws that use the same texture stay in the order they were recorded
+        std::stable_sort( commands.begin(), commands.end(), drawOrder_ );
+        size_t first = 0;
+
+        while ( first < commands.size() )
+        {
+            size_t last = first + 1;
+
+            while ( last < commands.size() && sameGroup_( commands[last], commands[first] ) )
+                ++last;
+
+            drawGroup_( first, last );
+            first = last;
+        }
+
+        commands.clear();
+    }
+
+    // The commands recorded before are put aside until the sprite batch is drawn
+    void beginSpriteBatch_() noexcept
+    {
+        held.swap( commands );
+        held_batching = batching;
+        held_layer = layer;
+        batching = true;
+        layer = 0;
+    }
+
+    void endSpriteBatch_() noexcept
+    {
+        flushBatch_();
+        commands.swap( held );
+        batching = held_batching;
+        layer = held_layer;
+    }
+
     bool screenshot_( const std::string& filename ) noexcept
     {
         int err = 0;
@@ -421,6 +671,35 @@ void * Window::getRenderingSys_() const noexcept
     return m_wimpl->renderer;
 }
 
+// private function
+bool Window::queueCopy_( void * texture, const lx::Graphics::ImgRect& area,
+                         const lx::Graphics::ImgRect * box, const double angle,
+                         const lx::Graphics::MirrorEffect mirror ) noexcept
+{
+    if ( !m_wimpl->batching )
+        return false;
+
+    const SDL_Rect SRC = { area.p.x, area.p.y, area.w, area.h };
+    const SDL_Rect DST = box == nullptr ? SDL_Rect{ 0, 0, 0, 0 }
+                         : SDL_Rect{ box->p.x, box->p.y, box->w, box->h };
+
+    return m_wimpl->record_( static_cast<SDL_Texture *>( texture ), SRC,
+                             box == nullptr ? nullptr : &DST, angle,
+                             static_cast<SDL_RendererFlip>( mirror ) );
+}
+
+// private function
+void Window::beginSpriteBatch_() noexcept
+{
+    m_wimpl->beginSpriteBatch_();
+}
+
+// private function
+void Window::endSpriteBatch_() noexcept
+{
+    m_wimpl->endSpriteBatch_();
+}
+
 void Window::setIcon( const std::string& ficon ) noexcept
 {
     SDL_SetWindowIcon( m_wimpl->window, lx::Graphics::BufferedImage( ficon ).m_surface );
@@ -628,6 +907,8 @@ float Window::getOpacity() noexcept
 
 void Window::setViewPort( const lx::Graphics::ImgRect& viewport ) noexcept
 {
+    // The recorded sprites are drawn in the previous viewport
+    m_wimpl->flushBatch_();
     const SDL_Rect VPORT = { viewport.p.x, viewport.p.y, viewport.w, viewport.h };
     SDL_RenderSetViewport( m_wimpl->renderer, &VPORT );
 }
@@ -674,6 +955,8 @@ void Window::hide() noexcept
 
 void Window::update() noexcept
 {
+    m_wimpl->flushBatch_();
+
     if ( m_wimpl->glcontext != nullptr )
         SDL_GL_SwapWindow( m_wimpl->window );
     else
@@ -682,6 +965,8 @@ void Window::update() noexcept
 
 void Window::clearWindow() noexcept
 {
+    m_wimpl->commands.clear();
+
     if ( m_wimpl->glcontext != nullptr )
     {
         const lx::Graphics::glColour GLC = { 0.0f, 0.0f, 0.0f, 1.0f };
@@ -693,8 +978,43 @@ void Window::clearWindow() noexcept
 }
 
 
+void Window::setBatching( const bool batching ) noexcept
+{
+    if ( !batching )
+        m_wimpl->flushBatch_();
+
+    m_wimpl->batching = batching;
+}
+
+bool Window::isBatching() const noexcept
+{
+    return m_wimpl->batching;
+}
+
+void Window::setDrawLayer( const int layer ) noexcept
+{
+    m_wimpl->layer = layer;
+}
+
+int Window::getDrawLayer() const noexcept
+{
+    return m_wimpl->layer;
+}
+
+void Window::flushBatch() noexcept
+{
+    m_wimpl->flushBatch_();
+}
+
+unsigned int Window::getBatchRenderCalls() const noexcept
+{
+    return m_wimpl->render_calls;
+}
+
+
 bool Window::screenshot( const std::string& filename ) noexcept
 {
+    m_wimpl->flushBatch_();
     return m_wimpl->screenshot_( filename );
 }
 
@@ -11,7 +11,15 @@
 */
 
 #include <Lunatix/Thread.hpp>
+#include <Lunatix/SystemInfo.hpp>
+#include <Lunatix/Log.hpp>
+
 #include <system_error>
+#include <condition_variable>
+#include <exception>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 
 namespace lx
@@ -40,6 +48,188 @@ size_t Thread::getID() const noexcept
     return std::hash<std::thread::id>()( m_thread.get_id() );
 }
 
+/* Worker pool */
+
+class WorkerPool_ final
+{
+    std::vector<std::thread> m_workers;
+    std::mutex m_loop_mutex;                    // One loop at a time
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+
+    // Current loop
+    const std::function<void( unsigned int )> * m_task;
+    unsigned int m_nb_tasks;
+    std::atomic<unsigned int> m_next;
+    unsigned long m_generation;
+    unsigned int m_busy;                        // Workers still in the loop
+    std::exception_ptr m_error;
+    bool m_stop;
+
+    WorkerPool_( const WorkerPool_& ) = delete;
+    WorkerPool_& operator =( const WorkerPool_& ) = delete;
+
+    void runTasks_() noexcept
+    {
+        unsigned int i;
+
+        while ( ( i = m_next.fetch_add( 1 ) ) < m_nb_tasks )
+        {
+            try
+            {
+                ( *m_task )( i );
+            }
+            catch ( ... )
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+
+                if ( !m_error )
+                    m_error = std::current_exception();
+            }
+        }
+    }
+
+    void work_() noexcept
+    {
+        unsigned long generation = 0;
+
+        for ( ;; )
+        {
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_start.wait( lock, [&]()
+                {
+                    return m_stop || m_generation != generation;
+                } );
+
+                if ( m_stop )
+                    return;
+
+                generation = m_generation;
+            }
+
+            runTasks_();
+
+            std::lock_guard<std::mutex> lock( m_mutex );
+
+            if ( --m_busy == 0 )
+                m_done.notify_one();
+        }
+    }
+
+public:
+
+    explicit WorkerPool_( const unsigned int nb_workers )
+        : m_workers(), m_loop_mutex(), m_mutex(), m_start(), m_done(),
+          m_task( nullptr ), m_nb_tasks( 0 ), m_next( 0 ),
+          m_generation( 0 ), m_busy( 0 ), m_error(), m_stop( false )
+    {
+        try
+        {
+            for ( unsigned int i = 0; i < nb_workers; ++i )
+            {
+                m_workers.emplace_back( &WorkerPool_::work_, this );
+            }
+        }
+        catch ( std::system_error& se )
+        {
+            lx::Log::logWarning( lx::Log::SYSTEM, "Worker pool: %u/%u thread(s) - %s",
+                                 static_cast<unsigned int>( m_workers.size() ),
+                                 nb_workers, se.what() );
+        }
+    }
+
+    unsigned int nbWorkers() const noexcept
+    {
+        return static_cast<unsigned int>( m_workers.size() );
+    }
+
+    void parallelFor( const unsigned int nb_tasks,
+                      const std::function<void( unsigned int )>& task )
+    {
+        std::lock_guard<std::mutex> loop_lock( m_loop_mutex );
+
+        if ( m_workers.empty() || nb_tasks < 2 )
+        {
+            for ( unsigned int i = 0; i < nb_tasks; ++i )
+                task( i );
+
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_task = &task;
+            m_nb_tasks = nb_tasks;
+            m_next = 0;
+            m_error = nullptr;
+            m_busy = static_cast<unsigned int>( m_workers.size() );
+            ++m_generation;
+        }
+
+        m_start.notify_all();
+        runTasks_();
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_done.wait( lock, [this]()
+            {
+                return m_busy == 0;
+            } );
+
+            m_task = nullptr;
+            error = m_error;
+            m_error = nullptr;
+        }
+
+        if ( error )
+            std::rethrow_exception( error );
+    }
+
+    ~WorkerPool_()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_stop = true;
+        }
+
+        m_start.notify_all();
+
+        for ( std::thread& worker : m_workers )
+            worker.join();
+    }
+};
+
+
+WorkerPool::WorkerPool( const unsigned int nb_workers )
+    : m_wpimpl( new WorkerPool_( nb_workers ) ) {}
+
+unsigned int WorkerPool::nbWorkers() const noexcept
+{
+    return m_wpimpl->nbWorkers();
+}
+
+void WorkerPool::parallelFor( const unsigned int nb_tasks,
+                              const std::function<void( unsigned int )>& task )
+{
+    m_wpimpl->parallelFor( nb_tasks, task );
+}
+
+WorkerPool::~WorkerPool()
+{
+    m_wpimpl.reset();
+}
+
+
+WorkerPool& getWorkerPool()
+{
+    const int NB_CPU = lx::SystemInfo::getCPUCount();
+    static WorkerPool pool( NB_CPU > 1 ? static_cast<unsigned int>( NB_CPU - 1 ) : 0U );
+    return pool;
+}
+
 }   // Multithreading
 
 }   // lx
@@ -49,9 +49,8 @@ class Particle_ final
 public:
 
     Particle_( lx::Graphics::Sprite& sp, const FloatingBox& b,
-               const lx::Physics::Vector2D& v ) noexcept
-        : m_fbox( b ), m_lifetime( xrand<unsigned int>( 0, DELAY ) ), m_velocity( v ),
-          m_texture( sp ) {}
+               const lx::Physics::Vector2D& v, const unsigned int lifetime ) noexcept
+        : m_fbox( b ), m_lifetime( lifetime ), m_velocity( v ), m_texture( sp ) {}
 
     void update() noexcept
     {
@@ -77,18 +76,28 @@ public:
         return m_lifetime;
     }
 
+    ParticleInfo getInfo() const noexcept
+    {
+        return ParticleInfo{ &m_texture, m_fbox, m_velocity, m_lifetime };
+    }
+
     ~Particle_() = default;
 };
 
 /* Particle — public interface */
 
 Particle::Particle( lx::Graphics::Sprite& sp, const FloatingBox& b ) noexcept
-    : m_pimpl( new Particle_( sp, b, VNULL ) ) {}
+    : m_pimpl( new Particle_( sp, b, VNULL, xrand<unsigned int>( 0, DELAY ) ) ) {}
 
 
 Particle::Particle( lx::Graphics::Sprite& sp, const FloatingBox& b,
                     const lx::Physics::Vector2D& v ) noexcept
-    : m_pimpl( new Particle_( sp, b, v ) ) {}
+    : m_pimpl( new Particle_( sp, b, v, xrand<unsigned int>( 0, DELAY ) ) ) {}
+
+
+Particle::Particle( lx::Graphics::Sprite& sp, const FloatingBox& b,
+                    const lx::Physics::Vector2D& v, const unsigned int lifetime ) noexcept
+    : m_pimpl( new Particle_( sp, b, v, lifetime ) ) {}
 
 
 void Particle::update() noexcept
@@ -114,6 +123,12 @@ unsigned int Particle::getDelay() const noexcept
     return m_pimpl->getDelay();
 }
 
+// private function
+ParticleInfo Particle::getInfo_() const noexcept
+{
+    return m_pimpl->getInfo();
+}
+
 Particle::~Particle()
 {
     m_pimpl.reset();
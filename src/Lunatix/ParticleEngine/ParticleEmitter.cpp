@@ -0,0 +1,170 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file ParticleEmitter.cpp
+*   @brief The Particle emitter implementation
+*   @author Luxon Jean-Pierre(Gumichan01)
+*
+*/
+
+#include <Lunatix/ParticleEmitter.hpp>
+#include <Lunatix/ParticleSystem.hpp>
+#include <Lunatix/Random.hpp>
+
+#include <cmath>
+
+
+namespace
+{
+
+// Random number in [a, b]
+inline float frange_( const float a, const float b ) noexcept
+{
+    return a + lx::Random::fxrand( 0.0f, 1.0f ) * ( b - a );
+}
+
+inline unsigned int urange_( const unsigned int a, const unsigned int b ) noexcept
+{
+    if ( a >= b )
+        return a;
+
+    const unsigned long long R =
+        lx::Random::xrand<unsigned long long>( 0ULL, static_cast<unsigned long long>( b - a ) + 1ULL );
+    return a + static_cast<unsigned int>( R );
+}
+
+}
+
+
+namespace lx
+{
+
+namespace ParticleEngine
+{
+
+/* Private implementation */
+
+class ParticleEmitter_ final
+{
+    ParticleSystem& m_system;
+    EmitterConfig m_config;
+    float m_accumulator;            // Particles that are still to be spawned
+
+    ParticleEmitter_( const ParticleEmitter_& ) = delete;
+    ParticleEmitter_& operator =( const ParticleEmitter_& ) = delete;
+
+    ParticleInfo generate_() const noexcept
+    {
+        using lx::Physics::FloatPosition;
+        using lx::Physics::FloatingBox;
+        using lx::Physics::Vector2D;
+
+        const lx::Physics::FloatingBox& A = m_config.area;
+        const float X = frange_( A.p.x.v, A.p.x.v + static_cast<float>( A.w ) );
+        const float Y = frange_( A.p.y.v, A.p.y.v + static_cast<float>( A.h ) );
+        const float HALF = m_config.spread / 2.0f;
+        const float ANGLE = frange_( m_config.direction - HALF, m_config.direction + HALF );
+        const float SPEED = frange_( m_config.speed_min, m_config.speed_max );
+
+        return ParticleInfo
+        {
+            m_config.sprite,
+            FloatingBox{ FloatPosition{ X, Y }, m_config.particle_w, m_config.particle_h },
+            Vector2D{ SPEED * std::cos( ANGLE ), -SPEED * std::sin( ANGLE ) },
+            urange_( m_config.lifetime_min, m_config.lifetime_max )
+        };
+    }
+
+public:
+
+    ParticleEmitter_( ParticleSystem& sys, const EmitterConfig& config ) noexcept
+        : m_system( sys ), m_config( config ), m_accumulator( 0.0f ) {}
+
+    void setConfig( const EmitterConfig& config ) noexcept
+    {
+        m_config = config;
+    }
+
+    const EmitterConfig& getConfig() const noexcept
+    {
+        return m_config;
+    }
+
+    void setPosition( const lx::Physics::FloatPosition& p ) noexcept
+    {
+        m_config.area.p = p;
+    }
+
+    unsigned int burst( const unsigned int n ) noexcept
+    {
+        unsigned int i = 0;
+
+        while ( i < n && m_system.addParticle( generate_() ) )
+            ++i;
+
+        return i;
+    }
+
+    unsigned int update() noexcept
+    {
+        if ( m_config.rate <= 0.0f )
+            return 0;
+
+        m_accumulator += m_config.rate;
+        const float N = std::floor( m_accumulator );
+        m_accumulator -= N;
+
+        return burst( static_cast<unsigned int>( N ) );
+    }
+
+    ~ParticleEmitter_() = default;
+};
+
+
+/* Public functions */
+
+ParticleEmitter::ParticleEmitter( ParticleSystem& sys, const EmitterConfig& config )
+    : m_eimpl( new ParticleEmitter_( sys, config ) ) {}
+
+void ParticleEmitter::setConfig( const EmitterConfig& config ) noexcept
+{
+    m_eimpl->setConfig( config );
+}
+
+const EmitterConfig& ParticleEmitter::getConfig() const noexcept
+{
+    return m_eimpl->getConfig();
+}
+
+void ParticleEmitter::setPosition( const lx::Physics::FloatPosition& p ) noexcept
+{
+    m_eimpl->setPosition( p );
+}
+
+unsigned int ParticleEmitter::burst( const unsigned int n ) noexcept
+{
+    return m_eimpl->burst( n );
+}
+
+unsigned int ParticleEmitter::update() noexcept
+{
+    return m_eimpl->update();
+}
+
+ParticleEmitter::~ParticleEmitter()
+{
+    m_eimpl.reset();
+}
+
+}   // ParticleEngine
+
+}   // lx
@@ -19,11 +19,202 @@
 
 #include <Lunatix/ParticleSystem.hpp>
 #include <Lunatix/Particle.hpp>
+#include <Lunatix/Texture.hpp>
+#include <Lunatix/SpriteBatch.hpp>
+#include <Lunatix/SystemInfo.hpp>
+#include <Lunatix/Thread.hpp>
 #include <Lunatix/Log.hpp>
 #include <Lunatix/Error.hpp>
 
+#include <algorithm>
 #include <exception>
-#include <array>
+#include <vector>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define LX_PARTICLE_SIMD 1
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+
+/*
+*   A kernel moves the particles and decrements their lifetime.
+*   A particle whose lifetime is already 0 is dead, its index is written
+*   in dead (in increasing order). The function returns the number of dead particles.
+*
+*   The position of a dead particle is also updated, it does not matter
+*   because the particle is removed right after.
+*/
+using KernelFn = unsigned int ( * )( float * x, float * y,
+                                     const float * vx, const float * vy,
+                                     unsigned int * lifetime, const unsigned int n,
+                                     unsigned int * dead );
+
+// Update the particles in [first, n)
+inline unsigned int updateRange_( float * x, float * y, const float * vx, const float * vy,
+                                  unsigned int * lifetime, const unsigned int first,
+                                  const unsigned int n, unsigned int * dead,
+                                  unsigned int nb_dead ) noexcept
+{
+    for ( unsigned int i = first; i < n; ++i )
+    {
+        x[i] += vx[i];
+        y[i] += vy[i];
+
+        if ( lifetime[i] == 0 )
+            dead[nb_dead++] = i;
+        else
+            lifetime[i]--;
+    }
+
+    return nb_dead;
+}
+
+unsigned int updateScalar_( float * x, float * y, const float * vx, const float * vy,
+                            unsigned int * lifetime, const unsigned int n,
+                            unsigned int * dead )
+{
+    return updateRange_( x, y, vx, vy, lifetime, 0, n, dead, 0 );
+}
+
+#if defined(LX_PARTICLE_SIMD)
+
+inline unsigned int pushDead_( int mask, const unsigned int base,
+                               unsigned int * dead, unsigned int nb_dead ) noexcept
+{
+    while ( mask != 0 )
+    {
+        dead[nb_dead++] = base + static_cast<unsigned int>( __builtin_ctz( mask ) );
+        mask &= mask - 1;
+    }
+
+    return nb_dead;
+}
+
+__attribute__( ( target( "sse2" ) ) )
+unsigned int updateSSE2_( float * x, float * y, const float * vx, const float * vy,
+                          unsigned int * lifetime, const unsigned int n,
+                          unsigned int * dead )
+{
+    const __m128i ZERO = _mm_setzero_si128();
+    const __m128i ONES = _mm_cmpeq_epi32( ZERO, ZERO );
+    unsigned int nb_dead = 0;
+    unsigned int i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        _mm_storeu_ps( x + i, _mm_add_ps( _mm_loadu_ps( x + i ), _mm_loadu_ps( vx + i ) ) );
+        _mm_storeu_ps( y + i, _mm_add_ps( _mm_loadu_ps( y + i ), _mm_loadu_ps( vy + i ) ) );
+
+        __m128i * lt = reinterpret_cast<__m128i *>( lifetime + i );
+        const __m128i L = _mm_loadu_si128( lt );
+        const __m128i IS_DEAD = _mm_cmpeq_epi32( L, ZERO );
+        // lifetime - 1 if the particle is alive, lifetime + 0 otherwise
+        _mm_storeu_si128( lt, _mm_add_epi32( L, _mm_xor_si128( IS_DEAD, ONES ) ) );
+        nb_dead = pushDead_( _mm_movemask_ps( _mm_castsi128_ps( IS_DEAD ) ), i, dead, nb_dead );
+    }
+
+    return updateRange_( x, y, vx, vy, lifetime, i, n, dead, nb_dead );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+unsigned int updateAVX2_( float * x, float * y, const float * vx, const float * vy,
+                          unsigned int * lifetime, const unsigned int n,
+                          unsigned int * dead )
+{
+    const __m256i ZERO = _mm256_setzero_si256();
+    const __m256i ONES = _mm256_cmpeq_epi32( ZERO, ZERO );
+    unsigned int nb_dead = 0;
+    unsigned int i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+        _mm256_storeu_ps( x + i, _mm256_add_ps( _mm256_loadu_ps( x + i ),
+                                                _mm256_loadu_ps( vx + i ) ) );
+        _mm256_storeu_ps( y + i, _mm256_add_ps( _mm256_loadu_ps( y + i ),
+                                                _mm256_loadu_ps( vy + i ) ) );
+
+        __m256i * lt = reinterpret_cast<__m256i *>( lifetime + i );
+        const __m256i L = _mm256_loadu_si256( lt );
+        const __m256i IS_DEAD = _mm256_cmpeq_epi32( L, ZERO );
+        _mm256_storeu_si256( lt, _mm256_add_epi32( L, _mm256_xor_si256( IS_DEAD, ONES ) ) );
+        nb_dead = pushDead_( _mm256_movemask_ps( _mm256_castsi256_ps( IS_DEAD ) ), i,
+                             dead, nb_dead );
+    }
+
+    return updateRange_( x, y, vx, vy, lifetime, i, n, dead, nb_dead );
+}
+
+#endif
+
+bool supported_( const lx::ParticleEngine::ParticleKernel kernel ) noexcept
+{
+    using lx::ParticleEngine::ParticleKernel;
+
+    switch ( kernel )
+    {
+#if defined(LX_PARTICLE_SIMD)
+    case ParticleKernel::SSE2:
+        return lx::SystemInfo::hasSSE2();
+
+    case ParticleKernel::AVX2:
+        return lx::SystemInfo::hasAVX2();
+#endif
+
+    case ParticleKernel::SCALAR:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+lx::ParticleEngine::ParticleKernel bestKernel_() noexcept
+{
+    using lx::ParticleEngine::ParticleKernel;
+
+    if ( supported_( ParticleKernel::AVX2 ) )
+        return ParticleKernel::AVX2;
+
+    if ( supported_( ParticleKernel::SSE2 ) )
+        return ParticleKernel::SSE2;
+
+    return ParticleKernel::SCALAR;
+}
+
+KernelFn kernelFn_( const lx::ParticleEngine::ParticleKernel kernel ) noexcept
+{
+    using lx::ParticleEngine::ParticleKernel;
+
+    switch ( kernel )
+    {
+#if defined(LX_PARTICLE_SIMD)
+    case ParticleKernel::SSE2:
+        return updateSSE2_;
+
+    case ParticleKernel::AVX2:
+        return updateAVX2_;
+#endif
+
+    default:
+        return updateScalar_;
+    }
+}
+
+/*
+*   A large system is updated by blocks of CHUNK_SIZE particles
+*   on the worker threads. The blocks do not depend on the number of threads,
+*   so neither does the result.
+*/
+const unsigned int CHUNK_SIZE = 8192;
+const unsigned int PARALLEL_THRESHOLD = 4 * CHUNK_SIZE;
+
+lx::ParticleEngine::ParticleKernel particle_kernel = bestKernel_();
+KernelFn particle_update = kernelFn_( particle_kernel );
+
+}
 
 
 namespace lx
@@ -34,99 +225,221 @@ namespace ParticleEngine
 
 /* Private implementation */
 
+/*
+*   The particles are stored as a structure of arrays:
+*   each attribute of the particles lives in its own contiguous array,
+*   so updating and drawing the particles is a linear walk over memory.
+*
+*   The live particles are packed in [0, m_count): a new particle
+*   is appended, a dead particle is replaced by the last one.
+*   So spawning, killing and counting the particles is O(1),
+*   and the update/display only touch the live particles.
+*/
 class ParticleSystem_ final
 {
-    std::unique_ptr<std::unique_ptr<Particle>[]> m_particles;
     const unsigned int M_NB_PARTICLES;
+    unsigned int m_count;                               // Number of live particles
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_vx;
+    std::vector<float> m_vy;
+    std::vector<int> m_w;
+    std::vector<int> m_h;
+    std::vector<unsigned int> m_lifetime;
+    std::vector<unsigned int> m_sprite;                 // Index in m_sprites
+    std::vector<unsigned int> m_dead;                   // Dead particles of the last update
+    std::vector<unsigned int> m_chunk_dead;             // Dead particles per block
+    std::vector<lx::Graphics::Sprite *> m_sprites;      // Sprites used by the particles
+    mutable lx::Graphics::SpriteBatch m_batch;
+
+    unsigned int spriteIndex_( lx::Graphics::Sprite * sp )
+    {
+        const auto it = std::find( m_sprites.begin(), m_sprites.end(), sp );
+
+        if ( it != m_sprites.end() )
+            return static_cast<unsigned int>( it - m_sprites.begin() );
+
+        m_sprites.push_back( sp );
+        return static_cast<unsigned int>( m_sprites.size() - 1 );
+    }
+
+    void rmParticle_( unsigned int index ) noexcept
+    {
+        const unsigned int LAST = --m_count;
+
+        if ( index != LAST )
+        {
+            m_x[index] = m_x[LAST];
+            m_y[index] = m_y[LAST];
+            m_vx[index] = m_vx[LAST];
+            m_vy[index] = m_vy[LAST];
+            m_w[index] = m_w[LAST];
+            m_h[index] = m_h[LAST];
+            m_lifetime[index] = m_lifetime[LAST];
+            m_sprite[index] = m_sprite[LAST];
+        }
+    }
 
 public:
 
     explicit ParticleSystem_( const unsigned int nb_part ) noexcept
-        : m_particles( new std::unique_ptr<Particle>[nb_part] ),
-          M_NB_PARTICLES( nb_part ) {}
+        : M_NB_PARTICLES( nb_part ), m_count( 0 ), m_x( nb_part ), m_y( nb_part ),
+          m_vx( nb_part ), m_vy( nb_part ), m_w( nb_part ), m_h( nb_part ),
+          m_lifetime( nb_part ), m_sprite( nb_part ), m_dead( nb_part ),
+          m_chunk_dead( nb_part / CHUNK_SIZE + 1 ), m_sprites(), m_batch() {}
 
-    bool addParticle( Particle * p ) const noexcept
+    bool addParticle( const ParticleInfo& info ) noexcept
     {
-        if ( m_particles == nullptr || p == nullptr )
+        if ( info.sprite == nullptr || m_count == M_NB_PARTICLES )
             return false;
 
-        bool done = false;
+        const unsigned int i = m_count;
 
-        for ( unsigned int i = 0; i < M_NB_PARTICLES; i++ )
+        try
         {
-            if ( m_particles[i] == nullptr )
-            {
-                m_particles[i].reset( p );
-                done = true;
-                break;
-            }
+            m_sprite[i] = spriteIndex_( info.sprite );
+        }
+        catch ( std::exception& e )
+        {
+            lx::Log::logCritical( lx::Log::APPLICATION,
+                                  "Particle system: %s", e.what() );
+            return false;
         }
 
-        return done;
+        m_x[i] = info.box.p.x.v;
+        m_y[i] = info.box.p.y.v;
+        m_vx[i] = info.velocity.vx.v;
+        m_vy[i] = info.velocity.vy.v;
+        m_w[i] = info.box.w;
+        m_h[i] = info.box.h;
+        m_lifetime[i] = info.lifetime;
+        ++m_count;
+        return true;
     }
 
-    bool rmParticle( unsigned int index ) const noexcept
+    bool addParticle( Particle * p ) noexcept
     {
-        if ( index > M_NB_PARTICLES || m_particles == nullptr
-                || m_particles[index] == nullptr )
+        if ( p == nullptr )
             return false;
 
-        m_particles[index].reset();
-        return true;
+        const bool done = addParticle( p->getInfo_() );
+
+        if ( done )
+            delete p;
+
+        return done;
+    }
+
+    // Update the blocks in parallel, then merge their dead particles
+    unsigned int updateChunks_()
+    {
+        const KernelFn UPDATE = particle_update;
+        const unsigned int NB_CHUNKS = ( m_count + CHUNK_SIZE - 1 ) / CHUNK_SIZE;
+
+        lx::Multithreading::getWorkerPool().parallelFor( NB_CHUNKS,
+                [&]( unsigned int c ) noexcept
+        {
+            const unsigned int FIRST = c * CHUNK_SIZE;
+            const unsigned int N = std::min( CHUNK_SIZE, m_count - FIRST );
+            m_chunk_dead[c] = UPDATE( m_x.data() + FIRST, m_y.data() + FIRST,
+                                      m_vx.data() + FIRST, m_vy.data() + FIRST,
+                                      m_lifetime.data() + FIRST, N, m_dead.data() + FIRST );
+        } );
+
+        // Indices are relative to their block. Each one is moved backward,
+        // so the merge can be done in place
+        unsigned int nb_dead = 0;
+
+        for ( unsigned int c = 0; c < NB_CHUNKS; ++c )
+        {
+            const unsigned int FIRST = c * CHUNK_SIZE;
+
+            for ( unsigned int j = 0; j < m_chunk_dead[c]; ++j )
+                m_dead[nb_dead++] = FIRST + m_dead[FIRST + j];
+        }
+
+        return nb_dead;
     }
 
-    void updateParticles() const noexcept
+    void updateParticles() noexcept
     {
-        if ( m_particles == nullptr )
-            return;
+        unsigned int nb_dead = 0;
+        bool done = false;
 
-        for ( unsigned int i = 0; i < M_NB_PARTICLES; i++ )
+        if ( m_count >= PARALLEL_THRESHOLD )
         {
-            if ( m_particles[i] != nullptr )
+            // Nothing is updated if the loop cannot be started
+            try
             {
-                if ( m_particles[i]->isDead() )
-                    rmParticle( i );
-                else
-                    m_particles[i]->update();
+                nb_dead = updateChunks_();
+                done = true;
+            }
+            catch ( std::exception& e )
+            {
+                lx::Log::logWarning( lx::Log::APPLICATION,
+                                     "Particle system: %s", e.what() );
             }
         }
+
+        if ( !done )
+        {
+            nb_dead = particle_update( m_x.data(), m_y.data(), m_vx.data(), m_vy.data(),
+                                       m_lifetime.data(), m_count, m_dead.data() );
+        }
+
+        // Remove the highest indices first, so the last particle
+        // that takes the place of a dead one is always alive
+        for ( unsigned int i = nb_dead; i > 0; --i )
+        {
+            rmParticle_( m_dead[i - 1] );
+        }
     }
 
     void displayParticles() const noexcept
     {
-        if ( m_particles == nullptr )
-            return;
-
-        for ( unsigned int i = 0; i < M_NB_PARTICLES; i++ )
+        for ( unsigned int i = 0; i < m_count; i++ )
         {
-            if ( m_particles[i] != nullptr )
+            // Display the particle when the delay is a multiple of 2
+            if ( m_lifetime[i] % 2 == 0 )
             {
-                // Display the particle when the delay is a multiple of 2
-                if ( m_particles[i]->getDelay() % 2 == 0 )
-                    m_particles[i]->draw();
+                const lx::Graphics::ImgRect BOX =
+                {
+                    { static_cast<int>( m_x[i] ), static_cast<int>( m_y[i] ) },
+                    m_w[i], m_h[i]
+                };
+
+                m_batch.add( *m_sprites[m_sprite[i]], BOX );
             }
         }
+
+        // The particles are drawn by texture
+        m_batch.flush();
     }
 
-    unsigned int nbEmptyParticles() const noexcept
+    bool getParticle( const unsigned int index, ParticleInfo& info ) const noexcept
     {
-        if ( m_particles == nullptr )
-            return 0;
+        if ( index >= m_count )
+            return false;
 
-        unsigned int nb = 0;
+        using lx::Physics::FloatPosition;
+        using lx::Physics::FloatingBox;
+        using lx::Physics::Vector2D;
 
-        for ( unsigned int i = 0; i < M_NB_PARTICLES; i++ )
-        {
-            if ( m_particles[i] == nullptr )
-                nb++;
-        }
+        info = ParticleInfo{ m_sprites[m_sprite[index]],
+                             FloatingBox{ FloatPosition{ m_x[index], m_y[index] }, m_w[index], m_h[index] },
+                             Vector2D{ m_vx[index], m_vy[index] }, m_lifetime[index]
+                           };
+        return true;
+    }
 
-        return nb;
+    unsigned int nbEmptyParticles() const noexcept
+    {
+        return M_NB_PARTICLES - m_count;
     }
 
     unsigned int nbActiveParticles() const noexcept
     {
-        return ( m_particles == nullptr ) ? 0 : M_NB_PARTICLES - nbEmptyParticles();
+        return m_count;
     }
 
     unsigned int nbTotalParticles() const noexcept
@@ -134,23 +447,27 @@ public:
         return M_NB_PARTICLES;
     }
 
-    ~ParticleSystem_()
-    {
-        if ( m_particles != nullptr )
-        {
-            for ( unsigned int i = 0; i < M_NB_PARTICLES; i++ )
-            {
-                m_particles[i].reset();
-            }
-        }
-
-        m_particles.reset();
-    }
+    ~ParticleSystem_() = default;
 };
 
 
 /* Public functions */
 
+ParticleKernel getParticleKernel() noexcept
+{
+    return particle_kernel;
+}
+
+bool setParticleKernel( const ParticleKernel kernel ) noexcept
+{
+    if ( !supported_( kernel ) )
+        return false;
+
+    particle_kernel = kernel;
+    particle_update = kernelFn_( kernel );
+    return true;
+}
+
 ParticleSystem::ParticleSystem( const unsigned int nbPart ) noexcept
     : m_psimpl( new ParticleSystem_( nbPart ) ) {}
 
@@ -166,6 +483,11 @@ bool ParticleSystem::addParticle( Particle * p ) noexcept
     return m_psimpl->addParticle( p );
 }
 
+bool ParticleSystem::addParticle( const ParticleInfo& info ) noexcept
+{
+    return m_psimpl->addParticle( info );
+}
+
 
 void ParticleSystem::updateParticles() noexcept
 {
@@ -179,6 +501,12 @@ void ParticleSystem::displayParticles() const noexcept
 }
 
 
+bool ParticleSystem::getParticle( const unsigned int index, ParticleInfo& info ) const noexcept
+{
+    return m_psimpl->getParticle( index, info );
+}
+
+
 unsigned int ParticleSystem::nbEmptyParticles() const noexcept
 {
     return m_psimpl->nbEmptyParticles();
@@ -0,0 +1,420 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file CollisionBatch.cpp
+*   @brief The implementation of the batched collision detection
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/CollisionBatch.hpp>
+#include <Lunatix/SystemInfo.hpp>
+
+#include <algorithm>
+#include <bitset>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define LX_BATCH_SIMD 1
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+
+/*
+*   A kernel writes the bits of the shapes in [0, n), mask is filled with zeros.
+*
+*   The AABB is given by its bounds [x0, x1] × [y0, y1],
+*   a point is an AABB whose bounds are the same.
+*   A circle is given by its center and its radius.
+*/
+using BoxKernelFn = void ( * )( const float x0, const float y0, const float x1, const float y1,
+                                const lx::Physics::BoxArray& boxes, uint64_t * mask );
+using CircleKernelFn = void ( * )( const float cx, const float cy, const float r,
+                                   const lx::Physics::CircleArray& circles, uint64_t * mask );
+using CircleBoxKernelFn = void ( * )( const float cx, const float cy, const float r,
+                                      const lx::Physics::BoxArray& boxes, uint64_t * mask );
+
+inline void setBit_( uint64_t * mask, const size_t i, const bool b ) noexcept
+{
+    mask[i / 64] |= static_cast<uint64_t>( b ? 1 : 0 ) << ( i % 64 );
+}
+
+// Same tests as collisionBox() — the edges are not included
+inline bool box_( const float x0, const float y0, const float x1, const float y1,
+                  const lx::Physics::BoxArray& b, const size_t i ) noexcept
+{
+    return x0 < b.x[i] + b.w[i] && b.x[i] < x1 && y0 < b.y[i] + b.h[i] && b.y[i] < y1;
+}
+
+// Same tests as collisionCircle() — the edges are included
+inline bool circle_( const float cx, const float cy, const float r,
+                     const lx::Physics::CircleArray& c, const size_t i ) noexcept
+{
+    const float DX = cx - c.x[i];
+    const float DY = cy - c.y[i];
+    const float R = r + c.r[i];
+    return DX * DX + DY * DY <= R * R;
+}
+
+// The closest point of the box to the center
+inline bool circleBox_( const float cx, const float cy, const float r,
+                        const lx::Physics::BoxArray& b, const size_t i ) noexcept
+{
+    const float DX = cx - std::min( std::max( cx, b.x[i] ), b.x[i] + b.w[i] );
+    const float DY = cy - std::min( std::max( cy, b.y[i] ), b.y[i] + b.h[i] );
+    return DX * DX + DY * DY <= r * r;
+}
+
+void boxScalar_( const float x0, const float y0, const float x1, const float y1,
+                 const lx::Physics::BoxArray& boxes, uint64_t * mask )
+{
+    for ( size_t i = 0; i < boxes.size(); ++i )
+        setBit_( mask, i, box_( x0, y0, x1, y1, boxes, i ) );
+}
+
+void circleScalar_( const float cx, const float cy, const float r,
+                    const lx::Physics::CircleArray& circles, uint64_t * mask )
+{
+    for ( size_t i = 0; i < circles.size(); ++i )
+        setBit_( mask, i, circle_( cx, cy, r, circles, i ) );
+}
+
+void circleBoxScalar_( const float cx, const float cy, const float r,
+                       const lx::Physics::BoxArray& boxes, uint64_t * mask )
+{
+    for ( size_t i = 0; i < boxes.size(); ++i )
+        setBit_( mask, i, circleBox_( cx, cy, r, boxes, i ) );
+}
+
+#if defined(LX_BATCH_SIMD)
+
+/*
+*   The SIMD kernels check 4 (SSE2) or 8 (AVX2) shapes per iteration,
+*   the remaining shapes are checked one by one.
+*   4 and 8 divide 64, so the bits of an iteration are in the same word.
+*/
+inline void setBits_( uint64_t * mask, const size_t i, const int bits ) noexcept
+{
+    mask[i / 64] |= static_cast<uint64_t>( static_cast<unsigned int>( bits ) ) << ( i % 64 );
+}
+
+__attribute__( ( target( "sse2" ) ) )
+void boxSSE2_( const float x0, const float y0, const float x1, const float y1,
+               const lx::Physics::BoxArray& boxes, uint64_t * mask )
+{
+    const size_t N = boxes.size();
+    const __m128 X0 = _mm_set1_ps( x0 ), Y0 = _mm_set1_ps( y0 );
+    const __m128 X1 = _mm_set1_ps( x1 ), Y1 = _mm_set1_ps( y1 );
+    size_t i = 0;
+
+    for ( ; i + 4 <= N; i += 4 )
+    {
+        const __m128 X = _mm_loadu_ps( boxes.x.data() + i );
+        const __m128 Y = _mm_loadu_ps( boxes.y.data() + i );
+        const __m128 XW = _mm_add_ps( X, _mm_loadu_ps( boxes.w.data() + i ) );
+        const __m128 YH = _mm_add_ps( Y, _mm_loadu_ps( boxes.h.data() + i ) );
+        const __m128 HIT = _mm_and_ps( _mm_and_ps( _mm_cmplt_ps( X0, XW ), _mm_cmplt_ps( X, X1 ) ),
+                                       _mm_and_ps( _mm_cmplt_ps( Y0, YH ), _mm_cmplt_ps( Y, Y1 ) ) );
+        setBits_( mask, i, _mm_movemask_ps( HIT ) );
+    }
+
+    for ( ; i < N; ++i )
+        setBit_( mask, i, box_( x0, y0, x1, y1, boxes, i ) );
+}
+
+__attribute__( ( target( "sse2" ) ) )
+void circleSSE2_( const float cx, const float cy, const float r,
+                  const lx::Physics::CircleArray& circles, uint64_t * mask )
+{
+    const size_t N = circles.size();
+    const __m128 CX = _mm_set1_ps( cx ), CY = _mm_set1_ps( cy ), CR = _mm_set1_ps( r );
+    size_t i = 0;
+
+    for ( ; i + 4 <= N; i += 4 )
+    {
+        const __m128 DX = _mm_sub_ps( CX, _mm_loadu_ps( circles.x.data() + i ) );
+        const __m128 DY = _mm_sub_ps( CY, _mm_loadu_ps( circles.y.data() + i ) );
+        const __m128 R = _mm_add_ps( CR, _mm_loadu_ps( circles.r.data() + i ) );
+        const __m128 D2 = _mm_add_ps( _mm_mul_ps( DX, DX ), _mm_mul_ps( DY, DY ) );
+        setBits_( mask, i, _mm_movemask_ps( _mm_cmple_ps( D2, _mm_mul_ps( R, R ) ) ) );
+    }
+
+    for ( ; i < N; ++i )
+        setBit_( mask, i, circle_( cx, cy, r, circles, i ) );
+}
+
+__attribute__( ( target( "sse2" ) ) )
+void circleBoxSSE2_( const float cx, const float cy, const float r,
+                     const lx::Physics::BoxArray& boxes, uint64_t * mask )
+{
+    const size_t N = boxes.size();
+    const __m128 CX = _mm_set1_ps( cx ), CY = _mm_set1_ps( cy ), R2 = _mm_set1_ps( r * r );
+    size_t i = 0;
+
+    for ( ; i + 4 <= N; i += 4 )
+    {
+        const __m128 X = _mm_loadu_ps( boxes.x.data() + i );
+        const __m128 Y = _mm_loadu_ps( boxes.y.data() + i );
+        const __m128 XW = _mm_add_ps( X, _mm_loadu_ps( boxes.w.data() + i ) );
+        const __m128 YH = _mm_add_ps( Y, _mm_loadu_ps( boxes.h.data() + i ) );
+        const __m128 DX = _mm_sub_ps( CX, _mm_min_ps( _mm_max_ps( CX, X ), XW ) );
+        const __m128 DY = _mm_sub_ps( CY, _mm_min_ps( _mm_max_ps( CY, Y ), YH ) );
+        const __m128 D2 = _mm_add_ps( _mm_mul_ps( DX, DX ), _mm_mul_ps( DY, DY ) );
+        setBits_( mask, i, _mm_movemask_ps( _mm_cmple_ps( D2, R2 ) ) );
+    }
+
+    for ( ; i < N; ++i )
+        setBit_( mask, i, circleBox_( cx, cy, r, boxes, i ) );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+void boxAVX2_( const float x0, const float y0, const float x1, const float y1,
+               const lx::Physics::BoxArray& boxes, uint64_t * mask )
+{
+    const size_t N = boxes.size();
+    const __m256 X0 = _mm256_set1_ps( x0 ), Y0 = _mm256_set1_ps( y0 );
+    const __m256 X1 = _mm256_set1_ps( x1 ), Y1 = _mm256_set1_ps( y1 );
+    size_t i = 0;
+
+    for ( ; i + 8 <= N; i += 8 )
+    {
+        const __m256 X = _mm256_loadu_ps( boxes.x.data() + i );
+        const __m256 Y = _mm256_loadu_ps( boxes.y.data() + i );
+        const __m256 XW = _mm256_add_ps( X, _mm256_loadu_ps( boxes.w.data() + i ) );
+        const __m256 YH = _mm256_add_ps( Y, _mm256_loadu_ps( boxes.h.data() + i ) );
+        const __m256 HIT = _mm256_and_ps( _mm256_and_ps( _mm256_cmp_ps( X0, XW, _CMP_LT_OQ ),
+                                                         _mm256_cmp_ps( X, X1, _CMP_LT_OQ ) ),
+                                          _mm256_and_ps( _mm256_cmp_ps( Y0, YH, _CMP_LT_OQ ),
+                                                         _mm256_cmp_ps( Y, Y1, _CMP_LT_OQ ) ) );
+        setBits_( mask, i, _mm256_movemask_ps( HIT ) );
+    }
+
+    for ( ; i < N; ++i )
+        setBit_( mask, i, box_( x0, y0, x1, y1, boxes, i ) );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+void circleAVX2_( const float cx, const float cy, const float r,
+                  const lx::Physics::CircleArray& circles, uint64_t * mask )
+{
+    const size_t N = circles.size();
+    const __m256 CX = _mm256_set1_ps( cx ), CY = _mm256_set1_ps( cy ), CR = _mm256_set1_ps( r );
+    size_t i = 0;
+
+    for ( ; i + 8 <= N; i += 8 )
+    {
+        const __m256 DX = _mm256_sub_ps( CX, _mm256_loadu_ps( circles.x.data() + i ) );
+        const __m256 DY = _mm256_sub_ps( CY, _mm256_loadu_ps( circles.y.data() + i ) );
+        const __m256 R = _mm256_add_ps( CR, _mm256_loadu_ps( circles.r.data() + i ) );
+        const __m256 D2 = _mm256_add_ps( _mm256_mul_ps( DX, DX ), _mm256_mul_ps( DY, DY ) );
+        setBits_( mask, i, _mm256_movemask_ps( _mm256_cmp_ps( D2, _mm256_mul_ps( R, R ),
+                                                              _CMP_LE_OQ ) ) );
+    }
+
+    for ( ; i < N; ++i )
+        setBit_( mask, i, circle_( cx, cy, r, circles, i ) );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+void circleBoxAVX2_( const float cx, const float cy, const float r,
+                     const lx::Physics::BoxArray& boxes, uint64_t * mask )
+{
+    const size_t N = boxes.size();
+    const __m256 CX = _mm256_set1_ps( cx ), CY = _mm256_set1_ps( cy );
+    const __m256 R2 = _mm256_set1_ps( r * r );
+    size_t i = 0;
+
+    for ( ; i + 8 <= N; i += 8 )
+    {
+        const __m256 X = _mm256_loadu_ps( boxes.x.data() + i );
+        const __m256 Y = _mm256_loadu_ps( boxes.y.data() + i );
+        const __m256 XW = _mm256_add_ps( X, _mm256_loadu_ps( boxes.w.data() + i ) );
+        const __m256 YH = _mm256_add_ps( Y, _mm256_loadu_ps( boxes.h.data() + i ) );
+        const __m256 DX = _mm256_sub_ps( CX, _mm256_min_ps( _mm256_max_ps( CX, X ), XW ) );
+        const __m256 DY = _mm256_sub_ps( CY, _mm256_min_ps( _mm256_max_ps( CY, Y ), YH ) );
+        const __m256 D2 = _mm256_add_ps( _mm256_mul_ps( DX, DX ), _mm256_mul_ps( DY, DY ) );
+        setBits_( mask, i, _mm256_movemask_ps( _mm256_cmp_ps( D2, R2, _CMP_LE_OQ ) ) );
+    }
+
+    for ( ; i < N; ++i )
+        setBit_( mask, i, circleBox_( cx, cy, r, boxes, i ) );
+}
+
+#endif
+
+struct Kernels final
+{
+    BoxKernelFn box;
+    CircleKernelFn circle;
+    CircleBoxKernelFn circle_box;
+};
+
+Kernels bestKernels_() noexcept
+{
+#if defined(LX_BATCH_SIMD)
+    if ( lx::SystemInfo::hasAVX2() )
+        return Kernels{ boxAVX2_, circleAVX2_, circleBoxAVX2_ };
+
+    if ( lx::SystemInfo::hasSSE2() )
+        return Kernels{ boxSSE2_, circleSSE2_, circleBoxSSE2_ };
+#endif
+
+    return Kernels{ boxScalar_, circleScalar_, circleBoxScalar_ };
+}
+
+const Kernels batch_kernels = bestKernels_();
+
+// Prepare the mask for n shapes (filled with zeros)
+uint64_t * resetMask_( std::vector<uint64_t>& mask, const size_t n )
+{
+    mask.assign( ( n + 63 ) / 64, 0ULL );
+    return mask.data();
+}
+
+size_t count_( const std::vector<uint64_t>& mask ) noexcept
+{
+    size_t count = 0;
+
+    for ( const uint64_t w : mask )
+        count += std::bitset<64>( w ).count();
+
+    return count;
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+/** BoxArray */
+
+void BoxArray::push( const FloatingBox& box )
+{
+    x.push_back( box.p.x.v );
+    y.push_back( box.p.y.v );
+    w.push_back( static_cast<float>( box.w ) );
+    h.push_back( static_cast<float>( box.h ) );
+}
+
+void BoxArray::set( const size_t index, const FloatingBox& box ) noexcept
+{
+    x[index] = box.p.x.v;
+    y[index] = box.p.y.v;
+    w[index] = static_cast<float>( box.w );
+    h[index] = static_cast<float>( box.h );
+}
+
+FloatingBox BoxArray::get( const size_t index ) const noexcept
+{
+    return FloatingBox{ FloatPosition{ x[index], y[index] }, static_cast<int>( w[index] ),
+                        static_cast<int>( h[index] ) };
+}
+
+size_t BoxArray::size() const noexcept
+{
+    return x.size();
+}
+
+void BoxArray::clear() noexcept
+{
+    x.clear();
+    y.clear();
+    w.clear();
+    h.clear();
+}
+
+
+/** CircleArray */
+
+void CircleArray::push( const Circle& circle )
+{
+    x.push_back( circle.center.x.v );
+    y.push_back( circle.center.y.v );
+    r.push_back( static_cast<float>( circle.radius ) );
+}
+
+void CircleArray::set( const size_t index, const Circle& circle ) noexcept
+{
+    x[index] = circle.center.x.v;
+    y[index] = circle.center.y.v;
+    r[index] = static_cast<float>( circle.radius );
+}
+
+Circle CircleArray::get( const size_t index ) const noexcept
+{
+    return Circle{ FloatPosition{ x[index], y[index] }, static_cast<unsigned int>( r[index] ) };
+}
+
+size_t CircleArray::size() const noexcept
+{
+    return x.size();
+}
+
+void CircleArray::clear() noexcept
+{
+    x.clear();
+    y.clear();
+    r.clear();
+}
+
+
+/** Batches */
+
+size_t collisionBoxBatch( const FloatingBox& box, const BoxArray& boxes,
+                          std::vector<uint64_t>& mask )
+{
+    batch_kernels.box( box.p.x.v, box.p.y.v, box.p.x.v + static_cast<float>( box.w ),
+                       box.p.y.v + static_cast<float>( box.h ), boxes,
+                       resetMask_( mask, boxes.size() ) );
+    return count_( mask );
+}
+
+size_t collisionCircleBatch( const Circle& circle, const CircleArray& circles,
+                             std::vector<uint64_t>& mask )
+{
+    batch_kernels.circle( circle.center.x.v, circle.center.y.v,
+                          static_cast<float>( circle.radius ), circles,
+                          resetMask_( mask, circles.size() ) );
+    return count_( mask );
+}
+
+size_t collisionCircleBoxBatch( const Circle& circle, const BoxArray& boxes,
+                                std::vector<uint64_t>& mask )
+{
+    batch_kernels.circle_box( circle.center.x.v, circle.center.y.v,
+                              static_cast<float>( circle.radius ), boxes,
+                              resetMask_( mask, boxes.size() ) );
+    return count_( mask );
+}
+
+size_t collisionPointBoxBatch( const FloatPosition& p, const BoxArray& boxes,
+                               std::vector<uint64_t>& mask )
+{
+    batch_kernels.box( p.x.v, p.y.v, p.x.v, p.y.v, boxes, resetMask_( mask, boxes.size() ) );
+    return count_( mask );
+}
+
+size_t collisionPointCircleBatch( const FloatPosition& p, const CircleArray& circles,
+                                  std::vector<uint64_t>& mask )
+{
+    batch_kernels.circle( p.x.v, p.y.v, 0.0f, circles, resetMask_( mask, circles.size() ) );
+    return count_( mask );
+}
+
+}   // Physics
+
+}   // lx
@@ -0,0 +1,353 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file CollisionMask.cpp
+*   @brief The implementation of the collision masks
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/CollisionMask.hpp>
+#include <Lunatix/Physics.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <stdexcept>
+#include <cmath>
+
+
+namespace
+{
+
+const int WORD_BITS = 64;
+
+inline size_t wordsPerRow_( const int width ) noexcept
+{
+    return static_cast<size_t>( ( width + WORD_BITS - 1 ) / WORD_BITS );
+}
+
+// The bits [i0, i1) of a word whose first bit is the bit 64 × k of the row
+inline uint64_t rangeMask_( const long k, const long i0, const long i1 ) noexcept
+{
+    const long LO = std::max( i0 - k * WORD_BITS, 0L );
+    const long HI = std::min( i1 - k * WORD_BITS, static_cast<long>( WORD_BITS ) );
+    const uint64_t UPPER = HI >= WORD_BITS ? ~0ULL : ( 1ULL << HI ) - 1ULL;
+    return UPPER & ~( ( 1ULL << LO ) - 1ULL );
+}
+
+/*
+*   The 64 bits of a row from the bit start (the bit t of the result is the bit start + t),
+*   start can be negative, the bits out of the row are 0.
+*/
+inline uint64_t fetch_( const uint64_t * row, const long nwords, const long start ) noexcept
+{
+    if ( start <= -WORD_BITS || start >= nwords * WORD_BITS )
+        return 0ULL;
+
+    if ( start < 0 )
+        return row[0] << ( -start );
+
+    const long W = start / WORD_BITS;
+    const long SHIFT = start % WORD_BITS;
+    uint64_t bits = row[W] >> SHIFT;
+
+    if ( SHIFT != 0 && W + 1 < nwords )
+        bits |= row[W + 1] << ( WORD_BITS - SHIFT );
+
+    return bits;
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+CollisionMask::CollisionMask() noexcept
+    : m_width( 0 ), m_height( 0 ), m_scale( 1 ), m_words_per_row( 0 ), m_bits(),
+      m_x0( 0 ), m_y0( 0 ), m_x1( 0 ), m_y1( 0 ) {}
+
+
+CollisionMask::CollisionMask( const int width, const int height, const int scale )
+    : m_width( width ), m_height( height ), m_scale( scale ), m_words_per_row( 0 ),
+      m_bits(), m_x0( 0 ), m_y0( 0 ), m_x1( 0 ), m_y1( 0 )
+{
+    if ( width < 0 || height < 0 || scale < 1 )
+        throw std::invalid_argument( "CollisionMask: invalid dimensions" );
+
+    m_words_per_row = wordsPerRow_( width );
+    m_bits.assign( m_words_per_row * static_cast<size_t>( height ), 0ULL );
+}
+
+
+void CollisionMask::updateBounds_() noexcept
+{
+    m_x0 = m_width;
+    m_y0 = m_height;
+    m_x1 = 0;
+    m_y1 = 0;
+
+    for ( int y = 0; y < m_height; ++y )
+    {
+        const uint64_t * ROW = m_bits.data() + static_cast<size_t>( y ) * m_words_per_row;
+
+        for ( size_t k = 0; k < m_words_per_row; ++k )
+        {
+            if ( ROW[k] == 0ULL )
+                continue;
+
+            const int BASE = static_cast<int>( k ) * WORD_BITS;
+            m_x0 = std::min( m_x0, BASE + __builtin_ctzll( ROW[k] ) );
+            m_x1 = std::max( m_x1, BASE + WORD_BITS - __builtin_clzll( ROW[k] ) );
+            m_y0 = std::min( m_y0, y );
+            m_y1 = y + 1;
+        }
+    }
+
+    if ( m_x0 >= m_x1 )
+        m_x0 = m_y0 = m_x1 = m_y1 = 0;
+}
+
+
+void CollisionMask::set( const int x, const int y, const bool solid ) noexcept
+{
+    if ( x < 0 || y < 0 || x >= m_width || y >= m_height )
+        return;
+
+    uint64_t& word = m_bits[static_cast<size_t>( y ) * m_words_per_row + static_cast<size_t>( x / WORD_BITS )];
+    const uint64_t BIT = 1ULL << ( x % WORD_BITS );
+
+    if ( solid )
+    {
+        word |= BIT;
+
+        if ( m_x0 >= m_x1 )
+        {
+            m_x0 = x;
+            m_y0 = y;
+            m_x1 = x + 1;
+            m_y1 = y + 1;
+        }
+        else
+        {
+            m_x0 = std::min( m_x0, x );
+            m_y0 = std::min( m_y0, y );
+            m_x1 = std::max( m_x1, x + 1 );
+            m_y1 = std::max( m_y1, y + 1 );
+        }
+    }
+    else if ( ( word & BIT ) != 0ULL )
+    {
+        word &= ~BIT;
+
+        // The bounds only change if the bit was on the border
+        if ( x == m_x0 || y == m_y0 || x + 1 == m_x1 || y + 1 == m_y1 )
+            updateBounds_();
+    }
+}
+
+
+bool CollisionMask::get( const int x, const int y ) const noexcept
+{
+    if ( x < 0 || y < 0 || x >= m_width || y >= m_height )
+        return false;
+
+    const uint64_t WORD = m_bits[static_cast<size_t>( y ) * m_words_per_row + static_cast<size_t>( x / WORD_BITS )];
+    return ( ( WORD >> ( x % WORD_BITS ) ) & 1ULL ) != 0ULL;
+}
+
+
+CollisionMask CollisionMask::downsample( const int factor ) const
+{
+    if ( factor < 1 )
+        throw std::invalid_argument( "CollisionMask: the factor must be at least 1" );
+
+    CollisionMask mask( ( m_width + factor - 1 ) / factor, ( m_height + factor - 1 ) / factor,
+                        m_scale * factor );
+
+    for ( int y = m_y0; y < m_y1; ++y )
+    {
+        const uint64_t * ROW = m_bits.data() + static_cast<size_t>( y ) * m_words_per_row;
+
+        for ( size_t k = 0; k < m_words_per_row; ++k )
+        {
+            uint64_t word = ROW[k];
+
+            while ( word != 0ULL )
+            {
+                const int X = static_cast<int>( k ) * WORD_BITS + __builtin_ctzll( word );
+                mask.set( X / factor, y / factor, true );
+                word &= word - 1ULL;
+            }
+        }
+    }
+
+    return mask;
+}
+
+
+int CollisionMask::getWidth() const noexcept
+{
+    return m_width;
+}
+
+int CollisionMask::getHeight() const noexcept
+{
+    return m_height;
+}
+
+int CollisionMask::getScale() const noexcept
+{
+    return m_scale;
+}
+
+FloatingBox CollisionMask::getBoundingBox( const FloatPosition& p ) const noexcept
+{
+    const float S = static_cast<float>( m_scale );
+    return FloatingBox{ FloatPosition{ p.x.v + static_cast<float>( m_x0 ) * S,
+                                       p.y.v + static_cast<float>( m_y0 ) * S },
+                        ( m_x1 - m_x0 ) * m_scale, ( m_y1 - m_y0 ) * m_scale };
+}
+
+size_t CollisionMask::count() const noexcept
+{
+    size_t n = 0;
+
+    for ( const uint64_t W : m_bits )
+        n += std::bitset<64>( W ).count();
+
+    return n;
+}
+
+
+/*
+*   The bit (i, j) of a mask at p covers the pixels
+*   [p.x + i × scale, p.x + (i + 1) × scale) × [p.y + j × scale, p.y + (j + 1) × scale).
+*/
+
+bool collisionMaskBox( const CollisionMask& mask, const FloatPosition& p,
+                       const FloatingBox& box ) noexcept
+{
+    if ( mask.m_x0 >= mask.m_x1 || !collisionBox( mask.getBoundingBox( p ), box ) )
+        return false;
+
+    // The bits that overlap the box (the edges are not included)
+    const float S = static_cast<float>( mask.m_scale );
+    const long I0 = std::max( static_cast<long>( std::floor( ( box.p.x.v - p.x.v ) / S ) ),
+                              static_cast<long>( mask.m_x0 ) );
+    const long I1 = std::min( static_cast<long>( std::ceil( ( box.p.x.v + box.w - p.x.v ) / S ) ),
+                              static_cast<long>( mask.m_x1 ) );
+    const long J0 = std::max( static_cast<long>( std::floor( ( box.p.y.v - p.y.v ) / S ) ),
+                              static_cast<long>( mask.m_y0 ) );
+    const long J1 = std::min( static_cast<long>( std::ceil( ( box.p.y.v + box.h - p.y.v ) / S ) ),
+                              static_cast<long>( mask.m_y1 ) );
+
+    for ( long j = J0; j < J1; ++j )
+    {
+        const uint64_t * ROW = mask.m_bits.data() + static_cast<size_t>( j ) * mask.m_words_per_row;
+
+        for ( long k = I0 / WORD_BITS; k * WORD_BITS < I1; ++k )
+        {
+            if ( ( ROW[k] & rangeMask_( k, I0, I1 ) ) != 0ULL )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+bool collisionMask( const CollisionMask& a, const FloatPosition& pa,
+                    const CollisionMask& b, const FloatPosition& pb ) noexcept
+{
+    if ( a.m_x0 >= a.m_x1 || b.m_x0 >= b.m_x1
+            || !collisionBox( a.getBoundingBox( pa ), b.getBoundingBox( pb ) ) )
+        return false;
+
+    // Different scales: check every solid block of a against b
+    if ( a.m_scale != b.m_scale )
+    {
+        const FloatingBox BB = b.getBoundingBox( pb );
+
+        for ( int j = a.m_y0; j < a.m_y1; ++j )
+        {
+            for ( int i = a.m_x0; i < a.m_x1; ++i )
+            {
+                const FloatingBox CELL{ FloatPosition{ pa.x.v + static_cast<float>( i * a.m_scale ),
+                                                       pa.y.v + static_cast<float>( j * a.m_scale ) },
+                                        a.m_scale, a.m_scale };
+
+                if ( a.get( i, j ) && collisionBox( CELL, BB ) && collisionMaskBox( b, pb, CELL ) )
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*
+        The bit i of a overlaps the bit i + dx of b, and the bit i + dx + 1
+        if the masks are not aligned (the same for the rows).
+    */
+    const float S = static_cast<float>( a.m_scale );
+    const float FX = ( pa.x.v - pb.x.v ) / S;
+    const float FY = ( pa.y.v - pb.y.v ) / S;
+    const long DX = static_cast<long>( std::floor( FX ) );
+    const long DY = static_cast<long>( std::floor( FY ) );
+    const long EX = static_cast<float>( DX ) < FX ? 1 : 0;
+    const long EY = static_cast<float>( DY ) < FY ? 1 : 0;
+
+    // The bits of a that can overlap a solid bit of b
+    const long I0 = std::max( static_cast<long>( a.m_x0 ), b.m_x0 - DX - EX );
+    const long I1 = std::min( static_cast<long>( a.m_x1 ), b.m_x1 - DX );
+    const long J0 = std::max( static_cast<long>( a.m_y0 ), b.m_y0 - DY - EY );
+    const long J1 = std::min( static_cast<long>( a.m_y1 ), b.m_y1 - DY );
+    const long NB_WORDS = static_cast<long>( b.m_words_per_row );
+
+    for ( long j = J0; j < J1; ++j )
+    {
+        const uint64_t * ROW_A = a.m_bits.data() + static_cast<size_t>( j ) * a.m_words_per_row;
+
+        for ( long k = I0 / WORD_BITS; k * WORD_BITS < I1; ++k )
+        {
+            const uint64_t WA = ROW_A[k] & rangeMask_( k, I0, I1 );
+
+            if ( WA == 0ULL )
+                continue;
+
+            uint64_t wb = 0ULL;
+
+            for ( long r = j + DY; r <= j + DY + EY; ++r )
+            {
+                if ( r < 0 || r >= b.m_height )
+                    continue;
+
+                const uint64_t * ROW_B = b.m_bits.data() + static_cast<size_t>( r ) * b.m_words_per_row;
+                wb |= fetch_( ROW_B, NB_WORDS, k * WORD_BITS + DX );
+
+                if ( EX != 0 )
+                    wb |= fetch_( ROW_B, NB_WORDS, k * WORD_BITS + DX + 1 );
+            }
+
+            if ( ( WA & wb ) != 0ULL )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+}   // Physics
+
+}   // lx
@@ -0,0 +1,840 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file CollisionWorld.cpp
+*   @brief The implementation of the broad phase
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/CollisionWorld.hpp>
+#include <Lunatix/Physics.hpp>
+#include <Lunatix/Polygon.hpp>
+
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+#include <cmath>
+
+
+namespace
+{
+
+using lx::Physics::ProxyID;
+
+const float CELL_LIMIT = 1073741824.0f;     // 2^30, keeps the cell coordinates in an int
+
+enum class ShapeType : short
+{
+    BOX, CIRCLE, POLYGON
+};
+
+// Cells covered by a bounding box (inclusive)
+struct CellRange final
+{
+    int x0, y0, x1, y1;
+};
+
+inline bool operator ==( const CellRange& a, const CellRange& b ) noexcept
+{
+    return a.x0 == b.x0 && a.y0 == b.y0 && a.x1 == b.x1 && a.y1 == b.y1;
+}
+
+struct Proxy final
+{
+    ShapeType type;
+    lx::Physics::FloatingBox box;
+    lx::Physics::Circle circle;
+    const lx::Physics::Polygon * poly;
+    float min_x, min_y, max_x, max_y;       // Bounding box
+    CellRange cells;
+    void * data;
+    uint32_t category;
+    uint32_t mask;
+    bool alive;
+};
+
+inline uint64_t cellKey( const int x, const int y ) noexcept
+{
+    return ( static_cast<uint64_t>( static_cast<uint32_t>( x ) ) << 32 )
+           | static_cast<uint32_t>( y );
+}
+
+struct CellHash final
+{
+    size_t operator ()( const uint64_t k ) const noexcept
+    {
+        // Mix the two coordinates (splitmix64 finalizer)
+        uint64_t z = k + 0x9E3779B97F4A7C15ULL;
+        z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+        z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+        return static_cast<size_t>( z ^ ( z >> 31 ) );
+    }
+};
+
+// See lx::Physics::CollisionFilter
+inline bool accept( const Proxy& a, const Proxy& b ) noexcept
+{
+    return ( a.category & b.mask ) != 0 && ( b.category & a.mask ) != 0;
+}
+
+// The shape of a query has no layer, the queries do not filter the proxies
+const uint32_t NO_LAYER = 0;
+
+inline bool overlap( const Proxy& a, const Proxy& b ) noexcept
+{
+    return a.min_x <= b.max_x && b.min_x <= a.max_x
+           && a.min_y <= b.max_y && b.min_y <= a.max_y;
+}
+
+void setBounds( Proxy& p )
+{
+    switch ( p.type )
+    {
+    case ShapeType::BOX:
+        p.min_x = p.box.p.x.v;
+        p.min_y = p.box.p.y.v;
+        p.max_x = p.box.p.x.v + static_cast<float>( p.box.w );
+        p.max_y = p.box.p.y.v + static_cast<float>( p.box.h );
+        break;
+
+    case ShapeType::CIRCLE:
+    {
+        const float R = static_cast<float>( p.circle.radius );
+        p.min_x = p.circle.center.x.v - R;
+        p.min_y = p.circle.center.y.v - R;
+        p.max_x = p.circle.center.x.v + R;
+        p.max_y = p.circle.center.y.v + R;
+    }
+    break;
+
+    case ShapeType::POLYGON:
+    {
+        const lx::Physics::FloatingBox B = p.poly->getEnclosingBox();
+        p.min_x = B.p.x.v;
+        p.min_y = B.p.y.v;
+        p.max_x = B.p.x.v + static_cast<float>( B.w );
+        p.max_y = B.p.y.v + static_cast<float>( B.h );
+    }
+    break;
+    }
+}
+
+// Exact collision between two shapes
+bool collide_( const Proxy& a, const Proxy& b )
+{
+    using namespace lx::Physics;
+
+    if ( a.type > b.type )
+        return collide_( b, a );
+
+    switch ( a.type )
+    {
+    case ShapeType::BOX:
+        if ( b.type == ShapeType::BOX )
+            return collisionBox( a.box, b.box );
+        else if ( b.type == ShapeType::CIRCLE )
+            return collisionCircleBox( b.circle, a.box );
+        else
+            return collisionBoxPoly( a.box, *b.poly );
+
+    case ShapeType::CIRCLE:
+        if ( b.type == ShapeType::CIRCLE )
+            return collisionCircle( a.circle, b.circle );
+        else
+            return collisionCirclePoly( a.circle, *b.poly );
+
+    case ShapeType::POLYGON:
+        return collisionPoly( *a.poly, *b.poly );
+    }
+
+    return false;
+}
+
+bool contains_( const Proxy& a, const lx::Physics::FloatPosition& p )
+{
+    using namespace lx::Physics;
+
+    switch ( a.type )
+    {
+    case ShapeType::BOX:
+        return collisionPointBox( p, a.box );
+
+    case ShapeType::CIRCLE:
+        return collisionPointCircle( p, a.circle );
+
+    case ShapeType::POLYGON:
+        return collisionPointPoly( p, *a.poly );
+    }
+
+    return false;
+}
+
+// Cast a segment against the exact shape of a proxy
+bool raycast_( const Proxy& a, const lx::Physics::Segment& s, lx::Physics::RayHit& hit )
+{
+    using namespace lx::Physics;
+
+    switch ( a.type )
+    {
+    case ShapeType::BOX:
+        return raycastBox( s, a.box, hit );
+
+    case ShapeType::CIRCLE:
+        return raycastCircle( s, a.circle, hit );
+
+    case ShapeType::POLYGON:
+        return raycastPoly( s, *a.poly, hit );
+    }
+
+    return false;
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+/* Private implementation */
+
+class CollisionWorld_ final
+{
+    using Cell = std::vector<ProxyID>;
+
+    const float M_INV_CELL;
+    std::vector<Proxy> m_proxies;
+    std::vector<ProxyID> m_free;
+    std::unordered_map<uint64_t, Cell, CellHash> m_cells;
+    size_t m_count;
+
+    CollisionWorld_( const CollisionWorld_& ) = delete;
+    CollisionWorld_& operator =( const CollisionWorld_& ) = delete;
+
+    int cellCoord_( const float v ) const noexcept
+    {
+        const float C = std::floor( v * M_INV_CELL );
+        return static_cast<int>( std::max( -CELL_LIMIT, std::min( C, CELL_LIMIT ) ) );
+    }
+
+    CellRange cellRange_( const Proxy& p ) const noexcept
+    {
+        return CellRange{ cellCoord_( p.min_x ), cellCoord_( p.min_y ),
+                          cellCoord_( p.max_x ), cellCoord_( p.max_y ) };
+    }
+
+    void insertCells_( const ProxyID id, const CellRange& r )
+    {
+        for ( int y = r.y0; y <= r.y1; ++y )
+        {
+            for ( int x = r.x0; x <= r.x1; ++x )
+            {
+                m_cells[cellKey( x, y )].push_back( id );
+            }
+        }
+    }
+
+    // The cells are kept when they become empty, so their memory is reused
+    void removeCells_( const ProxyID id, const CellRange& r ) noexcept
+    {
+        for ( int y = r.y0; y <= r.y1; ++y )
+        {
+            for ( int x = r.x0; x <= r.x1; ++x )
+            {
+                auto it = m_cells.find( cellKey( x, y ) );
+
+                if ( it == m_cells.end() )
+                    continue;
+
+                Cell& cell = it->second;
+                auto pos = std::find( cell.begin(), cell.end(), id );
+
+                if ( pos != cell.end() )
+                {
+                    *pos = cell.back();
+                    cell.pop_back();
+                }
+            }
+        }
+    }
+
+    ProxyID add_( Proxy& p )
+    {
+        setBounds( p );
+        p.cells = cellRange_( p );
+        p.alive = true;
+
+        ProxyID id;
+
+        if ( !m_free.empty() )
+        {
+            id = m_free.back();
+            m_proxies[id] = p;
+            m_free.pop_back();
+        }
+        else
+        {
+            id = static_cast<ProxyID>( m_proxies.size() );
+            m_proxies.push_back( p );
+        }
+
+        try
+        {
+            insertCells_( id, p.cells );
+        }
+        catch ( ... )
+        {
+            removeCells_( id, p.cells );
+            m_proxies[id].alive = false;
+            m_free.push_back( id );
+            throw;
+        }
+
+        ++m_count;
+        return id;
+    }
+
+    // Update the cells of a proxy after its shape changed
+    void rebin_( const ProxyID id ) noexcept
+    {
+        Proxy& p = m_proxies[id];
+        const CellRange OLD = p.cells;
+        setBounds( p );
+        p.cells = cellRange_( p );
+
+        if ( p.cells == OLD )
+            return;
+
+        removeCells_( id, OLD );
+
+        try
+        {
+            insertCells_( id, p.cells );
+        }
+        catch ( ... )
+        {
+            // Out of memory: the proxy is only in the cells it could be put in
+        }
+    }
+
+    bool valid_( const ProxyID id ) const noexcept
+    {
+        return id < m_proxies.size() && m_proxies[id].alive;
+    }
+
+    /*
+        A proxy that overlaps the query range may be found in several cells.
+        It is only reported in the first cell shared by both ranges.
+    */
+    template <typename Test>
+    void query_( const Proxy& q, std::vector<ProxyID>& result, Test test ) const
+    {
+        result.clear();
+        const CellRange R = cellRange_( q );
+        const double NB_CELLS = ( static_cast<double>( R.x1 ) - R.x0 + 1.0 )
+                                * ( static_cast<double>( R.y1 ) - R.y0 + 1.0 );
+
+        // Wide query: look at every proxy instead of every cell
+        if ( NB_CELLS > static_cast<double>( m_count ) )
+        {
+            for ( ProxyID id = 0; id < m_proxies.size(); ++id )
+            {
+                const Proxy& p = m_proxies[id];
+
+                if ( p.alive && overlap( p, q ) && test( p ) )
+                    result.push_back( id );
+            }
+
+            return;
+        }
+
+        for ( int y = R.y0; y <= R.y1; ++y )
+        {
+            for ( int x = R.x0; x <= R.x1; ++x )
+            {
+                auto it = m_cells.find( cellKey( x, y ) );
+
+                if ( it == m_cells.end() )
+                    continue;
+
+                for ( const ProxyID id : it->second )
+                {
+                    const Proxy& p = m_proxies[id];
+
+                    if ( std::max( R.x0, p.cells.x0 ) == x && std::max( R.y0, p.cells.y0 ) == y
+                            && overlap( p, q ) && test( p ) )
+                    {
+                        result.push_back( id );
+                    }
+                }
+            }
+        }
+
+        std::sort( result.begin(), result.end() );
+    }
+
+public:
+
+    explicit CollisionWorld_( const float cell_size )
+        : M_INV_CELL( 1.0f / cell_size ), m_proxies(), m_free(), m_cells(), m_count( 0 )
+    {
+        if ( !( cell_size > 0.0f ) )
+            throw std::invalid_argument( "CollisionWorld: the size of a cell must be positive" );
+    }
+
+    ProxyID addBox( const FloatingBox& box, void * user_data, const CollisionFilter& filter )
+    {
+        Proxy p{ ShapeType::BOX, box, Circle(), nullptr, 0.0f, 0.0f, 0.0f, 0.0f,
+                 CellRange(), user_data, filter.category, filter.mask, false };
+        return add_( p );
+    }
+
+    /*
+    *   The queries are const and may run on several threads:
+    *   every lazy cache of the polygon (box, convexity, convex parts)
+    *   is filled here, so they only read it
+    */
+    static void fillCache_( const Polygon& poly )
+    {
+        poly.numberOfConvexParts();
+    }
+
+    ProxyID addCircle( const Circle& circle, void * user_data, const CollisionFilter& filter )
+    {
+        Proxy p{ ShapeType::CIRCLE, FloatingBox(), circle, nullptr, 0.0f, 0.0f, 0.0f, 0.0f,
+                 CellRange(), user_data, filter.category, filter.mask, false };
+        return add_( p );
+    }
+
+    ProxyID addPolygon( const Polygon& poly, void * user_data, const CollisionFilter& filter )
+    {
+        fillCache_( poly );
+        Proxy p{ ShapeType::POLYGON, FloatingBox(), Circle(), &poly, 0.0f, 0.0f, 0.0f, 0.0f,
+                 CellRange(), user_data, filter.category, filter.mask, false };
+        return add_( p );
+    }
+
+    void updateBox( const ProxyID id, const FloatingBox& box ) noexcept
+    {
+        if ( valid_( id ) && m_proxies[id].type == ShapeType::BOX )
+        {
+            m_proxies[id].box = box;
+            rebin_( id );
+        }
+    }
+
+    void updateCircle( const ProxyID id, const Circle& circle ) noexcept
+    {
+        if ( valid_( id ) && m_proxies[id].type == ShapeType::CIRCLE )
+        {
+            m_proxies[id].circle = circle;
+            rebin_( id );
+        }
+    }
+
+    void updatePolygon( const ProxyID id )
+    {
+        if ( valid_( id ) && m_proxies[id].type == ShapeType::POLYGON )
+        {
+            // Check the polygon before touching the cells
+            m_proxies[id].poly->getEnclosingBox();
+            fillCache_( *m_proxies[id].poly );
+            rebin_( id );
+        }
+    }
+
+    bool remove( const ProxyID id ) noexcept
+    {
+        if ( !valid_( id ) )
+            return false;
+
+        removeCells_( id, m_proxies[id].cells );
+        m_proxies[id].alive = false;
+        m_proxies[id].poly = nullptr;
+        --m_count;
+
+        try
+        {
+            m_free.push_back( id );
+        }
+        catch ( ... )
+        {
+            // The identifier is lost, but the world is still consistent
+        }
+
+        return true;
+    }
+
+    void * getUserData( const ProxyID id ) const noexcept
+    {
+        return valid_( id ) ? m_proxies[id].data : nullptr;
+    }
+
+    void setFilter( const ProxyID id, const CollisionFilter& filter ) noexcept
+    {
+        if ( valid_( id ) )
+        {
+            m_proxies[id].category = filter.category;
+            m_proxies[id].mask = filter.mask;
+        }
+    }
+
+    CollisionFilter getFilter( const ProxyID id ) const noexcept
+    {
+        return valid_( id ) ? CollisionFilter{ m_proxies[id].category, m_proxies[id].mask }
+               : CollisionFilter{ 0, 0 };
+    }
+
+    size_t size() const noexcept
+    {
+        return m_count;
+    }
+
+    void findPairs( std::vector<ProxyPair>& pairs ) const
+    {
+        pairs.clear();
+
+        for ( const auto& entry : m_cells )
+        {
+            const Cell& cell = entry.second;
+            const size_t N = cell.size();
+
+            if ( N < 2 )
+                continue;
+
+            const int X = static_cast<int>( static_cast<uint32_t>( entry.first >> 32 ) );
+            const int Y = static_cast<int>( static_cast<uint32_t>( entry.first ) );
+
+            // The categories in the cell: a proxy that rejects all of them is skipped
+            uint32_t categories = 0;
+
+            for ( const ProxyID ID : cell )
+                categories |= m_proxies[ID].category;
+
+            for ( size_t i = 0; i < N; ++i )
+            {
+                const Proxy& a = m_proxies[cell[i]];
+
+                if ( ( a.mask & categories ) == 0 )
+                    continue;
+
+                for ( size_t j = i + 1; j < N; ++j )
+                {
+                    const Proxy& b = m_proxies[cell[j]];
+
+                    // Report the pair in the first cell shared by the two proxies only
+                    if ( !accept( a, b ) || std::max( a.cells.x0, b.cells.x0 ) != X
+                            || std::max( a.cells.y0, b.cells.y0 ) != Y || !overlap( a, b ) )
+                        continue;
+
+                    pairs.push_back( cell[i] < cell[j] ? ProxyPair{ cell[i], cell[j] }
+                                     : ProxyPair{ cell[j], cell[i] } );
+                }
+            }
+        }
+
+        std::sort( pairs.begin(), pairs.end(), []( const ProxyPair & a, const ProxyPair & b )
+        {
+            return a.first < b.first || ( a.first == b.first && a.second < b.second );
+        } );
+    }
+
+    void findCollisions( std::vector<ProxyPair>& pairs ) const
+    {
+        findPairs( pairs );
+
+        auto it = std::remove_if( pairs.begin(), pairs.end(), [this]( const ProxyPair & p )
+        {
+            return !collide_( m_proxies[p.first], m_proxies[p.second] );
+        } );
+
+        pairs.erase( it, pairs.end() );
+    }
+
+    bool collide( const ProxyID a, const ProxyID b ) const
+    {
+        if ( !valid_( a ) || !valid_( b ) )
+            return false;
+
+        return overlap( m_proxies[a], m_proxies[b] )
+               && collide_( m_proxies[a], m_proxies[b] );
+    }
+
+    void queryPoint( const FloatPosition& p, std::vector<ProxyID>& result ) const
+    {
+        const Proxy Q{ ShapeType::BOX, FloatingBox{ p, 0, 0 }, Circle(), nullptr,
+                       p.x.v, p.y.v, p.x.v, p.y.v, CellRange(), nullptr,
+                       NO_LAYER, NO_LAYER, true };
+
+        query_( Q, result, [&p]( const Proxy & a )
+        {
+            return contains_( a, p );
+        } );
+    }
+
+    void queryBox( const FloatingBox& box, std::vector<ProxyID>& result ) const
+    {
+        Proxy Q{ ShapeType::BOX, box, Circle(), nullptr, 0.0f, 0.0f, 0.0f, 0.0f,
+                 CellRange(), nullptr, NO_LAYER, NO_LAYER, true };
+        setBounds( Q );
+
+        query_( Q, result, [&Q]( const Proxy & a )
+        {
+            return collide_( a, Q );
+        } );
+    }
+
+    void queryCircle( const Circle& circle, std::vector<ProxyID>& result ) const
+    {
+        Proxy Q{ ShapeType::CIRCLE, FloatingBox(), circle, nullptr, 0.0f, 0.0f, 0.0f, 0.0f,
+                 CellRange(), nullptr, NO_LAYER, NO_LAYER, true };
+        setBounds( Q );
+
+        query_( Q, result, [&Q]( const Proxy & a )
+        {
+            return collide_( a, Q );
+        } );
+    }
+
+    ProxyID segmentCast( const Segment& s, RayHit& hit ) const
+    {
+        const float INF = std::numeric_limits<float>::infinity();
+        const float DX = s.q.x.v - s.p.x.v;
+        const float DY = s.q.y.v - s.p.y.v;
+        const int X0 = cellCoord_( s.p.x.v ), Y0 = cellCoord_( s.p.y.v );
+        const int X1 = cellCoord_( s.q.x.v ), Y1 = cellCoord_( s.q.y.v );
+        const int STEPS = std::abs( X1 - X0 ) + std::abs( Y1 - Y0 );
+
+        ProxyID best = NULL_PROXY;
+        hit.fraction = INF;
+
+        auto test = [&s, &hit, &best]( const Proxy & p, const ProxyID id )
+        {
+            RayHit h;
+
+            if ( raycast_( p, s, h ) && ( h.fraction < hit.fraction
+                                          || ( h.fraction == hit.fraction && id < best ) ) )
+            {
+                hit = h;
+                best = id;
+            }
+        };
+
+        // Long segment: look at every proxy instead of every cell
+        if ( static_cast<size_t>( STEPS ) >= m_count )
+        {
+            const Proxy Q{ ShapeType::BOX, FloatingBox(), Circle(), nullptr,
+                           std::min( s.p.x.v, s.q.x.v ), std::min( s.p.y.v, s.q.y.v ),
+                           std::max( s.p.x.v, s.q.x.v ), std::max( s.p.y.v, s.q.y.v ),
+                           CellRange(), nullptr, NO_LAYER, NO_LAYER, true };
+
+            for ( ProxyID id = 0; id < m_proxies.size(); ++id )
+            {
+                if ( m_proxies[id].alive && overlap( m_proxies[id], Q ) )
+                    test( m_proxies[id], id );
+            }
+
+            return best;
+        }
+
+        // Visit the cells in the order of the segment (Amanatides & Woo)
+        const float CELL = 1.0f / M_INV_CELL;
+        const int SX = DX > 0.0f ? 1 : -1;
+        const int SY = DY > 0.0f ? 1 : -1;
+        const float DELTA_X = DX != 0.0f ? CELL / std::abs( DX ) : INF;
+        const float DELTA_Y = DY != 0.0f ? CELL / std::abs( DY ) : INF;
+        float t_max_x = DX != 0.0f ? ( static_cast<float>( X0 + ( SX > 0 ? 1 : 0 ) ) * CELL
+                                       - s.p.x.v ) / DX : INF;
+        float t_max_y = DY != 0.0f ? ( static_cast<float>( Y0 + ( SY > 0 ? 1 : 0 ) ) * CELL
+                                       - s.p.y.v ) / DY : INF;
+        int x = X0, y = Y0;
+        int prev_x = X0, prev_y = Y0;
+
+        for ( int n = 0; n <= STEPS; ++n )
+        {
+            auto it = m_cells.find( cellKey( x, y ) );
+
+            if ( it != m_cells.end() )
+            {
+                for ( const ProxyID id : it->second )
+                {
+                    const CellRange& R = m_proxies[id].cells;
+
+                    /*
+                        A proxy on several cells is only tested in the first one:
+                        x and y are monotonic along the segment, so the cells
+                        of a proxy are visited one after the other
+                    */
+                    if ( n > 0 && R.x0 <= prev_x && prev_x <= R.x1
+                            && R.y0 <= prev_y && prev_y <= R.y1 )
+                        continue;
+
+                    test( m_proxies[id], id );
+                }
+            }
+
+            prev_x = x;
+            prev_y = y;
+
+            // The next cells are farther than the hit
+            if ( best != NULL_PROXY && hit.fraction <= std::min( t_max_x, t_max_y ) )
+                break;
+
+            if ( y == Y1 || ( x != X1 && t_max_x < t_max_y ) )
+            {
+                x += SX;
+                t_max_x += DELTA_X;
+            }
+            else
+            {
+                y += SY;
+                t_max_y += DELTA_Y;
+            }
+        }
+
+        return best;
+    }
+
+    ProxyID rayCast( const FloatPosition& origin, const Vector2D& direction,
+                     const float length, RayHit& hit ) const
+    {
+        const float NORM = std::sqrt( direction.vx.v * direction.vx.v
+                                      + direction.vy.v * direction.vy.v );
+
+        if ( !( NORM > 0.0f ) || !( length > 0.0f ) )
+            return NULL_PROXY;
+
+        const float K = length / NORM;
+        const FloatPosition Q{ origin.x.v + direction.vx.v * K, origin.y.v + direction.vy.v * K };
+        return segmentCast( Segment{ origin, Q }, hit );
+    }
+
+    ~CollisionWorld_() = default;
+};
+
+
+/* Public functions */
+
+CollisionWorld::CollisionWorld( const float cell_size )
+    : m_cwimpl( new CollisionWorld_( cell_size ) ) {}
+
+ProxyID CollisionWorld::addBox( const FloatingBox& box, void * user_data,
+                                const CollisionFilter& filter )
+{
+    return m_cwimpl->addBox( box, user_data, filter );
+}
+
+ProxyID CollisionWorld::addCircle( const Circle& circle, void * user_data,
+                                   const CollisionFilter& filter )
+{
+    return m_cwimpl->addCircle( circle, user_data, filter );
+}
+
+ProxyID CollisionWorld::addPolygon( const Polygon& poly, void * user_data,
+                                    const CollisionFilter& filter )
+{
+    return m_cwimpl->addPolygon( poly, user_data, filter );
+}
+
+void CollisionWorld::updateBox( const ProxyID id, const FloatingBox& box ) noexcept
+{
+    m_cwimpl->updateBox( id, box );
+}
+
+void CollisionWorld::updateCircle( const ProxyID id, const Circle& circle ) noexcept
+{
+    m_cwimpl->updateCircle( id, circle );
+}
+
+void CollisionWorld::updatePolygon( const ProxyID id )
+{
+    m_cwimpl->updatePolygon( id );
+}
+
+bool CollisionWorld::remove( const ProxyID id ) noexcept
+{
+    return m_cwimpl->remove( id );
+}
+
+void * CollisionWorld::getUserData( const ProxyID id ) const noexcept
+{
+    return m_cwimpl->getUserData( id );
+}
+
+void CollisionWorld::setFilter( const ProxyID id, const CollisionFilter& filter ) noexcept
+{
+    m_cwimpl->setFilter( id, filter );
+}
+
+CollisionFilter CollisionWorld::getFilter( const ProxyID id ) const noexcept
+{
+    return m_cwimpl->getFilter( id );
+}
+
+size_t CollisionWorld::size() const noexcept
+{
+    return m_cwimpl->size();
+}
+
+void CollisionWorld::findPairs( std::vector<ProxyPair>& pairs ) const
+{
+    m_cwimpl->findPairs( pairs );
+}
+
+void CollisionWorld::findCollisions( std::vector<ProxyPair>& pairs ) const
+{
+    m_cwimpl->findCollisions( pairs );
+}
+
+bool CollisionWorld::collide( const ProxyID a, const ProxyID b ) const
+{
+    return m_cwimpl->collide( a, b );
+}
+
+void CollisionWorld::queryPoint( const FloatPosition& p, std::vector<ProxyID>& result ) const
+{
+    m_cwimpl->queryPoint( p, result );
+}
+
+void CollisionWorld::queryBox( const FloatingBox& box, std::vector<ProxyID>& result ) const
+{
+    m_cwimpl->queryBox( box, result );
+}
+
+void CollisionWorld::queryCircle( const Circle& circle, std::vector<ProxyID>& result ) const
+{
+    m_cwimpl->queryCircle( circle, result );
+}
+
+ProxyID CollisionWorld::segmentCast( const Segment& s, RayHit& hit ) const
+{
+    return m_cwimpl->segmentCast( s, hit );
+}
+
+ProxyID CollisionWorld::rayCast( const FloatPosition& origin, const Vector2D& direction,
+                                 const float length, RayHit& hit ) const
+{
+    return m_cwimpl->rayCast( origin, direction, length, hit );
+}
+
+CollisionWorld::~CollisionWorld()
+{
+    m_cwimpl.reset();
+}
+
+}   // Physics
+
+}   // lx
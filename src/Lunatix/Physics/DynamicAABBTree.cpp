@@ -0,0 +1,646 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file DynamicAABBTree.cpp
+*   @brief The implementation of the dynamic bounding volume hierarchy
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/DynamicAABBTree.hpp>
+#include <Lunatix/Polygon.hpp>
+#include <Lunatix/Vector2D.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+
+namespace
+{
+
+using lx::Physics::ProxyID;
+
+const int NULL_NODE = -1;
+const float DISPLACEMENT_FACTOR = 2.0f;     // How far the movement is predicted
+
+struct AABB final
+{
+    float min_x, min_y, max_x, max_y;
+};
+
+inline AABB combine( const AABB& a, const AABB& b ) noexcept
+{
+    return AABB{ std::min( a.min_x, b.min_x ), std::min( a.min_y, b.min_y ),
+                 std::max( a.max_x, b.max_x ), std::max( a.max_y, b.max_y ) };
+}
+
+// The cost of a box for the insertion heuristic
+inline float perimeter( const AABB& a ) noexcept
+{
+    return 2.0f * ( ( a.max_x - a.min_x ) + ( a.max_y - a.min_y ) );
+}
+
+inline bool contains( const AABB& a, const AABB& b ) noexcept
+{
+    return a.min_x <= b.min_x && a.min_y <= b.min_y
+           && b.max_x <= a.max_x && b.max_y <= a.max_y;
+}
+
+inline bool overlap( const AABB& a, const AABB& b ) noexcept
+{
+    return a.min_x <= b.max_x && b.min_x <= a.max_x
+           && a.min_y <= b.max_y && b.min_y <= a.max_y;
+}
+
+inline AABB toAABB( const lx::Physics::FloatingBox& b ) noexcept
+{
+    return AABB{ b.p.x.v, b.p.y.v, b.p.x.v + static_cast<float>( b.w ),
+                 b.p.y.v + static_cast<float>( b.h ) };
+}
+
+inline AABB toAABB( const lx::Physics::Circle& c ) noexcept
+{
+    const float R = static_cast<float>( c.radius );
+    return AABB{ c.center.x.v - R, c.center.y.v - R, c.center.x.v + R, c.center.y.v + R };
+}
+
+/*
+*   Slab test: the fraction of the segment p + t.d (t in [0, 1])
+*   where it enters the box, a negative value if it misses it
+*/
+float rayEnter( const float px, const float py, const float dx, const float dy,
+                const AABB& a ) noexcept
+{
+    float tmin = 0.0f;
+    float tmax = 1.0f;
+    const float P[2]  = { px, py };
+    const float D[2]  = { dx, dy };
+    const float LO[2] = { a.min_x, a.min_y };
+    const float HI[2] = { a.max_x, a.max_y };
+
+    for ( int i = 0; i < 2; ++i )
+    {
+        if ( D[i] == 0.0f )
+        {
+            if ( P[i] < LO[i] || P[i] > HI[i] )
+                return -1.0f;
+        }
+        else
+        {
+            float t1 = ( LO[i] - P[i] ) / D[i];
+            float t2 = ( HI[i] - P[i] ) / D[i];
+
+            if ( t1 > t2 )
+                std::swap( t1, t2 );
+
+            tmin = std::max( tmin, t1 );
+            tmax = std::min( tmax, t2 );
+
+            if ( tmin > tmax )
+                return -1.0f;
+        }
+    }
+
+    return tmin;
+}
+
+struct Node final
+{
+    AABB fat;           // Leaf: fattened box, internal node: union of the children
+    AABB tight;         // Leaf: bounding box of the shape
+    void * data;
+    int parent;         // Next free node if the node is not used
+    int child1;
+    int child2;
+    int height;         // Leaf: 0, free node: -1
+
+    bool isLeaf() const noexcept
+    {
+        return child1 == NULL_NODE;
+    }
+};
+
+}
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+/* Private implementation */
+
+class DynamicAABBTree_ final
+{
+    std::vector<Node> m_nodes;
+    int m_root;
+    int m_free;
+    size_t m_count;
+    float m_margin;
+
+    DynamicAABBTree_( const DynamicAABBTree_& ) = delete;
+    DynamicAABBTree_& operator =( const DynamicAABBTree_& ) = delete;
+
+    int allocate_()
+    {
+        if ( m_free == NULL_NODE )
+        {
+            m_nodes.push_back( Node{ AABB{ 0.0f, 0.0f, 0.0f, 0.0f },
+                                     AABB{ 0.0f, 0.0f, 0.0f, 0.0f },
+                                     nullptr, NULL_NODE, NULL_NODE, NULL_NODE, -1 } );
+            m_free = static_cast<int>( m_nodes.size() ) - 1;
+            m_nodes[m_free].parent = NULL_NODE;
+        }
+
+        const int ID = m_free;
+        Node& n = m_nodes[ID];
+        m_free = n.parent;
+        n.parent = NULL_NODE;
+        n.child1 = NULL_NODE;
+        n.child2 = NULL_NODE;
+        n.height = 0;
+        n.data = nullptr;
+        return ID;
+    }
+
+    void release_( const int id ) noexcept
+    {
+        m_nodes[id].parent = m_free;
+        m_nodes[id].height = -1;
+        m_free = id;
+    }
+
+    bool isProxy_( const ProxyID id ) const noexcept
+    {
+        return id < m_nodes.size() && m_nodes[id].height == 0;
+    }
+
+    void fatten_( Node& leaf, const float dx, const float dy ) const noexcept
+    {
+        leaf.fat = AABB{ leaf.tight.min_x - m_margin, leaf.tight.min_y - m_margin,
+                         leaf.tight.max_x + m_margin, leaf.tight.max_y + m_margin };
+
+        // Extend the box in the direction of the movement
+        const float DX = DISPLACEMENT_FACTOR * dx;
+        const float DY = DISPLACEMENT_FACTOR * dy;
+        ( DX < 0.0f ? leaf.fat.min_x : leaf.fat.max_x ) += DX;
+        ( DY < 0.0f ? leaf.fat.min_y : leaf.fat.max_y ) += DY;
+    }
+
+    // Recompute the boxes and the heights from a node to the root
+    void refit_( int index ) noexcept
+    {
+        while ( index != NULL_NODE )
+        {
+            index = balance_( index );
+
+            Node& n = m_nodes[index];
+            const Node& C1 = m_nodes[n.child1];
+            const Node& C2 = m_nodes[n.child2];
+            n.height = 1 + std::max( C1.height, C2.height );
+            n.fat = combine( C1.fat, C2.fat );
+            index = n.parent;
+        }
+    }
+
+    void replaceChild_( const int parent, const int old_child, const int new_child ) noexcept
+    {
+        if ( parent == NULL_NODE )
+            m_root = new_child;
+        else if ( m_nodes[parent].child1 == old_child )
+            m_nodes[parent].child1 = new_child;
+        else
+            m_nodes[parent].child2 = new_child;
+    }
+
+    /*
+    *   If the subtree of a is unbalanced, rotate its highest child up.
+    *   Return the new root of the subtree.
+    */
+    int balance_( const int ia ) noexcept
+    {
+        Node& A = m_nodes[ia];
+
+        if ( A.isLeaf() || A.height < 2 )
+            return ia;
+
+        const int IB = A.child1;
+        const int IC = A.child2;
+        const int BALANCE = m_nodes[IC].height - m_nodes[IB].height;
+
+        if ( BALANCE > 1 )
+            return rotate_( ia, IC, false );
+
+        if ( BALANCE < -1 )
+            return rotate_( ia, IB, true );
+
+        return ia;
+    }
+
+    /*
+    *   Rotate the child up, a becomes its child. The highest grandchild
+    *   stays under the child, the other one goes under a.
+    */
+    int rotate_( const int ia, const int iup, const bool up_is_child1 ) noexcept
+    {
+        Node& A = m_nodes[ia];
+        Node& U = m_nodes[iup];
+        const int IF = U.child1;
+        const int IG = U.child2;
+        const int IHIGH = m_nodes[IF].height > m_nodes[IG].height ? IF : IG;
+        const int ILOW = IHIGH == IF ? IG : IF;
+
+        U.child1 = ia;
+        U.parent = A.parent;
+        A.parent = iup;
+        replaceChild_( U.parent, ia, iup );
+
+        U.child2 = IHIGH;
+
+        if ( up_is_child1 )
+            A.child1 = ILOW;
+        else
+            A.child2 = ILOW;
+
+        m_nodes[ILOW].parent = ia;
+
+        const Node& C1 = m_nodes[A.child1];
+        const Node& C2 = m_nodes[A.child2];
+        A.fat = combine( C1.fat, C2.fat );
+        A.height = 1 + std::max( C1.height, C2.height );
+        U.fat = combine( A.fat, m_nodes[IHIGH].fat );
+        U.height = 1 + std::max( A.height, m_nodes[IHIGH].height );
+        return iup;
+    }
+
+    void insertLeaf_( const int leaf )
+    {
+        if ( m_root == NULL_NODE )
+        {
+            m_root = leaf;
+            m_nodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // Find the best sibling (surface area heuristic)
+        const AABB LEAF_BOX = m_nodes[leaf].fat;
+        int index = m_root;
+
+        while ( !m_nodes[index].isLeaf() )
+        {
+            const Node& N = m_nodes[index];
+            const float AREA = perimeter( N.fat );
+            const float COMBINED = perimeter( combine( N.fat, LEAF_BOX ) );
+
+            // Cost of creating a new parent for this node and the new leaf
+            const float COST = 2.0f * COMBINED;
+            // Minimum cost of pushing the leaf further down the tree
+            const float INHERITANCE = 2.0f * ( COMBINED - AREA );
+
+            auto descentCost = [&]( const Node& c ) -> float
+            {
+                const float NEW_AREA = perimeter( combine( LEAF_BOX, c.fat ) );
+                return ( c.isLeaf() ? NEW_AREA : NEW_AREA - perimeter( c.fat ) ) + INHERITANCE;
+            };
+
+            const float COST1 = descentCost( m_nodes[N.child1] );
+            const float COST2 = descentCost( m_nodes[N.child2] );
+
+            if ( COST < COST1 && COST < COST2 )
+                break;
+
+            index = COST1 < COST2 ? N.child1 : N.child2;
+        }
+
+        const int SIBLING = index;
+        const int OLD_PARENT = m_nodes[SIBLING].parent;
+        const int NEW_PARENT = allocate_();     // May reallocate the nodes
+
+        Node& p = m_nodes[NEW_PARENT];
+        p.parent = OLD_PARENT;
+        p.fat = combine( LEAF_BOX, m_nodes[SIBLING].fat );
+        p.height = m_nodes[SIBLING].height + 1;
+        p.child1 = SIBLING;
+        p.child2 = leaf;
+        m_nodes[SIBLING].parent = NEW_PARENT;
+        m_nodes[leaf].parent = NEW_PARENT;
+        replaceChild_( OLD_PARENT, SIBLING, NEW_PARENT );
+
+        refit_( NEW_PARENT );
+    }
+
+    void removeLeaf_( const int leaf ) noexcept
+    {
+        if ( leaf == m_root )
+        {
+            m_root = NULL_NODE;
+            return;
+        }
+
+        const int PARENT = m_nodes[leaf].parent;
+        const int GRAND_PARENT = m_nodes[PARENT].parent;
+        const int SIBLING = m_nodes[PARENT].child1 == leaf ?
+                            m_nodes[PARENT].child2 : m_nodes[PARENT].child1;
+
+        replaceChild_( GRAND_PARENT, PARENT, SIBLING );
+        m_nodes[SIBLING].parent = GRAND_PARENT;
+        release_( PARENT );
+        refit_( GRAND_PARENT );
+    }
+
+    ProxyID add_( const AABB& box, void * data )
+    {
+        const int ID = allocate_();
+        Node& leaf = m_nodes[ID];
+        leaf.tight = box;
+        leaf.data = data;
+        fatten_( leaf, 0.0f, 0.0f );
+        insertLeaf_( ID );
+        ++m_count;
+        return static_cast<ProxyID>( ID );
+    }
+
+    // Visit the leaves whose fattened box overlaps the box
+    template <typename Visitor>
+    void query_( const AABB& box, std::vector<int>& stack, Visitor visit ) const
+    {
+        if ( m_root == NULL_NODE )
+            return;
+
+        stack.clear();
+        stack.push_back( m_root );
+
+        while ( !stack.empty() )
+        {
+            const Node& N = m_nodes[stack.back()];
+            const int ID = stack.back();
+            stack.pop_back();
+
+            if ( !overlap( N.fat, box ) )
+                continue;
+
+            if ( N.isLeaf() )
+                visit( ID );
+            else
+            {
+                stack.push_back( N.child1 );
+                stack.push_back( N.child2 );
+            }
+        }
+    }
+
+public:
+
+    explicit DynamicAABBTree_( const float margin ) noexcept
+        : m_nodes(), m_root( NULL_NODE ), m_free( NULL_NODE ), m_count( 0 ),
+          m_margin( std::max( margin, 0.0f ) ) {}
+
+    ProxyID addBox( const FloatingBox& box, void * data )
+    {
+        return add_( toAABB( box ), data );
+    }
+
+    ProxyID addCircle( const Circle& circle, void * data )
+    {
+        return add_( toAABB( circle ), data );
+    }
+
+    ProxyID addPolygon( const Polygon& poly, void * data )
+    {
+        return add_( toAABB( poly.getEnclosingBox() ), data );
+    }
+
+    bool move( const ProxyID id, const AABB& box, const Vector2D& v ) noexcept
+    {
+        if ( !isProxy_( id ) )
+            return false;
+
+        const int ID = static_cast<int>( id );
+        Node& leaf = m_nodes[ID];
+        leaf.tight = box;
+
+        if ( contains( leaf.fat, box ) )
+            return false;
+
+        removeLeaf_( ID );
+        fatten_( m_nodes[ID], v.vx.v, v.vy.v );
+        // No allocation: the parent released by removeLeaf_() is reused
+        insertLeaf_( ID );
+        return true;
+    }
+
+    bool remove( const ProxyID id ) noexcept
+    {
+        if ( !isProxy_( id ) )
+            return false;
+
+        removeLeaf_( static_cast<int>( id ) );
+        release_( static_cast<int>( id ) );
+        --m_count;
+        return true;
+    }
+
+    void * getUserData( const ProxyID id ) const noexcept
+    {
+        return isProxy_( id ) ? m_nodes[id].data : nullptr;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_count;
+    }
+
+    int getHeight() const noexcept
+    {
+        return m_root == NULL_NODE ? -1 : m_nodes[m_root].height;
+    }
+
+    void findPairs( std::vector<ProxyPair>& pairs ) const
+    {
+        pairs.clear();
+        std::vector<ProxyID> found;
+        std::vector<int> stack;
+
+        // Every leaf queries the tree, the pair is kept by its smallest proxy
+        for ( size_t i = 0; i < m_nodes.size(); ++i )
+        {
+            const Node& LEAF = m_nodes[i];
+
+            if ( LEAF.height != 0 )
+                continue;
+
+            found.clear();
+            query_( LEAF.tight, stack, [&]( const int j )
+            {
+                if ( static_cast<size_t>( j ) > i && overlap( LEAF.tight, m_nodes[j].tight ) )
+                    found.push_back( static_cast<ProxyID>( j ) );
+            } );
+
+            std::sort( found.begin(), found.end() );
+
+            for ( const ProxyID J : found )
+                pairs.push_back( ProxyPair{ static_cast<ProxyID>( i ), J } );
+        }
+    }
+
+    void queryBox( const FloatingBox& box, std::vector<ProxyID>& result ) const
+    {
+        result.clear();
+        const AABB B = toAABB( box );
+        std::vector<int> stack;
+
+        query_( B, stack, [&]( const int id )
+        {
+            if ( overlap( B, m_nodes[id].tight ) )
+                result.push_back( static_cast<ProxyID>( id ) );
+        } );
+
+        std::sort( result.begin(), result.end() );
+    }
+
+    void queryRay( const Segment& s, std::vector<ProxyID>& result ) const
+    {
+        result.clear();
+
+        if ( m_root == NULL_NODE )
+            return;
+
+        const float PX = s.p.x.v;
+        const float PY = s.p.y.v;
+        const float DX = s.q.x.v - PX;
+        const float DY = s.q.y.v - PY;
+
+        std::vector<std::pair<float, ProxyID>> hits;
+        std::vector<int> stack;
+        stack.reserve( 64 );
+        stack.push_back( m_root );
+
+        while ( !stack.empty() )
+        {
+            const int ID = stack.back();
+            const Node& N = m_nodes[ID];
+            stack.pop_back();
+
+            if ( rayEnter( PX, PY, DX, DY, N.fat ) < 0.0f )
+                continue;
+
+            if ( N.isLeaf() )
+            {
+                const float T = rayEnter( PX, PY, DX, DY, N.tight );
+
+                if ( T >= 0.0f )
+                    hits.push_back( std::make_pair( T, static_cast<ProxyID>( ID ) ) );
+            }
+            else
+            {
+                stack.push_back( N.child1 );
+                stack.push_back( N.child2 );
+            }
+        }
+
+        std::sort( hits.begin(), hits.end() );
+        result.reserve( hits.size() );
+
+        for ( const auto& h : hits )
+            result.push_back( h.second );
+    }
+
+    ~DynamicAABBTree_() = default;
+};
+
+
+/* Public functions */
+
+DynamicAABBTree::DynamicAABBTree( const float margin )
+    : m_timpl( new DynamicAABBTree_( margin ) ) {}
+
+
+ProxyID DynamicAABBTree::addBox( const FloatingBox& box, void * user_data )
+{
+    return m_timpl->addBox( box, user_data );
+}
+
+ProxyID DynamicAABBTree::addCircle( const Circle& circle, void * user_data )
+{
+    return m_timpl->addCircle( circle, user_data );
+}
+
+ProxyID DynamicAABBTree::addPolygon( const Polygon& poly, void * user_data )
+{
+    return m_timpl->addPolygon( poly, user_data );
+}
+
+
+bool DynamicAABBTree::moveBox( const ProxyID id, const FloatingBox& box,
+                               const Vector2D& v ) noexcept
+{
+    return m_timpl->move( id, toAABB( box ), v );
+}
+
+bool DynamicAABBTree::moveCircle( const ProxyID id, const Circle& circle,
+                                  const Vector2D& v ) noexcept
+{
+    return m_timpl->move( id, toAABB( circle ), v );
+}
+
+bool DynamicAABBTree::movePolygon( const ProxyID id, const Polygon& poly, const Vector2D& v )
+{
+    return m_timpl->move( id, toAABB( poly.getEnclosingBox() ), v );
+}
+
+bool DynamicAABBTree::remove( const ProxyID id ) noexcept
+{
+    return m_timpl->remove( id );
+}
+
+
+void * DynamicAABBTree::getUserData( const ProxyID id ) const noexcept
+{
+    return m_timpl->getUserData( id );
+}
+
+size_t DynamicAABBTree::size() const noexcept
+{
+    return m_timpl->size();
+}
+
+int DynamicAABBTree::getHeight() const noexcept
+{
+    return m_timpl->getHeight();
+}
+
+
+void DynamicAABBTree::findPairs( std::vector<ProxyPair>& pairs ) const
+{
+    m_timpl->findPairs( pairs );
+}
+
+void DynamicAABBTree::queryBox( const FloatingBox& box, std::vector<ProxyID>& result ) const
+{
+    m_timpl->queryBox( box, result );
+}
+
+void DynamicAABBTree::queryRay( const Segment& s, std::vector<ProxyID>& result ) const
+{
+    m_timpl->queryRay( s, result );
+}
+
+
+DynamicAABBTree::~DynamicAABBTree()
+{
+    m_timpl.reset();
+}
+
+}   // Physics
+
+}   // lx
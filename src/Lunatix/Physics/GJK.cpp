@@ -0,0 +1,654 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file GJK.cpp
+*   @brief The implementation of the narrow phase (GJK and EPA)
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/GJK.hpp>
+#include <Lunatix/Polygon.hpp>
+
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+
+namespace
+{
+
+const int GJK_MAX_ITERATIONS = 64;
+const int EPA_MAX_ITERATIONS = 64;
+const float EPA_TOLERANCE = 0.01f;
+const float EPSILON = 1e-6f;
+
+struct V2 final
+{
+    float x, y;
+};
+
+inline V2 operator +( const V2& a, const V2& b ) noexcept
+{
+    return V2{ a.x + b.x, a.y + b.y };
+}
+
+inline V2 operator -( const V2& a, const V2& b ) noexcept
+{
+    return V2{ a.x - b.x, a.y - b.y };
+}
+
+inline V2 operator -( const V2& a ) noexcept
+{
+    return V2{ -a.x, -a.y };
+}
+
+inline V2 operator *( const V2& a, const float s ) noexcept
+{
+    return V2{ a.x * s, a.y * s };
+}
+
+inline float dot( const V2& a, const V2& b ) noexcept
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+inline float cross( const V2& a, const V2& b ) noexcept
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+inline V2 normalize( const V2& a ) noexcept
+{
+    const float L = std::sqrt( dot( a, a ) );
+    return L > EPSILON ? a * ( 1.0f / L ) : V2{ 0.0f, 0.0f };
+}
+
+// (a × b) × c, the component of c orthogonal to a, towards b
+inline V2 tripleProduct( const V2& a, const V2& b, const V2& c ) noexcept
+{
+    return b * dot( a, c ) - a * dot( b, c );
+}
+
+inline V2 toV2( const lx::Physics::FloatPosition& p ) noexcept
+{
+    return V2{ p.x.v, p.y.v };
+}
+
+inline V2 support( const lx::Physics::ConvexShape& s, const V2& d )
+{
+    return toV2( s.support( lx::Physics::Vector2D{ d.x, d.y } ) );
+}
+
+// Point of the Minkowski difference a - b
+inline V2 supportAB( const lx::Physics::ConvexShape& a, const lx::Physics::ConvexShape& b,
+                     const V2& d )
+{
+    return support( a, d ) - support( b, -d );
+}
+
+/*
+*   GJK: build a simplex of the Minkowski difference that contains the origin.
+*   The simplex is the triangle used by EPA if the shapes collide.
+*
+*   touching: an origin on the boundary of the Minkowski difference
+*   (the shapes touch each other) is inside
+*/
+bool gjk_( const lx::Physics::ConvexShape& a, const lx::Physics::ConvexShape& b,
+           V2 simplex[3], const bool touching = false )
+{
+    V2 d{ 1.0f, 0.0f };
+    simplex[0] = supportAB( a, b, d );
+    int n = 1;
+    d = -simplex[0];
+
+    if ( dot( d, d ) < EPSILON )
+    {
+        if ( touching )
+            return true;
+
+        d = V2{ 0.0f, 1.0f };
+    }
+
+    for ( int i = 0; i < GJK_MAX_ITERATIONS; ++i )
+    {
+        const V2 P = supportAB( a, b, d );
+        const float PD = dot( P, d );
+
+        // The origin is beyond the farthest point in this direction
+        if ( touching ? PD < 0.0f : PD <= 0.0f )
+            return false;
+
+        simplex[n++] = P;
+        const V2 AO = -P;
+
+        if ( n == 2 )
+        {
+            const V2 AB = simplex[0] - P;
+
+            // The origin is on the line of the segment, try one side
+            if ( std::abs( cross( AB, AO ) ) <= EPSILON * dot( AB, AB ) )
+                d = V2{ -AB.y, AB.x };
+            else
+                d = tripleProduct( AB, AO, AB );
+        }
+        else
+        {
+            const V2 AB = simplex[1] - P;
+            const V2 AC = simplex[0] - P;
+            const V2 AB_PERP = tripleProduct( AC, AB, AB );
+            const V2 AC_PERP = tripleProduct( AB, AC, AC );
+
+            // An origin on an edge is outside, so that the shapes that touch do not collide
+            const float SIDE_AB = dot( AB_PERP, AO );
+            const float SIDE_AC = dot( AC_PERP, AO );
+
+            if ( touching ? SIDE_AB > 0.0f : SIDE_AB >= 0.0f )
+            {
+                // Remove C
+                simplex[0] = simplex[1];
+                simplex[1] = P;
+                n = 2;
+                d = AB_PERP;
+            }
+            else if ( touching ? SIDE_AC > 0.0f : SIDE_AC >= 0.0f )
+            {
+                // Remove B
+                simplex[1] = P;
+                n = 2;
+                d = AC_PERP;
+            }
+            else
+                return true;
+
+            if ( dot( d, d ) < EPSILON )
+                return false;
+        }
+    }
+
+    return false;
+}
+
+/*
+*   EPA: expand the simplex to the edge of the Minkowski difference
+*   that is the closest to the origin
+*/
+void epa_( const lx::Physics::ConvexShape& a, const lx::Physics::ConvexShape& b,
+           const V2 simplex[3], V2& normal, float& depth )
+{
+    std::vector<V2> polytope( simplex, simplex + 3 );
+    const float WINDING = cross( simplex[1] - simplex[0], simplex[2] - simplex[0] );
+
+    if ( std::abs( WINDING ) < EPSILON )
+    {
+        // Degenerate simplex: the shapes are touching
+        normal = normalize( V2{ -( simplex[1].y - simplex[0].y ), simplex[1].x - simplex[0].x } );
+        depth = 0.0f;
+        return;
+    }
+
+    for ( int it = 0; it < EPA_MAX_ITERATIONS; ++it )
+    {
+        size_t index = 0;
+        float min_dist = 0.0f;
+        V2 min_normal{ 0.0f, 0.0f };
+
+        for ( size_t i = 0; i < polytope.size(); ++i )
+        {
+            const V2& P = polytope[i];
+            const V2& Q = polytope[( i + 1 ) % polytope.size()];
+            const V2 E = Q - P;
+            // Outward normal of the edge
+            const V2 N = normalize( WINDING > 0.0f ? V2{ E.y, -E.x } : V2{ -E.y, E.x } );
+            const float DIST = dot( N, P );
+
+            if ( i == 0 || DIST < min_dist )
+            {
+                index = i;
+                min_dist = DIST;
+                min_normal = N;
+            }
+        }
+
+        const V2 S = supportAB( a, b, min_normal );
+
+        if ( dot( S, min_normal ) - min_dist < EPA_TOLERANCE || it == EPA_MAX_ITERATIONS - 1 )
+        {
+            normal = min_normal;
+            depth = std::max( min_dist, 0.0f );
+            return;
+        }
+
+        polytope.insert( polytope.begin() + static_cast<long>( index ) + 1, S );
+    }
+}
+
+// The edge of a shape that is the most perpendicular to a direction
+struct Edge final
+{
+    V2 max;         // Farthest vertex in the direction
+    V2 a;
+    V2 b;
+};
+
+Edge bestEdge_( const lx::Physics::ConvexShape& s, const V2& n )
+{
+    const unsigned long N = s.numberOfVertices();
+    unsigned long index = 0;
+    float max_proj = dot( toV2( s.getVertex( 0 ) ), n );
+
+    for ( unsigned long i = 1; i < N; ++i )
+    {
+        const float PROJ = dot( toV2( s.getVertex( i ) ), n );
+
+        if ( PROJ > max_proj )
+        {
+            max_proj = PROJ;
+            index = i;
+        }
+    }
+
+    const V2 V = toV2( s.getVertex( index ) );
+    const V2 V_NEXT = toV2( s.getVertex( ( index + 1 ) % N ) );
+    const V2 V_PREV = toV2( s.getVertex( ( index + N - 1 ) % N ) );
+    const V2 L = normalize( V - V_NEXT );
+    const V2 R = normalize( V - V_PREV );
+
+    if ( dot( R, n ) <= dot( L, n ) )
+        return Edge{ V, V_PREV, V };
+    else
+        return Edge{ V, V, V_NEXT };
+}
+
+// Keep the part of the segment where dot(n, p) >= o
+// The points are copied, out may be the array of v1 and v2
+unsigned int clip_( const V2 v1, const V2 v2, const V2& n, const float o, V2 out[2] ) noexcept
+{
+    unsigned int count = 0;
+    const float D1 = dot( n, v1 ) - o;
+    const float D2 = dot( n, v2 ) - o;
+
+    if ( D1 >= 0.0f )
+        out[count++] = v1;
+
+    if ( D2 >= 0.0f )
+        out[count++] = v2;
+
+    if ( D1 * D2 < 0.0f && count < 2 )
+        out[count++] = v1 + ( v2 - v1 ) * ( D1 / ( D1 - D2 ) );
+
+    return count;
+}
+
+// Circle against circle, n goes from a to b
+bool contactCircles_( const lx::Physics::Circle& a, const lx::Physics::Circle& b,
+                      V2& n, float& depth, V2& point ) noexcept
+{
+    const V2 D = toV2( b.center ) - toV2( a.center );
+    const float R = static_cast<float>( a.radius + b.radius );
+    const float DIST = std::sqrt( dot( D, D ) );
+
+    if ( DIST >= R )
+        return false;
+
+    n = DIST > EPSILON ? D * ( 1.0f / DIST ) : V2{ 1.0f, 0.0f };
+    depth = R - DIST;
+    point = toV2( b.center ) - n * static_cast<float>( b.radius );
+    return true;
+}
+
+/*
+*   Circle against a polygon, n goes from the circle to the polygon.
+*   The closest point of the boundary gives the normal, whether the center
+*   is in the polygon or not.
+*/
+bool contactCirclePoly_( const lx::Physics::Circle& c, const lx::Physics::ConvexShape& poly,
+                         V2& n, float& depth, V2& point )
+{
+    const unsigned long N = poly.numberOfVertices();
+    const V2 C = toV2( c.center );
+    const float R = static_cast<float>( c.radius );
+    float min_dist2 = 0.0f;
+    V2 closest{ 0.0f, 0.0f };
+    V2 edge_normal{ 0.0f, 0.0f };
+    bool has_pos = false, has_neg = false;
+    V2 average{ 0.0f, 0.0f };
+
+    for ( unsigned long i = 0; i < N; ++i )
+        average = average + toV2( poly.getVertex( i ) );
+
+    average = average * ( 1.0f / static_cast<float>( N ) );
+
+    for ( unsigned long i = 0; i < N; ++i )
+    {
+        const V2 A = toV2( poly.getVertex( i ) );
+        const V2 B = toV2( poly.getVertex( ( i + 1 ) % N ) );
+        const V2 E = B - A;
+        const float SIDE = cross( E, C - A );
+        has_pos = has_pos || SIDE > 0.0f;
+        has_neg = has_neg || SIDE < 0.0f;
+
+        const float LEN2 = dot( E, E );
+        const float T = LEN2 > EPSILON ? std::min( std::max( dot( C - A, E ) / LEN2, 0.0f ), 1.0f ) : 0.0f;
+        const V2 Q = A + E * T;
+        const float DIST2 = dot( C - Q, C - Q );
+
+        if ( i == 0 || DIST2 < min_dist2 )
+        {
+            min_dist2 = DIST2;
+            closest = Q;
+            // Outward normal of the edge
+            edge_normal = normalize( V2{ -E.y, E.x } );
+
+            if ( dot( edge_normal, A - average ) < 0.0f )
+                edge_normal = -edge_normal;
+        }
+    }
+
+    const bool INSIDE = !( has_pos && has_neg );
+    const float DIST = std::sqrt( min_dist2 );
+
+    if ( !INSIDE && DIST >= R )
+        return false;
+
+    if ( DIST <= EPSILON )
+        n = -edge_normal;
+    else
+        n = INSIDE ? ( C - closest ) * ( 1.0f / DIST ) : ( closest - C ) * ( 1.0f / DIST );
+
+    depth = INSIDE ? R + DIST : R - DIST;
+    point = closest;
+    return true;
+}
+
+/*
+*   Contact points of two polygons: the incident edge is clipped
+*   by the side planes of the reference edge, then the points that are
+*   in front of the reference edge are removed
+*/
+unsigned int clipContacts_( const lx::Physics::ConvexShape& a, const lx::Physics::ConvexShape& b,
+                            const V2& n, V2 points[2] )
+{
+    const Edge E1 = bestEdge_( a, n );
+    const Edge E2 = bestEdge_( b, -n );
+    const bool FLIP = std::abs( dot( normalize( E1.b - E1.a ), n ) )
+                      > std::abs( dot( normalize( E2.b - E2.a ), n ) );
+    const Edge& REF = FLIP ? E2 : E1;
+    const Edge& INC = FLIP ? E1 : E2;
+    const V2 REF_N = FLIP ? -n : n;
+
+    const V2 REFV = normalize( REF.b - REF.a );
+    V2 cp[2];
+
+    if ( clip_( INC.a, INC.b, REFV, dot( REFV, REF.a ), cp ) < 2 )
+        return 0;
+
+    if ( clip_( cp[0], cp[1], -REFV, -dot( REFV, REF.b ), cp ) < 2 )
+        return 0;
+
+    // Normal of the reference face, towards the incident shape
+    V2 face{ -REFV.y, REFV.x };
+
+    if ( dot( face, REF_N ) < 0.0f )
+        face = -face;
+
+    const float MAX = dot( face, REF.max );
+    unsigned int count = 0;
+
+    for ( const V2& p : cp )
+    {
+        if ( dot( face, p ) <= MAX + EPA_TOLERANCE )
+            points[count++] = p;
+    }
+
+    return count;
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+/* ConvexShape */
+
+ConvexShape::ConvexShape( const FloatingBox& box ) noexcept
+    : m_type( Type::BOX ), m_box( box ), m_circle{ box.p, 0 }, m_poly( nullptr ),
+      m_points( nullptr ), m_nb_points( 0 ) {}
+
+ConvexShape::ConvexShape( const Circle& circle ) noexcept
+    : m_type( Type::CIRCLE ),
+      m_box{ FloatPosition{ circle.center.x.v - static_cast<float>( circle.radius ),
+                            circle.center.y.v - static_cast<float>( circle.radius ) },
+             static_cast<int>( circle.radius * 2 ), static_cast<int>( circle.radius * 2 ) },
+      m_circle( circle ), m_poly( nullptr ), m_points( nullptr ), m_nb_points( 0 ) {}
+
+ConvexShape::ConvexShape( const Polygon& poly )
+    : m_type( Type::POLYGON ), m_box( poly.getEnclosingBox() ), m_circle{ m_box.p, 0 },
+      m_poly( &poly ), m_points( nullptr ), m_nb_points( 0 ) {}
+
+ConvexShape::ConvexShape( const FloatPosition * points, const unsigned long n ) noexcept
+    : m_type( Type::POINTS ), m_box{ points[0], 0, 0 }, m_circle{ points[0], 0 },
+      m_poly( nullptr ), m_points( points ), m_nb_points( n )
+{
+    float min_x = points[0].x.v, max_x = min_x;
+    float min_y = points[0].y.v, max_y = min_y;
+
+    for ( unsigned long i = 1; i < n; ++i )
+    {
+        min_x = std::min( min_x, points[i].x.v );
+        max_x = std::max( max_x, points[i].x.v );
+        min_y = std::min( min_y, points[i].y.v );
+        max_y = std::max( max_y, points[i].y.v );
+    }
+
+    // Same convention as Polygon::getEnclosingBox()
+    m_box = FloatingBox{ FloatPosition{ min_x, min_y }, static_cast<int>( max_x - min_x ) + 1,
+                         static_cast<int>( max_y - min_y ) + 1 };
+}
+
+
+FloatingBox ConvexShape::getEnclosingBox() const noexcept
+{
+    return m_box;
+}
+
+
+const Circle * ConvexShape::getCircle() const noexcept
+{
+    return m_type == Type::CIRCLE ? &m_circle : nullptr;
+}
+
+unsigned long ConvexShape::numberOfVertices() const noexcept
+{
+    switch ( m_type )
+    {
+    case Type::BOX:
+        return 4UL;
+
+    case Type::POLYGON:
+        return m_poly->numberOfEdges();
+
+    case Type::POINTS:
+        return m_nb_points;
+
+    default:
+        return 0UL;
+    }
+}
+
+FloatPosition ConvexShape::getVertex( const unsigned long index ) const
+{
+    if ( m_type == Type::POLYGON )
+        return m_poly->getPoint( index );
+
+    if ( m_type == Type::POINTS )
+        return m_points[index];
+
+    // Box: clockwise on the screen, from the top-left corner
+    const float X = m_box.p.x.v;
+    const float Y = m_box.p.y.v;
+    const float W = static_cast<float>( m_box.w );
+    const float H = static_cast<float>( m_box.h );
+
+    switch ( index )
+    {
+    case 0UL:
+        return FloatPosition{ X, Y };
+
+    case 1UL:
+        return FloatPosition{ X + W, Y };
+
+    case 2UL:
+        return FloatPosition{ X + W, Y + H };
+
+    default:
+        return FloatPosition{ X, Y + H };
+    }
+}
+
+FloatPosition ConvexShape::support( const Vector2D& d ) const
+{
+    const float DX = d.vx.v;
+    const float DY = d.vy.v;
+
+    if ( m_type == Type::CIRCLE )
+    {
+        const float L = std::sqrt( DX * DX + DY * DY );
+        const float R = L > EPSILON ? static_cast<float>( m_circle.radius ) / L : 0.0f;
+        return FloatPosition{ m_circle.center.x.v + DX * R, m_circle.center.y.v + DY * R };
+    }
+
+    if ( m_type == Type::BOX )
+    {
+        const float X = m_box.p.x.v;
+        const float Y = m_box.p.y.v;
+        return FloatPosition{ DX > 0.0f ? X + static_cast<float>( m_box.w ) : X,
+                              DY > 0.0f ? Y + static_cast<float>( m_box.h ) : Y };
+    }
+
+    if ( m_type == Type::POINTS )
+    {
+        const FloatPosition * best = m_points;
+        float max_proj = best->x.v * DX + best->y.v * DY;
+
+        for ( unsigned long i = 1; i < m_nb_points; ++i )
+        {
+            const float PROJ = m_points[i].x.v * DX + m_points[i].y.v * DY;
+
+            if ( PROJ > max_proj )
+            {
+                max_proj = PROJ;
+                best = m_points + i;
+            }
+        }
+
+        return *best;
+    }
+
+    const unsigned long N = m_poly->numberOfEdges();
+    FloatPosition best = m_poly->getPoint( 0 );
+    float max_proj = best.x.v * DX + best.y.v * DY;
+
+    for ( unsigned long i = 1; i < N; ++i )
+    {
+        const FloatPosition P = m_poly->getPoint( i );
+        const float PROJ = P.x.v * DX + P.y.v * DY;
+
+        if ( PROJ > max_proj )
+        {
+            max_proj = PROJ;
+            best = P;
+        }
+    }
+
+    return best;
+}
+
+
+/* Narrow phase */
+
+bool collisionGJK( const ConvexShape& a, const ConvexShape& b, const bool touching )
+{
+    V2 simplex[3];
+
+    if ( a.getCircle() != nullptr || b.getCircle() != nullptr )
+    {
+        ContactManifold unused;
+        return contactGJK( a, b, unused ) || ( touching && gjk_( a, b, simplex, true ) );
+    }
+
+    return gjk_( a, b, simplex, touching );
+}
+
+bool contactGJK( const ConvexShape& a, const ConvexShape& b, ContactManifold& manifold )
+{
+    const Circle * CA = a.getCircle();
+    const Circle * CB = b.getCircle();
+    V2 n{ 0.0f, 0.0f };
+    float depth = 0.0f;
+    V2 points[2];
+    unsigned int count = 0;
+
+    // The circles have an exact solution, EPA would only approximate their boundary
+    if ( CA != nullptr && CB != nullptr )
+    {
+        if ( !contactCircles_( *CA, *CB, n, depth, points[count++] ) )
+            return false;
+    }
+    else if ( CA != nullptr )
+    {
+        if ( !contactCirclePoly_( *CA, b, n, depth, points[count++] ) )
+            return false;
+    }
+    else if ( CB != nullptr )
+    {
+        if ( !contactCirclePoly_( *CB, a, n, depth, points[count++] ) )
+            return false;
+
+        n = -n;
+    }
+    else
+    {
+        V2 simplex[3];
+
+        if ( !gjk_( a, b, simplex ) )
+            return false;
+
+        epa_( a, b, simplex, n, depth );
+        count = clipContacts_( a, b, n, points );
+
+        if ( count == 0 )
+        {
+            // Parallel edges that cannot be clipped, keep the deepest point of b
+            points[count++] = support( b, -n );
+        }
+    }
+
+    manifold.normal = Vector2D{ n.x, n.y };
+    manifold.depth = depth;
+    manifold.nb_points = count;
+
+    for ( unsigned int i = 0; i < 2; ++i )
+    {
+        const V2& P = points[i < count ? i : 0];
+        manifold.points[i] = FloatPosition{ P.x, P.y };
+    }
+
+    return true;
+}
+
+}   // Physics
+
+}   // lx
@@ -18,9 +18,10 @@
 
 #include <Lunatix/Physics.hpp>
 #include <Lunatix/Polygon.hpp>
+#include <Lunatix/GJK.hpp>
 #include <Lunatix/Vector2D.hpp>
 #include <Lunatix/Hitbox.hpp>
-#include <Lunatix/Random.hpp>
+#include <algorithm>
 #include <stdexcept>
 
 
@@ -29,46 +30,6 @@ using namespace FloatBox;
 namespace
 {
 
-constexpr bool intersetInterval( const Float& min1, const Float& max1,
-                                 const Float& min2, const Float& max2 ) noexcept
-{
-    return ( min1 < min2 ) ? max1 > min2 : max2 > min1;
-}
-
-/*
-*   Calculate the collision between two polygons
-*   by using the Separating Axis Theorem (SAT).
-*
-*   http://www.dyn4j.org/2010/01/sat/
-*
-*   Thanks to the SAT, it is possible to calculate the collision between two polygons
-*   in linear time. But it does not work on triangles or non-convex polygons
-*
-*   Hypothesis/pre-condition : poly1 and poly2 must be convex with at least 4 edges
-*
-*   Complexity: O(m + n) — m > 3 is the number of vertices in poly1,
-*                          n > 3 is the number of vertices in poly2
-*/
-bool collisionPolySAT( const lx::Physics::Polygon& poly1,
-                       const lx::Physics::Polygon& poly2 ) noexcept
-{
-    const lx::Physics::FloatingBox& box1 = poly1.getEnclosingBox();
-    const lx::Physics::FloatingBox& box2 = poly2.getEnclosingBox();
-
-    lx::Physics::FloatPosition P1_min = box1.p;
-    lx::Physics::FloatPosition P2_min = box2.p;
-    lx::Physics::FloatPosition P1_max = box1.p;
-    lx::Physics::FloatPosition P2_max = box2.p;
-
-    P1_max.x += fbox<decltype( box1.w )>( box1.w );
-    P1_max.y += fbox<decltype( box1.h )>( box1.h );
-    P2_max.x += fbox<decltype( box2.w )>( box2.w );
-    P2_max.y += fbox<decltype( box2.h )>( box2.h );
-
-    return intersetInterval( P1_min.x, P1_max.x, P2_min.x, P2_max.x )
-           && intersetInterval( P1_min.y, P1_max.y, P2_min.y, P2_max.y );
-}
-
 /*
 *   Calculate the collision detection between two polygons
 *   by using their encloging box.
@@ -90,10 +51,24 @@ bool approximativeCollisionPoly( const lx::Physics::Polygon& poly1,
     return lx::Physics::collisionBox( BOX1, BOX2 );
 }
 
+/*
+*   Check if the bounds [x0, x1] × [y0, y1] overlap the enclosing box
+*   of the polygon, the edges included
+*
+*   pre-condition: poly must have at least 3 sides
+*/
+bool overlapBounds_( const float x0, const float y0, const float x1, const float y1,
+                     const lx::Physics::Polygon& poly )
+{
+    const lx::Physics::FloatingBox& B = poly.getEnclosingBox();
+    return x0 <= B.p.x.v + static_cast<float>( B.w ) && B.p.x.v <= x1
+           && y0 <= B.p.y.v + static_cast<float>( B.h ) && B.p.y.v <= y1;
+}
+
 /*
 *   The basic (and naive) collision detection
 *
-*   This naive implementation is only used for non-convex polygons.
+*   This naive implementation is only used for self-intersecting polygons.
 *
 *   pre-condition: poly1 and poly2 must have at least 3 sides
 *
@@ -132,6 +107,122 @@ bool basicCollisionPoly( const lx::Physics::Polygon& poly1,
              || collisionPointPoly( origin2, poly1 ) );
 }
 
+/*
+*   Check if two bounding boxes overlap, the edges included
+*/
+bool overlapBoxes_( const lx::Physics::FloatingBox& a,
+                    const lx::Physics::FloatingBox& b ) noexcept
+{
+    return a.p.x.v <= b.p.x.v + static_cast<float>( b.w )
+           && b.p.x.v <= a.p.x.v + static_cast<float>( a.w )
+           && a.p.y.v <= b.p.y.v + static_cast<float>( b.h )
+           && b.p.y.v <= a.p.y.v + static_cast<float>( a.h );
+}
+
+/*
+*   Check if an axis separates two convex shapes (box or convex part),
+*   the axis is the normal of an edge of the first shape
+*
+*   Two shapes that touch each other are not separated,
+*   like in the edge-based collision detection
+*/
+bool separatedByEdges_( const lx::Physics::ConvexShape& a,
+                        const lx::Physics::ConvexShape& b )
+{
+    const unsigned long N = a.numberOfVertices();
+    const unsigned long M = b.numberOfVertices();
+
+    for ( unsigned long i = 0, j = N - 1; i < N; j = i++ )
+    {
+        const lx::Physics::FloatPosition P = a.getVertex( j );
+        const lx::Physics::FloatPosition Q = a.getVertex( i );
+        const float AX = P.y.v - Q.y.v;
+        const float AY = Q.x.v - P.x.v;
+        float min_a = P.x.v * AX + P.y.v * AY, max_a = min_a;
+        float min_b = 0.0f, max_b = 0.0f;
+
+        for ( unsigned long k = 0; k < N; ++k )
+        {
+            const lx::Physics::FloatPosition V = a.getVertex( k );
+            const float PROJ = V.x.v * AX + V.y.v * AY;
+            min_a = std::min( min_a, PROJ );
+            max_a = std::max( max_a, PROJ );
+        }
+
+        for ( unsigned long k = 0; k < M; ++k )
+        {
+            const lx::Physics::FloatPosition V = b.getVertex( k );
+            const float PROJ = V.x.v * AX + V.y.v * AY;
+            min_b = ( k == 0 ) ? PROJ : std::min( min_b, PROJ );
+            max_b = ( k == 0 ) ? PROJ : std::max( max_b, PROJ );
+        }
+
+        if ( max_a < min_b || max_b < min_a )
+            return true;
+    }
+
+    return false;
+}
+
+/*
+*   Check the collision between a circle and a convex part, the edges included
+*/
+bool collisionCirclePart_( const lx::Physics::Circle& c,
+                           const lx::Physics::ConvexShape& part )
+{
+    const unsigned long N = part.numberOfVertices();
+    bool left = false, right = false;
+
+    for ( unsigned long i = 0, j = N - 1; i < N; j = i++ )
+    {
+        const lx::Physics::FloatPosition P = part.getVertex( j );
+        const lx::Physics::FloatPosition Q = part.getVertex( i );
+
+        if ( lx::Physics::collisionSegCircle( c, lx::Physics::Segment{ P, Q } ) )
+            return true;
+
+        const float CROSS = ( Q.x.v - P.x.v ) * ( c.center.y.v - P.y.v )
+                            - ( Q.y.v - P.y.v ) * ( c.center.x.v - P.x.v );
+        left  = left  || CROSS > 0.0f;
+        right = right || CROSS < 0.0f;
+    }
+
+    // The center is inside the part
+    return !( left && right );
+}
+
+/*
+*   Check the collision between a shape (box, circle or convex part)
+*   and the convex parts of a polygon, by using the separating axis theorem
+*
+*   pre-condition: poly.numberOfConvexParts() > 0
+*
+*   Complexity: O(k × m × n) in the worst case, k is the number of parts
+*               whose bounding box overlaps the bounding box of the shape.
+*               m and n are small since the parts are small.
+*/
+bool collisionParts_( const lx::Physics::ConvexShape& shape,
+                      const lx::Physics::Polygon& poly )
+{
+    const lx::Physics::FloatingBox& BOX = shape.getEnclosingBox();
+    const lx::Physics::Circle * circle = shape.getCircle();
+    const unsigned long NB_PARTS = poly.numberOfConvexParts();
+
+    for ( unsigned long i = 0UL; i < NB_PARTS; ++i )
+    {
+        const lx::Physics::ConvexShape& PART = poly.getConvexPart( i );
+
+        if ( !overlapBoxes_( BOX, PART.getEnclosingBox() ) )
+            continue;
+
+        if ( circle != nullptr ? collisionCirclePart_( *circle, PART )
+                : !separatedByEdges_( shape, PART ) && !separatedByEdges_( PART, shape ) )
+            return true;
+    }
+
+    return false;
+}
+
 bool intersectSeg_( const lx::Physics::FloatPosition& A,
                     const lx::Physics::FloatPosition& B,
                     const lx::Physics::FloatPosition& C,
@@ -282,27 +373,7 @@ bool intersectLine( const Line& l1, const Line& l2 ) noexcept
 
 bool collisionPointPoly( const FloatPosition& p, const Polygon& poly )
 {
-    const int V = 10000;
-    const unsigned long N = poly.numberOfEdges();
-    const float RIX = lx::Random::fxrand( 0.0f, 100.0f );
-    const float RIY = lx::Random::fxrand( 0.0f, 100.0f );
-
-    FloatPosition I{ V + RIX, V + RIY };
-    unsigned long nb_intersections = 0;
-
-    for ( unsigned long i = 0UL; i < N; ++i )
-    {
-        const FloatPosition& A = poly.getPoint( i );
-        const FloatPosition& B = poly.getPoint( ( i == N - 1UL ) ? 0UL : i + 1UL );
-
-        if ( p == A )
-            return true;
-
-        if ( intersectSegment( Segment{ p, I }, Segment{ A, B } ) )
-            nb_intersections++;
-    }
-
-    return ( nb_intersections % 2UL == 1UL );
+    return poly.contains( p );
 }
 
 
@@ -311,6 +382,17 @@ bool collisionCirclePoly( const Circle& c, const Polygon& poly )
     const FloatPosition FOLAT_POS = c.center;
     const unsigned long N = poly.numberOfEdges();
 
+    // The enclosing box of the polygon is cached
+    const float R = static_cast<float>( c.radius );
+
+    if ( N >= 3UL && !overlapBounds_( c.center.x.v - R, c.center.y.v - R,
+                                      c.center.x.v + R, c.center.y.v + R, poly ) )
+        return false;
+
+    // A concave polygon is checked part by part
+    if ( N >= 3UL && !poly.isConvex() && poly.numberOfConvexParts() > 0UL )
+        return collisionParts_( c, poly );
+
     if ( collisionPointPoly( FOLAT_POS, poly ) )
         return true;
 
@@ -337,6 +419,12 @@ bool collisionBoxPoly( const FloatingBox& box, const Polygon& poly )
     const FloatPosition C = { box.p.x + BOX_W, box.p.y + BOX_H };
     const FloatPosition D = { box.p.x, box.p.y + BOX_H };
 
+    if ( n >= 3UL && !overlapBounds_( A.x.v, A.y.v, C.x.v, C.y.v, poly ) )
+        return false;
+
+    if ( n >= 3UL && !poly.isConvex() && poly.numberOfConvexParts() > 0UL )
+        return collisionParts_( box, poly );
+
     for ( unsigned long j = 0UL; j < n; ++j )
     {
         const FloatPosition& E = poly.getPoint( j );
@@ -372,12 +460,32 @@ bool collisionPoly( const Polygon& poly1, const Polygon& poly2 )
     if ( !approximativeCollisionPoly( poly1, poly2 ) )
         return false;
 
-    // If the two polygons are convex and have at least 4 sides,
-    // use the SAT to detect the collision between then. -> O(n)
-    if ( poly1.isConvex() && poly2.isConvex() && N > NUM_SIDES && M > NUM_SIDES )
-        return collisionPolySAT( poly1, poly2 );
+    // If the two polygons are convex (triangles included),
+    // use GJK to detect the collision between then. -> O(n)
+    // Like the other collision functions, the polygons that touch each other collide
+    if ( poly1.isConvex() && poly2.isConvex() )
+        return collisionGJK( poly1, poly2, true );
+
+    // One of the polygons is not convex -> check the convex parts
+    // whose bounding boxes overlap (the decomposition is cached)
+    const unsigned long P1 = poly1.numberOfConvexParts();
+
+    if ( P1 > 0UL && poly2.numberOfConvexParts() > 0UL )
+    {
+        const FloatingBox& BOX2 = poly2.getEnclosingBox();
+
+        for ( unsigned long i = 0UL; i < P1; ++i )
+        {
+            const ConvexShape& PART = poly1.getConvexPart( i );
+
+            if ( overlapBoxes_( PART.getEnclosingBox(), BOX2 ) && collisionParts_( PART, poly2 ) )
+                return true;
+        }
+
+        return false;
+    }
 
-    // On of the polygons is not convex -> naive algorithm, -> O(n²)
+    // A self-intersecting polygon -> naive algorithm, -> O(n²)
     return basicCollisionPoly( poly1, poly2 );
 }
 
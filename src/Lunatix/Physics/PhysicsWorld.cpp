@@ -0,0 +1,796 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file PhysicsWorld.cpp
+*   @brief The implementation of the rigid body simulation
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/PhysicsWorld.hpp>
+#include <Lunatix/DynamicAABBTree.hpp>
+#include <Lunatix/GJK.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+
+namespace
+{
+
+using lx::Physics::BodyID;
+using lx::Physics::ProxyID;
+
+const unsigned int MAX_STEPS = 8;
+const int VELOCITY_ITERATIONS = 8;
+const int POSITION_ITERATIONS = 4;
+const float TREE_MARGIN = 2.0f;             // Pixels
+const float SLOP = 0.5f;                    // Penetration allowed, in pixels
+const float CORRECTION = 0.2f;              // Part of the penetration corrected by an iteration
+const float BOUNCE_THRESHOLD = 30.0f;       // Slower impacts do not bounce (pixels/s)
+const float SLEEP_VELOCITY = 4.0f;          // Pixels/s
+const float TIME_TO_SLEEP = 0.5f;           // Seconds
+const float DEFAULT_FRICTION = 0.2f;
+const unsigned int NO_ORDER = static_cast<unsigned int>( -1 );
+
+enum class BodyShape : short
+{
+    BOX, CIRCLE
+};
+
+struct Contact final
+{
+    BodyID a, b;
+    float nx, ny;               // From a to b
+    float depth;
+    float rx, ry;               // Position of b relative to a, when the depth was computed
+    float mass;                 // 1 / (inverse mass of a + inverse mass of b)
+    float bounce;               // Normal velocity expected after the impact
+    float friction;
+    float normal_impulse;
+    float tangent_impulse;
+};
+
+// The impulses of a contact, kept for the next step
+struct CachedImpulse final
+{
+    uint64_t key;
+    float normal_impulse;
+    float tangent_impulse;
+};
+
+inline uint64_t pairKey_( const BodyID a, const BodyID b ) noexcept
+{
+    return static_cast<uint64_t>( std::min( a, b ) ) << 32 | std::max( a, b );
+}
+
+inline void * toData_( const BodyID id ) noexcept
+{
+    return reinterpret_cast<void *>( static_cast<uintptr_t>( id ) );
+}
+
+inline BodyID fromData_( const void * data ) noexcept
+{
+    return static_cast<BodyID>( reinterpret_cast<uintptr_t>( data ) );
+}
+
+unsigned int findRoot_( std::vector<unsigned int>& parent, unsigned int i ) noexcept
+{
+    while ( parent[i] != i )
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+
+    return i;
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+/* Private implementation */
+
+class PhysicsWorld_ final
+{
+    const float M_TIMESTEP;
+    float m_accumulator;
+    float m_gx, m_gy;
+
+    // Bodies (structure of arrays), the position is the center of the body
+    std::vector<float> m_x, m_y;
+    std::vector<float> m_vx, m_vy;
+    std::vector<float> m_hw, m_hh;          // Half extents, the radius of a circle
+    std::vector<float> m_inv_mass;
+    std::vector<float> m_restitution, m_friction;
+    std::vector<float> m_sleep_time;
+    std::vector<BodyShape> m_shape;
+    std::vector<ProxyID> m_proxy;
+    std::vector<void *> m_data;
+    std::vector<unsigned char> m_alive;
+    std::vector<unsigned int> m_order;      // Index in m_awake, NO_ORDER if asleep
+    std::vector<BodyID> m_free;
+    size_t m_count;
+
+    std::vector<BodyID> m_awake;
+    DynamicAABBTree m_tree;
+
+    // Memory reused from step to step
+    std::vector<Contact> m_contacts;
+    std::vector<CachedImpulse> m_cache;
+    std::vector<ProxyID> m_query;
+    std::vector<unsigned int> m_parent;
+    std::vector<float> m_island_sleep;
+
+    PhysicsWorld_( const PhysicsWorld_& ) = delete;
+    PhysicsWorld_& operator =( const PhysicsWorld_& ) = delete;
+
+    bool valid_( const BodyID id ) const noexcept
+    {
+        return id < m_alive.size() && m_alive[id] != 0;
+    }
+
+    bool dynamic_( const BodyID id ) const noexcept
+    {
+        return m_inv_mass[id] > 0.0f;
+    }
+
+    FloatingBox box_( const BodyID id ) const noexcept
+    {
+        return FloatingBox{ FloatPosition{ m_x[id] - m_hw[id], m_y[id] - m_hh[id] },
+                            static_cast<int>( 2.0f * m_hw[id] ), static_cast<int>( 2.0f * m_hh[id] ) };
+    }
+
+    Circle circle_( const BodyID id ) const noexcept
+    {
+        return Circle{ FloatPosition{ m_x[id], m_y[id] }, static_cast<unsigned int>( m_hw[id] ) };
+    }
+
+    ConvexShape shape_( const BodyID id ) const noexcept
+    {
+        if ( m_shape[id] == BodyShape::CIRCLE )
+            return ConvexShape( circle_( id ) );
+
+        return ConvexShape( box_( id ) );
+    }
+
+    void wake_( const BodyID id )
+    {
+        if ( dynamic_( id ) && m_order[id] == NO_ORDER )
+        {
+            m_sleep_time[id] = 0.0f;
+            m_order[id] = static_cast<unsigned int>( m_awake.size() );
+            m_awake.push_back( id );
+        }
+    }
+
+    // Wake up the bodies around a region
+    void wakeAround_( const FloatingBox& box )
+    {
+        m_tree.queryBox( box, m_query );
+
+        for ( const ProxyID P : m_query )
+            wake_( fromData_( m_tree.getUserData( P ) ) );
+    }
+
+    BodyID add_( const BodyShape shape, const float x, const float y, const float hw,
+                 const float hh, const float mass, void * user_data )
+    {
+        BodyID id;
+
+        if ( !m_free.empty() )
+        {
+            id = m_free.back();
+        }
+        else
+        {
+            id = static_cast<BodyID>( m_alive.size() );
+            m_x.push_back( 0.0f );
+            m_y.push_back( 0.0f );
+            m_vx.push_back( 0.0f );
+            m_vy.push_back( 0.0f );
+            m_hw.push_back( 0.0f );
+            m_hh.push_back( 0.0f );
+            m_inv_mass.push_back( 0.0f );
+            m_restitution.push_back( 0.0f );
+            m_friction.push_back( 0.0f );
+            m_sleep_time.push_back( 0.0f );
+            m_shape.push_back( shape );
+            m_proxy.push_back( NULL_PROXY );
+            m_data.push_back( nullptr );
+            m_alive.push_back( 0 );
+            m_order.push_back( NO_ORDER );
+        }
+
+        m_x[id] = x;
+        m_y[id] = y;
+        m_vx[id] = 0.0f;
+        m_vy[id] = 0.0f;
+        m_hw[id] = hw;
+        m_hh[id] = hh;
+        m_inv_mass[id] = mass > 0.0f ? 1.0f / mass : 0.0f;
+        m_restitution[id] = 0.0f;
+        m_friction[id] = DEFAULT_FRICTION;
+        m_sleep_time[id] = 0.0f;
+        m_shape[id] = shape;
+        m_data[id] = user_data;
+        m_order[id] = NO_ORDER;
+        m_proxy[id] = m_tree.addBox( box_( id ), toData_( id ) );
+        m_alive[id] = 1;
+
+        if ( !m_free.empty() && m_free.back() == id )
+            m_free.pop_back();
+
+        ++m_count;
+        // The new body and the bodies it touches
+        wakeAround_( box_( id ) );
+        return id;
+    }
+
+    /*
+        Find the contacts of the awake bodies. A sleeping body touched
+        by an awake body is woken up, and is appended to the list.
+        A pair of awake bodies is found by the body that comes first in the list.
+    */
+    void findContacts_()
+    {
+        m_contacts.clear();
+
+        for ( size_t k = 0; k < m_awake.size(); ++k )
+        {
+            const BodyID A = m_awake[k];
+            m_tree.queryBox( box_( A ), m_query );
+
+            for ( const ProxyID P : m_query )
+            {
+                const BodyID B = fromData_( m_tree.getUserData( P ) );
+
+                if ( B == A || ( m_order[B] != NO_ORDER && m_order[B] < k ) )
+                    continue;
+
+                ContactManifold m;
+
+                if ( !contactGJK( shape_( A ), shape_( B ), m ) )
+                    continue;
+
+                wake_( B );
+
+                const float IM = m_inv_mass[A] + m_inv_mass[B];
+                m_contacts.push_back( Contact{ A, B, m.normal.vx.v, m.normal.vy.v, m.depth,
+                                               m_x[B] - m_x[A], m_y[B] - m_y[A], 1.0f / IM, 0.0f,
+                                               std::sqrt( m_friction[A] * m_friction[B] ),
+                                               0.0f, 0.0f } );
+            }
+        }
+    }
+
+    inline void applyImpulse_( const Contact& c, const float px, const float py ) noexcept
+    {
+        m_vx[c.a] -= px * m_inv_mass[c.a];
+        m_vy[c.a] -= py * m_inv_mass[c.a];
+        m_vx[c.b] += px * m_inv_mass[c.b];
+        m_vy[c.b] += py * m_inv_mass[c.b];
+    }
+
+    /*
+        Sequential impulses, without rotation. The solver starts from the impulses
+        of the previous step (warm starting), so that a stack converges.
+    */
+    void solveVelocities_()
+    {
+        auto keyLess = []( const CachedImpulse& c, const uint64_t key )
+        {
+            return c.key < key;
+        };
+
+        for ( Contact& c : m_contacts )
+        {
+            const float VN = ( m_vx[c.b] - m_vx[c.a] ) * c.nx + ( m_vy[c.b] - m_vy[c.a] ) * c.ny;
+            const float E = std::max( m_restitution[c.a], m_restitution[c.b] );
+            c.bounce = -VN > BOUNCE_THRESHOLD ? -E * VN : 0.0f;
+
+            // The impulses do not depend on the order of the bodies
+            const uint64_t KEY = pairKey_( c.a, c.b );
+            const auto IT = std::lower_bound( m_cache.begin(), m_cache.end(), KEY, keyLess );
+
+            if ( IT != m_cache.end() && IT->key == KEY )
+            {
+                c.normal_impulse = IT->normal_impulse;
+                c.tangent_impulse = IT->tangent_impulse;
+                applyImpulse_( c, c.nx * c.normal_impulse - c.ny * c.tangent_impulse,
+                               c.ny * c.normal_impulse + c.nx * c.tangent_impulse );
+            }
+        }
+
+        for ( int it = 0; it < VELOCITY_ITERATIONS; ++it )
+        {
+            for ( Contact& c : m_contacts )
+            {
+                const float RVX = m_vx[c.b] - m_vx[c.a];
+                const float RVY = m_vy[c.b] - m_vy[c.a];
+
+                // Normal impulse, the accumulated impulse only pushes
+                const float VN = RVX * c.nx + RVY * c.ny;
+                const float NEW_NI = std::max( c.normal_impulse + c.mass * ( c.bounce - VN ), 0.0f );
+                const float DN = NEW_NI - c.normal_impulse;
+                c.normal_impulse = NEW_NI;
+                applyImpulse_( c, c.nx * DN, c.ny * DN );
+
+                // Friction, bounded by the normal impulse (Coulomb)
+                const float TX = -c.ny, TY = c.nx;
+                const float VT = ( m_vx[c.b] - m_vx[c.a] ) * TX + ( m_vy[c.b] - m_vy[c.a] ) * TY;
+                const float MAX_FRICTION = c.friction * c.normal_impulse;
+                const float NEW_TI = std::max( -MAX_FRICTION, std::min( c.tangent_impulse - c.mass * VT,
+                                                                        MAX_FRICTION ) );
+                const float DT = NEW_TI - c.tangent_impulse;
+                c.tangent_impulse = NEW_TI;
+                applyImpulse_( c, TX * DT, TY * DT );
+            }
+        }
+
+        m_cache.clear();
+
+        for ( const Contact& c : m_contacts )
+            m_cache.push_back( CachedImpulse{ pairKey_( c.a, c.b ), c.normal_impulse, c.tangent_impulse } );
+
+        std::sort( m_cache.begin(), m_cache.end(), []( const CachedImpulse& x, const CachedImpulse& y )
+        {
+            return x.key < y.key;
+        } );
+    }
+
+    /*
+        The bodies do not rotate, so the penetration along the normal of a contact
+        only depends on the relative position of the bodies
+    */
+    void correctPositions_() noexcept
+    {
+        for ( int it = 0; it < POSITION_ITERATIONS; ++it )
+        {
+            for ( const Contact& c : m_contacts )
+            {
+                const float DEPTH = c.depth - ( ( m_x[c.b] - m_x[c.a] - c.rx ) * c.nx
+                                                + ( m_y[c.b] - m_y[c.a] - c.ry ) * c.ny );
+                const float K = CORRECTION * std::max( DEPTH - SLOP, 0.0f ) * c.mass;
+                m_x[c.a] -= c.nx * K * m_inv_mass[c.a];
+                m_y[c.a] -= c.ny * K * m_inv_mass[c.a];
+                m_x[c.b] += c.nx * K * m_inv_mass[c.b];
+                m_y[c.b] += c.ny * K * m_inv_mass[c.b];
+            }
+        }
+    }
+
+    /*
+        The awake bodies linked by a contact form an island (union-find),
+        an island falls asleep when all its bodies have been slow for a while.
+        The static bodies do not link the islands.
+    */
+    void updateSleep_( const float h )
+    {
+        const size_t N = m_awake.size();
+        const float LIMIT = SLEEP_VELOCITY * SLEEP_VELOCITY;
+        m_parent.resize( N );
+        m_island_sleep.assign( N, TIME_TO_SLEEP );
+
+        for ( size_t k = 0; k < N; ++k )
+        {
+            const BodyID B = m_awake[k];
+            m_parent[k] = static_cast<unsigned int>( k );
+
+            if ( m_vx[B] * m_vx[B] + m_vy[B] * m_vy[B] > LIMIT )
+                m_sleep_time[B] = 0.0f;
+            else
+                m_sleep_time[B] += h;
+        }
+
+        for ( const Contact& c : m_contacts )
+        {
+            if ( dynamic_( c.a ) && dynamic_( c.b ) )
+            {
+                const unsigned int RA = findRoot_( m_parent, m_order[c.a] );
+                const unsigned int RB = findRoot_( m_parent, m_order[c.b] );
+                m_parent[std::max( RA, RB )] = std::min( RA, RB );
+            }
+        }
+
+        for ( size_t k = 0; k < N; ++k )
+        {
+            const unsigned int R = findRoot_( m_parent, static_cast<unsigned int>( k ) );
+            m_island_sleep[R] = std::min( m_island_sleep[R], m_sleep_time[m_awake[k]] );
+        }
+
+        size_t n = 0;
+
+        for ( size_t k = 0; k < N; ++k )
+        {
+            const BodyID B = m_awake[k];
+
+            if ( m_island_sleep[findRoot_( m_parent, static_cast<unsigned int>( k ) )] >= TIME_TO_SLEEP )
+            {
+                m_vx[B] = 0.0f;
+                m_vy[B] = 0.0f;
+                m_order[B] = NO_ORDER;
+            }
+            else
+            {
+                m_order[B] = static_cast<unsigned int>( n );
+                m_awake[n++] = B;
+            }
+        }
+
+        m_awake.resize( n );
+    }
+
+    void substep_( const float h )
+    {
+        for ( const BodyID B : m_awake )
+        {
+            m_vx[B] += m_gx * h;
+            m_vy[B] += m_gy * h;
+        }
+
+        findContacts_();
+        solveVelocities_();
+
+        for ( const BodyID B : m_awake )
+        {
+            m_x[B] += m_vx[B] * h;
+            m_y[B] += m_vy[B] * h;
+        }
+
+        correctPositions_();
+
+        for ( const BodyID B : m_awake )
+        {
+            m_tree.moveBox( m_proxy[B], box_( B ), Vector2D{ m_vx[B] * h, m_vy[B] * h } );
+        }
+
+        updateSleep_( h );
+    }
+
+public:
+
+    explicit PhysicsWorld_( const float timestep )
+        : M_TIMESTEP( timestep ), m_accumulator( 0.0f ), m_gx( 0.0f ), m_gy( 0.0f ),
+          m_x(), m_y(), m_vx(), m_vy(), m_hw(), m_hh(), m_inv_mass(), m_restitution(),
+          m_friction(), m_sleep_time(), m_shape(), m_proxy(), m_data(), m_alive(), m_order(),
+          m_free(), m_count( 0 ), m_awake(), m_tree( TREE_MARGIN ), m_contacts(), m_cache(), m_query(),
+          m_parent(), m_island_sleep()
+    {
+        if ( !( timestep > 0.0f ) )
+            throw std::invalid_argument( "PhysicsWorld: the time step must be positive" );
+    }
+
+    BodyID addBox( const FloatingBox& box, const float mass, void * user_data )
+    {
+        const float HW = static_cast<float>( box.w ) / 2.0f;
+        const float HH = static_cast<float>( box.h ) / 2.0f;
+        return add_( BodyShape::BOX, box.p.x.v + HW, box.p.y.v + HH, HW, HH, mass, user_data );
+    }
+
+    BodyID addCircle( const Circle& circle, const float mass, void * user_data )
+    {
+        const float R = static_cast<float>( circle.radius );
+        return add_( BodyShape::CIRCLE, circle.center.x.v, circle.center.y.v, R, R, mass, user_data );
+    }
+
+    bool remove( const BodyID id ) noexcept
+    {
+        if ( !valid_( id ) )
+            return false;
+
+        // The bodies it supported must fall
+        try
+        {
+            wakeAround_( box_( id ) );
+        }
+        catch ( ... )
+        {
+            // Out of memory: some bodies may stay asleep
+        }
+
+        if ( m_order[id] != NO_ORDER )
+        {
+            // Keep the order of the other bodies
+            m_awake.erase( m_awake.begin() + m_order[id] );
+
+            for ( size_t k = m_order[id]; k < m_awake.size(); ++k )
+                m_order[m_awake[k]] = static_cast<unsigned int>( k );
+        }
+
+        m_tree.remove( m_proxy[id] );
+        m_alive[id] = 0;
+        m_order[id] = NO_ORDER;
+        m_data[id] = nullptr;
+        --m_count;
+
+        try
+        {
+            m_free.push_back( id );
+        }
+        catch ( ... )
+        {
+            // The identifier is lost, but the world is still consistent
+        }
+
+        return true;
+    }
+
+    void setGravity( const Vector2D& g ) noexcept
+    {
+        if ( g.vx.v == m_gx && g.vy.v == m_gy )
+            return;
+
+        m_gx = g.vx.v;
+        m_gy = g.vy.v;
+
+        // A body at rest may not be at rest with the new gravity
+        try
+        {
+            for ( BodyID id = 0; id < m_alive.size(); ++id )
+            {
+                if ( m_alive[id] != 0 )
+                    wake_( id );
+            }
+        }
+        catch ( ... )
+        {
+            // Out of memory: some bodies may stay asleep
+        }
+    }
+
+    Vector2D getGravity() const noexcept
+    {
+        return Vector2D{ m_gx, m_gy };
+    }
+
+    void setPosition( const BodyID id, const FloatPosition& p ) noexcept
+    {
+        if ( !valid_( id ) )
+            return;
+
+        const float OLD_X = m_x[id], OLD_Y = m_y[id];
+        m_sleep_time[id] = 0.0f;
+
+        try
+        {
+            // The bodies around the old position and the new one
+            wakeAround_( box_( id ) );
+            m_x[id] = m_shape[id] == BodyShape::BOX ? p.x.v + m_hw[id] : p.x.v;
+            m_y[id] = m_shape[id] == BodyShape::BOX ? p.y.v + m_hh[id] : p.y.v;
+            m_tree.moveBox( m_proxy[id], box_( id ), Vector2D{ m_x[id] - OLD_X, m_y[id] - OLD_Y } );
+            wakeAround_( box_( id ) );
+        }
+        catch ( ... )
+        {
+            // Out of memory: some bodies may stay asleep
+        }
+    }
+
+    void setVelocity( const BodyID id, const Vector2D& v ) noexcept
+    {
+        if ( !valid_( id ) || !dynamic_( id ) )
+            return;
+
+        m_vx[id] = v.vx.v;
+        m_vy[id] = v.vy.v;
+        m_sleep_time[id] = 0.0f;
+
+        try
+        {
+            wake_( id );
+        }
+        catch ( ... ) {}
+    }
+
+    void applyImpulse( const BodyID id, const Vector2D& impulse ) noexcept
+    {
+        if ( valid_( id ) && dynamic_( id ) )
+        {
+            setVelocity( id, Vector2D{ m_vx[id] + impulse.vx.v * m_inv_mass[id],
+                                       m_vy[id] + impulse.vy.v * m_inv_mass[id] } );
+        }
+    }
+
+    void setMaterial( const BodyID id, const float restitution, const float friction ) noexcept
+    {
+        if ( valid_( id ) )
+        {
+            m_restitution[id] = std::max( 0.0f, std::min( restitution, 1.0f ) );
+            m_friction[id] = std::max( 0.0f, friction );
+        }
+    }
+
+    FloatingBox getBox( const BodyID id ) const noexcept
+    {
+        return valid_( id ) ? box_( id ) : FloatingBox{ FloatPosition{ 0.0f, 0.0f }, 0, 0 };
+    }
+
+    Circle getCircle( const BodyID id ) const noexcept
+    {
+        if ( !valid_( id ) )
+            return Circle{ FloatPosition{ 0.0f, 0.0f }, 0 };
+
+        if ( m_shape[id] == BodyShape::CIRCLE )
+            return circle_( id );
+
+        const float R = std::sqrt( m_hw[id] * m_hw[id] + m_hh[id] * m_hh[id] );
+        return Circle{ FloatPosition{ m_x[id], m_y[id] }, static_cast<unsigned int>( std::ceil( R ) ) };
+    }
+
+    Vector2D getVelocity( const BodyID id ) const noexcept
+    {
+        return valid_( id ) ? Vector2D{ m_vx[id], m_vy[id] } : Vector2D{ 0.0f, 0.0f };
+    }
+
+    bool isAwake( const BodyID id ) const noexcept
+    {
+        return valid_( id ) && m_order[id] != NO_ORDER;
+    }
+
+    void * getUserData( const BodyID id ) const noexcept
+    {
+        return valid_( id ) ? m_data[id] : nullptr;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_count;
+    }
+
+    size_t numberOfAwakeBodies() const noexcept
+    {
+        return m_awake.size();
+    }
+
+    unsigned int step( const float dt )
+    {
+        if ( !( dt > 0.0f ) )
+            return 0;
+
+        unsigned int n = 0;
+        m_accumulator += dt;
+
+        while ( m_accumulator >= M_TIMESTEP && n < MAX_STEPS )
+        {
+            substep_( M_TIMESTEP );
+            m_accumulator -= M_TIMESTEP;
+            ++n;
+        }
+
+        // Too slow: drop the steps that were not run
+        if ( m_accumulator >= M_TIMESTEP )
+            m_accumulator = std::fmod( m_accumulator, M_TIMESTEP );
+
+        return n;
+    }
+
+    float getAlpha() const noexcept
+    {
+        return m_accumulator / M_TIMESTEP;
+    }
+
+    ~PhysicsWorld_() = default;
+};
+
+
+/* Public functions */
+
+PhysicsWorld::PhysicsWorld( const float timestep )
+    : m_pwimpl( new PhysicsWorld_( timestep ) ) {}
+
+BodyID PhysicsWorld::addBox( const FloatingBox& box, const float mass, void * user_data )
+{
+    return m_pwimpl->addBox( box, mass, user_data );
+}
+
+BodyID PhysicsWorld::addCircle( const Circle& circle, const float mass, void * user_data )
+{
+    return m_pwimpl->addCircle( circle, mass, user_data );
+}
+
+bool PhysicsWorld::remove( const BodyID id ) noexcept
+{
+    return m_pwimpl->remove( id );
+}
+
+void PhysicsWorld::setGravity( const Vector2D& g ) noexcept
+{
+    m_pwimpl->setGravity( g );
+}
+
+Vector2D PhysicsWorld::getGravity() const noexcept
+{
+    return m_pwimpl->getGravity();
+}
+
+void PhysicsWorld::setPosition( const BodyID id, const FloatPosition& p ) noexcept
+{
+    m_pwimpl->setPosition( id, p );
+}
+
+void PhysicsWorld::setVelocity( const BodyID id, const Vector2D& v ) noexcept
+{
+    m_pwimpl->setVelocity( id, v );
+}
+
+void PhysicsWorld::applyImpulse( const BodyID id, const Vector2D& impulse ) noexcept
+{
+    m_pwimpl->applyImpulse( id, impulse );
+}
+
+void PhysicsWorld::setMaterial( const BodyID id, const float restitution,
+                                const float friction ) noexcept
+{
+    m_pwimpl->setMaterial( id, restitution, friction );
+}
+
+FloatingBox PhysicsWorld::getBox( const BodyID id ) const noexcept
+{
+    return m_pwimpl->getBox( id );
+}
+
+Circle PhysicsWorld::getCircle( const BodyID id ) const noexcept
+{
+    return m_pwimpl->getCircle( id );
+}
+
+Vector2D PhysicsWorld::getVelocity( const BodyID id ) const noexcept
+{
+    return m_pwimpl->getVelocity( id );
+}
+
+bool PhysicsWorld::isAwake( const BodyID id ) const noexcept
+{
+    return m_pwimpl->isAwake( id );
+}
+
+void * PhysicsWorld::getUserData( const BodyID id ) const noexcept
+{
+    return m_pwimpl->getUserData( id );
+}
+
+size_t PhysicsWorld::size() const noexcept
+{
+    return m_pwimpl->size();
+}
+
+size_t PhysicsWorld::numberOfAwakeBodies() const noexcept
+{
+    return m_pwimpl->numberOfAwakeBodies();
+}
+
+unsigned int PhysicsWorld::step( const float dt )
+{
+    return m_pwimpl->step( dt );
+}
+
+float PhysicsWorld::getAlpha() const noexcept
+{
+    return m_pwimpl->getAlpha();
+}
+
+PhysicsWorld::~PhysicsWorld()
+{
+    m_pwimpl.reset();
+}
+
+}   // Physics
+
+}   // lx
@@ -20,7 +20,12 @@
 #include <Lunatix/Polygon.hpp>
 #include <Lunatix/Physics.hpp>
 #include <Lunatix/Vector2D.hpp>
+#include <Lunatix/GJK.hpp>
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
+#include <cstdint>
+#include <cmath>
 
 using namespace std;
 using namespace FloatBox;
@@ -72,10 +77,35 @@ PolygonException::~PolygonException() noexcept {}
 
 /* Polygon - private implementation */
 
+/*
+*   The points are stored in the local space, with a transformation:
+*   world = pivot + rotation.scale.(local - pivot) + translation.
+*   The pivot is the centroid of the local polygon.
+*   The world points, the bounding box, the centroid and the convexity
+*   are cached, and only computed again when they are requested
+*   after a modification.
+*/
 class Polygon_ final
 {
-    std::vector<FloatPosition> m_points;
-    bool m_convex;
+    std::vector<FloatPosition> m_points;    // Local space
+    Vector2D m_translation;
+    float m_angle;
+    float m_scale;
+
+    mutable std::vector<FloatPosition> m_world;
+    mutable FloatingBox m_box;
+    mutable FloatPosition m_pivot;          // Local centroid
+    mutable bool m_has_centroid;            // FALSE if the polygon is self-intersecting
+    mutable float m_orientation;            // Sign of the area (1 or -1)
+    mutable bool m_convex;
+    mutable bool m_local_dirty;             // Pivot and convexity
+    mutable bool m_world_dirty;             // World points and bounding box
+
+    // Convex decomposition: indices of the local points of every part
+    mutable std::vector<std::vector<unsigned int>> m_parts;
+    mutable std::vector<std::vector<FloatPosition>> m_parts_world;
+    mutable bool m_parts_dirty;             // Decomposition
+    mutable bool m_parts_world_dirty;       // World points of the parts
 
     Float area_() const noexcept
     {
@@ -114,11 +144,7 @@ class Polygon_ final
         return true;
     }
 
-public:
-
-    Polygon_() : m_points(), m_convex( false ) {}
-
-    void convexity_() noexcept
+    void convexity_() const noexcept
     {
         float sign = 0.0f;
         bool have_sign = false;
@@ -165,72 +191,513 @@ public:
         m_convex = true;
     }
 
+    // The convexity and the centroid do not depend on the transformation
+    void updateLocal_() const noexcept
+    {
+        if ( !m_local_dirty )
+            return;
+
+        m_local_dirty = false;
+        m_convex = false;
+        m_has_centroid = false;
+        m_orientation = 1.0f;
+        m_pivot = FloatPosition{ FNIL, FNIL };
+
+        if ( m_points.size() < TRIANGLE_SIDES )
+            return;
+
+        convexity_();
+        m_orientation = area_() < FNIL ? -1.0f : 1.0f;
+        m_has_centroid = calculateCentroid_( m_pivot );
+
+        if ( !m_has_centroid )
+        {
+            // Center of the local bounding box
+            float min_x = m_points[0].x.v, max_x = min_x;
+            float min_y = m_points[0].y.v, max_y = min_y;
+
+            for ( const FloatPosition& p : m_points )
+            {
+                min_x = std::min( min_x, p.x.v );
+                max_x = std::max( max_x, p.x.v );
+                min_y = std::min( min_y, p.y.v );
+                max_y = std::max( max_y, p.y.v );
+            }
 
-    inline void addPoint( const FloatPosition& p )
+            m_pivot = FloatPosition{ ( min_x + max_x ) / 2.0f, ( min_y + max_y ) / 2.0f };
+        }
+    }
+
+    void updateWorld_() const
     {
-        m_points.push_back( p );
+        if ( !m_world_dirty )
+            return;
+
+        const float TX = m_translation.vx.v;
+        const float TY = m_translation.vy.v;
+        m_world.resize( m_points.size() );
+
+        if ( m_angle == 0.0f && m_scale == 1.0f )
+        {
+            for ( size_t i = 0; i < m_points.size(); ++i )
+                m_world[i] = FloatPosition{ m_points[i].x.v + TX, m_points[i].y.v + TY };
+        }
+        else
+        {
+            updateLocal_();
+            const float PX = m_pivot.x.v;
+            const float PY = m_pivot.y.v;
+            const float C = std::cos( m_angle ) * m_scale;
+            const float S = std::sin( m_angle ) * m_scale;
+
+            // A positive angle turns counterclockwise on the screen (the Y axis points down)
+            for ( size_t i = 0; i < m_points.size(); ++i )
+            {
+                const float DX = m_points[i].x.v - PX;
+                const float DY = m_points[i].y.v - PY;
+                m_world[i] = FloatPosition{ PX + C * DX + S * DY + TX, PY - S * DX + C * DY + TY };
+            }
+        }
+
+        if ( m_world.size() >= TRIANGLE_SIDES )
+        {
+            FloatPosition point0 = m_world[0];
+            m_box = { point0, 0, 0 };
+
+            for ( const FloatPosition& p : m_world )
+            {
+                // X
+                if ( p.x < m_box.p.x )
+                    m_box.p.x = p.x;
+
+                if ( p.x > point0.x )
+                    point0.x = p.x;
+
+                // Y
+                if ( p.y < m_box.p.y )
+                    m_box.p.y = p.y;
+
+                if ( p.y > point0.y )
+                    point0.y = p.y;
+            }
+
+            m_box.w = static_cast<int>( point0.x - m_box.p.x ) + 1;
+            m_box.h = static_cast<int>( point0.y - m_box.p.y ) + 1;
+        }
+
+        m_world_dirty = false;
+        m_parts_world_dirty = true;
     }
 
-    inline unsigned long numberOfEdges() const noexcept
+    bool selfIntersecting_() const noexcept
     {
-        return m_points.size();
+        const size_t N = m_points.size();
+
+        for ( size_t i = 0; i < N; ++i )
+        {
+            const Segment S{ m_points[i], m_points[( i + 1 ) % N] };
+
+            // Skip the adjacent edges, they share a vertex
+            for ( size_t j = i + 2; j < N; ++j )
+            {
+                if ( i == 0 && j == N - 1 )
+                    continue;
+
+                if ( intersectSegment( S, Segment{ m_points[j], m_points[( j + 1 ) % N] } ) )
+                    return true;
+            }
+        }
+
+        return false;
     }
 
+    inline float turn_( const unsigned int a, const unsigned int b, const unsigned int c ) const noexcept
+    {
+        const FloatPosition& A = m_points[a];
+        const FloatPosition& B = m_points[b];
+        const FloatPosition& C = m_points[c];
+        return ( B.x.v - A.x.v ) * ( C.y.v - B.y.v ) - ( B.y.v - A.y.v ) * ( C.x.v - B.x.v );
+    }
 
-    inline FloatPosition getPoint( const unsigned long index ) const
+    /*
+    *   Ear clipping: cut the triangles (a, b, c) where b is convex
+    *   and no other vertex is in the triangle.
+    *   idx must have a positive orientation.
+    */
+    bool triangulate_( std::vector<unsigned int> idx ) const
     {
-        return m_points.at( index );
+        while ( idx.size() > TRIANGLE_SIDES )
+        {
+            const size_t M = idx.size();
+            bool found = false;
+
+            for ( size_t i = 0; i < M && !found; ++i )
+            {
+                const unsigned int A = idx[( i + M - 1 ) % M];
+                const unsigned int B = idx[i];
+                const unsigned int C = idx[( i + 1 ) % M];
+                const float TURN = turn_( A, B, C );
+
+                if ( TURN < 0.0f )
+                    continue;
+
+                bool ear = true;
+
+                // A flat vertex is removed, without any triangle
+                for ( size_t j = 0; j < M && ear && TURN > 0.0f; ++j )
+                {
+                    const unsigned int P = idx[j];
+
+                    if ( P == A || P == B || P == C )
+                        continue;
+
+                    ear = !( turn_( A, B, P ) >= 0.0f && turn_( B, C, P ) >= 0.0f
+                             && turn_( C, A, P ) >= 0.0f );
+                }
+
+                if ( ear )
+                {
+                    if ( TURN > 0.0f )
+                        m_parts.push_back( std::vector<unsigned int>{ A, B, C } );
+
+                    idx.erase( idx.begin() + static_cast<long>( i ) );
+                    found = true;
+                }
+            }
+
+            if ( !found )
+                return false;
+        }
+
+        if ( turn_( idx[0], idx[1], idx[2] ) > 0.0f )
+            m_parts.push_back( idx );
+
+        return true;
     }
 
-    FloatingBox getEnclosingBox() const
+    bool convexPart_( const std::vector<unsigned int>& part ) const noexcept
     {
-        if ( m_points.size() < TRIANGLE_SIDES )
-            throw PolygonException( "Polygon: Cannot get the enclosing bounding box" );
+        const size_t M = part.size();
+
+        for ( size_t i = 0; i < M; ++i )
+        {
+            if ( turn_( part[( i + M - 1 ) % M], part[i], part[( i + 1 ) % M] ) < 0.0f )
+                return false;
+        }
+
+        return true;
+    }
+
+    /*
+    *   Hertel-Mehlhorn: remove the diagonals between two parts
+    *   when the union of the parts is still convex
+    */
+    void mergeParts_() const
+    {
+        auto key = []( const unsigned int u, const unsigned int v )
+        {
+            return ( static_cast<uint64_t>( u ) << 32 ) | v;
+        };
+
+        std::unordered_map<uint64_t, size_t> edges;
+
+        for ( size_t i = 0; i < m_parts.size(); ++i )
+        {
+            const std::vector<unsigned int>& P = m_parts[i];
+
+            for ( size_t k = 0; k < P.size(); ++k )
+                edges[key( P[k], P[( k + 1 ) % P.size()] )] = i;
+        }
+
+        for ( size_t i = 0; i < m_parts.size(); ++i )
+        {
+            bool merged = true;
+
+            while ( merged && !m_parts[i].empty() )
+            {
+                merged = false;
+                const std::vector<unsigned int>& P = m_parts[i];
+
+                for ( size_t k = 0; k < P.size() && !merged; ++k )
+                {
+                    const unsigned int U = P[k];
+                    const unsigned int V = P[( k + 1 ) % P.size()];
+                    const auto IT = edges.find( key( V, U ) );
+
+                    if ( IT == edges.end() || IT->second == i || m_parts[IT->second].empty() )
+                        continue;
+
+                    // P from V to U, then Q from U to V (without U and V)
+                    const std::vector<unsigned int>& Q = m_parts[IT->second];
+                    const size_t QU = std::find( Q.begin(), Q.end(), U ) - Q.begin();
+                    std::vector<unsigned int> loop;
+
+                    for ( size_t n = 0; n < P.size(); ++n )
+                        loop.push_back( P[( k + 1 + n ) % P.size()] );
+
+                    for ( size_t n = 1; n + 1 < Q.size(); ++n )
+                        loop.push_back( Q[( QU + n ) % Q.size()] );
+
+                    if ( !convexPart_( loop ) )
+                        continue;
+
+                    const size_t J = IT->second;
+                    edges.erase( key( U, V ) );
+                    edges.erase( key( V, U ) );
+
+                    for ( size_t n = 0; n < loop.size(); ++n )
+                        edges[key( loop[n], loop[( n + 1 ) % loop.size()] )] = i;
+
+                    m_parts[J].clear();
+                    m_parts[i] = loop;
+                    merged = true;
+                }
+            }
+        }
+
+        m_parts.erase( std::remove_if( m_parts.begin(), m_parts.end(),
+                                       []( const std::vector<unsigned int>& p )
+        {
+            return p.empty();
+        } ), m_parts.end() );
+    }
+
+    // The decomposition is empty if the polygon is self-intersecting
+    void decompose_() const
+    {
+        updateLocal_();
+        m_parts.clear();
+        const unsigned int N = static_cast<unsigned int>( m_points.size() );
+
+        if ( N < TRIANGLE_SIDES )
+            return;
+
+        std::vector<unsigned int> idx( N );
+
+        for ( unsigned int i = 0; i < N; ++i )
+            idx[i] = i;
+
+        if ( m_convex )
+        {
+            m_parts.push_back( idx );
+            return;
+        }
+
+        if ( area_() == FNIL || selfIntersecting_() )
+            return;
+
+        if ( m_orientation < 0.0f )
+            std::reverse( idx.begin(), idx.end() );
 
-        FloatPosition point0 = m_points.at( 0 );
-        FloatingBox box = { point0, 0, 0 };
+        if ( !triangulate_( idx ) )
+            m_parts.clear();
+        else
+            mergeParts_();
+    }
 
-        for ( const FloatPosition& p : m_points )
+    void updateParts_() const
+    {
+        if ( m_parts_dirty )
         {
-            // X
-            if ( p.x < box.p.x )
-                box.p.x = p.x;
+            decompose_();
+            m_parts_dirty = false;
+            m_parts_world_dirty = true;
+        }
 
-            if ( p.x > point0.x )
-                point0.x = p.x;
+        updateWorld_();
 
-            // Y
-            if ( p.y < box.p.y )
-                box.p.y = p.y;
+        if ( m_parts_world_dirty )
+        {
+            m_parts_world.resize( m_parts.size() );
 
-            if ( p.y > point0.y )
-                point0.y = p.y;
+            for ( size_t i = 0; i < m_parts.size(); ++i )
+            {
+                m_parts_world[i].clear();
+
+                for ( const unsigned int v : m_parts[i] )
+                    m_parts_world[i].push_back( m_world[v] );
+            }
+
+            m_parts_world_dirty = false;
         }
+    }
 
-        box.w = static_cast<int>( point0.x - box.p.x ) + 1;
-        box.h = static_cast<int>( point0.y - box.p.y ) + 1;
+    /*
+    *   Wedge test: find the triangle (v0, vi, vi+1) that contains the direction of p
+    *   by a binary search, then check the side of the edge (vi, vi+1).
+    *   The points on the boundary are in the polygon.
+    *
+    *   pre-condition: the polygon is convex and the cache is up to date
+    */
+    bool containsConvex_( const float px, const float py ) const noexcept
+    {
+        const size_t N = m_world.size();
+        const float X0 = m_world[0].x.v;
+        const float Y0 = m_world[0].y.v;
+        const float DX = px - X0;
+        const float DY = py - Y0;
+
+        // Positive if p is on the left of (v0, vi), according to the orientation
+        auto side = [&]( const size_t i ) -> float
+        {
+            return m_orientation * ( ( m_world[i].x.v - X0 ) * DY - ( m_world[i].y.v - Y0 ) * DX );
+        };
 
-        return box;
+        if ( side( 1 ) < 0.0f || side( N - 1 ) > 0.0f )
+            return false;
+
+        size_t lo = 1;
+        size_t hi = N - 1;
+
+        while ( hi - lo > 1 )
+        {
+            const size_t MID = ( lo + hi ) / 2;
+
+            if ( side( MID ) >= 0.0f )
+                lo = MID;
+            else
+                hi = MID;
+        }
+
+        const FloatPosition& A = m_world[lo];
+        const FloatPosition& B = m_world[hi];
+        return m_orientation * ( ( B.x.v - A.x.v ) * ( py - A.y.v )
+                                 - ( B.y.v - A.y.v ) * ( px - A.x.v ) ) >= 0.0f;
+    }
+
+    /*
+    *   Crossing number: count the edges crossed by the horizontal ray
+    *   that goes from p to the right (even-odd rule)
+    *
+    *   pre-condition: the cache is up to date
+    */
+    bool containsCrossing_( const float px, const float py ) const noexcept
+    {
+        const size_t N = m_world.size();
+        bool inside = false;
+
+        for ( size_t i = 0, j = N - 1; i < N; j = i++ )
+        {
+            const float XI = m_world[i].x.v;
+            const float YI = m_world[i].y.v;
+            const float XJ = m_world[j].x.v;
+            const float YJ = m_world[j].y.v;
+
+            if ( XI == px && YI == py )
+                return true;
+
+            if ( ( YI > py ) != ( YJ > py )
+                    && px < ( XJ - XI ) * ( py - YI ) / ( YJ - YI ) + XI )
+                inside = !inside;
+        }
+
+        return inside;
+    }
+
+public:
+
+    Polygon_() : m_points(), m_translation{ FNIL, FNIL }, m_angle( 0.0f ), m_scale( 1.0f ),
+        m_world(), m_box{ FloatPosition{ FNIL, FNIL }, 0, 0 }, m_pivot{ FNIL, FNIL },
+        m_has_centroid( false ), m_orientation( 1.0f ), m_convex( false ), m_local_dirty( true ),
+        m_world_dirty( true ), m_parts(), m_parts_world(), m_parts_dirty( true ),
+        m_parts_world_dirty( true ) {}
+
+    inline void invalidate() noexcept
+    {
+        m_local_dirty = true;
+        m_world_dirty = true;
+        m_parts_dirty = true;
+    }
+
+    // The point is given in the world space
+    void addPoint( const FloatPosition& p )
+    {
+        if ( m_angle == 0.0f && m_scale == 1.0f )
+            m_points.push_back( FloatPosition{ p.x - m_translation.vx, p.y - m_translation.vy } );
+        else
+        {
+            // Bake the current transformation into the local points
+            updateWorld_();
+            m_points = m_world;
+            m_points.push_back( p );
+            m_translation = Vector2D{ FNIL, FNIL };
+            m_angle = 0.0f;
+            m_scale = 1.0f;
+        }
+
+        invalidate();
+    }
+
+    inline unsigned long numberOfEdges() const noexcept
+    {
+        return m_points.size();
+    }
+
+
+    inline FloatPosition getPoint( const unsigned long index ) const
+    {
+        updateWorld_();
+        return m_world.at( index );
+    }
+
+    FloatingBox getEnclosingBox() const
+    {
+        if ( m_points.size() < TRIANGLE_SIDES )
+            throw PolygonException( "Polygon: Cannot get the enclosing bounding box" );
+
+        updateWorld_();
+        return m_box;
     }
 
     inline bool isConvex() const noexcept
     {
+        updateLocal_();
         return m_convex;
     }
 
+    unsigned long numberOfConvexParts() const
+    {
+        updateParts_();
+        return m_parts_world.size();
+    }
+
+    ConvexShape getConvexPart( const unsigned long index ) const
+    {
+        updateParts_();
+        const std::vector<FloatPosition>& PART = m_parts_world.at( index );
+        return ConvexShape( PART.data(), PART.size() );
+    }
+
+    bool contains( const FloatPosition& p ) const
+    {
+        if ( m_points.size() < TRIANGLE_SIDES )
+            return false;
+
+        updateLocal_();
+        updateWorld_();
+
+        const float PX = p.x.v;
+        const float PY = p.y.v;
+
+        if ( PX < m_box.p.x.v || PY < m_box.p.y.v
+                || PX > m_box.p.x.v + static_cast<float>( m_box.w )
+                || PY > m_box.p.y.v + static_cast<float>( m_box.h ) )
+            return false;
+
+        return m_convex ? containsConvex_( PX, PY ) : containsCrossing_( PX, PY );
+    }
+
     void _move( const Vector2D& v ) noexcept
     {
-        std::for_each( m_points.begin(), m_points.end(), [&v] ( FloatPosition & p )
-        {
-            movePoint( p, v );
-        } );
+        m_translation += v;
+        m_world_dirty = true;
     }
 
     void moveTo( const FloatPosition& p )
     {
-        FloatPosition centroid;
+        updateLocal_();
 
-        if ( !calculateCentroid_( centroid ) )
+        if ( !m_has_centroid )
         {
             // self-intersecting polygon. The movement is less accurate
             constexpr Float TWO = fbox( 2.0f );
@@ -242,8 +709,33 @@ public:
 
             _move( Vector2D{p.x - q.x, p.y - q.y} );
         }
-        else // Normal case.→ accurate movement
-            _move( Vector2D{p.x - centroid.x, p.y - centroid.y} );
+        else // Normal case.→ accurate movement (the pivot does not move)
+        {
+            const FloatPosition CENTROID{ m_pivot.x + m_translation.vx, m_pivot.y + m_translation.vy };
+            _move( Vector2D{p.x - CENTROID.x, p.y - CENTROID.y} );
+        }
+    }
+
+    void setRotation( const float angle ) noexcept
+    {
+        m_angle = angle;
+        m_world_dirty = true;
+    }
+
+    inline float getRotation() const noexcept
+    {
+        return m_angle;
+    }
+
+    void setScale( const float scale ) noexcept
+    {
+        m_scale = scale;
+        m_world_dirty = true;
+    }
+
+    inline float getScale() const noexcept
+    {
+        return m_scale;
     }
 
     ~Polygon_() = default;
@@ -261,9 +753,8 @@ Polygon::~Polygon()
 
 void Polygon::convexity_() noexcept
 {
-    // Update the convexity when the polygon has at least 3 edges
-    if ( m_polyimpl->numberOfEdges() >= TRIANGLE_SIDES )
-        m_polyimpl->convexity_();
+    // The convexity is evaluated the next time it is requested
+    m_polyimpl->invalidate();
 }
 
 // It is used by the function template
@@ -275,7 +766,6 @@ void Polygon::addPoint_( const FloatPosition& p )
 void Polygon::addPoint( const FloatPosition& p )
 {
     m_polyimpl->addPoint( p );
-    convexity_();
 }
 
 unsigned long Polygon::numberOfEdges() const noexcept
@@ -298,6 +788,21 @@ bool Polygon::isConvex() const noexcept
     return m_polyimpl->isConvex();
 }
 
+unsigned long Polygon::numberOfConvexParts() const
+{
+    return m_polyimpl->numberOfConvexParts();
+}
+
+ConvexShape Polygon::getConvexPart( const unsigned long index ) const
+{
+    return m_polyimpl->getConvexPart( index );
+}
+
+bool Polygon::contains( const FloatPosition& p ) const
+{
+    return m_polyimpl->contains( p );
+}
+
 void Polygon::move( const Vector2D& v ) noexcept
 {
     m_polyimpl->_move( v );
@@ -308,6 +813,26 @@ void Polygon::moveTo( const FloatPosition& p )
     m_polyimpl->moveTo( p );
 }
 
+void Polygon::setRotation( const float angle ) noexcept
+{
+    m_polyimpl->setRotation( angle );
+}
+
+float Polygon::getRotation() const noexcept
+{
+    return m_polyimpl->getRotation();
+}
+
+void Polygon::setScale( const float scale ) noexcept
+{
+    m_polyimpl->setScale( scale );
+}
+
+float Polygon::getScale() const noexcept
+{
+    return m_polyimpl->getScale();
+}
+
 }   // physics
 
 }   // lx
@@ -0,0 +1,215 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file Raycast.cpp
+*   @brief The implementation of the segment casts
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/Raycast.hpp>
+#include <Lunatix/Polygon.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cmath>
+
+
+namespace
+{
+
+const float EPSILON = 1e-9f;
+const float INFINITE_FRACTION = std::numeric_limits<float>::infinity();
+
+inline void setHit_( const lx::Physics::Segment& s, const float t, const float nx,
+                     const float ny, lx::Physics::RayHit& hit ) noexcept
+{
+    hit.fraction = t;
+    hit.point = lx::Physics::FloatPosition{ s.p.x.v + ( s.q.x.v - s.p.x.v ) * t,
+                                            s.p.y.v + ( s.q.y.v - s.p.y.v ) * t };
+    hit.normal = lx::Physics::Vector2D{ nx, ny };
+}
+
+/*
+*   The interval of the fractions where p + d × t is in [low, high]
+*/
+bool slab_( const float p, const float d, const float low, const float high,
+            float& entry, float& exit ) noexcept
+{
+    if ( std::abs( d ) < EPSILON )
+    {
+        entry = -INFINITE_FRACTION;
+        exit = INFINITE_FRACTION;
+        return low <= p && p <= high;
+    }
+
+    const float T1 = ( low - p ) / d;
+    const float T2 = ( high - p ) / d;
+    entry = std::min( T1, T2 );
+    exit = std::max( T1, T2 );
+    return true;
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+bool raycastBox( const Segment& s, const FloatingBox& box, RayHit& hit ) noexcept
+{
+    const float DX = s.q.x.v - s.p.x.v;
+    const float DY = s.q.y.v - s.p.y.v;
+    float entry_x, exit_x, entry_y, exit_y;
+
+    if ( !slab_( s.p.x.v, DX, box.p.x.v, box.p.x.v + static_cast<float>( box.w ), entry_x, exit_x )
+            || !slab_( s.p.y.v, DY, box.p.y.v, box.p.y.v + static_cast<float>( box.h ),
+                       entry_y, exit_y ) )
+        return false;
+
+    const float ENTRY = std::max( entry_x, entry_y );
+    const float EXIT  = std::min( exit_x, exit_y );
+
+    // ENTRY < 0: the origin is in the box
+    if ( ENTRY > EXIT || ENTRY < 0.0f || ENTRY > 1.0f )
+        return false;
+
+    if ( entry_x > entry_y )
+        setHit_( s, ENTRY, DX > 0.0f ? -1.0f : 1.0f, 0.0f, hit );
+    else
+        setHit_( s, ENTRY, 0.0f, DY > 0.0f ? -1.0f : 1.0f, hit );
+
+    return true;
+}
+
+
+bool raycastCircle( const Segment& s, const Circle& circle, RayHit& hit ) noexcept
+{
+    const float DX = s.q.x.v - s.p.x.v;
+    const float DY = s.q.y.v - s.p.y.v;
+    const float MX = s.p.x.v - circle.center.x.v;
+    const float MY = s.p.y.v - circle.center.y.v;
+    const float R = static_cast<float>( circle.radius );
+
+    const float A = DX * DX + DY * DY;
+    const float B = MX * DX + MY * DY;
+    const float C = MX * MX + MY * MY - R * R;
+
+    // C < 0: the origin is in the circle
+    if ( A < EPSILON || C < 0.0f || B > 0.0f )
+        return false;
+
+    const float DISC = B * B - A * C;
+
+    if ( DISC < 0.0f )
+        return false;
+
+    const float T = ( -B - std::sqrt( DISC ) ) / A;
+
+    if ( T < 0.0f || T > 1.0f || R <= 0.0f )
+        return false;
+
+    setHit_( s, T, ( MX + DX * T ) / R, ( MY + DY * T ) / R, hit );
+    return true;
+}
+
+
+namespace
+{
+
+// Point: callable that gives the vertex i of the polygon
+template <typename Point>
+bool raycastPoly_( const Segment& s, const unsigned long N, Point point, RayHit& hit )
+{
+    if ( N < 3UL )
+        throw std::invalid_argument( "The polygon must have at least 3 sides to cast a segment" );
+
+    const float DX = s.q.x.v - s.p.x.v;
+    const float DY = s.q.y.v - s.p.y.v;
+
+    /*
+        The segment enters the polygon through an edge E if it crosses it
+        against its outward normal. The outward normal depends on the orientation
+        of the polygon, so the first crossing of each sign is kept
+        and the orientation is computed in the same loop.
+    */
+    float best[2] = { INFINITE_FRACTION, INFINITE_FRACTION };
+    float normal[2][2] = { { 0.0f, 0.0f }, { 0.0f, 0.0f } };
+    float area = 0.0f;
+
+    for ( unsigned long i = 0, j = N - 1; i < N; j = i++ )
+    {
+        const FloatPosition A = point( j );
+        const FloatPosition B = point( i );
+        const float EX = B.x.v - A.x.v;
+        const float EY = B.y.v - A.y.v;
+        area += A.x.v * B.y.v - B.x.v * A.y.v;
+
+        const float DENOM = DX * EY - DY * EX;
+
+        // Parallel: the segment cannot enter the polygon through this edge
+        if ( std::abs( DENOM ) < EPSILON )
+            continue;
+
+        const float AX = A.x.v - s.p.x.v;
+        const float AY = A.y.v - s.p.y.v;
+        const float T = ( AX * EY - AY * EX ) / DENOM;
+        const float U = ( AX * DY - AY * DX ) / DENOM;
+        const int SIDE = DENOM < 0.0f ? 0 : 1;
+
+        if ( T < 0.0f || T > 1.0f || U < 0.0f || U > 1.0f || T >= best[SIDE] )
+            continue;
+
+        // The normal of the edge against the segment
+        const float LEN = std::sqrt( EX * EX + EY * EY );
+        best[SIDE] = T;
+        normal[SIDE][0] = ( SIDE == 0 ? EY : -EY ) / LEN;
+        normal[SIDE][1] = ( SIDE == 0 ? -EX : EX ) / LEN;
+    }
+
+    // Counterclockwise (positive area): the segment enters where DX × EY - DY × EX < 0
+    const int SIDE = area > 0.0f ? 0 : 1;
+
+    if ( best[SIDE] > 1.0f )
+        return false;
+
+    setHit_( s, best[SIDE], normal[SIDE][0], normal[SIDE][1], hit );
+    return true;
+}
+
+}
+
+
+bool raycastPoly( const Segment& s, const Polygon& poly, RayHit& hit )
+{
+    return raycastPoly_( s, poly.numberOfEdges(), [&poly]( const unsigned long i )
+    {
+        return poly.getPoint( i );
+    }, hit );
+}
+
+
+bool raycastPoly( const Segment& s, const FloatPosition * points, const unsigned long n,
+                  RayHit& hit )
+{
+    return raycastPoly_( s, n, [points]( const unsigned long i )
+    {
+        return points[i];
+    }, hit );
+}
+
+}   // Physics
+
+}   // lx
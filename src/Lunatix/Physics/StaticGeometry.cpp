@@ -0,0 +1,685 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file StaticGeometry.cpp
+*   @brief The implementation of the baked static geometry
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/StaticGeometry.hpp>
+#include <Lunatix/Polygon.hpp>
+#include <Lunatix/GJK.hpp>
+#include <Lunatix/FileIO.hpp>
+
+#include <type_traits>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+
+
+namespace
+{
+
+/*
+    The file is a header followed by 5 arrays, every field is 4 bytes long:
+
+    Header | PolygonRecord × nb_polygons | Node × nb_nodes | PartRecord × nb_parts
+           | vertices of the polygons (x, y) | vertices of the parts (x, y)
+
+    The parts are sorted in the order of the leaves of the tree, so a leaf
+    refers to a range of parts. The first node is the root, the left child
+    of a node is the next node.
+*/
+
+const char MAGIC[4] = { 'L', 'X', 'S', 'G' };
+const uint32_t VERSION = 1;
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+const size_t LEAF_SIZE = 4;
+const size_t MAX_DEPTH = 64;
+
+struct Header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t nb_polygons;
+    uint32_t nb_vertices;
+    uint32_t nb_parts;
+    uint32_t nb_part_vertices;
+    uint32_t nb_nodes;
+};
+
+struct Bounds
+{
+    float min_x, min_y, max_x, max_y;
+};
+
+struct PolygonRecord
+{
+    uint32_t first_vertex;
+    uint32_t nb_vertices;
+    Bounds bounds;
+};
+
+struct PartRecord
+{
+    uint32_t polygon;
+    uint32_t first_vertex;
+    uint32_t nb_vertices;
+    uint32_t padding;
+    Bounds bounds;
+};
+
+// Leaf if count > 0: the parts [index, index + count), otherwise index is the right child
+struct Node
+{
+    Bounds bounds;
+    uint32_t index;
+    uint32_t count;
+};
+
+static_assert( std::is_standard_layout<lx::Physics::FloatPosition>::value
+               && sizeof( lx::Physics::FloatPosition ) == 2 * sizeof( float ),
+               "The vertices of the file must be readable in place" );
+static_assert( sizeof( Header ) % 4 == 0 && sizeof( PolygonRecord ) % 4 == 0
+               && sizeof( PartRecord ) % 4 == 0 && sizeof( Node ) % 4 == 0,
+               "Every array of the file must be aligned on 4 bytes" );
+
+
+inline Bounds emptyBounds_() noexcept
+{
+    const float INF = std::numeric_limits<float>::infinity();
+    return Bounds{ INF, INF, -INF, -INF };
+}
+
+inline void extend_( Bounds& b, const float x, const float y ) noexcept
+{
+    b.min_x = std::min( b.min_x, x );
+    b.min_y = std::min( b.min_y, y );
+    b.max_x = std::max( b.max_x, x );
+    b.max_y = std::max( b.max_y, y );
+}
+
+inline void merge_( Bounds& b, const Bounds& c ) noexcept
+{
+    extend_( b, c.min_x, c.min_y );
+    extend_( b, c.max_x, c.max_y );
+}
+
+inline bool overlap_( const Bounds& a, const Bounds& b ) noexcept
+{
+    return a.min_x <= b.max_x && b.min_x <= a.max_x && a.min_y <= b.max_y && b.min_y <= a.max_y;
+}
+
+inline bool contains_( const Bounds& b, const float x, const float y ) noexcept
+{
+    return b.min_x <= x && x <= b.max_x && b.min_y <= y && y <= b.max_y;
+}
+
+// The fraction where the segment p + d × t enters the bounds, infinite if it does not
+float enter_( const Bounds& b, const float px, const float py, const float dx,
+              const float dy, const float tmax ) noexcept
+{
+    const float INF = std::numeric_limits<float>::infinity();
+    float t0 = 0.0f, t1 = tmax;
+    const float P[2] = { px, py };
+    const float D[2] = { dx, dy };
+    const float LOW[2] = { b.min_x, b.min_y };
+    const float HIGH[2] = { b.max_x, b.max_y };
+
+    for ( int i = 0; i < 2; ++i )
+    {
+        if ( D[i] == 0.0f )
+        {
+            if ( P[i] < LOW[i] || P[i] > HIGH[i] )
+                return INF;
+
+            continue;
+        }
+
+        const float A = ( LOW[i] - P[i] ) / D[i];
+        const float B = ( HIGH[i] - P[i] ) / D[i];
+        t0 = std::max( t0, std::min( A, B ) );
+        t1 = std::min( t1, std::max( A, B ) );
+
+        if ( t0 > t1 )
+            return INF;
+    }
+
+    return t0;
+}
+
+// Point in a convex polygon, whatever its orientation
+bool convexContains_( const lx::Physics::FloatPosition * points, const uint32_t n,
+                      const float x, const float y ) noexcept
+{
+    bool positive = false, negative = false;
+
+    for ( uint32_t i = 0, j = n - 1; i < n; j = i++ )
+    {
+        const float C = ( points[i].x.v - points[j].x.v ) * ( y - points[j].y.v )
+                        - ( points[i].y.v - points[j].y.v ) * ( x - points[j].x.v );
+        positive = positive || C > 0.0f;
+        negative = negative || C < 0.0f;
+
+        if ( positive && negative )
+            return false;
+    }
+
+    return true;
+}
+
+
+/* Bake */
+
+struct BakedPart
+{
+    PartRecord record;
+    float cx, cy;
+};
+
+// Build the subtree of the parts [first, last), the parts are reordered
+void buildTree_( std::vector<BakedPart>& parts, const size_t first, const size_t last,
+                 std::vector<Node>& nodes )
+{
+    const size_t INDEX = nodes.size();
+    Bounds bounds = emptyBounds_();
+    Bounds centers = emptyBounds_();
+
+    for ( size_t i = first; i < last; ++i )
+    {
+        merge_( bounds, parts[i].record.bounds );
+        extend_( centers, parts[i].cx, parts[i].cy );
+    }
+
+    nodes.push_back( Node{ bounds, static_cast<uint32_t>( first ),
+                           static_cast<uint32_t>( last - first ) } );
+
+    if ( last - first <= LEAF_SIZE )
+        return;
+
+    // Median split on the longest axis of the centers
+    const bool X_AXIS = centers.max_x - centers.min_x >= centers.max_y - centers.min_y;
+    const size_t MID = first + ( last - first ) / 2;
+
+    std::nth_element( parts.begin() + static_cast<long>( first ), parts.begin() + static_cast<long>( MID ),
+                      parts.begin() + static_cast<long>( last ),
+                      [X_AXIS]( const BakedPart & a, const BakedPart & b )
+    {
+        return X_AXIS ? a.cx < b.cx : a.cy < b.cy;
+    } );
+
+    buildTree_( parts, first, MID, nodes );
+    nodes[INDEX].index = static_cast<uint32_t>( nodes.size() );
+    nodes[INDEX].count = 0;
+    buildTree_( parts, MID, last, nodes );
+}
+
+template <typename T>
+void write_( lx::FileIO::File& f, const std::vector<T>& v, const std::string& filename )
+{
+    if ( !v.empty() && f.write( v.data(), sizeof( T ), v.size() ) != v.size() )
+        throw lx::FileIO::IOException( "bakeStaticGeometry: " + filename + " - cannot write the file" );
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+void bakeStaticGeometry( const std::vector<const Polygon *>& polygons, const std::string& filename )
+{
+    std::vector<PolygonRecord> records;
+    std::vector<FloatPosition> vertices;
+    std::vector<BakedPart> parts;
+    std::vector<FloatPosition> part_vertices;
+    std::vector<Node> nodes;
+
+    records.reserve( polygons.size() );
+
+    for ( const Polygon * poly : polygons )
+    {
+        const unsigned long N = poly->numberOfEdges();
+        const unsigned long NB_PARTS = N < 3UL ? 0UL : poly->numberOfConvexParts();
+
+        if ( NB_PARTS == 0UL )
+            throw PolygonException( "bakeStaticGeometry: a polygon has less than 3 sides or is self-intersecting" );
+
+        PolygonRecord r{ static_cast<uint32_t>( vertices.size() ), static_cast<uint32_t>( N ),
+                         emptyBounds_() };
+
+        for ( unsigned long i = 0; i < N; ++i )
+        {
+            vertices.push_back( poly->getPoint( i ) );
+            extend_( r.bounds, vertices.back().x.v, vertices.back().y.v );
+        }
+
+        for ( unsigned long k = 0; k < NB_PARTS; ++k )
+        {
+            const ConvexShape PART = poly->getConvexPart( k );
+            const unsigned long M = PART.numberOfVertices();
+            BakedPart b{ PartRecord{ static_cast<uint32_t>( records.size() ),
+                                     static_cast<uint32_t>( part_vertices.size() ),
+                                     static_cast<uint32_t>( M ), 0, emptyBounds_() }, 0.0f, 0.0f };
+
+            for ( unsigned long i = 0; i < M; ++i )
+            {
+                part_vertices.push_back( PART.getVertex( i ) );
+                extend_( b.record.bounds, part_vertices.back().x.v, part_vertices.back().y.v );
+            }
+
+            b.cx = ( b.record.bounds.min_x + b.record.bounds.max_x ) / 2.0f;
+            b.cy = ( b.record.bounds.min_y + b.record.bounds.max_y ) / 2.0f;
+            parts.push_back( b );
+        }
+
+        records.push_back( r );
+    }
+
+    if ( !parts.empty() )
+        buildTree_( parts, 0, parts.size(), nodes );
+
+    std::vector<PartRecord> part_records;
+    part_records.reserve( parts.size() );
+
+    for ( const BakedPart& b : parts )
+        part_records.push_back( b.record );
+
+    Header h{ { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3] }, VERSION, BYTE_ORDER_MARK,
+              static_cast<uint32_t>( records.size() ), static_cast<uint32_t>( vertices.size() ),
+              static_cast<uint32_t>( part_records.size() ), static_cast<uint32_t>( part_vertices.size() ),
+              static_cast<uint32_t>( nodes.size() ) };
+
+    lx::FileIO::File f( filename, lx::FileIO::FileMode::WRONLY );
+
+    if ( f.write( &h, sizeof( Header ), 1 ) != 1 )
+        throw lx::FileIO::IOException( "bakeStaticGeometry: " + filename + " - cannot write the file" );
+
+    write_( f, records, filename );
+    write_( f, nodes, filename );
+    write_( f, part_records, filename );
+    write_( f, vertices, filename );
+    write_( f, part_vertices, filename );
+}
+
+
+/* StaticGeometry — private implementation */
+
+class StaticGeometry_ final
+{
+    lx::FileIO::MappedFile m_file;
+    Header m_header;
+    const PolygonRecord * m_polygons;
+    const Node * m_nodes;
+    const PartRecord * m_parts;
+    const FloatPosition * m_vertices;
+    const FloatPosition * m_part_vertices;
+
+    StaticGeometry_( const StaticGeometry_& ) = delete;
+    StaticGeometry_& operator =( const StaticGeometry_& ) = delete;
+
+    void load_()
+    {
+        const std::string STR( std::string( "StaticGeometry: " ) + m_file.getFilename() + " - " );
+        const uint8_t * DATA = static_cast<const uint8_t *>( m_file.data() );
+
+        if ( m_file.size() < sizeof( Header ) )
+            throw lx::FileIO::IOException( STR + "not a static geometry file" );
+
+        std::memcpy( &m_header, DATA, sizeof( Header ) );
+
+        if ( std::memcmp( m_header.magic, MAGIC, sizeof( MAGIC ) ) != 0 )
+            throw lx::FileIO::IOException( STR + "not a static geometry file" );
+
+        if ( m_header.version != VERSION || m_header.byte_order != BYTE_ORDER_MARK )
+            throw lx::FileIO::IOException( STR + "unsupported version or byte order" );
+
+        // 64-bit: a count (32-bit) × a record size cannot overflow
+        const uint64_t POLYGONS = sizeof( Header );
+        const uint64_t NODES = POLYGONS + uint64_t( sizeof( PolygonRecord ) ) * m_header.nb_polygons;
+        const uint64_t PARTS = NODES + uint64_t( sizeof( Node ) ) * m_header.nb_nodes;
+        const uint64_t VERTICES = PARTS + uint64_t( sizeof( PartRecord ) ) * m_header.nb_parts;
+        const uint64_t PART_VERTICES = VERTICES + uint64_t( sizeof( FloatPosition ) ) * m_header.nb_vertices;
+        const uint64_t END = PART_VERTICES + uint64_t( sizeof( FloatPosition ) ) * m_header.nb_part_vertices;
+
+        if ( END != static_cast<uint64_t>( m_file.size() ) )
+            throw lx::FileIO::IOException( STR + "the file is truncated or corrupted" );
+
+        m_polygons = reinterpret_cast<const PolygonRecord *>( DATA + POLYGONS );
+        m_nodes = reinterpret_cast<const Node *>( DATA + NODES );
+        m_parts = reinterpret_cast<const PartRecord *>( DATA + PARTS );
+        m_vertices = reinterpret_cast<const FloatPosition *>( DATA + VERTICES );
+        m_part_vertices = reinterpret_cast<const FloatPosition *>( DATA + PART_VERTICES );
+
+        if ( !validRecords_() || !validTree_() )
+            throw lx::FileIO::IOException( STR + "the file is corrupted" );
+    }
+
+    // A range [first, first + n) in an array of size max, with at least 3 vertices
+    static bool validRange_( const uint32_t first, const uint32_t n, const uint32_t max ) noexcept
+    {
+        return n >= 3 && uint64_t( first ) + n <= max;
+    }
+
+    bool validRecords_() const noexcept
+    {
+        for ( uint32_t i = 0; i < m_header.nb_polygons; ++i )
+        {
+            if ( !validRange_( m_polygons[i].first_vertex, m_polygons[i].nb_vertices, m_header.nb_vertices ) )
+                return false;
+        }
+
+        for ( uint32_t i = 0; i < m_header.nb_parts; ++i )
+        {
+            const PartRecord& P = m_parts[i];
+
+            if ( P.polygon >= m_header.nb_polygons
+                    || !validRange_( P.first_vertex, P.nb_vertices, m_header.nb_part_vertices ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    /*
+    *   The children of a node are after it (no cycle), the leaves refer to existing parts,
+    *   and the tree is not deeper than the stack of traverse_()
+    */
+    bool validTree_() const
+    {
+        const uint32_t N = m_header.nb_nodes;
+        std::vector<uint32_t> depth( N, 0 );
+
+        for ( uint32_t i = 0; i < N; ++i )
+        {
+            const Node& NODE = m_nodes[i];
+
+            if ( depth[i] >= MAX_DEPTH - 1 )
+                return false;
+
+            if ( NODE.count > 0 )
+            {
+                if ( uint64_t( NODE.index ) + NODE.count > m_header.nb_parts )
+                    return false;
+            }
+            else
+            {
+                if ( NODE.index <= i + 1 || NODE.index >= N )
+                    return false;
+
+                depth[i + 1] = std::max( depth[i + 1], depth[i] + 1 );
+                depth[NODE.index] = std::max( depth[NODE.index], depth[i] + 1 );
+            }
+        }
+
+        return true;
+    }
+
+    const PolygonRecord& polygon_( const unsigned int poly ) const
+    {
+        if ( poly >= m_header.nb_polygons )
+            throw std::out_of_range( "StaticGeometry: invalid index of polygon" );
+
+        return m_polygons[poly];
+    }
+
+    const PartRecord& part_( const unsigned long index ) const
+    {
+        if ( index >= m_header.nb_parts )
+            throw std::out_of_range( "StaticGeometry: invalid index of convex part" );
+
+        return m_parts[index];
+    }
+
+    // Call f on every part of the leaves whose bounds are accepted by visit
+    template <typename Visit, typename F>
+    void traverse_( Visit visit, F f ) const
+    {
+        if ( m_header.nb_nodes == 0 )
+            return;
+
+        uint32_t stack[MAX_DEPTH];
+        size_t top = 0;
+        stack[top++] = 0;
+
+        while ( top > 0 )
+        {
+            const Node& NODE = m_nodes[stack[--top]];
+
+            if ( !visit( NODE.bounds ) )
+                continue;
+
+            if ( NODE.count > 0 )
+            {
+                for ( uint32_t i = NODE.index; i < NODE.index + NODE.count; ++i )
+                    f( m_parts[i] );
+            }
+            else
+            {
+                // Checked by validTree_()
+                if ( top + 2 > MAX_DEPTH )
+                    throw std::length_error( "StaticGeometry: the tree is too deep" );
+
+                const uint32_t LEFT = static_cast<uint32_t>( &NODE - m_nodes ) + 1;
+                stack[top++] = NODE.index;
+                stack[top++] = LEFT;
+            }
+        }
+    }
+
+    static void unique_( std::vector<unsigned int>& result )
+    {
+        std::sort( result.begin(), result.end() );
+        result.erase( std::unique( result.begin(), result.end() ), result.end() );
+    }
+
+public:
+
+    explicit StaticGeometry_( const std::string& filename )
+        : m_file( filename ), m_header(), m_polygons( nullptr ), m_nodes( nullptr ),
+          m_parts( nullptr ), m_vertices( nullptr ), m_part_vertices( nullptr )
+    {
+        load_();
+    }
+
+    unsigned int numberOfPolygons() const noexcept
+    {
+        return m_header.nb_polygons;
+    }
+
+    unsigned long numberOfVertices( const unsigned int poly ) const
+    {
+        return polygon_( poly ).nb_vertices;
+    }
+
+    const FloatPosition * getVertices( const unsigned int poly ) const
+    {
+        return m_vertices + polygon_( poly ).first_vertex;
+    }
+
+    FloatingBox getEnclosingBox( const unsigned int poly ) const
+    {
+        const Bounds& B = polygon_( poly ).bounds;
+        // Same convention as Polygon::getEnclosingBox()
+        return FloatingBox{ FloatPosition{ B.min_x, B.min_y }, static_cast<int>( B.max_x - B.min_x ) + 1,
+                            static_cast<int>( B.max_y - B.min_y ) + 1 };
+    }
+
+    unsigned long numberOfConvexParts() const noexcept
+    {
+        return m_header.nb_parts;
+    }
+
+    ConvexShape getConvexPart( const unsigned long index ) const
+    {
+        const PartRecord& P = part_( index );
+        return ConvexShape( m_part_vertices + P.first_vertex, P.nb_vertices );
+    }
+
+    unsigned int getPolygonOfPart( const unsigned long index ) const
+    {
+        return part_( index ).polygon;
+    }
+
+    void queryPoint( const FloatPosition& p, std::vector<unsigned int>& result ) const
+    {
+        const float X = p.x.v, Y = p.y.v;
+        result.clear();
+
+        traverse_( [X, Y]( const Bounds & b )
+        {
+            return contains_( b, X, Y );
+        },
+        [this, X, Y, &result]( const PartRecord & part )
+        {
+            if ( contains_( part.bounds, X, Y )
+                    && convexContains_( m_part_vertices + part.first_vertex, part.nb_vertices, X, Y ) )
+                result.push_back( part.polygon );
+        } );
+
+        unique_( result );
+    }
+
+    void queryShape( const ConvexShape& shape, std::vector<unsigned int>& result ) const
+    {
+        const FloatingBox BOX = shape.getEnclosingBox();
+        const Bounds Q{ BOX.p.x.v, BOX.p.y.v, BOX.p.x.v + static_cast<float>( BOX.w ),
+                        BOX.p.y.v + static_cast<float>( BOX.h ) };
+        result.clear();
+
+        traverse_( [&Q]( const Bounds & b )
+        {
+            return overlap_( b, Q );
+        },
+        [this, &Q, &shape, &result]( const PartRecord & part )
+        {
+            if ( overlap_( part.bounds, Q ) && collisionGJK( shape,
+                    ConvexShape( m_part_vertices + part.first_vertex, part.nb_vertices ) ) )
+                result.push_back( part.polygon );
+        } );
+
+        unique_( result );
+    }
+
+    unsigned int segmentCast( const Segment& s, RayHit& hit ) const
+    {
+        const float INF = std::numeric_limits<float>::infinity();
+        const float PX = s.p.x.v, PY = s.p.y.v;
+        const float DX = s.q.x.v - PX, DY = s.q.y.v - PY;
+        // Sorted, in order to find a polygon by binary search
+        std::vector<unsigned int> tested;
+        unsigned int best = NO_POLYGON;
+        hit.fraction = INF;
+
+        // The nodes that are entered after the best hit are skipped
+        traverse_( [&]( const Bounds & b )
+        {
+            return enter_( b, PX, PY, DX, DY, std::min( hit.fraction, 1.0f ) ) < INF;
+        },
+        [&]( const PartRecord & part )
+        {
+            // A polygon is cast once, even if several of its parts are visited
+            auto it = std::lower_bound( tested.begin(), tested.end(), part.polygon );
+
+            if ( it != tested.end() && *it == part.polygon )
+                return;
+
+            tested.insert( it, part.polygon );
+            const PolygonRecord& POLY = m_polygons[part.polygon];
+            RayHit h;
+
+            if ( raycastPoly( s, m_vertices + POLY.first_vertex, POLY.nb_vertices, h )
+                    && h.fraction < hit.fraction )
+            {
+                hit = h;
+                best = part.polygon;
+            }
+        } );
+
+        return best;
+    }
+
+    ~StaticGeometry_() = default;
+};
+
+
+/* StaticGeometry — public functions */
+
+StaticGeometry::StaticGeometry( const std::string& filename )
+    : m_sgimpl( new StaticGeometry_( filename ) ) {}
+
+
+unsigned int StaticGeometry::numberOfPolygons() const noexcept
+{
+    return m_sgimpl->numberOfPolygons();
+}
+
+unsigned long StaticGeometry::numberOfVertices( const unsigned int poly ) const
+{
+    return m_sgimpl->numberOfVertices( poly );
+}
+
+const FloatPosition * StaticGeometry::getVertices( const unsigned int poly ) const
+{
+    return m_sgimpl->getVertices( poly );
+}
+
+FloatingBox StaticGeometry::getEnclosingBox( const unsigned int poly ) const
+{
+    return m_sgimpl->getEnclosingBox( poly );
+}
+
+unsigned long StaticGeometry::numberOfConvexParts() const noexcept
+{
+    return m_sgimpl->numberOfConvexParts();
+}
+
+ConvexShape StaticGeometry::getConvexPart( const unsigned long index ) const
+{
+    return m_sgimpl->getConvexPart( index );
+}
+
+unsigned int StaticGeometry::getPolygonOfPart( const unsigned long index ) const
+{
+    return m_sgimpl->getPolygonOfPart( index );
+}
+
+void StaticGeometry::queryPoint( const FloatPosition& p, std::vector<unsigned int>& result ) const
+{
+    m_sgimpl->queryPoint( p, result );
+}
+
+void StaticGeometry::queryShape( const ConvexShape& shape, std::vector<unsigned int>& result ) const
+{
+    m_sgimpl->queryShape( shape, result );
+}
+
+unsigned int StaticGeometry::segmentCast( const Segment& s, RayHit& hit ) const
+{
+    return m_sgimpl->segmentCast( s, hit );
+}
+
+StaticGeometry::~StaticGeometry()
+{
+    m_sgimpl.reset();
+}
+
+}   // Physics
+
+}   // lx
@@ -0,0 +1,376 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file Sweep.cpp
+*   @brief The implementation of the continuous collision detection
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/Sweep.hpp>
+#include <Lunatix/Physics.hpp>
+#include <Lunatix/Polygon.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cmath>
+
+
+namespace
+{
+
+const float EPSILON = 1e-6f;
+const float INFINITE_TIME = std::numeric_limits<float>::infinity();
+
+struct V2 final
+{
+    float x, y;
+};
+
+inline V2 operator +( const V2& a, const V2& b ) noexcept
+{
+    return V2{ a.x + b.x, a.y + b.y };
+}
+
+inline V2 operator -( const V2& a, const V2& b ) noexcept
+{
+    return V2{ a.x - b.x, a.y - b.y };
+}
+
+inline V2 operator *( const V2& a, const float s ) noexcept
+{
+    return V2{ a.x * s, a.y * s };
+}
+
+inline float dot( const V2& a, const V2& b ) noexcept
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+inline V2 toV2( const lx::Physics::FloatPosition& p ) noexcept
+{
+    return V2{ p.x.v, p.y.v };
+}
+
+inline V2 toV2( const lx::Physics::Vector2D& v ) noexcept
+{
+    return V2{ v.vx.v, v.vy.v };
+}
+
+inline void setNormal_( lx::Physics::TimeOfImpact& toi, const V2& n ) noexcept
+{
+    toi.normal = lx::Physics::Vector2D{ n.x, n.y };
+}
+
+// The normal used when the shapes cannot give one: against the movement
+V2 defaultNormal_( const V2& v ) noexcept
+{
+    const float LEN = std::sqrt( dot( v, v ) );
+    return LEN > EPSILON ? v * ( -1.0f / LEN ) : V2{ 0.0f, -1.0f };
+}
+
+/*
+*   The first time t in [0, limit) such that |m + v × t| = r,
+*   if the distance decreases — returns INFINITE_TIME otherwise
+*
+*   m is the position of the moving center relative to the fixed point
+*/
+float timeToPoint_( const V2& m, const V2& v, const float r, const float limit ) noexcept
+{
+    const float A = dot( v, v );
+    const float B = dot( m, v );
+    const float C = dot( m, m ) - r * r;
+
+    if ( A < EPSILON || B >= 0.0f )
+        return INFINITE_TIME;
+
+    const float DISC = B * B - A * C;
+
+    if ( DISC < 0.0f )
+        return INFINITE_TIME;
+
+    const float T = ( -B - std::sqrt( DISC ) ) / A;
+    return ( T >= 0.0f && T < limit ) ? T : INFINITE_TIME;
+}
+
+/*
+*   Sweep a circle against the edges of a closed polyline
+*
+*   vertex(i) gives the i-th vertex, overlap tells if the circle
+*   already collides with the shape, inside if its center is in the shape
+*/
+template <typename Vertex>
+bool sweepEdges_( const lx::Physics::Circle& circle, const V2& v, const unsigned long n,
+                  Vertex vertex, const bool overlap, const bool inside,
+                  lx::Physics::TimeOfImpact& toi )
+{
+    const V2 C = toV2( circle.center );
+    const float R = static_cast<float>( circle.radius );
+
+    if ( overlap )
+    {
+        // The normal goes from the closest point of the boundary to the center
+        V2 best_d{ 0.0f, 0.0f };
+        float best_dist = INFINITE_TIME;
+
+        for ( unsigned long i = 0, j = n - 1; i < n; j = i++ )
+        {
+            const V2 P = toV2( vertex( j ) );
+            const V2 E = toV2( vertex( i ) ) - P;
+            const float LEN2 = dot( E, E );
+            float u = LEN2 > EPSILON ? dot( C - P, E ) / LEN2 : 0.0f;
+            u = u < 0.0f ? 0.0f : ( u > 1.0f ? 1.0f : u );
+
+            const V2 D = C - ( P + E * u );
+            const float DIST = dot( D, D );
+
+            if ( DIST < best_dist )
+            {
+                best_dist = DIST;
+                best_d = D;
+            }
+        }
+
+        const float LEN = std::sqrt( best_dist );
+        toi.time = 0.0f;
+        setNormal_( toi, LEN > EPSILON ? best_d * ( ( inside ? -1.0f : 1.0f ) / LEN )
+                    : defaultNormal_( v ) );
+        return true;
+    }
+
+    float best = INFINITE_TIME;
+    V2 normal{ 0.0f, 0.0f };
+
+    for ( unsigned long i = 0, j = n - 1; i < n; j = i++ )
+    {
+        const V2 P = toV2( vertex( j ) );
+        const V2 Q = toV2( vertex( i ) );
+        const V2 E = Q - P;
+        const float LEN2 = dot( E, E );
+
+        // The vertex Q (every vertex is the end of an edge)
+        const float TV = timeToPoint_( C - Q, v, R, best );
+
+        if ( TV < best )
+        {
+            best = TV;
+            normal = ( C - Q + v * TV ) * ( 1.0f / R );
+        }
+
+        if ( LEN2 < EPSILON )
+            continue;
+
+        // The side of the edge where the center is
+        const float LEN = std::sqrt( LEN2 );
+        V2 en{ -E.y / LEN, E.x / LEN };
+        float s0 = dot( C - P, en );
+
+        if ( s0 < 0.0f )
+        {
+            en = V2{ -en.x, -en.y };
+            s0 = -s0;
+        }
+
+        const float VN = dot( v, en );
+
+        if ( VN >= 0.0f )
+            continue;
+
+        const float T = ( s0 - R ) / -VN;
+
+        if ( T < 0.0f || T >= best )
+            continue;
+
+        const V2 CONTACT = C + v * T - en * R;
+        const float U = dot( CONTACT - P, E ) / LEN2;
+
+        if ( U >= 0.0f && U <= 1.0f )
+        {
+            best = T;
+            normal = en;
+        }
+    }
+
+    if ( best > 1.0f )
+        return false;
+
+    toi.time = best;
+    setNormal_( toi, normal );
+    return true;
+}
+
+/*
+*   The interval of time when the moving interval [p, p + size]
+*   strictly overlaps [q, q + qsize]
+*/
+bool slab_( const float p, const float size, const float v, const float q, const float qsize,
+            float& entry, float& exit ) noexcept
+{
+    const float LOW  = q - size;
+    const float HIGH = q + qsize;
+
+    if ( std::abs( v ) < EPSILON )
+    {
+        entry = -INFINITE_TIME;
+        exit = INFINITE_TIME;
+        return LOW < p && p < HIGH;
+    }
+
+    const float T1 = ( LOW - p ) / v;
+    const float T2 = ( HIGH - p ) / v;
+    entry = std::min( T1, T2 );
+    exit = std::max( T1, T2 );
+    return true;
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+bool sweepBox( const FloatingBox& box, const Vector2D& v, const FloatingBox& target,
+               TimeOfImpact& toi ) noexcept
+{
+    const float BW = static_cast<float>( box.w );
+    const float BH = static_cast<float>( box.h );
+    const float TW = static_cast<float>( target.w );
+    const float TH = static_cast<float>( target.h );
+    const V2 V = toV2( v );
+
+    if ( collisionBox( box, target ) )
+    {
+        // The axis of the smallest penetration
+        const float LEFT   = box.p.x.v + BW - target.p.x.v;
+        const float RIGHT  = target.p.x.v + TW - box.p.x.v;
+        const float TOP    = box.p.y.v + BH - target.p.y.v;
+        const float BOTTOM = target.p.y.v + TH - box.p.y.v;
+        const float MIN_X = std::min( LEFT, RIGHT );
+        const float MIN_Y = std::min( TOP, BOTTOM );
+
+        toi.time = 0.0f;
+
+        if ( MIN_X < MIN_Y )
+            setNormal_( toi, V2{ LEFT < RIGHT ? -1.0f : 1.0f, 0.0f } );
+        else
+            setNormal_( toi, V2{ 0.0f, TOP < BOTTOM ? -1.0f : 1.0f } );
+
+        return true;
+    }
+
+    float entry_x, exit_x, entry_y, exit_y;
+
+    if ( !slab_( box.p.x.v, BW, V.x, target.p.x.v, TW, entry_x, exit_x )
+            || !slab_( box.p.y.v, BH, V.y, target.p.y.v, TH, entry_y, exit_y ) )
+        return false;
+
+    const float ENTRY = std::max( entry_x, entry_y );
+    const float EXIT  = std::min( exit_x, exit_y );
+
+    // Touching during an instant (a corner) is not a collision
+    if ( ENTRY >= EXIT || ENTRY < 0.0f || ENTRY > 1.0f )
+        return false;
+
+    toi.time = ENTRY;
+
+    if ( entry_x > entry_y )
+        setNormal_( toi, V2{ V.x > 0.0f ? -1.0f : 1.0f, 0.0f } );
+    else
+        setNormal_( toi, V2{ 0.0f, V.y > 0.0f ? -1.0f : 1.0f } );
+
+    return true;
+}
+
+
+bool sweepCircle( const Circle& circle, const Vector2D& v, const Circle& target,
+                  TimeOfImpact& toi ) noexcept
+{
+    const V2 M = toV2( circle.center ) - toV2( target.center );
+    const V2 V = toV2( v );
+    const float R = static_cast<float>( circle.radius + target.radius );
+
+    if ( collisionCircle( circle, target ) )
+    {
+        const float LEN = std::sqrt( dot( M, M ) );
+        toi.time = 0.0f;
+        setNormal_( toi, LEN > EPSILON ? M * ( 1.0f / LEN ) : defaultNormal_( V ) );
+        return true;
+    }
+
+    const float T = timeToPoint_( M, V, R, 1.0f );
+
+    if ( T > 1.0f )
+        return false;
+
+    toi.time = T;
+    setNormal_( toi, ( M + V * T ) * ( 1.0f / R ) );
+    return true;
+}
+
+
+bool sweepCircleBox( const Circle& circle, const Vector2D& v, const FloatingBox& box,
+                     TimeOfImpact& toi ) noexcept
+{
+    const float W = static_cast<float>( box.w );
+    const float H = static_cast<float>( box.h );
+    const FloatPosition CORNERS[4] =
+    {
+        box.p, FloatPosition{ box.p.x.v + W, box.p.y.v },
+        FloatPosition{ box.p.x.v + W, box.p.y.v + H }, FloatPosition{ box.p.x.v, box.p.y.v + H }
+    };
+
+    auto vertex = [&CORNERS]( const unsigned long i ) -> const FloatPosition&
+    {
+        return CORNERS[i];
+    };
+
+    return sweepEdges_( circle, toV2( v ), 4UL, vertex, collisionCircleBox( circle, box ),
+                        collisionPointBox( circle.center, box ), toi );
+}
+
+
+bool sweepCirclePoly( const Circle& circle, const Vector2D& v, const Polygon& poly,
+                      TimeOfImpact& toi )
+{
+    const unsigned long N = poly.numberOfEdges();
+
+    if ( N < 3UL )
+        throw std::invalid_argument( "The polygon must have at least "
+                                     "3 sides to calculate the time of impact" );
+
+    // The swept circle is enclosed in a box: no impact outside of it
+    const float R = static_cast<float>( circle.radius );
+    const float X0 = std::min( circle.center.x.v, circle.center.x.v + v.vx.v ) - R;
+    const float Y0 = std::min( circle.center.y.v, circle.center.y.v + v.vy.v ) - R;
+    const float X1 = std::max( circle.center.x.v, circle.center.x.v + v.vx.v ) + R;
+    const float Y1 = std::max( circle.center.y.v, circle.center.y.v + v.vy.v ) + R;
+    const FloatingBox& B = poly.getEnclosingBox();
+
+    if ( X1 < B.p.x.v || B.p.x.v + static_cast<float>( B.w ) < X0
+            || Y1 < B.p.y.v || B.p.y.v + static_cast<float>( B.h ) < Y0 )
+        return false;
+
+    auto vertex = [&poly]( const unsigned long i )
+    {
+        return poly.getPoint( i );
+    };
+
+    return sweepEdges_( circle, toV2( v ), N, vertex, collisionCirclePoly( circle, poly ),
+                        poly.contains( circle.center ), toi );
+}
+
+}   // Physics
+
+}   // lx
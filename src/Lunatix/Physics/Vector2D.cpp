@@ -24,8 +24,6 @@ using namespace FloatBox;
 namespace lx
 {
 
-constexpr Float ONE = fbox( 1.0f );
-
 namespace Physics
 {
 
@@ -41,113 +39,6 @@ bool operator !=( const Vector2D& u, const Vector2D& v ) noexcept
 }
 
 
-Vector2D operator +( const Vector2D u, const Vector2D v ) noexcept
-{
-    return Vector2D{u.vx + v.vx, u.vy + v.vy};
-}
-
-
-Vector2D& operator +=( Vector2D& u, const Vector2D& v ) noexcept
-{
-    u = u + v;
-    return u;
-}
-
-
-Vector2D operator -( const Vector2D u, const Vector2D v ) noexcept
-{
-    return Vector2D{u.vx - v.vx, u.vy - v.vy};
-}
-
-
-Vector2D& operator -=( Vector2D& u, const Vector2D& v ) noexcept
-{
-    u = u - v;
-    return u;
-}
-
-
-Vector2D operator -( const Vector2D& v ) noexcept
-{
-    return Vector2D{ -v.vx, -v.vy};
-}
-
-
-Vector2D& operator ++( Vector2D& v ) noexcept
-{
-    v.vx += ONE;
-    v.vy += ONE;
-    return v;
-}
-
-
-Vector2D operator ++( Vector2D& v, int ) noexcept
-{
-    Vector2D t = v;
-    ++v;
-    return t;
-}
-
-
-Vector2D& operator --( Vector2D& v ) noexcept
-{
-    v.vx -= ONE;
-    v.vy -= ONE;
-    return v;
-}
-
-
-Vector2D operator --( Vector2D& v, int ) noexcept
-{
-    Vector2D t = v;
-    --v;
-    return t;
-}
-
-
-Vector2D operator *( Vector2D v, float lambda ) noexcept
-{
-    return Vector2D{v.vx * lambda, v.vy * lambda};
-}
-
-Vector2D& operator *=( Vector2D& v, float lambda ) noexcept
-{
-    v.vx *= fbox( lambda );
-    v.vy *= fbox( lambda );
-    return v;
-}
-
-Vector2D operator /( Vector2D v, float lambda ) noexcept
-{
-    return Vector2D{v.vx / lambda, v.vy / lambda};
-}
-
-Vector2D& operator /=( Vector2D& v, float lambda ) noexcept
-{
-    v.vx /= fbox( lambda );
-    v.vy /= fbox( lambda );
-    return v;
-}
-
-Float scalar_product( const Vector2D& u, const Vector2D& v ) noexcept
-{
-    return ( u.vx * v.vx ) + ( u.vy * v.vy );
-}
-
-
-Float vector_product( const Vector2D& u, const Vector2D& v ) noexcept
-{
-    return ( u.vx * v.vy ) - ( v.vx * u.vy );
-}
-
-
-Float vector_norm( const Vector2D& v ) noexcept
-{
-    Float tmp = scalar_product( v, v );
-    return FloatMath::sqrt( tmp );
-}
-
-
 bool isNullVector( const Vector2D& v ) noexcept
 {
     return v.vx == FNIL && v.vy == FNIL;
@@ -159,15 +50,6 @@ bool collinear( const Vector2D& u, const Vector2D& v ) noexcept
     return vector_product( u, v ) == FNIL;
 }
 
-Vector2D& normalize( Vector2D& v ) noexcept
-{
-    if ( isNullVector( v ) )
-        return v;
-
-    v *= ( ONE / vector_norm( v ) );
-    return v;
-}
-
 }   // Physics
 
 }   // lx
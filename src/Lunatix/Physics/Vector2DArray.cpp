@@ -0,0 +1,395 @@
+/*
+*   Copyright © 2018 Luxon Jean-Pierre
+*   https://gumichan01.github.io/
+*
+*   LunatiX is a free, SDL2-based library.
+*   It can be used for open-source or commercial games thanks to the zlib/libpng license.
+*
+*   Luxon Jean-Pierre (Gumichan01)
+*   luxon.jean.pierre@gmail.com
+*/
+
+/**
+*   @file Vector2DArray.cpp
+*   @brief The implementation of the packed vectors
+*   @author Luxon Jean-Pierre(Gumichan01)
+*/
+
+#include <Lunatix/Vector2DArray.hpp>
+#include <Lunatix/SystemInfo.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define LX_VECTOR_SIMD 1
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+
+/*
+*   A kernel processes the vectors in [0, n).
+*   u = u × s + (ax, ay) covers the scaling and the translation.
+*/
+using AddScaledFn = void ( * )( float * ux, float * uy, const float * vx, const float * vy,
+                                const float lambda, const size_t n );
+using AffineFn = void ( * )( float * ux, float * uy, const float s, const float ax,
+                             const float ay, const size_t n );
+using DotFn = void ( * )( const float * ux, const float * uy, const float * vx,
+                          const float * vy, float * result, const size_t n );
+using NormFn = void ( * )( const float * ux, const float * uy, float * result, const size_t n );
+using NormalizeFn = void ( * )( float * ux, float * uy, const size_t n );
+
+void addScaledScalar_( float * ux, float * uy, const float * vx, const float * vy,
+                       const float lambda, const size_t n )
+{
+    for ( size_t i = 0; i < n; ++i )
+    {
+        ux[i] += vx[i] * lambda;
+        uy[i] += vy[i] * lambda;
+    }
+}
+
+void affineScalar_( float * ux, float * uy, const float s, const float ax,
+                    const float ay, const size_t n )
+{
+    for ( size_t i = 0; i < n; ++i )
+    {
+        ux[i] = ux[i] * s + ax;
+        uy[i] = uy[i] * s + ay;
+    }
+}
+
+void dotScalar_( const float * ux, const float * uy, const float * vx,
+                 const float * vy, float * result, const size_t n )
+{
+    for ( size_t i = 0; i < n; ++i )
+        result[i] = ux[i] * vx[i] + uy[i] * vy[i];
+}
+
+void normScalar_( const float * ux, const float * uy, float * result, const size_t n )
+{
+    for ( size_t i = 0; i < n; ++i )
+        result[i] = std::sqrt( ux[i] * ux[i] + uy[i] * uy[i] );
+}
+
+void normalizeScalar_( float * ux, float * uy, const size_t n )
+{
+    for ( size_t i = 0; i < n; ++i )
+    {
+        const float D = ux[i] * ux[i] + uy[i] * uy[i];
+
+        if ( D > 0.0f )
+        {
+            const float INV = 1.0f / std::sqrt( D );
+            ux[i] *= INV;
+            uy[i] *= INV;
+        }
+    }
+}
+
+#if defined(LX_VECTOR_SIMD)
+
+/*
+*   The SIMD kernels process 4 (SSE2) or 8 (AVX2) vectors per iteration,
+*   the remaining vectors are processed by the scalar kernels.
+*   The operations are the same as the scalar ones (no FMA, no approximation),
+*   so the results do not depend on the processor.
+*/
+
+__attribute__( ( target( "sse2" ) ) )
+void addScaledSSE2_( float * ux, float * uy, const float * vx, const float * vy,
+                     const float lambda, const size_t n )
+{
+    const __m128 L = _mm_set1_ps( lambda );
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        _mm_storeu_ps( ux + i, _mm_add_ps( _mm_loadu_ps( ux + i ), _mm_mul_ps( _mm_loadu_ps( vx + i ), L ) ) );
+        _mm_storeu_ps( uy + i, _mm_add_ps( _mm_loadu_ps( uy + i ), _mm_mul_ps( _mm_loadu_ps( vy + i ), L ) ) );
+    }
+
+    addScaledScalar_( ux + i, uy + i, vx + i, vy + i, lambda, n - i );
+}
+
+__attribute__( ( target( "sse2" ) ) )
+void affineSSE2_( float * ux, float * uy, const float s, const float ax,
+                  const float ay, const size_t n )
+{
+    const __m128 S = _mm_set1_ps( s ), AX = _mm_set1_ps( ax ), AY = _mm_set1_ps( ay );
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        _mm_storeu_ps( ux + i, _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( ux + i ), S ), AX ) );
+        _mm_storeu_ps( uy + i, _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( uy + i ), S ), AY ) );
+    }
+
+    affineScalar_( ux + i, uy + i, s, ax, ay, n - i );
+}
+
+__attribute__( ( target( "sse2" ) ) )
+void dotSSE2_( const float * ux, const float * uy, const float * vx,
+               const float * vy, float * result, const size_t n )
+{
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        const __m128 X = _mm_mul_ps( _mm_loadu_ps( ux + i ), _mm_loadu_ps( vx + i ) );
+        const __m128 Y = _mm_mul_ps( _mm_loadu_ps( uy + i ), _mm_loadu_ps( vy + i ) );
+        _mm_storeu_ps( result + i, _mm_add_ps( X, Y ) );
+    }
+
+    dotScalar_( ux + i, uy + i, vx + i, vy + i, result + i, n - i );
+}
+
+__attribute__( ( target( "sse2" ) ) )
+void normSSE2_( const float * ux, const float * uy, float * result, const size_t n )
+{
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        const __m128 X = _mm_loadu_ps( ux + i );
+        const __m128 Y = _mm_loadu_ps( uy + i );
+        _mm_storeu_ps( result + i, _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( X, X ), _mm_mul_ps( Y, Y ) ) ) );
+    }
+
+    normScalar_( ux + i, uy + i, result + i, n - i );
+}
+
+__attribute__( ( target( "sse2" ) ) )
+void normalizeSSE2_( float * ux, float * uy, const size_t n )
+{
+    const __m128 ONE = _mm_set1_ps( 1.0f );
+    const __m128 ZERO = _mm_setzero_ps();
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        const __m128 X = _mm_loadu_ps( ux + i );
+        const __m128 Y = _mm_loadu_ps( uy + i );
+        const __m128 D = _mm_add_ps( _mm_mul_ps( X, X ), _mm_mul_ps( Y, Y ) );
+        // The null vectors are multiplied by 1
+        const __m128 POSITIVE = _mm_cmpgt_ps( D, ZERO );
+        const __m128 INV = _mm_or_ps( _mm_and_ps( POSITIVE, _mm_div_ps( ONE, _mm_sqrt_ps( D ) ) ),
+                                      _mm_andnot_ps( POSITIVE, ONE ) );
+        _mm_storeu_ps( ux + i, _mm_mul_ps( X, INV ) );
+        _mm_storeu_ps( uy + i, _mm_mul_ps( Y, INV ) );
+    }
+
+    normalizeScalar_( ux + i, uy + i, n - i );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+void addScaledAVX2_( float * ux, float * uy, const float * vx, const float * vy,
+                     const float lambda, const size_t n )
+{
+    const __m256 L = _mm256_set1_ps( lambda );
+    size_t i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+        _mm256_storeu_ps( ux + i, _mm256_add_ps( _mm256_loadu_ps( ux + i ),
+                                                 _mm256_mul_ps( _mm256_loadu_ps( vx + i ), L ) ) );
+        _mm256_storeu_ps( uy + i, _mm256_add_ps( _mm256_loadu_ps( uy + i ),
+                                                 _mm256_mul_ps( _mm256_loadu_ps( vy + i ), L ) ) );
+    }
+
+    addScaledScalar_( ux + i, uy + i, vx + i, vy + i, lambda, n - i );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+void affineAVX2_( float * ux, float * uy, const float s, const float ax,
+                  const float ay, const size_t n )
+{
+    const __m256 S = _mm256_set1_ps( s ), AX = _mm256_set1_ps( ax ), AY = _mm256_set1_ps( ay );
+    size_t i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+        _mm256_storeu_ps( ux + i, _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( ux + i ), S ), AX ) );
+        _mm256_storeu_ps( uy + i, _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( uy + i ), S ), AY ) );
+    }
+
+    affineScalar_( ux + i, uy + i, s, ax, ay, n - i );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+void dotAVX2_( const float * ux, const float * uy, const float * vx,
+               const float * vy, float * result, const size_t n )
+{
+    size_t i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+        const __m256 X = _mm256_mul_ps( _mm256_loadu_ps( ux + i ), _mm256_loadu_ps( vx + i ) );
+        const __m256 Y = _mm256_mul_ps( _mm256_loadu_ps( uy + i ), _mm256_loadu_ps( vy + i ) );
+        _mm256_storeu_ps( result + i, _mm256_add_ps( X, Y ) );
+    }
+
+    dotScalar_( ux + i, uy + i, vx + i, vy + i, result + i, n - i );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+void normAVX2_( const float * ux, const float * uy, float * result, const size_t n )
+{
+    size_t i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+        const __m256 X = _mm256_loadu_ps( ux + i );
+        const __m256 Y = _mm256_loadu_ps( uy + i );
+        _mm256_storeu_ps( result + i, _mm256_sqrt_ps( _mm256_add_ps( _mm256_mul_ps( X, X ),
+                                                                     _mm256_mul_ps( Y, Y ) ) ) );
+    }
+
+    normScalar_( ux + i, uy + i, result + i, n - i );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+void normalizeAVX2_( float * ux, float * uy, const size_t n )
+{
+    const __m256 ONE = _mm256_set1_ps( 1.0f );
+    const __m256 ZERO = _mm256_setzero_ps();
+    size_t i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+        const __m256 X = _mm256_loadu_ps( ux + i );
+        const __m256 Y = _mm256_loadu_ps( uy + i );
+        const __m256 D = _mm256_add_ps( _mm256_mul_ps( X, X ), _mm256_mul_ps( Y, Y ) );
+        const __m256 INV = _mm256_blendv_ps( ONE, _mm256_div_ps( ONE, _mm256_sqrt_ps( D ) ),
+                                             _mm256_cmp_ps( D, ZERO, _CMP_GT_OQ ) );
+        _mm256_storeu_ps( ux + i, _mm256_mul_ps( X, INV ) );
+        _mm256_storeu_ps( uy + i, _mm256_mul_ps( Y, INV ) );
+    }
+
+    normalizeScalar_( ux + i, uy + i, n - i );
+}
+
+#endif
+
+struct Kernels final
+{
+    AddScaledFn add_scaled;
+    AffineFn affine;
+    DotFn dot;
+    NormFn norm;
+    NormalizeFn normalize;
+};
+
+Kernels bestKernels_() noexcept
+{
+#if defined(LX_VECTOR_SIMD)
+    if ( lx::SystemInfo::hasAVX2() )
+        return Kernels{ addScaledAVX2_, affineAVX2_, dotAVX2_, normAVX2_, normalizeAVX2_ };
+
+    if ( lx::SystemInfo::hasSSE2() )
+        return Kernels{ addScaledSSE2_, affineSSE2_, dotSSE2_, normSSE2_, normalizeSSE2_ };
+#endif
+
+    return Kernels{ addScaledScalar_, affineScalar_, dotScalar_, normScalar_, normalizeScalar_ };
+}
+
+const Kernels vector_kernels = bestKernels_();
+
+inline size_t size_( const lx::Physics::Vector2DArray& u, const lx::Physics::Vector2DArray& v ) noexcept
+{
+    return std::min( u.size(), v.size() );
+}
+
+}
+
+
+namespace lx
+{
+
+namespace Physics
+{
+
+/** Vector2DArray */
+
+void Vector2DArray::push( const Vector2D& v )
+{
+    x.push_back( v.vx.v );
+    y.push_back( v.vy.v );
+}
+
+void Vector2DArray::set( const size_t index, const Vector2D& v ) noexcept
+{
+    x[index] = v.vx.v;
+    y[index] = v.vy.v;
+}
+
+Vector2D Vector2DArray::get( const size_t index ) const noexcept
+{
+    return Vector2D{ x[index], y[index] };
+}
+
+void Vector2DArray::resize( const size_t n )
+{
+    x.resize( n, 0.0f );
+    y.resize( n, 0.0f );
+}
+
+size_t Vector2DArray::size() const noexcept
+{
+    return std::min( x.size(), y.size() );
+}
+
+void Vector2DArray::clear() noexcept
+{
+    x.clear();
+    y.clear();
+}
+
+
+/** Operations */
+
+void add( Vector2DArray& u, const Vector2DArray& v ) noexcept
+{
+    // v × 1 is exactly v
+    vector_kernels.add_scaled( u.x.data(), u.y.data(), v.x.data(), v.y.data(), 1.0f, size_( u, v ) );
+}
+
+void addScaled( Vector2DArray& u, const Vector2DArray& v, const float lambda ) noexcept
+{
+    vector_kernels.add_scaled( u.x.data(), u.y.data(), v.x.data(), v.y.data(), lambda, size_( u, v ) );
+}
+
+void add( Vector2DArray& u, const Vector2D& v ) noexcept
+{
+    vector_kernels.affine( u.x.data(), u.y.data(), 1.0f, v.vx.v, v.vy.v, u.size() );
+}
+
+void scale( Vector2DArray& u, const float lambda ) noexcept
+{
+    vector_kernels.affine( u.x.data(), u.y.data(), lambda, 0.0f, 0.0f, u.size() );
+}
+
+void scalar_product( const Vector2DArray& u, const Vector2DArray& v, std::vector<float>& result )
+{
+    result.resize( size_( u, v ) );
+    vector_kernels.dot( u.x.data(), u.y.data(), v.x.data(), v.y.data(), result.data(), result.size() );
+}
+
+void vector_norm( const Vector2DArray& u, std::vector<float>& result )
+{
+    result.resize( u.size() );
+    vector_kernels.norm( u.x.data(), u.y.data(), result.data(), result.size() );
+}
+
+void normalize( Vector2DArray& u ) noexcept
+{
+    vector_kernels.normalize( u.x.data(), u.y.data(), u.size() );
+}
+
+}   // Physics
+
+}   // lx
@@ -55,6 +55,16 @@ int getCPUCount() noexcept
     return SDL_GetCPUCount();
 }
 
+bool hasSSE2() noexcept
+{
+    return SDL_HasSSE2() == SDL_TRUE;
+}
+
+bool hasAVX2() noexcept
+{
+    return SDL_HasAVX2() == SDL_TRUE;
+}
+
 int getSystemRAM() noexcept
 {
     return SDL_GetSystemRAM();
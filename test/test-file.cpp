@@ -23,6 +23,7 @@ void test_tellSeek( void );
 void test_buffer( void );
 void test_buffer2( void );
 void test_tmp( void );
+void test_mapped( void );
 void test_fs( void );
 void test_getChunk( void );
 
@@ -56,6 +57,7 @@ int main( int argc, char ** argv )
     test_buffer();
     test_buffer2();
     test_tmp();
+    test_mapped();
     test_fs();
     test_getChunk();
     remove( str.c_str() );
@@ -480,6 +482,43 @@ void test_tmp( void )
     lx::Log::log( " = END TEST = " );
 }
 
+void test_mapped( void )
+{
+    lx::Log::log( " = TEST Mapped file = " );
+
+    string str1 = "data/bullet.png";
+
+    try
+    {
+        lx::FileIO::MappedFile m( str1 );
+        File f( str1, FileMode::RDONLY );
+        std::vector<char> buf( static_cast<size_t>( f.size() ) );
+        f.read( buf.data(), sizeof( char ), buf.size() );
+
+        if ( m.size() == buf.size() && std::memcmp( m.data(), buf.data(), buf.size() ) == 0 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - %s mapped, %u bytes", m.getFilename(),
+                              static_cast<unsigned int>( m.size() ) );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - the mapped file is not the same as the file" );
+    }
+    catch ( lx::FileIO::IOException& ioe )
+    {
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - %s", ioe.what() );
+    }
+
+    try
+    {
+        lx::FileIO::MappedFile m( string( "data/no_such_file" ) );
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - a file that does not exist was mapped" );
+    }
+    catch ( lx::FileIO::IOException& ioe )
+    {
+        lx::Log::logInfo( lx::Log::TEST, "SUCCESS - IOException occurred as expected: %s", ioe.what() );
+    }
+
+    lx::Log::log( " = END TEST = " );
+}
+
 using u8map = std::map<UTF8string, UTF8string>;
 using u8pair = std::pair<UTF8string, UTF8string>;
 
@@ -112,6 +112,156 @@ public:
     }
 };
 
+void test_counters()
+{
+    const unsigned int CAPACITY = 100000;
+    const ParticleInfo INFO{ red, FloatingBox{FloatPosition{0.0f, 0.0f}, 5, 5},
+                             Vector2D{1.0f, 0.0f}, 2 };
+
+    lx::Log::log( " = TEST counters = " );
+    ParticleSystem s( CAPACITY );
+
+    if ( s.nbEmptyParticles() != CAPACITY || s.nbActiveParticles() != 0 )
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - empty system: %u active",
+                          s.nbActiveParticles() );
+    else
+        lx::Log::logInfo( lx::Log::TEST, "SUCCESS - empty system" );
+
+    for ( unsigned int i = 0; i < CAPACITY; ++i )
+        s.addParticle( INFO );
+
+    if ( s.addParticle( INFO ) || s.nbEmptyParticles() != 0 )
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - full system: %u empty slot(s)",
+                          s.nbEmptyParticles() );
+    else
+        lx::Log::logInfo( lx::Log::TEST, "SUCCESS - full system" );
+
+    // lifetime: 2, 1, 0, then dead
+    for ( int i = 0; i < 3; ++i )
+        s.updateParticles();
+
+    if ( s.nbActiveParticles() != 0 || s.nbEmptyParticles() != CAPACITY )
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - all the particles should be dead: %u active",
+                          s.nbActiveParticles() );
+    else
+        lx::Log::logInfo( lx::Log::TEST, "SUCCESS - all the particles are dead" );
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_kernels()
+{
+    const unsigned int CAPACITIES[] = { 1003, 40009 };  // serial and parallel updates
+    const ParticleKernel KERNELS[] = { ParticleKernel::SCALAR, ParticleKernel::SSE2,
+                                       ParticleKernel::AVX2
+                                     };
+    const ParticleKernel DEFAULT_KERNEL = getParticleKernel();
+
+    lx::Log::log( " = TEST kernels = " );
+
+    for ( const unsigned int CAPACITY : CAPACITIES )
+    {
+        // The state of every particle after each update, with the first kernel
+        std::vector<std::vector<ParticleInfo>> expected;
+
+        for ( const ParticleKernel& kernel : KERNELS )
+        {
+            if ( !setParticleKernel( kernel ) )
+            {
+                lx::Log::logInfo( lx::Log::TEST, "SUCCESS - kernel %d not supported",
+                                  static_cast<int>( kernel ) );
+                continue;
+            }
+
+            ParticleSystem s( CAPACITY );
+            std::vector<std::vector<ParticleInfo>> states;
+
+            for ( unsigned int i = 0; i < CAPACITY; ++i )
+            {
+                const float F = static_cast<float>( i );
+                s.addParticle( ParticleInfo{ red, FloatingBox{FloatPosition{F, -F}, 5, 5},
+                                             Vector2D{0.25f * F, 0.5f - 0.125f * F},
+                                             i % 13 } );
+            }
+
+            for ( int k = 0; k < 14; ++k )
+            {
+                s.updateParticles();
+                states.push_back( std::vector<ParticleInfo>( s.nbActiveParticles() ) );
+
+                for ( unsigned int i = 0; i < s.nbActiveParticles(); ++i )
+                    s.getParticle( i, states.back()[i] );
+            }
+
+            if ( expected.empty() )
+                expected = states;
+
+            bool same = s.nbActiveParticles() == 0;
+
+            for ( size_t k = 0; same && k < states.size(); ++k )
+            {
+                same = states[k].size() == expected[k].size();
+
+                for ( size_t i = 0; same && i < states[k].size(); ++i )
+                {
+                    const ParticleInfo& P = states[k][i];
+                    const ParticleInfo& Q = expected[k][i];
+                    same = P.box.p.x.v == Q.box.p.x.v && P.box.p.y.v == Q.box.p.y.v
+                           && P.velocity.vx.v == Q.velocity.vx.v
+                           && P.velocity.vy.v == Q.velocity.vy.v && P.lifetime == Q.lifetime;
+                }
+            }
+
+            if ( !same )
+                lx::Log::logInfo( lx::Log::TEST, "FAILURE - kernel %d, %u particles: different results",
+                                  static_cast<int>( kernel ), CAPACITY );
+            else
+                lx::Log::logInfo( lx::Log::TEST, "SUCCESS - kernel %d, %u particles: same results",
+                                  static_cast<int>( kernel ), CAPACITY );
+        }
+    }
+
+    setParticleKernel( DEFAULT_KERNEL );
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_emitter()
+{
+    const unsigned int CAPACITY = 5000;
+    EmitterConfig config{ red, FloatingBox{FloatPosition{100.0f, 100.0f}, 20, 20}, 5, 5,
+                          0.25f, 0.0f, 6.28f, 1.0f, 4.0f, 3, 3 };
+
+    lx::Log::log( " = TEST emitter = " );
+    ParticleSystem s( CAPACITY );
+    ParticleEmitter emitter( s, config );
+
+    if ( emitter.burst( CAPACITY ) != CAPACITY || s.nbActiveParticles() != CAPACITY )
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - burst: %u active", s.nbActiveParticles() );
+    else
+        lx::Log::logInfo( lx::Log::TEST, "SUCCESS - burst of %u particles", CAPACITY );
+
+    if ( emitter.burst( 1 ) != 0 )
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - burst in a full system" );
+    else
+        lx::Log::logInfo( lx::Log::TEST, "SUCCESS - burst in a full system" );
+
+    // lifetime = 3: every particle is dead after 4 updates
+    for ( int i = 0; i < 4; ++i )
+        s.updateParticles();
+
+    unsigned int spawned = 0;
+
+    for ( int i = 0; i < 8; ++i )
+        spawned += emitter.update();
+
+    if ( spawned != 2 || s.nbActiveParticles() != 2 )
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - rate: expected 2, got %u (%u active)",
+                          spawned, s.nbActiveParticles() );
+    else
+        lx::Log::logInfo( lx::Log::TEST, "SUCCESS - rate: 2 particles in 8 updates" );
+
+    lx::Log::log( " = END TEST = " );
+}
 
 int main( int argc, char ** argv )
 {
@@ -148,6 +298,10 @@ int main( int argc, char ** argv )
         lx::Log::log( "%s", ie.what() );
     }
 
+    test_counters();
+    test_kernels();
+    test_emitter();
+
     lx::Log::log( "Loading the dot" );
     dot = new Dot();
     lx::Log::log( "Dot loaded" );
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <sstream>
 #include <stdexcept>
+#include <cstring>
 
 using namespace std;
 using namespace lx::Physics;
@@ -36,9 +37,24 @@ void test_VectorOpposite( void );
 void test_VectorIncDec( void );
 void test_VectorCollinear( void );
 void test_VectorLambda( void );
+void test_Vector2DArray( void );
 
 void test_conversion( void );
 
+void test_collisionWorld( void );
+void test_collisionFilter( void );
+void test_aabbTree( void );
+void test_polygonTransform( void );
+void test_pointInPolygon( void );
+void test_gjk( void );
+void test_convexDecomposition( void );
+void test_sweep( void );
+void test_collisionBatch( void );
+void test_raycast( void );
+void test_physicsWorld( void );
+void test_collisionMask( void );
+void test_staticGeometry( void );
+
 using namespace lx::Physics;
 
 void displayPoly( Polygon& poly );
@@ -82,7 +98,22 @@ int main( int argc, char ** argv )
     test_VectorIncDec();
     test_VectorCollinear();
     test_VectorLambda();
+    test_Vector2DArray();
     test_conversion();
+    test_polygonTransform();
+    test_pointInPolygon();
+    test_gjk();
+    test_convexDecomposition();
+    test_sweep();
+    test_collisionBatch();
+    test_raycast();
+    test_physicsWorld();
+    test_collisionMask();
+    test_staticGeometry();
+
+    test_collisionWorld();
+    test_collisionFilter();
+    test_aabbTree();
 
     lx::quit();
     lx::Log::log( " ==== END Physics ==== \n" );
@@ -979,6 +1010,55 @@ void test_collision2Polygon( void )
     else
         lx::Log::log( "SUCCESS - collision polyc2/poly3" );
 
+    // The polygons that touch each other collide, convex or not
+    lx::Log::log( "touching polygons" );
+    Polygon t1, t2, t3, t4, l1;
+    t1.addPoint( FloatPosition{ 0.0f, 0.0f } );
+    t1.addPoint( FloatPosition{ 10.0f, 0.0f } );
+    t1.addPoint( FloatPosition{ 0.0f, 10.0f } );
+    t2.addPoint( FloatPosition{ 10.0f, 0.0f } );
+    t2.addPoint( FloatPosition{ 10.0f, 10.0f } );
+    t2.addPoint( FloatPosition{ 0.0f, 10.0f } );
+    // Only a vertex in common with t1
+    t3.addPoint( FloatPosition{ 10.0f, 0.0f } );
+    t3.addPoint( FloatPosition{ 20.0f, 0.0f } );
+    t3.addPoint( FloatPosition{ 20.0f, -10.0f } );
+    // Close to t1, but not touching
+    t4.addPoint( FloatPosition{ 10.0f, 1.0f } );
+    t4.addPoint( FloatPosition{ 10.0f, 10.0f } );
+    t4.addPoint( FloatPosition{ 1.5f, 10.0f } );
+    // L shape (not convex), its bottom edge is the top edge of t2
+    l1.addPoint( FloatPosition{ 0.0f, 10.0f } );
+    l1.addPoint( FloatPosition{ 10.0f, 10.0f } );
+    l1.addPoint( FloatPosition{ 10.0f, 15.0f } );
+    l1.addPoint( FloatPosition{ 5.0f, 15.0f } );
+    l1.addPoint( FloatPosition{ 5.0f, 20.0f } );
+    l1.addPoint( FloatPosition{ 0.0f, 20.0f } );
+
+    const struct
+    {
+        const char * what;
+        bool result;
+        bool expected;
+    } TOUCHING[] =
+    {
+        { "convex, shared edge", collisionPoly( t1, t2 ), true },
+        { "convex, shared vertex", collisionPoly( t1, t3 ), true },
+        { "convex, no contact", collisionPoly( t1, t4 ), false },
+        { "not convex, shared edge", collisionPoly( l1, t2 ), true },
+        { "not convex, shared edge (swapped)", collisionPoly( t2, l1 ), true },
+        { "box, shared edge", collisionBoxPoly( FloatingBox{ FloatPosition{ 10.0f, 0.0f }, 5, 5 }, t2 ), true },
+    };
+
+    for ( const auto& T : TOUCHING )
+    {
+        if ( T.result == T.expected )
+            lx::Log::log( "SUCCESS - touching polygons, %s: %d", T.what, T.result );
+        else
+            lx::Log::log( "FAILURE - touching polygons, %s: expected: %d; got: %d", T.what,
+                          T.expected, T.result );
+    }
+
     lx::Log::log( " = END TEST = " );
 }
 
@@ -1567,6 +1647,143 @@ void test_VectorLambda( void )
     lx::Log::log( " = END TEST = " );
 }
 
+void test_Vector2DArray( void )
+{
+    lx::Log::log( " = TEST Vector2DArray = " );
+
+    constexpr Vector2D U{ 1.0f, 2.0f };
+    constexpr Vector2D V = ( U + Vector2D{ 3.0f, 4.0f } ) * 2.0f - U;
+    static_assert( V.vx.v == 7.0f && V.vy.v == 10.0f, "constexpr Vector2D operators" );
+    static_assert( scalar_product( U, V ).v == 27.0f && vector_product( U, V ).v == -4.0f,
+                   "constexpr Vector2D products" );
+
+    const size_t N = 1003;   // Not a multiple of 8
+    Vector2DArray u, v;
+    std::vector<Vector2D> su, sv;
+
+    auto rnd = []()
+    {
+        return static_cast<float>( lx::Random::xrand<unsigned int>( 0, 2000 ) ) / 10.0f - 100.0f;
+    };
+
+    for ( size_t i = 0; i < N; ++i )
+    {
+        su.push_back( Vector2D{ rnd(), rnd() } );
+        sv.push_back( Vector2D{ rnd(), rnd() } );
+        u.push( su.back() );
+        v.push( sv.back() );
+    }
+
+    // Null vectors
+    su[7] = Vector2D{ 0.0f, 0.0f };
+    u.set( 7, su[7] );
+    su[N - 1] = Vector2D{ 0.0f, 0.0f };
+    u.set( N - 1, su[N - 1] );
+
+    auto same = [&u, &su]()
+    {
+        for ( size_t i = 0; i < su.size(); ++i )
+        {
+            if ( u.x[i] != su[i].vx.v || u.y[i] != su[i].vy.v )
+                return false;
+        }
+
+        return u.size() == su.size();
+    };
+
+    std::vector<float> dots, norms;
+    scalar_product( u, v, dots );
+    vector_norm( u, norms );
+    bool ok = dots.size() == N && norms.size() == N;
+
+    for ( size_t i = 0; ok && i < N; ++i )
+    {
+        ok = dots[i] == scalar_product( su[i], sv[i] ).v && norms[i] == vector_norm( su[i] ).v;
+    }
+
+    if ( ok )
+        lx::Log::log( "SUCCESS - scalar products and norms" );
+    else
+        lx::Log::log( "FAILURE - scalar products and norms" );
+
+    const float DT = 1.0f / 60.0f;
+    const Vector2D G{ 0.0f, 9.81f };
+    add( u, v );
+    addScaled( u, v, DT );
+    add( u, G );
+    scale( u, 0.5f );
+
+    for ( size_t i = 0; i < N; ++i )
+    {
+        su[i] += sv[i];
+        su[i] += sv[i] * DT;
+        su[i] += G;
+        su[i] *= 0.5f;
+    }
+
+    if ( same() )
+        lx::Log::log( "SUCCESS - add, addScaled, scale" );
+    else
+        lx::Log::log( "FAILURE - add, addScaled, scale" );
+
+    u.set( 7, Vector2D{ 0.0f, 0.0f } );
+    su[7] = Vector2D{ 0.0f, 0.0f };
+    normalize( u );
+
+    for ( Vector2D& w : su )
+        normalize( w );
+
+    if ( same() && u.get( 7 ) == Vector2D{ 0.0f, 0.0f } && vector_norm( u.get( 0 ) ) == fbox( 1.0f ) )
+        lx::Log::log( "SUCCESS - normalize" );
+    else
+        lx::Log::log( "FAILURE - normalize" );
+
+    // Arrays of different sizes
+    Vector2DArray small;
+    small.push( Vector2D{ 1.0f, 1.0f } );
+    const Vector2D FIRST = u.get( 0 );
+    add( small, u );
+    scalar_product( u, small, dots );
+
+    if ( small.size() == 1 && small.get( 0 ) == Vector2D{ 1.0f, 1.0f } + FIRST && dots.size() == 1 )
+        lx::Log::log( "SUCCESS - arrays of different sizes" );
+    else
+        lx::Log::log( "FAILURE - arrays of different sizes" );
+
+    // Bulk kinematics
+    const size_t M = 1000000;
+    Vector2DArray positions, velocities;
+    std::vector<Vector2D> sp( M, Vector2D{ 0.0f, 0.0f } ), svel( M, Vector2D{ 1.0f, 2.0f } );
+    positions.resize( M );
+
+    for ( size_t i = 0; i < M; ++i )
+        velocities.push( svel[i] );
+
+    unsigned int t = lx::Time::getTicks();
+
+    for ( int k = 0; k < 60; ++k )
+        addScaled( positions, velocities, DT );
+
+    const unsigned int T_ARRAY = lx::Time::getTicks() - t;
+    t = lx::Time::getTicks();
+
+    for ( int k = 0; k < 60; ++k )
+    {
+        for ( size_t i = 0; i < M; ++i )
+            sp[i] += svel[i] * DT;
+    }
+
+    lx::Log::log( "60 × %lu vectors: %u ms (array), %u ms (Vector2D)",
+                  static_cast<unsigned long>( M ), T_ARRAY, lx::Time::getTicks() - t );
+
+    if ( positions.get( M - 1 ) == sp[M - 1] )
+        lx::Log::log( "SUCCESS - bulk kinematics" );
+    else
+        lx::Log::log( "FAILURE - bulk kinematics" );
+
+    lx::Log::log( " = END TEST = " );
+}
+
 #define i32(x) static_cast<int>(x)
 
 void test_conversion( void )
@@ -1594,6 +1811,2020 @@ void test_conversion( void )
     lx::Log::log( " = END TEST = " );
 }
 
+void test_polygonTransform( void )
+{
+    lx::Log::log( " = TEST Polygon transformation = " );
+
+    const float PI = 3.14159265f;
+    const unsigned int NB_VERTICES = 64;
+    auto near = []( const Float& x, const float y )
+    {
+        return std::abs( x.v - y ) < 0.01f;
+    };
+
+    Polygon poly;
+    std::vector<FloatPosition> points;
+
+    // Regular polygon, centered on (100, 100)
+    for ( unsigned int i = 0; i < NB_VERTICES; ++i )
+    {
+        const float A = 2.0f * PI * static_cast<float>( i ) / static_cast<float>( NB_VERTICES );
+        points.push_back( FloatPosition{ 100.0f + 50.0f * std::cos( A ), 100.0f + 50.0f * std::sin( A ) } );
+    }
+
+    poly.addPoints( points.begin(), points.end() );
+
+    if ( poly.isConvex() )
+        lx::Log::log( "SUCCESS - convex polygon with %u vertices", NB_VERTICES );
+    else
+        lx::Log::log( "FAILURE - the polygon should be convex" );
+
+    const uint32_t T = lx::Time::getTicks();
+
+    for ( unsigned int i = 0; i < 100000; ++i )
+        poly.move( Vector2D{ 1.0f, 0.5f } );
+
+    lx::Log::log( "100000 moves in %u ms", lx::Time::getTicks() - T );
+    poly.move( Vector2D{ -100000.0f, -50000.0f } );
+
+    const FloatingBox B = poly.getEnclosingBox();
+
+    if ( near( B.p.x, 50.0f ) && near( B.p.y, 50.0f ) && B.w == 101 && B.h == 101 )
+        lx::Log::log( "SUCCESS - enclosing box after the moves: (%f, %f, %d, %d)",
+                      B.p.x.v, B.p.y.v, B.w, B.h );
+    else
+        lx::Log::log( "FAILURE - enclosing box after the moves: (%f, %f, %d, %d)",
+                      B.p.x.v, B.p.y.v, B.w, B.h );
+
+    // A quarter of turn: the first point (right) goes to the top
+    poly.setRotation( PI / 2.0f );
+    FloatPosition p = poly.getPoint( 0 );
+
+    if ( near( p.x, 100.0f ) && near( p.y, 50.0f ) && poly.isConvex() )
+        lx::Log::log( "SUCCESS - rotation: (%f, %f)", p.x.v, p.y.v );
+    else
+        lx::Log::log( "FAILURE - rotation: (%f, %f), expected (100, 50)", p.x.v, p.y.v );
+
+    poly.setScale( 2.0f );
+    const FloatingBox BS = poly.getEnclosingBox();
+
+    if ( near( BS.p.x, 0.0f ) && near( BS.p.y, 0.0f ) && BS.w == 201 && BS.h == 201 )
+        lx::Log::log( "SUCCESS - scale: (%f, %f, %d, %d)", BS.p.x.v, BS.p.y.v, BS.w, BS.h );
+    else
+        lx::Log::log( "FAILURE - scale: (%f, %f, %d, %d), expected (0, 0, 201, 201)",
+                      BS.p.x.v, BS.p.y.v, BS.w, BS.h );
+
+    // The rotation and the scale are around the centroid
+    poly.moveTo( FloatPosition{ 500.0f, 400.0f } );
+    const FloatingBox BM = poly.getEnclosingBox();
+
+    if ( near( BM.p.x, 400.0f ) && near( BM.p.y, 300.0f ) )
+        lx::Log::log( "SUCCESS - moveTo: (%f, %f)", BM.p.x.v, BM.p.y.v );
+    else
+        lx::Log::log( "FAILURE - moveTo: (%f, %f), expected (400, 300)", BM.p.x.v, BM.p.y.v );
+
+    // Adding a point applies the transformation
+    const FloatPosition P0 = poly.getPoint( 0 );
+    poly.addPoint( FloatPosition{ 500.0f, 400.0f } );
+
+    if ( poly.getRotation() == 0.0f && poly.getScale() == 1.0f && poly.getPoint( 0 ) == P0
+            && poly.numberOfEdges() == NB_VERTICES + 1 && !poly.isConvex() )
+        lx::Log::log( "SUCCESS - point added to a rotated polygon" );
+    else
+        lx::Log::log( "FAILURE - point added to a rotated polygon" );
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_pointInPolygon( void )
+{
+    lx::Log::log( " = TEST point in polygon = " );
+
+    const float PI = 3.14159265f;
+    const unsigned int NB_VERTICES = 64;
+    const unsigned int NB_POINTS = 100000;
+    Polygon convex, star;
+
+    // A convex polygon and a star (not convex), with the same number of vertices
+    for ( unsigned int i = 0; i < NB_VERTICES; ++i )
+    {
+        const float A = 2.0f * PI * static_cast<float>( i ) / static_cast<float>( NB_VERTICES );
+        const float R = ( i % 2 == 0 ) ? 200.0f : 80.0f;
+        convex.addPoint( FloatPosition{ 300.0f + 200.0f * std::cos( A ), 300.0f + 200.0f * std::sin( A ) } );
+        star.addPoint( FloatPosition{ 300.0f + R * std::cos( A ), 300.0f + R * std::sin( A ) } );
+    }
+
+    // Reference: crossing number on every edge
+    auto reference = []( const FloatPosition& p, const Polygon& poly )
+    {
+        const unsigned long N = poly.numberOfEdges();
+        bool inside = false;
+
+        for ( unsigned long i = 0, j = N - 1; i < N; j = i++ )
+        {
+            const FloatPosition A = poly.getPoint( i );
+            const FloatPosition B = poly.getPoint( j );
+
+            if ( ( A.y.v > p.y.v ) != ( B.y.v > p.y.v )
+                    && p.x.v < ( B.x.v - A.x.v ) * ( p.y.v - A.y.v ) / ( B.y.v - A.y.v ) + A.x.v )
+                inside = !inside;
+        }
+
+        return inside;
+    };
+
+    std::vector<FloatPosition> points;
+
+    for ( unsigned int i = 0; i < NB_POINTS; ++i )
+    {
+        points.push_back( FloatPosition{ lx::Random::fxrand( 0.0f, 1.0f ) * 600.0f,
+                                         lx::Random::fxrand( 0.0f, 1.0f ) * 600.0f } );
+    }
+
+    unsigned int nb_convex = 0, nb_star = 0, nb_diff = 0;
+    uint32_t t = lx::Time::getTicks();
+
+    for ( const FloatPosition& p : points )
+    {
+        nb_convex += collisionPointPoly( p, convex ) ? 1 : 0;
+        nb_star += collisionPointPoly( p, star ) ? 1 : 0;
+    }
+
+    lx::Log::log( "%u points in %u ms", 2 * NB_POINTS, lx::Time::getTicks() - t );
+
+    for ( const FloatPosition& p : points )
+    {
+        nb_diff += collisionPointPoly( p, convex ) != reference( p, convex ) ? 1 : 0;
+        nb_diff += collisionPointPoly( p, star ) != reference( p, star ) ? 1 : 0;
+    }
+
+    if ( convex.isConvex() && !star.isConvex() && nb_diff == 0 )
+        lx::Log::log( "SUCCESS - %u points in the convex polygon, %u in the star", nb_convex, nb_star );
+    else
+        lx::Log::log( "FAILURE - %u differences with the reference", nb_diff );
+
+    // Deterministic: the same point always gets the same result, vertices included
+    bool same = true;
+    const FloatPosition V = convex.getPoint( 5 );
+    const FloatPosition S = star.getPoint( 7 );
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        same = same && collisionPointPoly( V, convex ) && collisionPointPoly( S, star )
+               && !collisionPointPoly( FloatPosition{ 300.0f, 600.0f }, convex );
+    }
+
+    lx::Log::log( "%s - deterministic result", same ? "SUCCESS" : "FAILURE" );
+
+    // The box and the circle use the same test
+    const FloatingBox INSIDE{ FloatPosition{ 290.0f, 290.0f }, 20, 20 };
+    const FloatingBox OUTSIDE{ FloatPosition{ 0.0f, 0.0f }, 20, 20 };
+    const Circle CIN{ FloatPosition{ 300.0f, 300.0f }, 10 };
+    const Circle COUT{ FloatPosition{ 10.0f, 590.0f }, 10 };
+
+    if ( collisionBoxPoly( INSIDE, star ) && !collisionBoxPoly( OUTSIDE, convex )
+            && collisionCirclePoly( CIN, convex ) && !collisionCirclePoly( COUT, star ) )
+        lx::Log::log( "SUCCESS - box and circle in the polygons" );
+    else
+        lx::Log::log( "FAILURE - box and circle in the polygons" );
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_gjk( void )
+{
+    lx::Log::log( " = TEST GJK/EPA = " );
+
+    auto near = []( const float x, const float y )
+    {
+        return std::abs( x - y ) < 0.02f;
+    };
+
+    const FloatingBox A{ FloatPosition{ 0.0f, 0.0f }, 10, 10 };
+    const FloatingBox B{ FloatPosition{ 8.0f, 2.0f }, 10, 10 };
+    ContactManifold m;
+
+    if ( contactGJK( A, B, m ) && near( m.normal.vx.v, 1.0f ) && near( m.normal.vy.v, 0.0f )
+            && near( m.depth, 2.0f ) && m.nb_points == 2 )
+        lx::Log::log( "SUCCESS - box/box: depth %f, contact points (%f, %f) (%f, %f)", m.depth,
+                      m.points[0].x.v, m.points[0].y.v, m.points[1].x.v, m.points[1].y.v );
+    else
+        lx::Log::log( "FAILURE - box/box: normal (%f, %f), depth %f, %u points",
+                      m.normal.vx.v, m.normal.vy.v, m.depth, m.nb_points );
+
+    // Triangles
+    Polygon t1, t2;
+    t1.addPoint( FloatPosition{ 0.0f, 0.0f } );
+    t1.addPoint( FloatPosition{ 20.0f, 0.0f } );
+    t1.addPoint( FloatPosition{ 10.0f, 20.0f } );
+    t2.addPoint( FloatPosition{ 0.0f, 15.0f } );
+    t2.addPoint( FloatPosition{ 20.0f, 15.0f } );
+    t2.addPoint( FloatPosition{ 10.0f, 35.0f } );
+
+    if ( collisionGJK( t1, t2 ) && collisionPoly( t1, t2 ) && contactGJK( t1, t2, m ) )
+    {
+        // The MTV separates the triangles
+        movePoly( t1, Vector2D{ -m.normal.vx * fbox( m.depth + 0.01f ), -m.normal.vy * fbox( m.depth + 0.01f ) } );
+
+        if ( !collisionGJK( t1, t2 ) )
+            lx::Log::log( "SUCCESS - triangle/triangle: depth %f", m.depth );
+        else
+            lx::Log::log( "FAILURE - triangle/triangle: still in collision after the move" );
+    }
+    else
+        lx::Log::log( "FAILURE - triangle/triangle: no collision" );
+
+    movePoly( t2, Vector2D{ 100.0f, 0.0f } );
+
+    if ( !collisionGJK( t1, t2 ) && !collisionPoly( t1, t2 ) )
+        lx::Log::log( "SUCCESS - triangle/triangle: no collision" );
+    else
+        lx::Log::log( "FAILURE - triangle/triangle: collision" );
+
+    // Circles
+    const Circle C1{ FloatPosition{ 0.0f, 0.0f }, 10 };
+    const Circle C2{ FloatPosition{ 15.0f, 0.0f }, 10 };
+    const Circle C3{ FloatPosition{ 20.0f, 0.0f }, 10 };
+
+    if ( contactGJK( C1, C2, m ) && near( m.normal.vx.v, 1.0f ) && near( m.depth, 5.0f )
+            && m.nb_points == 1 && !collisionGJK( C1, C3 ) )
+        lx::Log::log( "SUCCESS - circle/circle: depth %f", m.depth );
+    else
+        lx::Log::log( "FAILURE - circle/circle: normal (%f, %f), depth %f",
+                      m.normal.vx.v, m.normal.vy.v, m.depth );
+
+    const Circle C4{ FloatPosition{ 10.0f, -8.0f }, 10 };
+
+    if ( contactGJK( C4, A, m ) && near( m.normal.vx.v, 0.0f ) && near( m.normal.vy.v, 1.0f )
+            && near( m.depth, 2.0f ) && near( m.points[0].x.v, 10.0f ) && near( m.points[0].y.v, 0.0f ) )
+        lx::Log::log( "SUCCESS - circle/box: depth %f", m.depth );
+    else
+        lx::Log::log( "FAILURE - circle/box: normal (%f, %f), depth %f",
+                      m.normal.vx.v, m.normal.vy.v, m.depth );
+
+    // Same result as collisionBox() and collisionCircle() on random shapes
+    unsigned int nb_diff = 0;
+
+    for ( int i = 0; i < 10000; ++i )
+    {
+        const FloatingBox B1{ FloatPosition{ static_cast<float>( lx::Random::xrand<unsigned int>( 0, 100 ) ),
+                                             static_cast<float>( lx::Random::xrand<unsigned int>( 0, 100 ) ) },
+                              static_cast<int>( lx::Random::xrand<unsigned int>( 1, 40 ) ),
+                              static_cast<int>( lx::Random::xrand<unsigned int>( 1, 40 ) ) };
+        const FloatingBox B2{ FloatPosition{ static_cast<float>( lx::Random::xrand<unsigned int>( 0, 100 ) ),
+                                             static_cast<float>( lx::Random::xrand<unsigned int>( 0, 100 ) ) },
+                              static_cast<int>( lx::Random::xrand<unsigned int>( 1, 40 ) ),
+                              static_cast<int>( lx::Random::xrand<unsigned int>( 1, 40 ) ) };
+        const Circle CA{ B1.p, static_cast<unsigned int>( B1.w ) };
+        const Circle CB{ FloatPosition{ B2.p.x + fbox( 0.5f ), B2.p.y }, static_cast<unsigned int>( B2.w ) };
+
+        nb_diff += collisionGJK( B1, B2 ) != collisionBox( B1, B2 ) ? 1 : 0;
+        nb_diff += collisionGJK( CA, CB ) != collisionCircle( CA, CB ) ? 1 : 0;
+    }
+
+    if ( nb_diff == 0 )
+        lx::Log::log( "SUCCESS - same results as collisionBox() and collisionCircle()" );
+    else
+        lx::Log::log( "FAILURE - %u differences with collisionBox() and collisionCircle()", nb_diff );
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_convexDecomposition( void )
+{
+    lx::Log::log( " = TEST convex decomposition = " );
+
+    const float PI = 3.14159265f;
+    const unsigned int NB_VERTICES = 200;
+    const unsigned int NB_BOXES = 20000;
+    Polygon star, ground;
+
+    // A star and a ground with a jagged surface, 200 vertices each
+    for ( unsigned int i = 0; i < NB_VERTICES; ++i )
+    {
+        const float A = 2.0f * PI * static_cast<float>( i ) / static_cast<float>( NB_VERTICES );
+        const float R = ( i % 2 == 0 ) ? 250.0f : 150.0f;
+        star.addPoint( FloatPosition{ 300.0f + R * std::cos( A ), 300.0f + R * std::sin( A ) } );
+    }
+
+    for ( unsigned int i = 0; i < NB_VERTICES - 2; ++i )
+    {
+        const float H = ( i % 3 == 0 ) ? 350.0f : 400.0f + lx::Random::fxrand( 0.0f, 1.0f ) * 50.0f;
+        ground.addPoint( FloatPosition{ 3.0f * static_cast<float>( i ), H } );
+    }
+
+    ground.addPoint( FloatPosition{ 3.0f * static_cast<float>( NB_VERTICES - 3 ), 600.0f } );
+    ground.addPoint( FloatPosition{ 0.0f, 600.0f } );
+
+    // The parts cover the polygon: same area
+    auto area = []( const ConvexShape& s )
+    {
+        float a = 0.0f;
+        const unsigned long N = s.numberOfVertices();
+
+        for ( unsigned long i = 0, j = N - 1; i < N; j = i++ )
+        {
+            const FloatPosition P = s.getVertex( j );
+            const FloatPosition Q = s.getVertex( i );
+            a += P.x.v * Q.y.v - Q.x.v * P.y.v;
+        }
+
+        return std::abs( a ) / 2.0f;
+    };
+
+    for ( const Polygon * poly : { &star, &ground } )
+    {
+        uint32_t t = lx::Time::getTicks();
+        const unsigned long NB_PARTS = poly->numberOfConvexParts();
+        const uint32_t DT = lx::Time::getTicks() - t;
+        const float AREA = area( ConvexShape( *poly ) );
+        float sum = 0.0f;
+
+        for ( unsigned long i = 0; i < NB_PARTS; ++i )
+            sum += area( poly->getConvexPart( i ) );
+
+        lx::Log::log( "%lu parts in %u ms, area of the parts: %f, area: %f", NB_PARTS, DT, sum, AREA );
+
+        if ( !poly->isConvex() && NB_PARTS > 1 && NB_PARTS < NB_VERTICES
+                && std::abs( sum - AREA ) < AREA * 0.001f )
+            lx::Log::log( "SUCCESS - the polygon is decomposed" );
+        else
+            lx::Log::log( "FAILURE - the polygon is not decomposed" );
+    }
+
+    // Reference: every edge of the box against every edge of the polygon
+    auto reference = []( const FloatingBox& b, const Polygon& poly )
+    {
+        const float W = static_cast<float>( b.w );
+        const float H = static_cast<float>( b.h );
+        const FloatPosition C[4] = { b.p, FloatPosition{ b.p.x.v + W, b.p.y.v },
+                                     FloatPosition{ b.p.x.v + W, b.p.y.v + H },
+                                     FloatPosition{ b.p.x.v, b.p.y.v + H }
+                                   };
+        const unsigned long N = poly.numberOfEdges();
+
+        for ( unsigned long i = 0, j = N - 1; i < N; j = i++ )
+        {
+            const Segment E{ poly.getPoint( j ), poly.getPoint( i ) };
+
+            for ( int k = 0; k < 4; ++k )
+            {
+                if ( intersectSegment( Segment{ C[k], C[( k + 1 ) % 4] }, E ) )
+                    return true;
+            }
+        }
+
+        return poly.contains( C[0] ) || collisionPointBox( poly.getPoint( 0 ), b );
+    };
+
+    std::vector<FloatingBox> boxes;
+
+    for ( unsigned int i = 0; i < NB_BOXES; ++i )
+    {
+        boxes.push_back( FloatingBox{ FloatPosition{ lx::Random::fxrand( 0.0f, 1.0f ) * 600.0f - 10.0f,
+                                                     lx::Random::fxrand( 0.0f, 1.0f ) * 650.0f - 10.0f },
+                                      static_cast<int>( lx::Random::xrand<unsigned int>( 1, 30 ) ),
+                                      static_cast<int>( lx::Random::xrand<unsigned int>( 1, 30 ) ) } );
+    }
+
+    unsigned int nb_hits = 0, nb_diff = 0;
+    uint32_t t = lx::Time::getTicks();
+
+    for ( const FloatingBox& b : boxes )
+    {
+        nb_hits += collisionBoxPoly( b, star ) ? 1 : 0;
+        nb_hits += collisionBoxPoly( b, ground ) ? 1 : 0;
+    }
+
+    lx::Log::log( "%u box/polygon tests in %u ms", 2 * NB_BOXES, lx::Time::getTicks() - t );
+
+    for ( const FloatingBox& b : boxes )
+    {
+        nb_diff += collisionBoxPoly( b, star ) != reference( b, star ) ? 1 : 0;
+        nb_diff += collisionBoxPoly( b, ground ) != reference( b, ground ) ? 1 : 0;
+    }
+
+    if ( nb_diff == 0 )
+        lx::Log::log( "SUCCESS - %u collisions, same result as the edges", nb_hits );
+    else
+        lx::Log::log( "FAILURE - %u differences with the edges", nb_diff );
+
+    // Circles and concave polygons
+    const Circle CIN{ FloatPosition{ 300.0f, 300.0f }, 5 };
+    const Circle CSPIKE{ FloatPosition{ 545.0f, 300.0f }, 3 };
+    const Circle COUT{ FloatPosition{ 300.0f, 20.0f }, 10 };
+
+    if ( collisionCirclePoly( CIN, star ) && collisionCirclePoly( CSPIKE, star )
+            && !collisionCirclePoly( COUT, star ) && collisionCirclePoly( CIN, ground ) == false )
+        lx::Log::log( "SUCCESS - circle and concave polygon" );
+    else
+        lx::Log::log( "FAILURE - circle and concave polygon" );
+
+    // Two concave polygons
+    Polygon small_star;
+
+    for ( unsigned int i = 0; i < 10; ++i )
+    {
+        const float A = 2.0f * PI * static_cast<float>( i ) / 10.0f;
+        const float R = ( i % 2 == 0 ) ? 30.0f : 10.0f;
+        small_star.addPoint( FloatPosition{ R * std::cos( A ), R * std::sin( A ) } );
+    }
+
+    small_star.moveTo( FloatPosition{ 300.0f, 300.0f } );
+    const bool INSIDE = collisionPoly( star, small_star );
+    small_star.moveTo( FloatPosition{ 300.0f, 10.0f } );
+    const bool OUTSIDE = collisionPoly( star, small_star );
+    small_star.moveTo( FloatPosition{ 300.0f, 380.0f } );
+    const bool GROUND = collisionPoly( small_star, ground );
+
+    t = lx::Time::getTicks();
+
+    for ( int i = 0; i < 10000; ++i )
+        collisionPoly( star, ground );
+
+    lx::Log::log( "10000 tests between the star and the ground in %u ms", lx::Time::getTicks() - t );
+
+    if ( INSIDE && !OUTSIDE && GROUND && collisionPoly( star, ground ) )
+        lx::Log::log( "SUCCESS - two concave polygons" );
+    else
+        lx::Log::log( "FAILURE - two concave polygons" );
+
+    // Adding a point updates the decomposition
+    Polygon l;
+    l.addPoint( FloatPosition{ 0.0f, 0.0f } );
+    l.addPoint( FloatPosition{ 20.0f, 0.0f } );
+    l.addPoint( FloatPosition{ 20.0f, 20.0f } );
+
+    const unsigned long TRIANGLE = l.numberOfConvexParts();
+    l.addPoint( FloatPosition{ 10.0f, 10.0f } );
+    l.addPoint( FloatPosition{ 0.0f, 20.0f } );
+
+    if ( TRIANGLE == 1 && l.numberOfConvexParts() == 2 )
+        lx::Log::log( "SUCCESS - the decomposition is updated" );
+    else
+        lx::Log::log( "FAILURE - the decomposition is updated: %lu, %lu", TRIANGLE, l.numberOfConvexParts() );
+
+    try
+    {
+        l.getConvexPart( 2 );
+        lx::Log::log( "FAILURE - out of range" );
+    }
+    catch ( const std::out_of_range& )
+    {
+        lx::Log::log( "SUCCESS - out of range" );
+    }
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_sweep( void )
+{
+    lx::Log::log( " = TEST sweep = " );
+
+    auto near = []( const float x, const float y )
+    {
+        return std::abs( x - y ) < 0.001f;
+    };
+
+    // A bullet and a thin wall
+    FloatingBox bullet{ FloatPosition{ 0.0f, 10.0f }, 2, 2 };
+    const FloatingBox WALL{ FloatPosition{ 50.0f, 0.0f }, 1, 100 };
+    const Vector2D V{ 100.0f, 0.0f };
+    TimeOfImpact toi;
+
+    if ( sweepBox( bullet, V, WALL, toi ) && near( toi.time, 0.48f )
+            && toi.normal == Vector2D{ -1.0f, 0.0f } )
+        lx::Log::log( "SUCCESS - the bullet hits the wall at %f", toi.time );
+    else
+        lx::Log::log( "FAILURE - the bullet does not hit the wall" );
+
+    moveBox( bullet, V );
+
+    if ( !collisionBox( bullet, WALL ) )
+        lx::Log::log( "SUCCESS - without the sweep, the bullet goes through the wall" );
+    else
+        lx::Log::log( "FAILURE - without the sweep, the bullet goes through the wall" );
+
+    const FloatingBox ABOVE{ FloatPosition{ 0.0f, -10.0f }, 2, 2 };
+    const FloatingBox INSIDE{ FloatPosition{ 49.0f, 50.0f }, 2, 2 };
+    const FloatingBox CORNER{ FloatPosition{ 46.0f, 98.0f }, 2, 2 };
+
+    if ( !sweepBox( ABOVE, V, WALL, toi ) && sweepBox( INSIDE, V, WALL, toi ) && toi.time == 0.0f
+            && !sweepBox( CORNER, Vector2D{ 4.0f, 4.0f }, WALL, toi ) )
+        lx::Log::log( "SUCCESS - box: no impact, overlap and corner" );
+    else
+        lx::Log::log( "FAILURE - box: no impact, overlap and corner" );
+
+    // Circles
+    const Circle C{ FloatPosition{ 0.0f, 10.0f }, 5 };
+    const Circle TARGET{ FloatPosition{ 50.0f, 10.0f }, 5 };
+
+    if ( sweepCircle( C, V, TARGET, toi ) && near( toi.time, 0.4f )
+            && near( toi.normal.vx.v, -1.0f ) && near( toi.normal.vy.v, 0.0f ) )
+        lx::Log::log( "SUCCESS - circle/circle at %f", toi.time );
+    else
+        lx::Log::log( "FAILURE - circle/circle" );
+
+    if ( !sweepCircle( C, Vector2D{ 0.0f, 100.0f }, TARGET, toi )
+            && sweepCircleBox( C, V, WALL, toi ) && near( toi.time, 0.45f )
+            && near( toi.normal.vx.v, -1.0f ) )
+        lx::Log::log( "SUCCESS - circle/box at %f", toi.time );
+    else
+        lx::Log::log( "FAILURE - circle/box" );
+
+    // Circle and polygon: compare with 256 steps
+    const float PI = 3.14159265f;
+    Polygon star;
+
+    for ( unsigned int i = 0; i < 16; ++i )
+    {
+        const float A = 2.0f * PI * static_cast<float>( i ) / 16.0f;
+        const float R = ( i % 2 == 0 ) ? 100.0f : 30.0f;
+        star.addPoint( FloatPosition{ 300.0f + R * std::cos( A ), 300.0f + R * std::sin( A ) } );
+    }
+
+    const int NB_STEPS = 256;
+    unsigned int nb_hits = 0, nb_diff = 0;
+
+    for ( int n = 0; n < 2000; ++n )
+    {
+        const Circle CIRCLE{ FloatPosition{ lx::Random::fxrand( 0.0f, 1.0f ) * 600.0f,
+                                            lx::Random::fxrand( 0.0f, 1.0f ) * 600.0f },
+                             lx::Random::xrand<unsigned int>( 1, 8 ) };
+        const Vector2D MOVE{ lx::Random::fxrand( 0.0f, 1.0f ) * 600.0f - 300.0f,
+                             lx::Random::fxrand( 0.0f, 1.0f ) * 600.0f - 300.0f };
+        const bool HIT = sweepCirclePoly( CIRCLE, MOVE, star, toi );
+        int first = -1;
+
+        for ( int i = 0; i <= NB_STEPS && first == -1; ++i )
+        {
+            Circle c = CIRCLE;
+            const float T = static_cast<float>( i ) / static_cast<float>( NB_STEPS );
+            moveCircle( c, MOVE * T );
+
+            if ( collisionCirclePoly( c, star ) )
+                first = i;
+        }
+
+        nb_hits += HIT ? 1 : 0;
+
+        // The sweep finds every collision, not after the first step that collides
+        if ( first != -1 && ( !HIT || toi.time > static_cast<float>( first ) / NB_STEPS + 0.001f ) )
+            ++nb_diff;
+
+        // At the time of impact, the circle touches the polygon
+        if ( HIT )
+        {
+            Circle c{ CIRCLE.center, CIRCLE.radius + 1 };
+            moveCircle( c, MOVE * toi.time );
+            nb_diff += collisionCirclePoly( c, star ) ? 0 : 1;
+        }
+    }
+
+    if ( nb_diff == 0 )
+        lx::Log::log( "SUCCESS - circle/polygon: %u impacts", nb_hits );
+    else
+        lx::Log::log( "FAILURE - circle/polygon: %u differences with the steps", nb_diff );
+
+    try
+    {
+        sweepCirclePoly( C, V, Polygon(), toi );
+        lx::Log::log( "FAILURE - empty polygon" );
+    }
+    catch ( const std::invalid_argument& )
+    {
+        lx::Log::log( "SUCCESS - empty polygon" );
+    }
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_collisionBatch( void )
+{
+    lx::Log::log( " = TEST collision batch = " );
+
+    const unsigned int NB_BULLETS = 10003;   // not a multiple of 64
+    BoxArray boxes;
+    CircleArray circles;
+
+    for ( unsigned int i = 0; i < NB_BULLETS; ++i )
+    {
+        const FloatPosition P{ lx::Random::fxrand( 0.0f, 1.0f ) * 800.0f,
+                               lx::Random::fxrand( 0.0f, 1.0f ) * 600.0f };
+        boxes.push( FloatingBox{ P, static_cast<int>( lx::Random::xrand<unsigned int>( 1, 16 ) ),
+                                 static_cast<int>( lx::Random::xrand<unsigned int>( 1, 16 ) ) } );
+        circles.push( Circle{ P, lx::Random::xrand<unsigned int>( 1, 16 ) } );
+    }
+
+    const FloatingBox PLAYER{ FloatPosition{ 380.5f, 280.25f }, 40, 40 };
+    const Circle CPLAYER{ FloatPosition{ 400.5f, 300.25f }, 20 };
+    const FloatPosition POINT{ 400.5f, 300.25f };
+    std::vector<uint64_t> mask;
+
+    auto bit = [&mask]( const size_t i )
+    {
+        return ( ( mask[i / 64] >> ( i % 64 ) ) & 1 ) == 1;
+    };
+
+    // Same result as the functions of Physics.hpp
+    unsigned int nb_diff = 0;
+    size_t count = collisionBoxBatch( PLAYER, boxes, mask );
+    size_t expected = 0;
+
+    for ( unsigned int i = 0; i < NB_BULLETS; ++i )
+    {
+        const bool HIT = collisionBox( PLAYER, boxes.get( i ) );
+        expected += HIT ? 1 : 0;
+        nb_diff += HIT != bit( i ) ? 1 : 0;
+    }
+
+    nb_diff += count != expected ? 1 : 0;
+    count = collisionCircleBatch( CPLAYER, circles, mask );
+
+    for ( unsigned int i = 0; i < NB_BULLETS; ++i )
+        nb_diff += collisionCircle( CPLAYER, circles.get( i ) ) != bit( i ) ? 1 : 0;
+
+    collisionCircleBoxBatch( CPLAYER, boxes, mask );
+
+    for ( unsigned int i = 0; i < NB_BULLETS; ++i )
+        nb_diff += collisionCircleBox( CPLAYER, boxes.get( i ) ) != bit( i ) ? 1 : 0;
+
+    collisionPointBoxBatch( POINT, boxes, mask );
+
+    for ( unsigned int i = 0; i < NB_BULLETS; ++i )
+        nb_diff += collisionPointBox( POINT, boxes.get( i ) ) != bit( i ) ? 1 : 0;
+
+    collisionPointCircleBatch( POINT, circles, mask );
+
+    for ( unsigned int i = 0; i < NB_BULLETS; ++i )
+        nb_diff += collisionPointCircle( POINT, circles.get( i ) ) != bit( i ) ? 1 : 0;
+
+    if ( nb_diff == 0 && mask.size() == ( NB_BULLETS + 63 ) / 64 )
+        lx::Log::log( "SUCCESS - same result as the single tests, %lu circles hit",
+                      static_cast<unsigned long>( count ) );
+    else
+        lx::Log::log( "FAILURE - %u differences with the single tests", nb_diff );
+
+    // Edges: the boxes do not collide, the circles do
+    BoxArray edge;
+    CircleArray cedge;
+    edge.push( FloatingBox{ FloatPosition{ 420.5f, 280.25f }, 10, 10 } );
+    cedge.push( Circle{ FloatPosition{ 440.5f, 300.25f }, 20 } );
+
+    if ( collisionBoxBatch( PLAYER, edge, mask ) == 0
+            && collisionCircleBatch( CPLAYER, cedge, mask ) == 1 && mask[0] == 1 )
+        lx::Log::log( "SUCCESS - edges" );
+    else
+        lx::Log::log( "FAILURE - edges" );
+
+    // Timing
+    const int NB_FRAMES = 1000;
+    uint32_t t = lx::Time::getTicks();
+
+    for ( int i = 0; i < NB_FRAMES; ++i )
+        count = collisionCircleBatch( CPLAYER, circles, mask );
+
+    const uint32_t T_BATCH = lx::Time::getTicks() - t;
+    t = lx::Time::getTicks();
+    expected = 0;
+
+    for ( int i = 0; i < NB_FRAMES; ++i )
+    {
+        for ( unsigned int j = 0; j < NB_BULLETS; ++j )
+            expected += collisionCircle( CPLAYER, circles.get( j ) ) ? 1 : 0;
+    }
+
+    lx::Log::log( "%d × %u circles: %u ms (batch), %u ms (one by one)",
+                  NB_FRAMES, NB_BULLETS, T_BATCH, lx::Time::getTicks() - t );
+
+    if ( expected == count * NB_FRAMES )
+        lx::Log::log( "SUCCESS - %lu collisions per frame", static_cast<unsigned long>( count ) );
+    else
+        lx::Log::log( "FAILURE - %lu collisions per frame", static_cast<unsigned long>( count ) );
+
+    BoxArray empty;
+
+    if ( collisionBoxBatch( PLAYER, empty, mask ) == 0 && mask.empty() )
+        lx::Log::log( "SUCCESS - empty batch" );
+    else
+        lx::Log::log( "FAILURE - empty batch" );
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_raycast( void )
+{
+    lx::Log::log( " = TEST raycast = " );
+
+    auto near = []( const float x, const float y )
+    {
+        return std::abs( x - y ) < 0.001f;
+    };
+
+    RayHit hit;
+    const Segment S{ FloatPosition{ 0.0f, 10.0f }, FloatPosition{ 100.0f, 10.0f } };
+    const FloatingBox BOX{ FloatPosition{ 40.0f, 0.0f }, 10, 20 };
+    const Circle CIRCLE{ FloatPosition{ 60.0f, 10.0f }, 5 };
+
+    if ( raycastBox( S, BOX, hit ) && near( hit.fraction, 0.4f ) && near( hit.point.x.v, 40.0f )
+            && hit.normal == Vector2D{ -1.0f, 0.0f } )
+        lx::Log::log( "SUCCESS - segment/box" );
+    else
+        lx::Log::log( "FAILURE - segment/box" );
+
+    if ( raycastCircle( S, CIRCLE, hit ) && near( hit.fraction, 0.55f )
+            && near( hit.normal.vx.v, -1.0f ) && near( hit.normal.vy.v, 0.0f ) )
+        lx::Log::log( "SUCCESS - segment/circle" );
+    else
+        lx::Log::log( "FAILURE - segment/circle" );
+
+    // The origin is in the shape
+    const Segment INSIDE{ FloatPosition{ 45.0f, 10.0f }, FloatPosition{ 100.0f, 10.0f } };
+
+    if ( !raycastBox( INSIDE, BOX, hit ) && raycastCircle( INSIDE, CIRCLE, hit ) )
+        lx::Log::log( "SUCCESS - the origin is in the box" );
+    else
+        lx::Log::log( "FAILURE - the origin is in the box" );
+
+    // A U-shaped polygon: the segment goes out of it, then enters it again
+    Polygon u;
+    u.addPoint( FloatPosition{ 0.0f, 0.0f } );
+    u.addPoint( FloatPosition{ 10.0f, 0.0f } );
+    u.addPoint( FloatPosition{ 10.0f, 30.0f } );
+    u.addPoint( FloatPosition{ 30.0f, 30.0f } );
+    u.addPoint( FloatPosition{ 30.0f, 0.0f } );
+    u.addPoint( FloatPosition{ 40.0f, 0.0f } );
+    u.addPoint( FloatPosition{ 40.0f, 40.0f } );
+    u.addPoint( FloatPosition{ 0.0f, 40.0f } );
+
+    const Segment ACROSS{ FloatPosition{ 5.0f, 10.0f }, FloatPosition{ 45.0f, 10.0f } };
+    const Segment ABOVE{ FloatPosition{ 20.0f, -10.0f }, FloatPosition{ 20.0f, 50.0f } };
+
+    if ( raycastPoly( ACROSS, u, hit ) && near( hit.point.x.v, 30.0f )
+            && near( hit.normal.vx.v, -1.0f ) && raycastPoly( ABOVE, u, hit )
+            && near( hit.point.y.v, 30.0f ) && near( hit.normal.vy.v, -1.0f ) )
+        lx::Log::log( "SUCCESS - segment/polygon" );
+    else
+        lx::Log::log( "FAILURE - segment/polygon: (%f, %f)", hit.point.x.v, hit.point.y.v );
+
+    // A world of obstacles, against every shape one by one
+    CollisionWorld world( 32.0f );
+    std::vector<FloatingBox> boxes;
+    std::vector<Circle> circles;
+    std::vector<Polygon> polygons( 20 );
+    std::vector<ProxyID> ids;
+
+    for ( int i = 0; i < 300; ++i )
+    {
+        const FloatPosition P{ lx::Random::fxrand( 0.0f, 1.0f ) * 2000.0f,
+                               lx::Random::fxrand( 0.0f, 1.0f ) * 2000.0f };
+        boxes.push_back( FloatingBox{ P, static_cast<int>( lx::Random::xrand<unsigned int>( 4, 40 ) ),
+                                      static_cast<int>( lx::Random::xrand<unsigned int>( 4, 40 ) ) } );
+        circles.push_back( Circle{ FloatPosition{ P.x.v + 1000.0f, P.y.v },
+                                   lx::Random::xrand<unsigned int>( 2, 20 ) } );
+    }
+
+    for ( unsigned int i = 0; i < polygons.size(); ++i )
+    {
+        const float X = lx::Random::fxrand( 0.0f, 1.0f ) * 2000.0f;
+        const float Y = lx::Random::fxrand( 0.0f, 1.0f ) * 2000.0f;
+
+        for ( unsigned int k = 0; k < 12; ++k )
+        {
+            const float A = 2.0f * 3.14159265f * static_cast<float>( k ) / 12.0f;
+            const float R = ( k % 2 == 0 ) ? 120.0f : 50.0f;
+            polygons[i].addPoint( FloatPosition{ X + R * std::cos( A ), Y + R * std::sin( A ) } );
+        }
+    }
+
+    for ( const FloatingBox& b : boxes )
+        ids.push_back( world.addBox( b ) );
+
+    for ( const Circle& c : circles )
+        ids.push_back( world.addCircle( c ) );
+
+    for ( const Polygon& p : polygons )
+        ids.push_back( world.addPolygon( p ) );
+
+    auto brute = [&]( const Segment & s, RayHit & best )
+    {
+        ProxyID found = NULL_PROXY;
+        best.fraction = 2.0f;
+        RayHit h;
+        size_t k = 0;
+
+        for ( const FloatingBox& b : boxes )
+        {
+            if ( raycastBox( s, b, h ) && h.fraction < best.fraction )
+            {
+                best = h;
+                found = ids[k];
+            }
+
+            ++k;
+        }
+
+        for ( const Circle& c : circles )
+        {
+            if ( raycastCircle( s, c, h ) && h.fraction < best.fraction )
+            {
+                best = h;
+                found = ids[k];
+            }
+
+            ++k;
+        }
+
+        for ( const Polygon& p : polygons )
+        {
+            if ( raycastPoly( s, p, h ) && h.fraction < best.fraction )
+            {
+                best = h;
+                found = ids[k];
+            }
+
+            ++k;
+        }
+
+        return found;
+    };
+
+    // Hundreds of agents look at random points
+    const int NB_RAYS = 5000;
+    std::vector<Segment> rays;
+
+    for ( int i = 0; i < NB_RAYS; ++i )
+    {
+        const FloatPosition P{ lx::Random::fxrand( 0.0f, 1.0f ) * 2000.0f,
+                               lx::Random::fxrand( 0.0f, 1.0f ) * 2000.0f };
+        const FloatPosition Q{ P.x.v + lx::Random::fxrand( 0.0f, 1.0f ) * 600.0f - 300.0f,
+                               P.y.v + lx::Random::fxrand( 0.0f, 1.0f ) * 600.0f - 300.0f };
+        rays.push_back( Segment{ P, Q } );
+    }
+
+    unsigned int nb_hits = 0, nb_brute = 0, nb_diff = 0;
+    uint32_t t = lx::Time::getTicks();
+
+    for ( const Segment& s : rays )
+        nb_hits += world.segmentCast( s, hit ) != NULL_PROXY ? 1 : 0;
+
+    const uint32_t T_WORLD = lx::Time::getTicks() - t;
+    t = lx::Time::getTicks();
+
+    for ( const Segment& s : rays )
+    {
+        RayHit h;
+        nb_brute += brute( s, h ) != NULL_PROXY ? 1 : 0;
+    }
+
+    lx::Log::log( "%d segments: %u ms (world), %u ms (every shape)", NB_RAYS, T_WORLD,
+                  lx::Time::getTicks() - t );
+
+    for ( const Segment& s : rays )
+    {
+        RayHit h;
+        const ProxyID B = brute( s, h );
+        const ProxyID W = world.segmentCast( s, hit );
+        nb_diff += ( B != W || ( W != NULL_PROXY && hit.fraction != h.fraction ) ) ? 1 : 0;
+    }
+
+    if ( nb_diff == 0 && nb_hits == nb_brute )
+        lx::Log::log( "SUCCESS - %u segments hit a shape, same result as every shape", nb_hits );
+    else
+        lx::Log::log( "FAILURE - %u differences with every shape", nb_diff );
+
+    // A ray
+    CollisionWorld w2( 16.0f );
+    const ProxyID WALL = w2.addBox( FloatingBox{ FloatPosition{ 100.0f, -50.0f }, 4, 100 } );
+    const ProxyID ID = w2.rayCast( FloatPosition{ 0.0f, 0.0f }, Vector2D{ 2.0f, 0.0f }, 200.0f, hit );
+
+    if ( ID == WALL && near( hit.fraction * 200.0f, 100.0f )
+            && w2.rayCast( FloatPosition{ 0.0f, 0.0f }, Vector2D{ 2.0f, 0.0f }, 50.0f, hit ) == NULL_PROXY
+            && w2.rayCast( FloatPosition{ 0.0f, 0.0f }, Vector2D{ 0.0f, 0.0f }, 200.0f, hit ) == NULL_PROXY )
+        lx::Log::log( "SUCCESS - ray" );
+    else
+        lx::Log::log( "FAILURE - ray" );
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_physicsWorld( void )
+{
+    lx::Log::log( " = TEST physics world = " );
+
+    const float H = 1.0f / 60.0f;
+
+    auto near = []( const float x, const float y, const float tolerance )
+    {
+        return std::abs( x - y ) < tolerance;
+    };
+
+    try
+    {
+        PhysicsWorld bad( 0.0f );
+        lx::Log::log( "FAILURE - invalid time step" );
+    }
+    catch ( const std::invalid_argument& )
+    {
+        lx::Log::log( "SUCCESS - invalid time step" );
+    }
+
+    // Fixed steps
+    {
+        PhysicsWorld world( H );
+
+        const unsigned int N1 = world.step( 0.11f );
+        const float ALPHA = world.getAlpha();
+        const unsigned int N2 = world.step( 2.0f );
+
+        if ( N1 == 6 && near( ALPHA, 0.6f, 0.01f ) && N2 == 8 && world.getAlpha() < 1.0f
+                && world.step( 0.0f ) == 0 )
+            lx::Log::log( "SUCCESS - fixed steps: %u, alpha: %f", N1, ALPHA );
+        else
+            lx::Log::log( "FAILURE - fixed steps: %u, alpha: %f, %u", N1, ALPHA, N2 );
+    }
+
+    // A box falls on the ground, and falls asleep
+    PhysicsWorld world( H );
+    world.setGravity( Vector2D{ 0.0f, 600.0f } );
+
+    int data = 42;
+    const BodyID GROUND = world.addBox( FloatingBox{ FloatPosition{ 0.0f, 400.0f }, 800, 20 }, 0.0f );
+    const BodyID BOX = world.addBox( FloatingBox{ FloatPosition{ 100.0f, 300.0f }, 20, 20 }, 1.0f, &data );
+
+    if ( world.size() == 2 && world.numberOfAwakeBodies() == 1 && !world.isAwake( GROUND )
+            && world.getUserData( BOX ) == &data )
+        lx::Log::log( "SUCCESS - bodies" );
+    else
+        lx::Log::log( "FAILURE - bodies" );
+
+    for ( int i = 0; i < 180; ++i )
+        world.step( H );
+
+    FloatingBox b = world.getBox( BOX );
+
+    if ( near( b.p.y.v + 20.0f, 400.0f, 1.0f ) && near( b.p.x.v, 100.0f, 0.01f ) && !world.isAwake( BOX )
+            && world.numberOfAwakeBodies() == 0 )
+        lx::Log::log( "SUCCESS - the box rests on the ground, asleep" );
+    else
+        lx::Log::log( "FAILURE - the box: (%f, %f), awake: %d", b.p.x.v, b.p.y.v, world.isAwake( BOX ) );
+
+    // The ground disappears
+    world.remove( GROUND );
+
+    if ( world.isAwake( BOX ) && !world.remove( GROUND ) && world.size() == 1 )
+        lx::Log::log( "SUCCESS - remove wakes the neighbours" );
+    else
+        lx::Log::log( "FAILURE - remove wakes the neighbours" );
+
+    for ( int i = 0; i < 30; ++i )
+        world.step( H );
+
+    if ( world.getBox( BOX ).p.y.v > b.p.y.v + 50.0f && world.getVelocity( BOX ).vy.v > 0.0f )
+        lx::Log::log( "SUCCESS - the box falls" );
+    else
+        lx::Log::log( "FAILURE - the box falls: %f", world.getBox( BOX ).p.y.v );
+
+    // A ball bounces on a wall
+    {
+        PhysicsWorld w( H );
+        w.addBox( FloatingBox{ FloatPosition{ 200.0f, 0.0f }, 20, 200 }, 0.0f );
+        const BodyID BALL = w.addCircle( Circle{ FloatPosition{ 100.0f, 100.0f }, 10 }, 1.0f );
+        w.setMaterial( BALL, 1.0f, 0.0f );
+        w.setVelocity( BALL, Vector2D{ 200.0f, 0.0f } );
+
+        for ( int i = 0; i < 60; ++i )
+            w.step( H );
+
+        const Vector2D V = w.getVelocity( BALL );
+        const Circle C = w.getCircle( BALL );
+
+        if ( near( V.vx.v, -200.0f, 1.0f ) && near( V.vy.v, 0.0f, 0.01f ) && C.center.x.v < 190.0f
+                && C.radius == 10 )
+            lx::Log::log( "SUCCESS - bounce: (%f, %f)", V.vx.v, V.vy.v );
+        else
+            lx::Log::log( "FAILURE - bounce: (%f, %f), x: %f", V.vx.v, V.vy.v, C.center.x.v );
+    }
+
+    // A stack of boxes
+    {
+        PhysicsWorld w( H );
+        w.setGravity( Vector2D{ 0.0f, 600.0f } );
+        w.addBox( FloatingBox{ FloatPosition{ 0.0f, 400.0f }, 800, 20 }, 0.0f );
+        BodyID stack[5];
+
+        for ( int i = 0; i < 5; ++i )
+            stack[i] = w.addBox( FloatingBox{ FloatPosition{ 100.0f, 378.0f - 22.0f * i }, 20, 20 }, 1.0f );
+
+        for ( int i = 0; i < 300; ++i )
+            w.step( H );
+
+        const FloatingBox TOP = w.getBox( stack[4] );
+
+        if ( w.numberOfAwakeBodies() == 0 && near( TOP.p.y.v, 300.0f, 4.0f ) && near( TOP.p.x.v, 100.0f, 1.0f ) )
+            lx::Log::log( "SUCCESS - stack of boxes, asleep" );
+        else
+            lx::Log::log( "FAILURE - stack of boxes: %lu awake, top: (%f, %f)",
+                          static_cast<unsigned long>( w.numberOfAwakeBodies() ), TOP.p.x.v, TOP.p.y.v );
+
+        // Hit the bottom of the stack, the whole island wakes up
+        w.applyImpulse( stack[0], Vector2D{ 100.0f, 0.0f } );
+        w.step( H );
+
+        if ( w.numberOfAwakeBodies() == 5 )
+            lx::Log::log( "SUCCESS - the island wakes up" );
+        else
+            lx::Log::log( "FAILURE - the island wakes up: %lu",
+                          static_cast<unsigned long>( w.numberOfAwakeBodies() ) );
+
+        // The stack falls asleep again, then the gravity is reversed
+        for ( int i = 0; i < 300; ++i )
+            w.step( H );
+
+        const size_t NB_ASLEEP = w.numberOfAwakeBodies();
+        w.setGravity( Vector2D{ 0.0f, -600.0f } );
+        const size_t NB_AWAKE = w.numberOfAwakeBodies();
+
+        for ( int i = 0; i < 30; ++i )
+            w.step( H );
+
+        if ( NB_ASLEEP == 0 && NB_AWAKE == 5 && w.getBox( stack[4] ).p.y.v < TOP.p.y.v - 20.0f )
+            lx::Log::log( "SUCCESS - setGravity wakes the bodies up" );
+        else
+            lx::Log::log( "FAILURE - setGravity wakes the bodies up: %lu, %lu awake, top: %f",
+                          static_cast<unsigned long>( NB_ASLEEP ), static_cast<unsigned long>( NB_AWAKE ),
+                          w.getBox( stack[4] ).p.y.v );
+    }
+
+    // Many idle bodies
+    {
+        const unsigned int NB_ROWS = 100;
+        const unsigned int NB_COLUMNS = 100;
+        PhysicsWorld w( H );
+        w.setGravity( Vector2D{ 0.0f, 600.0f } );
+        std::vector<BodyID> ids;
+
+        for ( unsigned int r = 0; r < NB_ROWS; ++r )
+        {
+            const float Y = 40.0f * r;
+            w.addBox( FloatingBox{ FloatPosition{ 0.0f, Y + 10.0f }, 2000, 10 }, 0.0f );
+
+            for ( unsigned int c = 0; c < NB_COLUMNS; ++c )
+            {
+                const FloatPosition P{ 20.0f * c, Y };
+
+                if ( c % 2 == 0 )
+                    ids.push_back( w.addBox( FloatingBox{ P, 10, 10 }, 1.0f ) );
+                else
+                    ids.push_back( w.addCircle( Circle{ FloatPosition{ P.x.v + 5.0f, P.y.v + 5.0f }, 5 }, 1.0f ) );
+            }
+        }
+
+        unsigned int t = lx::Time::getTicks();
+
+        for ( int i = 0; i < 60; ++i )
+            w.step( H );
+
+        lx::Log::log( "%lu bodies, settle in %u ms", static_cast<unsigned long>( w.size() ),
+                      lx::Time::getTicks() - t );
+
+        const size_t NB_SETTLED = w.numberOfAwakeBodies();
+
+        for ( unsigned int i = 0; i < 10; ++i )
+            w.applyImpulse( ids[i * 997], Vector2D{ 0.0f, -200.0f } );
+
+        t = lx::Time::getTicks();
+
+        for ( int i = 0; i < 60; ++i )
+            w.step( H );
+
+        const unsigned int T = lx::Time::getTicks() - t;
+        const size_t NB_AWAKE = w.numberOfAwakeBodies();
+
+        if ( NB_SETTLED == 0 && NB_AWAKE <= 30 )
+            lx::Log::log( "SUCCESS - %lu bodies awake, 60 steps in %u ms",
+                          static_cast<unsigned long>( NB_AWAKE ), T );
+        else
+            lx::Log::log( "FAILURE - %lu bodies awake after settling, %lu after the impulses",
+                          static_cast<unsigned long>( NB_SETTLED ), static_cast<unsigned long>( NB_AWAKE ) );
+    }
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_collisionMask( void )
+{
+    lx::Log::log( " = TEST collision mask = " );
+
+    auto rnd = []( const unsigned int n )
+    {
+        return lx::Random::xrand<unsigned int>( 0, n );
+    };
+
+    // A random blob
+    auto blob = [&rnd]( const int w, const int h, const int scale )
+    {
+        CollisionMask m( w, h, scale );
+
+        for ( int y = 0; y < h; ++y )
+        {
+            for ( int x = 0; x < w; ++x )
+            {
+                const int DX = 2 * x - w, DY = 2 * y - h;
+
+                if ( DX * DX + DY * DY < w * h && rnd( 4 ) != 0 )
+                    m.set( x, y, true );
+            }
+        }
+
+        return m;
+    };
+
+    auto cell = []( const CollisionMask& m, const FloatPosition& p, const int i, const int j )
+    {
+        const int S = m.getScale();
+        return FloatingBox{ FloatPosition{ p.x.v + static_cast<float>( i * S ), p.y.v + static_cast<float>( j * S ) },
+                            S, S };
+    };
+
+    // Every solid pixel against every solid pixel
+    auto bruteMask = [&cell]( const CollisionMask& a, const FloatPosition& pa,
+                              const CollisionMask& b, const FloatPosition& pb )
+    {
+        for ( int j = 0; j < a.getHeight(); ++j )
+            for ( int i = 0; i < a.getWidth(); ++i )
+                for ( int l = 0; a.get( i, j ) && l < b.getHeight(); ++l )
+                    for ( int k = 0; k < b.getWidth(); ++k )
+                        if ( b.get( k, l ) && collisionBox( cell( a, pa, i, j ), cell( b, pb, k, l ) ) )
+                            return true;
+        return false;
+    };
+
+    auto bruteBox = [&cell]( const CollisionMask& a, const FloatPosition& pa, const FloatingBox& box )
+    {
+        for ( int j = 0; j < a.getHeight(); ++j )
+            for ( int i = 0; i < a.getWidth(); ++i )
+                if ( a.get( i, j ) && collisionBox( cell( a, pa, i, j ), box ) )
+                    return true;
+        return false;
+    };
+
+    CollisionMask empty;
+    CollisionMask m( 100, 3 );
+    m.set( 70, 1, true );
+    m.set( 99, 2, true );
+    m.set( 100, 2, true );      // Out of the mask
+    const FloatingBox BB = m.getBoundingBox( FloatPosition{ 10.0f, 10.0f } );
+
+    if ( m.count() == 2 && m.get( 70, 1 ) && !m.get( 71, 1 ) && !m.get( 100, 2 )
+            && BB.p.x.v == 80.0f && BB.p.y.v == 11.0f && BB.w == 30 && BB.h == 2
+            && !collisionMask( empty, FloatPosition{ 0.0f, 0.0f }, m, FloatPosition{ 0.0f, 0.0f } ) )
+        lx::Log::log( "SUCCESS - mask" );
+    else
+        lx::Log::log( "FAILURE - mask" );
+
+    m.set( 99, 2, false );
+    const FloatingBox BB2 = m.getBoundingBox( FloatPosition{ 0.0f, 0.0f } );
+    const CollisionMask D = m.downsample( 8 );
+
+    if ( BB2.w == 1 && BB2.h == 1 && D.getWidth() == 13 && D.getHeight() == 1 && D.getScale() == 8
+            && D.get( 8, 0 ) && D.count() == 1 )
+        lx::Log::log( "SUCCESS - downsampled mask" );
+    else
+        lx::Log::log( "FAILURE - downsampled mask" );
+
+    try
+    {
+        CollisionMask bad( -1, 4 );
+        lx::Log::log( "FAILURE - invalid mask" );
+    }
+    catch ( const std::invalid_argument& )
+    {
+        lx::Log::log( "SUCCESS - invalid mask" );
+    }
+
+    // Same results as every pixel against every pixel
+    const int NB_TESTS = 300;
+    int nb_diff = 0, nb_hits = 0;
+
+    for ( int t = 0; t < NB_TESTS; ++t )
+    {
+        const int SA = t % 3 == 0 ? 2 : 1;
+        const int SB = t % 5 == 0 ? 3 : SA;
+        const CollisionMask A = blob( 8 + static_cast<int>( rnd( 80 ) ), 4 + static_cast<int>( rnd( 20 ) ), SA );
+        const CollisionMask B = blob( 4 + static_cast<int>( rnd( 20 ) ), 4 + static_cast<int>( rnd( 20 ) ), SB );
+        // Aligned and unaligned positions
+        const float FRACTION = t % 2 == 0 ? 0.0f : 0.5f;
+        const FloatPosition PA{ static_cast<float>( rnd( 40 ) ), static_cast<float>( rnd( 40 ) ) };
+        const FloatPosition PB{ static_cast<float>( rnd( 120 ) ) + FRACTION,
+                                static_cast<float>( rnd( 60 ) ) + FRACTION };
+        const FloatingBox BOX{ FloatPosition{ static_cast<float>( rnd( 160 ) ) - FRACTION,
+                                              static_cast<float>( rnd( 80 ) ) },
+                               static_cast<int>( rnd( 10 ) ), static_cast<int>( rnd( 10 ) ) };
+
+        const bool HIT = collisionMask( A, PA, B, PB );
+        nb_hits += HIT ? 1 : 0;
+        nb_diff += HIT != bruteMask( A, PA, B, PB ) ? 1 : 0;
+        nb_diff += collisionMask( B, PB, A, PA ) != HIT ? 1 : 0;
+        nb_diff += collisionMaskBox( A, PA, BOX ) != bruteBox( A, PA, BOX ) ? 1 : 0;
+
+        // A downsampled mask does not miss a collision
+        nb_diff += HIT && !collisionMask( A.downsample( 4 ), PA, B, PB ) ? 1 : 0;
+    }
+
+    if ( nb_diff == 0 )
+        lx::Log::log( "SUCCESS - %d collisions out of %d, same result as every pixel", nb_hits, NB_TESTS );
+    else
+        lx::Log::log( "FAILURE - %d differences with every pixel", nb_diff );
+
+    // Big sprites, 1 pixel apart
+    CollisionMask ring( 256, 256 ), ring2( 256, 256 );
+
+    for ( int y = 0; y < 256; ++y )
+    {
+        for ( int x = 0; x < 256; ++x )
+        {
+            const int D2 = ( x - 128 ) * ( x - 128 ) + ( y - 128 ) * ( y - 128 );
+            ring.set( x, y, D2 < 128 * 128 && D2 >= 120 * 120 );
+            ring2.set( x, y, D2 < 128 * 128 && D2 >= 120 * 120 );
+        }
+    }
+
+    const FloatPosition P0{ 0.0f, 0.0f };
+    const FloatPosition P1{ 254.0f, 0.0f };
+    const FloatPosition P2{ 190.0f, 190.0f };
+    int n = 0;
+    const unsigned int T = lx::Time::getTicks();
+
+    for ( int i = 0; i < 10000; ++i )
+        n += collisionMask( ring, P0, ring2, P1 ) && !collisionMask( ring, P0, ring2, P2 ) ? 1 : 0;
+
+    lx::Log::log( "20000 tests of 256×256 masks in %u ms", lx::Time::getTicks() - T );
+
+    if ( n == 10000 )
+        lx::Log::log( "SUCCESS - big masks" );
+    else
+        lx::Log::log( "FAILURE - big masks: %d", n );
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_staticGeometry( void )
+{
+    lx::Log::log( " = TEST StaticGeometry = " );
+
+    const std::string FILENAME( "./static_geometry.lxsg" );
+    const unsigned int NB_POLYGONS = 400;
+    const unsigned int NB_SPIKES = 12;
+    const float PI = 3.14159265f;
+    std::vector<std::unique_ptr<Polygon>> polygons;
+    std::vector<const Polygon *> level;
+    std::vector<unsigned int> result;
+
+    // Concave stars on a grid
+    lx::Random::initRand();
+
+    for ( unsigned int i = 0; i < NB_POLYGONS; ++i )
+    {
+        const float CX = static_cast<float>( ( i % 20 ) * 50 + 25 );
+        const float CY = static_cast<float>( ( i / 20 ) * 50 + 25 );
+        std::vector<FloatPosition> points;
+
+        for ( unsigned int k = 0; k < 2 * NB_SPIKES; ++k )
+        {
+            const float A = PI * static_cast<float>( k ) / static_cast<float>( NB_SPIKES );
+            const float R = static_cast<float>( k % 2 == 0 ? lx::Random::xrand<unsigned int>( 18, 30 )
+                                                : lx::Random::xrand<unsigned int>( 6, 12 ) );
+            points.push_back( FloatPosition{ CX + R * std::cos( A ), CY + R * std::sin( A ) } );
+        }
+
+        polygons.emplace_back( new Polygon() );
+        polygons.back()->addPoints( points.begin(), points.end() );
+        level.push_back( polygons.back().get() );
+    }
+
+    uint32_t t = lx::Time::getTicks();
+    bakeStaticGeometry( level, FILENAME );
+    lx::Log::log( "bake: %u polygons in %u ms", NB_POLYGONS, lx::Time::getTicks() - t );
+
+    t = lx::Time::getTicks();
+    StaticGeometry geometry( FILENAME );
+    lx::Log::log( "load: %u convex parts in %u ms",
+                  static_cast<unsigned int>( geometry.numberOfConvexParts() ), lx::Time::getTicks() - t );
+
+    bool same = geometry.numberOfPolygons() == NB_POLYGONS;
+    unsigned long nb_parts = 0;
+
+    for ( unsigned int i = 0; same && i < NB_POLYGONS; ++i )
+    {
+        const FloatPosition * V = geometry.getVertices( i );
+        same = geometry.numberOfVertices( i ) == polygons[i]->numberOfEdges();
+        nb_parts += polygons[i]->numberOfConvexParts();
+
+        for ( unsigned long k = 0; same && k < geometry.numberOfVertices( i ); ++k )
+            same = V[k] == polygons[i]->getPoint( k );
+    }
+
+    same = same && nb_parts == geometry.numberOfConvexParts();
+    lx::Log::log( "%s - the polygons of the file", same ? "SUCCESS" : "FAILURE" );
+
+    // Brute force against the polygons
+    bool ok_point = true, ok_shape = true, ok_ray = true;
+
+    for ( unsigned int n = 0; n < 500; ++n )
+    {
+        const FloatPosition P{ static_cast<float>( lx::Random::xrand<unsigned int>( 0, 1000 ) ) + 0.37f,
+                               static_cast<float>( lx::Random::xrand<unsigned int>( 0, 1000 ) ) + 0.61f };
+        const Circle C{ P, lx::Random::xrand<unsigned int>( 1, 40 ) };
+        const FloatPosition Q{ static_cast<float>( lx::Random::xrand<unsigned int>( 0, 1000 ) ) + 0.13f,
+                               static_cast<float>( lx::Random::xrand<unsigned int>( 0, 1000 ) ) + 0.29f };
+        const Segment S{ P, Q };
+        std::vector<unsigned int> expected;
+
+        geometry.queryPoint( P, result );
+
+        for ( unsigned int i = 0; i < NB_POLYGONS; ++i )
+        {
+            if ( polygons[i]->contains( P ) )
+                expected.push_back( i );
+        }
+
+        ok_point = ok_point && result == expected;
+        expected.clear();
+        geometry.queryShape( C, result );
+
+        for ( unsigned int i = 0; i < NB_POLYGONS; ++i )
+        {
+            bool hit = false;
+
+            for ( unsigned long k = 0; !hit && k < polygons[i]->numberOfConvexParts(); ++k )
+                hit = collisionGJK( C, polygons[i]->getConvexPart( k ) );
+
+            if ( hit )
+                expected.push_back( i );
+        }
+
+        ok_shape = ok_shape && result == expected;
+
+        RayHit hit, h;
+        float best = 2.0f;
+        const unsigned int FIRST = geometry.segmentCast( S, hit );
+
+        for ( unsigned int i = 0; i < NB_POLYGONS; ++i )
+        {
+            if ( raycastPoly( S, *polygons[i], h ) )
+                best = std::min( best, h.fraction );
+        }
+
+        ok_ray = ok_ray && ( FIRST == NO_POLYGON ? best > 1.0f
+                             : std::abs( hit.fraction - best ) < 1e-6f && hit.fraction <= 1.0f );
+    }
+
+    lx::Log::log( "%s - queryPoint", ok_point ? "SUCCESS" : "FAILURE" );
+    lx::Log::log( "%s - queryShape", ok_shape ? "SUCCESS" : "FAILURE" );
+    lx::Log::log( "%s - segmentCast", ok_ray ? "SUCCESS" : "FAILURE" );
+
+    // Corrupted indices: header (32 bytes) | polygons (24 bytes each) | nodes (24 bytes each) | parts
+    std::vector<uint8_t> baked;
+    {
+        lx::FileIO::File f( FILENAME, lx::FileIO::FileMode::RDONLY );
+        baked.resize( static_cast<size_t>( f.size() ) );
+        f.read( baked.data(), sizeof( uint8_t ), baked.size() );
+    }
+
+    const size_t NODES = 32 + 24 * NB_POLYGONS;
+    uint32_t nb_nodes = 0;
+    std::memcpy( &nb_nodes, baked.data() + 28, sizeof( uint32_t ) );
+
+    const size_t PARTS = NODES + 24 * nb_nodes;
+    const struct
+    {
+        const char * what;
+        size_t offset;
+        uint32_t value;
+    } CORRUPTIONS[] =
+    {
+        { "cycle in the tree (right child of the root = root)", NODES + 16, 0 },
+        { "leaf out of the parts", NODES + 24 * ( nb_nodes - 1 ) + 16, 0xFFFFFFF0U },
+        { "polygon of a part out of range", PARTS, NB_POLYGONS },
+        { "vertices of a part out of range", PARTS + 4, 0xFFFFFFFFU },
+        { "vertices of a polygon out of range", 32 + 4, 0x7FFFFFFFU },
+    };
+
+    for ( const auto& C : CORRUPTIONS )
+    {
+        std::vector<uint8_t> corrupted( baked );
+        std::memcpy( corrupted.data() + C.offset, &C.value, sizeof( uint32_t ) );
+        {
+            lx::FileIO::File f( FILENAME, lx::FileIO::FileMode::WRONLY );
+            f.write( corrupted.data(), sizeof( uint8_t ), corrupted.size() );
+        }
+
+        try
+        {
+            StaticGeometry bad( FILENAME );
+            bad.queryPoint( FloatPosition{ 25.0f, 25.0f }, result );
+            lx::Log::log( "FAILURE - corrupted file loaded: %s", C.what );
+        }
+        catch ( lx::FileIO::IOException& e )
+        {
+            lx::Log::log( "SUCCESS - %s: %s", C.what, e.what() );
+        }
+    }
+
+    // Truncated file
+    {
+        lx::FileIO::File f( FILENAME, lx::FileIO::FileMode::WRONLY );
+        f.write( "LXSG", sizeof( char ), 4 );
+    }
+
+    try
+    {
+        StaticGeometry bad( FILENAME );
+        lx::Log::log( "FAILURE - truncated file loaded" );
+    }
+    catch ( lx::FileIO::IOException& e )
+    {
+        lx::Log::log( "SUCCESS - truncated file: %s", e.what() );
+    }
+
+    // Self-intersecting polygon
+    Polygon bow;
+    bow.addPoint( FloatPosition{ 0.0f, 0.0f } );
+    bow.addPoint( FloatPosition{ 10.0f, 10.0f } );
+    bow.addPoint( FloatPosition{ 10.0f, 0.0f } );
+    bow.addPoint( FloatPosition{ 0.0f, 10.0f } );
+
+    try
+    {
+        bakeStaticGeometry( std::vector<const Polygon *>{ &bow }, FILENAME );
+        lx::Log::log( "FAILURE - self-intersecting polygon baked" );
+    }
+    catch ( PolygonException& e )
+    {
+        lx::Log::log( "SUCCESS - self-intersecting polygon: %s", e.what() );
+    }
+
+    std::remove( FILENAME.c_str() );
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_collisionWorld( void )
+{
+    lx::Log::log( " = TEST CollisionWorld = " );
+
+    const unsigned int NB_HITBOXES = 200;
+    const unsigned int NB_BULLETS = 3000;
+    std::vector<ProxyID> ids;
+    std::vector<ProxyPair> pairs;
+    std::vector<ProxyID> result;
+    std::vector<FloatingBox> boxes;
+    std::vector<Circle> bullets;
+
+    lx::Random::initRand();
+    CollisionWorld world( 32.0f );
+    bullets.reserve( NB_BULLETS );
+
+    for ( unsigned int i = 0; i < NB_HITBOXES; ++i )
+    {
+        const float X = static_cast<float>( lx::Random::xrand<unsigned int>( 0, 1000 ) );
+        const float Y = static_cast<float>( lx::Random::xrand<unsigned int>( 0, 1000 ) );
+        boxes.push_back( FloatingBox{ FloatPosition{ X, Y },
+                                      static_cast<int>( lx::Random::xrand<unsigned int>( 8, 48 ) ),
+                                      static_cast<int>( lx::Random::xrand<unsigned int>( 8, 48 ) ) } );
+        ids.push_back( world.addBox( boxes.back() ) );
+    }
+
+    for ( unsigned int i = 0; i < NB_BULLETS; ++i )
+    {
+        const float X = static_cast<float>( lx::Random::xrand<unsigned int>( 0, 1000 ) );
+        const float Y = static_cast<float>( lx::Random::xrand<unsigned int>( 0, 1000 ) );
+        bullets.push_back( Circle{ FloatPosition{ X, Y }, lx::Random::xrand<unsigned int>( 2, 6 ) } );
+        ids.push_back( world.addCircle( bullets.back(), &bullets.back() ) );
+    }
+
+    if ( world.size() == NB_HITBOXES + NB_BULLETS )
+        lx::Log::log( "SUCCESS - %u proxies", static_cast<unsigned int>( world.size() ) );
+    else
+        lx::Log::log( "FAILURE - expected %u proxies, got %u", NB_HITBOXES + NB_BULLETS,
+                      static_cast<unsigned int>( world.size() ) );
+
+    if ( world.getUserData( ids[NB_HITBOXES] ) == &bullets[0] && world.getUserData( ids[0] ) == nullptr )
+        lx::Log::log( "SUCCESS - user data" );
+    else
+        lx::Log::log( "FAILURE - user data" );
+
+    // Brute force: every pair of bullet/hitbox in collision
+    std::vector<ProxyPair> expected;
+
+    for ( unsigned int b = 0; b < NB_BULLETS; ++b )
+    {
+        for ( unsigned int h = 0; h < NB_HITBOXES; ++h )
+        {
+            if ( collisionCircleBox( bullets[b], boxes[h] ) )
+                expected.push_back( ProxyPair{ ids[h], ids[NB_HITBOXES + b] } );
+        }
+    }
+
+    uint32_t t = lx::Time::getTicks();
+    world.findPairs( pairs );
+    lx::Log::log( "findPairs: %u candidate pairs in %u ms", static_cast<unsigned int>( pairs.size() ),
+                  lx::Time::getTicks() - t );
+
+    unsigned int nb_found = 0;
+    bool unique = true;
+
+    for ( size_t i = 0; i < pairs.size(); ++i )
+    {
+        const ProxyPair& P = pairs[i];
+
+        if ( i > 0 && P.first == pairs[i - 1].first && P.second == pairs[i - 1].second )
+            unique = false;
+
+        // Only bullet/hitbox collisions are expected
+        if ( P.first < NB_HITBOXES && P.second >= NB_HITBOXES && world.collide( P.first, P.second ) )
+            ++nb_found;
+    }
+
+    if ( unique && nb_found == expected.size() )
+        lx::Log::log( "SUCCESS - findPairs: %u bullet/hitbox collisions", nb_found );
+    else
+        lx::Log::log( "FAILURE - findPairs: expected %u collisions, got %u",
+                      static_cast<unsigned int>( expected.size() ), nb_found );
+
+    // Queries
+    const FloatingBox QBOX{ FloatPosition{ 100.0f, 100.0f }, 200, 150 };
+    const Circle QCIRCLE{ FloatPosition{ 500.0f, 500.0f }, 64 };
+    const FloatPosition QPOINT{ 250.0f, 250.0f };
+    bool ok_box = true, ok_circle = true, ok_point = true;
+
+    world.queryBox( QBOX, result );
+
+    for ( unsigned int i = 0; i < ids.size(); ++i )
+    {
+        const bool C = i < NB_HITBOXES ? collisionBox( boxes[i], QBOX )
+                       : collisionCircleBox( bullets[i - NB_HITBOXES], QBOX );
+        ok_box = ok_box && C == std::binary_search( result.begin(), result.end(), ids[i] );
+    }
+
+    world.queryCircle( QCIRCLE, result );
+
+    for ( unsigned int i = 0; i < ids.size(); ++i )
+    {
+        const bool C = i < NB_HITBOXES ? collisionCircleBox( QCIRCLE, boxes[i] )
+                       : collisionCircle( bullets[i - NB_HITBOXES], QCIRCLE );
+        ok_circle = ok_circle && C == std::binary_search( result.begin(), result.end(), ids[i] );
+    }
+
+    world.queryPoint( QPOINT, result );
+
+    for ( unsigned int i = 0; i < ids.size(); ++i )
+    {
+        const bool C = i < NB_HITBOXES ? collisionPointBox( QPOINT, boxes[i] )
+                       : collisionPointCircle( QPOINT, bullets[i - NB_HITBOXES] );
+        ok_point = ok_point && C == std::binary_search( result.begin(), result.end(), ids[i] );
+    }
+
+    lx::Log::log( "%s - queryBox", ok_box ? "SUCCESS" : "FAILURE" );
+    lx::Log::log( "%s - queryCircle", ok_circle ? "SUCCESS" : "FAILURE" );
+    lx::Log::log( "%s - queryPoint", ok_point ? "SUCCESS" : "FAILURE" );
+
+    // Move every bullet, then remove them
+    t = lx::Time::getTicks();
+
+    for ( unsigned int b = 0; b < NB_BULLETS; ++b )
+    {
+        moveCircle( bullets[b], Vector2D{ 3.0f, -2.0f } );
+        world.updateCircle( ids[NB_HITBOXES + b], bullets[b] );
+    }
+
+    lx::Log::log( "update of %u bullets in %u ms", NB_BULLETS, lx::Time::getTicks() - t );
+    world.queryCircle( QCIRCLE, result );
+    ok_circle = true;
+
+    for ( unsigned int b = 0; b < NB_BULLETS; ++b )
+    {
+        const bool C = collisionCircle( bullets[b], QCIRCLE );
+        ok_circle = ok_circle && C == std::binary_search( result.begin(), result.end(),
+                    ids[NB_HITBOXES + b] );
+    }
+
+    lx::Log::log( "%s - queryCircle after the update", ok_circle ? "SUCCESS" : "FAILURE" );
+
+    for ( unsigned int b = 0; b < NB_BULLETS; ++b )
+        world.remove( ids[NB_HITBOXES + b] );
+
+    world.findPairs( pairs );
+    bool no_bullet = !world.remove( ids[NB_HITBOXES] ) && world.size() == NB_HITBOXES;
+
+    for ( const ProxyPair& P : pairs )
+        no_bullet = no_bullet && P.second < NB_HITBOXES;
+
+    lx::Log::log( "%s - remove", no_bullet ? "SUCCESS" : "FAILURE" );
+
+    // Polygon proxy
+    Polygon poly;
+    poly.addPoint( FloatPosition{ 10.0f, 10.0f } );
+    poly.addPoint( FloatPosition{ 60.0f, 10.0f } );
+    poly.addPoint( FloatPosition{ 35.0f, 60.0f } );
+
+    CollisionWorld w2( 16.0f );
+    const ProxyID PID = w2.addPolygon( poly );
+    const ProxyID BID = w2.addBox( FloatingBox{ FloatPosition{ 100.0f, 100.0f }, 10, 10 } );
+    w2.findPairs( pairs );
+
+    if ( pairs.empty() )
+        lx::Log::log( "SUCCESS - polygon far from the box" );
+    else
+        lx::Log::log( "FAILURE - polygon far from the box" );
+
+    movePoly( poly, Vector2D{ 70.0f, 60.0f } );
+    w2.updatePolygon( PID );
+    w2.findPairs( pairs );
+
+    if ( pairs.size() == 1 && w2.collide( PID, BID ) )
+        lx::Log::log( "SUCCESS - polygon on the box" );
+    else
+        lx::Log::log( "FAILURE - polygon on the box" );
+
+    try
+    {
+        CollisionWorld w3( 0.0f );
+        lx::Log::log( "FAILURE - invalid cell size" );
+    }
+    catch ( std::invalid_argument& e )
+    {
+        lx::Log::log( "SUCCESS - invalid cell size: %s", e.what() );
+    }
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_collisionFilter( void )
+{
+    lx::Log::log( " = TEST CollisionFilter = " );
+
+    const uint32_t PLAYER = 0x0001u, ENEMY = 0x0002u, PLAYER_BULLET = 0x0004u, ENEMY_BULLET = 0x0008u;
+    const CollisionFilter FILTERS[] =
+    {
+        { PLAYER, ENEMY | ENEMY_BULLET },
+        { ENEMY, PLAYER | PLAYER_BULLET },
+        { PLAYER_BULLET, ENEMY },
+        { ENEMY_BULLET, PLAYER },
+    };
+    const unsigned int NB_SHAPES = 2000;
+    std::vector<Circle> circles;
+    std::vector<unsigned int> layers;
+    std::vector<ProxyPair> pairs;
+    std::vector<ProxyPair> expected;
+
+    lx::Random::initRand();
+    CollisionWorld world( 32.0f );
+
+    for ( unsigned int i = 0; i < NB_SHAPES; ++i )
+    {
+        const float X = static_cast<float>( lx::Random::xrand<unsigned int>( 0, 600 ) );
+        const float Y = static_cast<float>( lx::Random::xrand<unsigned int>( 0, 600 ) );
+        circles.push_back( Circle{ FloatPosition{ X, Y }, lx::Random::xrand<unsigned int>( 2, 12 ) } );
+        layers.push_back( lx::Random::xrand<unsigned int>( 0, 3 ) );
+        world.addCircle( circles.back(), nullptr, FILTERS[layers.back()] );
+    }
+
+    const CollisionFilter F = world.getFilter( 0 );
+    const CollisionFilter NF = world.getFilter( NB_SHAPES );
+
+    if ( F.category == FILTERS[layers[0]].category && F.mask == FILTERS[layers[0]].mask
+            && NF.category == 0 && NF.mask == 0 )
+        lx::Log::log( "SUCCESS - getFilter" );
+    else
+        lx::Log::log( "FAILURE - getFilter" );
+
+    auto brute_force = [&]()
+    {
+        expected.clear();
+
+        for ( ProxyID i = 0; i < NB_SHAPES; ++i )
+        {
+            for ( ProxyID j = i + 1; j < NB_SHAPES; ++j )
+            {
+                const CollisionFilter& A = FILTERS[layers[i]];
+                const CollisionFilter& B = FILTERS[layers[j]];
+
+                if ( ( A.category & B.mask ) != 0 && ( B.category & A.mask ) != 0
+                        && collisionCircle( circles[i], circles[j] ) )
+                    expected.push_back( ProxyPair{ i, j } );
+            }
+        }
+    };
+
+    auto same = []( std::vector<ProxyPair> v, std::vector<ProxyPair> w )
+    {
+        auto cmp = []( const ProxyPair & a, const ProxyPair & b )
+        {
+            return a.first < b.first || ( a.first == b.first && a.second < b.second );
+        };
+
+        std::sort( v.begin(), v.end(), cmp );
+        std::sort( w.begin(), w.end(), cmp );
+        return v.size() == w.size() && std::equal( v.begin(), v.end(), w.begin(),
+                []( const ProxyPair & a, const ProxyPair & b )
+        {
+            return a.first == b.first && a.second == b.second;
+        } );
+    };
+
+    brute_force();
+    world.findPairs( pairs );
+    bool no_filtered = true;
+
+    for ( const ProxyPair& P : pairs )
+    {
+        const CollisionFilter& A = FILTERS[layers[P.first]];
+        const CollisionFilter& B = FILTERS[layers[P.second]];
+        no_filtered = no_filtered && ( A.category & B.mask ) != 0 && ( B.category & A.mask ) != 0;
+    }
+
+    lx::Log::log( "%s - findPairs: no filtered pair in %u pairs", no_filtered ? "SUCCESS" : "FAILURE",
+                  static_cast<unsigned int>( pairs.size() ) );
+
+    uint32_t t = lx::Time::getTicks();
+    world.findCollisions( pairs );
+    lx::Log::log( "findCollisions: %u pairs in %u ms", static_cast<unsigned int>( pairs.size() ),
+                  lx::Time::getTicks() - t );
+    lx::Log::log( "%s - findCollisions, %u expected pairs", same( pairs, expected ) ? "SUCCESS" : "FAILURE",
+                  static_cast<unsigned int>( expected.size() ) );
+
+    // Every player bullet becomes an enemy bullet
+    for ( ProxyID i = 0; i < NB_SHAPES; ++i )
+    {
+        if ( layers[i] == 2 )
+        {
+            layers[i] = 3;
+            world.setFilter( i, FILTERS[3] );
+        }
+    }
+
+    brute_force();
+    world.findCollisions( pairs );
+    lx::Log::log( "%s - setFilter, %u expected pairs", same( pairs, expected ) ? "SUCCESS" : "FAILURE",
+                  static_cast<unsigned int>( expected.size() ) );
+
+    // Nothing collides with nothing
+    CollisionWorld w2( 16.0f );
+    const Circle C{ FloatPosition{ 10.0f, 10.0f }, 8 };
+    w2.addCircle( C, nullptr, CollisionFilter{ PLAYER, 0 } );
+    w2.addCircle( C, nullptr, CollisionFilter{ PLAYER, 0 } );
+    w2.addCircle( C );
+    w2.findPairs( pairs );
+
+    if ( pairs.empty() )
+        lx::Log::log( "SUCCESS - empty mask" );
+    else
+        lx::Log::log( "FAILURE - empty mask: %u pairs", static_cast<unsigned int>( pairs.size() ) );
+
+    // The queries ignore the layers
+    std::vector<ProxyID> result;
+    RayHit hit;
+    w2.queryCircle( C, result );
+    const ProxyID FIRST = w2.segmentCast( Segment{ FloatPosition{ -10.0f, 10.0f },
+                                                   FloatPosition{ 30.0f, 10.0f } }, hit );
+
+    if ( result.size() == 3 && FIRST == 0 )
+        lx::Log::log( "SUCCESS - the queries find every layer" );
+    else
+        lx::Log::log( "FAILURE - the queries find every layer: %u proxies, first hit: %u",
+                      static_cast<unsigned int>( result.size() ), static_cast<unsigned int>( FIRST ) );
+
+    lx::Log::log( " = END TEST = " );
+}
+
+void test_aabbTree( void )
+{
+    lx::Log::log( " = TEST DynamicAABBTree = " );
+
+    const unsigned int NB_ENEMIES = 200;
+    const unsigned int NB_BULLETS = 3000;
+    std::vector<ProxyID> ids;
+    std::vector<ProxyPair> pairs;
+    std::vector<ProxyID> result;
+    std::vector<FloatingBox> boxes;
+
+    lx::Random::initRand();
+    DynamicAABBTree tree;
+
+    if ( tree.size() == 0 && tree.getHeight() == -1 )
+        lx::Log::log( "SUCCESS - empty tree" );
+    else
+        lx::Log::log( "FAILURE - empty tree" );
+
+    // A boss that covers most of the screen, some enemies and a lot of bullets
+    Polygon boss;
+    boss.addPoint( FloatPosition{ 100.0f, 50.0f } );
+    boss.addPoint( FloatPosition{ 800.0f, 120.0f } );
+    boss.addPoint( FloatPosition{ 700.0f, 600.0f } );
+    boss.addPoint( FloatPosition{ 150.0f, 500.0f } );
+
+    boxes.push_back( boss.getEnclosingBox() );
+    ids.push_back( tree.addPolygon( boss, &boss ) );
+
+    for ( unsigned int i = 0; i < NB_ENEMIES + NB_BULLETS; ++i )
+    {
+        const float X = static_cast<float>( lx::Random::xrand<unsigned int>( 0, 1000 ) );
+        const float Y = static_cast<float>( lx::Random::xrand<unsigned int>( 0, 1000 ) );
+        const int SZ = i < NB_ENEMIES ? static_cast<int>( lx::Random::xrand<unsigned int>( 16, 64 ) ) : 2;
+        boxes.push_back( FloatingBox{ FloatPosition{ X, Y }, SZ, SZ } );
+        ids.push_back( tree.addBox( boxes.back() ) );
+    }
+
+    const unsigned int N = static_cast<unsigned int>( boxes.size() );
+    // The identifiers are not contiguous, the tree also stores its internal nodes
+    std::vector<unsigned int> index( *std::max_element( ids.begin(), ids.end() ) + 1, N );
+
+    for ( unsigned int i = 0; i < N; ++i )
+        index[ids[i]] = i;
+
+    auto boxOf = [&]( const ProxyID id ) -> const FloatingBox&
+    {
+        return boxes[index[id]];
+    };
+
+    // Balanced: the height is logarithmic
+    const int MAX_HEIGHT = static_cast<int>( 2.0 * std::log2( static_cast<double>( N ) ) ) + 2;
+
+    if ( tree.size() == N && tree.getHeight() <= MAX_HEIGHT )
+        lx::Log::log( "SUCCESS - %u proxies, height: %d", N, tree.getHeight() );
+    else
+        lx::Log::log( "FAILURE - %u proxies (expected %u), height: %d", static_cast<unsigned int>( tree.size() ),
+                      N, tree.getHeight() );
+
+    if ( tree.getUserData( ids[0] ) == &boss && tree.getUserData( ids[1] ) == nullptr
+            && tree.getUserData( NULL_PROXY ) == nullptr )
+        lx::Log::log( "SUCCESS - user data" );
+    else
+        lx::Log::log( "FAILURE - user data" );
+
+    // Brute force
+    std::vector<ProxyPair> expected;
+    uint32_t t = lx::Time::getTicks();
+
+    for ( unsigned int i = 0; i < N; ++i )
+    {
+        for ( unsigned int j = i + 1; j < N; ++j )
+        {
+            if ( collisionBox( boxes[i], boxes[j] ) )
+                expected.push_back( ProxyPair{ std::min( ids[i], ids[j] ), std::max( ids[i], ids[j] ) } );
+        }
+    }
+
+    const uint32_t T_BRUTE = lx::Time::getTicks() - t;
+    t = lx::Time::getTicks();
+    tree.findPairs( pairs );
+    const uint32_t T_TREE = lx::Time::getTicks() - t;
+    lx::Log::log( "brute force: %u pairs in %u ms, tree: %u candidate pairs in %u ms",
+                  static_cast<unsigned int>( expected.size() ), T_BRUTE,
+                  static_cast<unsigned int>( pairs.size() ), T_TREE );
+
+    // The tree reports the boxes that touch, collisionBox() does not
+    std::vector<ProxyPair> found;
+    bool sorted = true;
+
+    for ( size_t i = 0; i < pairs.size(); ++i )
+    {
+        const ProxyPair& P = pairs[i];
+
+        if ( i > 0 && !( pairs[i - 1].first < P.first
+                         || ( pairs[i - 1].first == P.first && pairs[i - 1].second < P.second ) ) )
+            sorted = false;
+
+        if ( collisionBox( boxOf( P.first ), boxOf( P.second ) ) )
+            found.push_back( P );
+    }
+
+    auto pairLess = []( const ProxyPair& a, const ProxyPair& b )
+    {
+        return a.first < b.first || ( a.first == b.first && a.second < b.second );
+    };
+
+    auto pairEq = []( const ProxyPair& a, const ProxyPair& b )
+    {
+        return a.first == b.first && a.second == b.second;
+    };
+
+    std::sort( expected.begin(), expected.end(), pairLess );
+
+    if ( sorted && found.size() == expected.size()
+            && std::equal( found.begin(), found.end(), expected.begin(), pairEq ) )
+        lx::Log::log( "SUCCESS - findPairs: %u collisions", static_cast<unsigned int>( found.size() ) );
+    else
+        lx::Log::log( "FAILURE - findPairs: expected %u collisions, got %u",
+                      static_cast<unsigned int>( expected.size() ), static_cast<unsigned int>( found.size() ) );
+
+    // Region query
+    const FloatingBox QBOX{ FloatPosition{ 300.0f, 700.0f }, 150, 100 };
+    bool ok = true;
+    tree.queryBox( QBOX, result );
+
+    for ( unsigned int i = 0; i < N; ++i )
+    {
+        if ( collisionBox( boxes[i], QBOX ) )
+            ok = ok && std::binary_search( result.begin(), result.end(), ids[i] );
+    }
+
+    lx::Log::log( "%s - queryBox: %u proxies", ok ? "SUCCESS" : "FAILURE",
+                  static_cast<unsigned int>( result.size() ) );
+
+    // Ray query
+    Segment ray{ FloatPosition{ -10.0f, 900.0f }, FloatPosition{ 1010.0f, 900.0f } };
+    tree.queryRay( ray, result );
+    ok = true;
+
+    for ( unsigned int i = 1; i < N; ++i )
+    {
+        const FloatingBox& B = boxes[i];
+        const bool CROSS = B.p.y.v <= 900.0f && B.p.y.v + static_cast<float>( B.h ) >= 900.0f;
+        ok = ok && CROSS == ( std::find( result.begin(), result.end(), ids[i] ) != result.end() );
+    }
+
+    for ( size_t i = 1; i < result.size(); ++i )
+        ok = ok && boxOf( result[i - 1] ).p.x <= boxOf( result[i] ).p.x;
+
+    lx::Log::log( "%s - queryRay: %u proxies", ok ? "SUCCESS" : "FAILURE",
+                  static_cast<unsigned int>( result.size() ) );
+
+    // Small moves stay in the fattened box
+    unsigned int nb_reinserted = 0;
+    const FloatingBox OLD_BOX = boxes[1];
+    moveBox( boxes[1], Vector2D{ 1.0f, 1.0f } );
+    nb_reinserted += tree.moveBox( ids[1], boxes[1], Vector2D{ 1.0f, 1.0f } ) ? 1 : 0;
+    moveBox( boxes[1], Vector2D{ 100.0f, 0.0f } );
+    nb_reinserted += tree.moveBox( ids[1], boxes[1], Vector2D{ 100.0f, 0.0f } ) ? 10 : 0;
+
+    if ( nb_reinserted == 10 )
+        lx::Log::log( "SUCCESS - moveBox: only the big move reinserts the box" );
+    else
+        lx::Log::log( "FAILURE - moveBox: %u", nb_reinserted );
+
+    tree.queryBox( OLD_BOX, result );
+
+    if ( !std::binary_search( result.begin(), result.end(), ids[1] ) )
+        lx::Log::log( "SUCCESS - the box is not at its old position" );
+    else
+        lx::Log::log( "FAILURE - the box is still at its old position" );
+
+    // Move every bullet
+    nb_reinserted = 0;
+    t = lx::Time::getTicks();
+
+    for ( unsigned int i = NB_ENEMIES + 1; i < N; ++i )
+    {
+        moveBox( boxes[i], Vector2D{ 3.0f, -2.0f } );
+        nb_reinserted += tree.moveBox( ids[i], boxes[i], Vector2D{ 3.0f, -2.0f } ) ? 1 : 0;
+    }
+
+    lx::Log::log( "update of %u bullets in %u ms, %u reinsertions", NB_BULLETS,
+                  lx::Time::getTicks() - t, nb_reinserted );
+
+    tree.findPairs( pairs );
+    found.clear();
+    expected.clear();
+
+    for ( const ProxyPair& P : pairs )
+    {
+        if ( collisionBox( boxOf( P.first ), boxOf( P.second ) ) )
+            found.push_back( P );
+    }
+
+    for ( unsigned int i = 0; i < N; ++i )
+    {
+        for ( unsigned int j = i + 1; j < N; ++j )
+        {
+            if ( collisionBox( boxes[i], boxes[j] ) )
+                expected.push_back( ProxyPair{ std::min( ids[i], ids[j] ), std::max( ids[i], ids[j] ) } );
+        }
+    }
+
+    std::sort( expected.begin(), expected.end(), pairLess );
+
+    if ( found.size() == expected.size() && std::equal( found.begin(), found.end(), expected.begin(), pairEq ) )
+        lx::Log::log( "SUCCESS - findPairs after the update" );
+    else
+        lx::Log::log( "FAILURE - findPairs after the update: expected %u, got %u",
+                      static_cast<unsigned int>( expected.size() ), static_cast<unsigned int>( found.size() ) );
+
+    // Remove the bullets
+    for ( unsigned int i = NB_ENEMIES + 1; i < N; ++i )
+        tree.remove( ids[i] );
+
+    if ( !tree.remove( ids[N - 1] ) && tree.size() == NB_ENEMIES + 1
+            && tree.getHeight() <= static_cast<int>( 2.0 * std::log2( NB_ENEMIES + 1.0 ) ) + 2 )
+        lx::Log::log( "SUCCESS - remove, height: %d", tree.getHeight() );
+    else
+        lx::Log::log( "FAILURE - remove, size: %u, height: %d", static_cast<unsigned int>( tree.size() ),
+                      tree.getHeight() );
+
+    lx::Log::log( " = END TEST = " );
+}
+
 void displayPoly( Polygon& poly )
 {
     ostringstream os;
@@ -31,6 +31,7 @@ struct msg_t
 void test_thread();
 void test_thread_fail();
 void test_async();
+void test_worker_pool();
 
 unsigned long fact_( unsigned long n, unsigned long acc ) noexcept;
 unsigned long fact( long n );
@@ -59,6 +60,7 @@ int main( int argc, char ** argv )
     test_thread();
     test_thread_fail();
     test_async();
+    test_worker_pool();
 
     lx::Log::log( " ==== END TEST ==== " );
     lx::quit();
@@ -242,3 +244,54 @@ void test_async()
 
     lx::Log::log( "      == END TEST ==    " );
 }
+
+void test_worker_pool()
+{
+    lx::Log::log( "   == TEST worker pool ==   " );
+
+    const size_t tid = lx::Multithreading::getCurrentThreadID();
+    const unsigned int NB_TASKS = 1000;
+    std::vector<unsigned long> expected( NB_TASKS );
+
+    for ( unsigned int i = 0; i < NB_TASKS; ++i )
+        expected[i] = fact( i % 20 );
+
+    for ( unsigned int nb_workers : { 0U, 1U, 3U, 8U } )
+    {
+        lx::Multithreading::WorkerPool pool( nb_workers );
+        std::vector<unsigned long> r( NB_TASKS, 0 );
+
+        lx::Log::log( "(#%x): WorkerPool - %u worker(s)", tid, pool.nbWorkers() );
+
+        // Reuse the same threads for several loops
+        for ( int k = 0; k < 3; ++k )
+        {
+            pool.parallelFor( NB_TASKS, [&r]( unsigned int i )
+            {
+                r[i] = fact( i % 20 );
+            } );
+        }
+
+        if ( r == expected )
+            lx::Log::log( "(#%x): SUCCESS - parallel loop OK", tid );
+        else
+            lx::Log::log( "(#%x): FAILURE - parallel loop KO", tid );
+
+        try
+        {
+            pool.parallelFor( NB_TASKS, []( unsigned int i )
+            {
+                fact( i == 42 ? -1 : 1 );
+            } );
+            lx::Log::log( "(#%x): FAILURE - an exception should occur", tid );
+        }
+        catch ( const std::invalid_argument& inv )
+        {
+            lx::Log::log( "(#%x): SUCCESS - %s - OK", tid, inv.what() );
+        }
+    }
+
+    lx::Log::log( "(#%x): shared pool - %u worker(s)", tid,
+                  lx::Multithreading::getWorkerPool().nbWorkers() );
+    lx::Log::log( "      == END TEST ==    " );
+}
@@ -4,6 +4,9 @@
 
 #include <sstream>
 #include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
 
 using namespace std;
 using namespace lx::Graphics;
@@ -246,6 +249,466 @@ void test_image( lx::Win::Window * win )
         lx::Log::log( "%s", ie.what() );
     }
 
+    lx::Log::logInfo( lx::Log::APPLICATION, "collision mask" );
+
+    try
+    {
+        BufferedImage data( name );
+        const lx::Physics::CollisionMask MASK = data.generateCollisionMask();
+        const lx::Physics::CollisionMask COARSE = data.generateCollisionMask( 128, 4 );
+        const lx::Physics::FloatPosition P{ 0.0f, 0.0f };
+
+        if ( MASK.getScale() == 1 && COARSE.getScale() == 4 && MASK.count() > 0
+                && COARSE.getWidth() == ( MASK.getWidth() + 3 ) / 4
+                && COARSE.count() == MASK.downsample( 4 ).count()
+                && lx::Physics::collisionMask( MASK, P, COARSE, P ) )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - collision mask: %d×%d, %lu solid pixels",
+                              MASK.getWidth(), MASK.getHeight(),
+                              static_cast<unsigned long>( MASK.count() ) );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - collision mask" );
+    }
+    catch ( lx::Graphics::ImageException& ie )
+    {
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - Surface; it should be created" );
+        lx::Log::log( "%s", ie.what() );
+    }
+
+    lx::Log::logInfo( lx::Log::APPLICATION, "grayscale and negative filters" );
+
+    try
+    {
+        BufferedImage data( sp_str );
+        const size_t SOLID = data.generateCollisionMask().count();
+
+        lx::Time::Timer timer0;
+        timer0.start();
+        data.convertGrayscale().convertNegative();
+        timer0.pause();
+        lx::Log::logInfo( lx::Log::APPLICATION, "filters on %s done in %d ms",
+                          sp_str.c_str(), timer0.getTicks() );
+
+        if ( data.generateCollisionMask().count() == SOLID )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - the alpha channel is not modified by the filters" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - the filters should not modify the alpha channel" );
+
+        lx::Graphics::Sprite * img = data.generateSprite( *win );
+        win->clearWindow();
+        img->draw();
+        win->update();
+        lx::Time::delay( 500 );
+        delete img;
+    }
+    catch ( lx::Graphics::ImageException& ie )
+    {
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - Surface; it should be created" );
+        lx::Log::log( "%s", ie.what() );
+    }
+
+    lx::Log::logInfo( lx::Log::APPLICATION, "grayscale and negative values" );
+
+    {
+        // 37 pixels per row: the SIMD kernels filter 32 or 36 pixels, the scalar one the others.
+        // The rows of the 16-bit and 24-bit images are padded, the last size is filtered in parallel
+        const PixelFormat FORMATS[] = { PixelFormat::RGBA8888, PixelFormat::ARGB8888,
+                                        PixelFormat::RGB24, PixelFormat::RGBA4444,
+                                        PixelFormat::ARGB4444
+                                      };
+        const char * NAMES[] = { "RGBA8888", "ARGB8888", "RGB24", "RGBA4444", "ARGB4444" };
+        const ImgRect SIZES[] = { ImgRect{ 0, 0, 37, 3 }, ImgRect{ 0, 0, 521, 509 } };
+
+        // The value of a channel with the precision of the format, and back to 8 bits
+        auto quantize = []( const PixelFormat f, const int v )
+        {
+            return ( f == PixelFormat::RGBA4444 || f == PixelFormat::ARGB4444 ) ? v >> 4 : v;
+        };
+        auto expand = []( const PixelFormat f, const int v )
+        {
+            return ( f == PixelFormat::RGBA4444 || f == PixelFormat::ARGB4444 ) ? v * 17 : v;
+        };
+
+        for ( size_t i = 0; i < sizeof( FORMATS ) / sizeof( FORMATS[0] ); ++i )
+        {
+            const PixelFormat F = FORMATS[i];
+
+            for ( const ImgRect& S : SIZES )
+            {
+                try
+                {
+                    BufferedImage gray( S.w, S.h, F );
+                    BufferedImage negative( S.w, S.h, F );
+                    const int MAX = quantize( F, 255 );
+                    int errors = 0;
+
+                    for ( int y = 0; y < S.h; ++y )
+                    {
+                        for ( int x = 0; x < S.w; ++x )
+                        {
+                            const lx::Graphics::Colour C =
+                            {
+                                static_cast<uint8_t>( x * 37 + y * 11 ),
+                                static_cast<uint8_t>( x * 101 + y * 7 ),
+                                static_cast<uint8_t>( x * 13 + y * 59 ),
+                                static_cast<uint8_t>( x * 29 + y )
+                            };
+                            gray.setPixel( x, y, C );
+                            negative.setPixel( x, y, C );
+                        }
+                    }
+
+                    BufferedImage source( S.w, S.h, F );
+
+                    for ( int y = 0; y < S.h; ++y )
+                    {
+                        for ( int x = 0; x < S.w; ++x )
+                            source.setPixel( x, y, gray.getPixel( x, y ) );
+                    }
+
+                    gray.convertGrayscale();
+                    negative.convertNegative();
+
+                    for ( int y = 0; y < S.h; ++y )
+                    {
+                        for ( int x = 0; x < S.w; ++x )
+                        {
+                            const lx::Graphics::Colour C = source.getPixel( x, y );
+                            const lx::Graphics::Colour G = gray.getPixel( x, y );
+                            const lx::Graphics::Colour N = negative.getPixel( x, y );
+                            const int R = quantize( F, C.r ), GR = quantize( F, C.g ), B = quantize( F, C.b );
+                            // Rec. 709 weights, in 8-bit fixed point
+                            const int V = expand( F, ( 54 * R + 183 * GR + 19 * B ) >> 8 );
+
+                            if ( G.r != V || G.g != V || G.b != V || G.a != C.a
+                                    || N.r != expand( F, MAX - R ) || N.g != expand( F, MAX - GR )
+                                    || N.b != expand( F, MAX - B ) || N.a != C.a )
+                                ++errors;
+                        }
+                    }
+
+                    if ( errors == 0 )
+                        lx::Log::logInfo( lx::Log::TEST, "SUCCESS - format %s, %d×%d: expected values",
+                                          NAMES[i], S.w, S.h );
+                    else
+                        lx::Log::logInfo( lx::Log::TEST, "FAILURE - format %s, %d×%d: %d wrong pixel(s)",
+                                          NAMES[i], S.w, S.h, errors );
+                }
+                catch ( lx::Graphics::ImageException& ie )
+                {
+                    lx::Log::logInfo( lx::Log::TEST, "FAILURE - the image should be created" );
+                    lx::Log::log( "%s", ie.what() );
+                }
+            }
+        }
+    }
+
+    lx::Log::logInfo( lx::Log::APPLICATION, "image pipeline" );
+
+    try
+    {
+        BufferedImage data( sp_str );
+        lx::Graphics::ImagePipeline p = data.pipeline();
+
+        if ( p.numberOfPasses() == 0 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - empty pipeline: no pass" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - empty pipeline: expected: 0; got: %u",
+                              static_cast<unsigned int>( p.numberOfPasses() ) );
+
+        p.tint( lx::Graphics::Colour{255, 128, 128, 255} ).grayscale().negative().premultiply();
+
+        if ( p.numberOfPasses() == 1 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - per-pixel operations fused into 1 pass" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - per-pixel operations: expected: 1 pass; got: %u",
+                              static_cast<unsigned int>( p.numberOfPasses() ) );
+
+        p.gaussianBlur( 2.0f ).negative().blur( 0 );
+
+        if ( p.numberOfPasses() == 1 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - blur fused with the per-pixel operations" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - blur: expected: 1 pass; got: %u",
+                              static_cast<unsigned int>( p.numberOfPasses() ) );
+
+        try
+        {
+            p.blur( -1 );
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - blur with a negative radius" );
+        }
+        catch ( std::invalid_argument& )
+        {
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - invalid_argument: negative radius" );
+        }
+
+        lx::Time::Timer timer0;
+        timer0.start();
+        p.apply();
+        timer0.pause();
+        lx::Log::logInfo( lx::Log::APPLICATION, "pipeline on %s done in %d ms",
+                          sp_str.c_str(), timer0.getTicks() );
+
+        if ( p.numberOfPasses() == 0 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - the pipeline is cleared by apply()" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - the pipeline should be cleared by apply()" );
+
+        // tint then blur: in one pass, in two passes, and computed here
+        const int W = 40, H = 23, RADIUS = 2;
+        const lx::Graphics::Colour TINT = { 255, 128, 64, 200 };
+        BufferedImage fused( W, H );
+        BufferedImage sequential( W, H );
+        std::vector<float> tinted( W * H * 4 );
+
+        for ( int y = 0; y < H; ++y )
+        {
+            for ( int x = 0; x < W; ++x )
+            {
+                const lx::Graphics::Colour C = { static_cast<uint8_t>( x * 6 ), static_cast<uint8_t>( y * 11 ),
+                                                 static_cast<uint8_t>( x * y ), 255
+                                               };
+                const uint8_t CHANNELS[] = { C.r, C.g, C.b, C.a };
+                const uint8_t FACTORS[] = { TINT.r, TINT.g, TINT.b, TINT.a };
+
+                fused.setPixel( x, y, C );
+                sequential.setPixel( x, y, C );
+
+                for ( int c = 0; c < 4; ++c )
+                    tinted[( y * W + x ) * 4 + c] = CHANNELS[c] * ( FACTORS[c] / 255.0f );
+            }
+        }
+
+        lx::Graphics::ImagePipeline p1 = fused.pipeline();
+        p1.tint( TINT ).blur( RADIUS ).apply();
+        lx::Graphics::ImagePipeline p2 = sequential.pipeline();
+        p2.tint( TINT ).apply();
+        lx::Graphics::ImagePipeline p3 = sequential.pipeline();
+        p3.blur( RADIUS ).apply();
+
+        int errors = 0;
+
+        for ( int y = 0; y < H; ++y )
+        {
+            for ( int x = 0; x < W; ++x )
+            {
+                float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+                // The pixels out of the image are the ones of the edges
+                for ( int j = -RADIUS; j <= RADIUS; ++j )
+                {
+                    for ( int i = -RADIUS; i <= RADIUS; ++i )
+                    {
+                        const int X = std::min( std::max( x + i, 0 ), W - 1 );
+                        const int Y = std::min( std::max( y + j, 0 ), H - 1 );
+
+                        for ( int c = 0; c < 4; ++c )
+                            sum[c] += tinted[( Y * W + X ) * 4 + c];
+                    }
+                }
+
+                const lx::Graphics::Colour F = fused.getPixel( x, y );
+                const lx::Graphics::Colour S = sequential.getPixel( x, y );
+                const uint8_t FC[] = { F.r, F.g, F.b, F.a };
+                const uint8_t SC[] = { S.r, S.g, S.b, S.a };
+
+                for ( int c = 0; c < 4; ++c )
+                {
+                    const float REF = sum[c] / ( ( 2 * RADIUS + 1 ) * ( 2 * RADIUS + 1 ) );
+
+                    if ( std::abs( FC[c] - REF ) > 1.0f || std::abs( SC[c] - REF ) > 1.0f )
+                        ++errors;
+                }
+            }
+        }
+
+        if ( errors == 0 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - fused and sequential pipelines give the same image" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - fused and sequential pipelines: %d wrong value(s)",
+                              errors );
+
+        lx::Graphics::Sprite * img = data.generateSprite( *win );
+        win->clearWindow();
+        img->draw();
+        win->update();
+        lx::Time::delay( 500 );
+        delete img;
+    }
+    catch ( lx::Graphics::ImageException& ie )
+    {
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - Surface; it should be created" );
+        lx::Log::log( "%s", ie.what() );
+    }
+
+    lx::Log::logInfo( lx::Log::APPLICATION, "resampling and levels of detail" );
+
+    try
+    {
+        using lx::Graphics::ResizeFilter;
+        BufferedImage data( sp_str );
+        const ResizeFilter FILTERS[] = { ResizeFilter::BOX, ResizeFilter::BILINEAR, ResizeFilter::LANCZOS3 };
+
+        for ( const ResizeFilter f : FILTERS )
+        {
+            lx::Time::Timer timer0;
+            timer0.start();
+            std::unique_ptr<BufferedImage> half( data.resize( 424, 224, f ) );
+            timer0.pause();
+
+            const lx::Physics::CollisionMask MASK = half->generateCollisionMask();
+            lx::Log::logInfo( lx::Log::APPLICATION, "resize (filter %d) done in %d ms",
+                              static_cast<int>( f ), timer0.getTicks() );
+
+            if ( MASK.getWidth() == 424 && MASK.getHeight() == 224 )
+                lx::Log::logInfo( lx::Log::TEST, "SUCCESS - resized image: 424 × 224" );
+            else
+                lx::Log::logInfo( lx::Log::TEST, "FAILURE - resized image: expected: 424 × 224; got: %d × %d",
+                                  MASK.getWidth(), MASK.getHeight() );
+        }
+
+        try
+        {
+            delete data.resize( 0, 1 );
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - resize to 0 × 1" );
+        }
+        catch ( std::invalid_argument& )
+        {
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - invalid_argument: resize to 0 × 1" );
+        }
+
+        // Values: the same size is the identity, a constant image stays constant,
+        // and the transparent pixels do not darken the edge of an opaque area
+        BufferedImage pattern( 31, 17 );
+        BufferedImage constant( 31, 17 );
+        BufferedImage edge( 31, 17 );
+        const lx::Graphics::Colour CONSTANT = { 10, 200, 77, 128 };
+        const lx::Graphics::Colour RED = { 255, 0, 0, 255 };
+        const lx::Graphics::Colour CLEAR = { 0, 0, 0, 0 };
+
+        for ( int y = 0; y < 17; ++y )
+        {
+            for ( int x = 0; x < 31; ++x )
+            {
+                pattern.setPixel( x, y, lx::Graphics::Colour{ static_cast<uint8_t>( x * 8 ),
+                                  static_cast<uint8_t>( y * 15 ), static_cast<uint8_t>( x * y ), 255 } );
+                constant.setPixel( x, y, CONSTANT );
+                edge.setPixel( x, y, x < 15 ? RED : CLEAR );
+            }
+        }
+
+        for ( const ResizeFilter f : FILTERS )
+        {
+            std::unique_ptr<BufferedImage> same( pattern.resize( 31, 17, f ) );
+            std::unique_ptr<BufferedImage> down( constant.resize( 13, 7, f ) );
+            std::unique_ptr<BufferedImage> up( constant.resize( 50, 40, f ) );
+            std::unique_ptr<BufferedImage> small( edge.resize( 12, 5, f ) );
+            std::unique_ptr<BufferedImage> big( edge.resize( 70, 9, f ) );
+            int errors = 0;
+
+            auto similar = []( const lx::Graphics::Colour& a, const lx::Graphics::Colour& b )
+            {
+                return std::abs( a.r - b.r ) <= 1 && std::abs( a.g - b.g ) <= 1
+                       && std::abs( a.b - b.b ) <= 1 && std::abs( a.a - b.a ) <= 1;
+            };
+
+            for ( int y = 0; y < 17; ++y )
+            {
+                for ( int x = 0; x < 31; ++x )
+                {
+                    const lx::Graphics::Colour P = pattern.getPixel( x, y );
+                    const lx::Graphics::Colour Q = same->getPixel( x, y );
+
+                    if ( P.r != Q.r || P.g != Q.g || P.b != Q.b || P.a != Q.a )
+                        ++errors;
+                }
+            }
+
+            for ( int y = 0; y < 40; ++y )
+            {
+                for ( int x = 0; x < 50; ++x )
+                {
+                    if ( ( x < 13 && y < 7 && !similar( down->getPixel( x, y ), CONSTANT ) )
+                            || !similar( up->getPixel( x, y ), CONSTANT ) )
+                        ++errors;
+                }
+            }
+
+            for ( int y = 0; y < 9; ++y )
+            {
+                for ( int x = 0; x < 70; ++x )
+                {
+                    const lx::Graphics::Colour C = big->getPixel( x, y );
+                    const lx::Graphics::Colour D = x < 12 && y < 5 ? small->getPixel( x, y ) : RED;
+
+                    if ( ( C.a > 0 && !similar( C, lx::Graphics::Colour{ 255, 0, 0, C.a } ) )
+                            || ( D.a > 0 && !similar( D, lx::Graphics::Colour{ 255, 0, 0, D.a } ) ) )
+                        ++errors;
+                }
+            }
+
+            if ( errors == 0 )
+                lx::Log::logInfo( lx::Log::TEST, "SUCCESS - resize (filter %d): expected values",
+                                  static_cast<int>( f ) );
+            else
+                lx::Log::logInfo( lx::Log::TEST, "FAILURE - resize (filter %d): %d wrong pixel(s)",
+                                  static_cast<int>( f ), errors );
+        }
+
+        // 1696 × 897 → 848 × 448 → … → 3 × 1 → 1 × 1
+        const size_t NB_LEVELS = data.generateMipmaps().size();
+
+        if ( NB_LEVELS == 10 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - mip chain: 10 levels" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - mip chain: expected: 10 levels; got: %u",
+                              static_cast<unsigned int>( NB_LEVELS ) );
+
+        lx::Graphics::Sprite * img = data.generateMipmappedSprite( *win );
+
+        if ( img->getNumberOfLevels() == 11 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - mipmapped sprite: 11 levels" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - mipmapped sprite: expected: 11 levels; got: %u",
+                              static_cast<unsigned int>( img->getNumberOfLevels() ) );
+
+        // The smallest level that is at least as big as the box
+        const ImgRect BOXES[] = { ImgRect{0, 0, 2000, 1000}, ImgRect{0, 0, 1696, 897},
+                                  ImgRect{0, 0, 849, 448}, ImgRect{0, 0, 848, 448},
+                                  ImgRect{0, 0, 424, 224}, ImgRect{0, 0, 300, 100},
+                                  ImgRect{0, 0, 3, 2}, ImgRect{0, 0, 1, 1}
+                                };
+        const size_t LEVELS[] = { 0, 0, 0, 1, 2, 2, 8, 10 };
+
+        for ( size_t i = 0; i < sizeof( LEVELS ) / sizeof( LEVELS[0] ); ++i )
+        {
+            const size_t LEVEL = img->getLevel( BOXES[i] );
+
+            if ( LEVEL == LEVELS[i] )
+                lx::Log::logInfo( lx::Log::TEST, "SUCCESS - box %d × %d: level %u",
+                                  BOXES[i].w, BOXES[i].h, static_cast<unsigned int>( LEVEL ) );
+            else
+                lx::Log::logInfo( lx::Log::TEST, "FAILURE - box %d × %d: expected: level %u; got: %u",
+                                  BOXES[i].w, BOXES[i].h, static_cast<unsigned int>( LEVELS[i] ),
+                                  static_cast<unsigned int>( LEVEL ) );
+        }
+
+        // From the full size to a tiny sprite
+        for ( int w = 1696; w > 8; w /= 2 )
+        {
+            win->clearWindow();
+            img->draw( ImgRect{0, 0, w / 2, w / 4} );
+            win->update();
+            lx::Time::delay( 100 );
+        }
+
+        delete img;
+    }
+    catch ( lx::Graphics::ImageException& ie )
+    {
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - Surface; it should be created" );
+        lx::Log::log( "%s", ie.what() );
+    }
+
     // Display a bullet
     try
     {
@@ -288,6 +751,223 @@ void test_image( lx::Win::Window * win )
         lx::Log::log( "%s", ie.what() );
     }
 
+    lx::Log::log( "||> SpriteBatch" );
+
+    try
+    {
+        lx::Graphics::Sprite img( name, *win );
+        lx::Graphics::Sprite half( name, *win, ImgRect{0, 0, 128, 64} );
+        lx::Graphics::SpriteBatch batch;
+        const int NB_SPRITES = 32;
+
+        lx::Log::logInfo( lx::Log::APPLICATION, "Draw %d sprites with two textures in a batch",
+                          NB_SPRITES );
+
+        for ( int k = 0; k < 64; k++ )
+        {
+            win->clearWindow();
+
+            for ( int i = 0; i < NB_SPRITES; i++ )
+            {
+                const ImgRect BOX{ ( i % 8 ) * 120 + k, ( i / 8 ) * 140, 128, 64 };
+                batch.add( i % 2 == 0 ? img : half, BOX );
+            }
+
+            if ( batch.size() != static_cast<size_t>( NB_SPRITES ) )
+                lx::Log::logInfo( lx::Log::TEST, "FAILURE - batch: expected %d sprites, got %u",
+                                  NB_SPRITES, static_cast<unsigned int>( batch.size() ) );
+
+            batch.flush();
+
+            // Two groups, each drawn as one piece of geometry or as one copy per sprite
+            const unsigned int CALLS = win->getBatchRenderCalls();
+
+            if ( k == 0 && ( CALLS < 2 || CALLS > static_cast<unsigned int>( NB_SPRITES ) ) )
+                lx::Log::logInfo( lx::Log::TEST, "FAILURE - batch: %u render calls", CALLS );
+
+            win->update();
+            lx::Time::delay( 16 );
+        }
+
+        // Nothing was recorded in the window since the flush of the sprite batch
+        win->flushBatch();
+
+        if ( win->getBatchRenderCalls() == 0 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - an empty flush does not call the renderer" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - empty flush: expected 0 render calls, got %u",
+                              win->getBatchRenderCalls() );
+
+        if ( batch.size() == 0 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - the batch is empty after a flush" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - the batch is not empty after a flush" );
+    }
+    catch ( lx::Graphics::ImageException& ie )
+    {
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - image from file: should be loaded" );
+        lx::Log::log( "%s", ie.what() );
+    }
+
+    lx::Log::log( "||> Batching mode" );
+
+    try
+    {
+        lx::Graphics::Sprite img( name, *win );
+        lx::Graphics::Sprite boss( sp_str, *win, ImgRect{0, 0, 424, 448} );
+        const int NB_SPRITES = 256;
+
+        win->setBatching( true );
+
+        if ( win->isBatching() )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - the window is in batching mode" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - the window should be in batching mode" );
+
+        lx::Log::logInfo( lx::Log::APPLICATION, "Draw %d sprites (rotated, mirrored) in 2 layers",
+                          NB_SPRITES );
+
+        for ( int k = 0; k < 64; k++ )
+        {
+            win->clearWindow();
+            win->setDrawLayer( 1 );
+
+            for ( int i = 0; i < NB_SPRITES; i++ )
+            {
+                const ImgRect BOX{ ( i % 32 ) * 30 + k, ( i / 32 ) * 60, 32, 32 };
+                const MirrorEffect M = i % 3 == 0 ? MirrorEffect::HORIZONTAL : MirrorEffect::NONE;
+                img.draw( BOX, static_cast<double>( i + k ) * 0.05, M );
+            }
+
+            // Drawn below the bullets
+            win->setDrawLayer( 0 );
+            boss.draw( ImgRect{ 256, 128, 424, 448 } );
+            win->update();
+            lx::Time::delay( 16 );
+        }
+
+        const unsigned int CALLS = win->getBatchRenderCalls();
+        lx::Log::logInfo( lx::Log::APPLICATION, "%d sprites drawn with %u call(s) to the renderer",
+                          NB_SPRITES + 1, CALLS );
+
+#if SDL_VERSION_ATLEAST(2,0,18)
+        if ( CALLS == 2 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - one call per texture" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - expected: 2 calls; got: %u", CALLS );
+#endif
+
+        win->setDrawLayer( 0 );
+        win->setBatching( false );
+    }
+    catch ( lx::Graphics::ImageException& ie )
+    {
+        win->setBatching( false );
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - image from file: should be loaded" );
+        lx::Log::log( "%s", ie.what() );
+    }
+
+    lx::Log::log( "||> TextureAtlas" );
+
+    {
+        lx::Graphics::SkylinePacker packer( 256, 256 );
+        std::vector<ImgRect> rects;
+        ImgRect r;
+        bool overlap = false;
+
+        for ( int i = 0; i < 64; i++ )
+        {
+            if ( packer.insert( 8 + ( i * 7 ) % 25, 8 + ( i * 13 ) % 21, r ) )
+                rects.push_back( r );
+        }
+
+        for ( size_t i = 0; i < rects.size(); i++ )
+        {
+            for ( size_t j = i + 1; j < rects.size(); j++ )
+            {
+                if ( rects[i].p.x < rects[j].p.x + rects[j].w && rects[j].p.x < rects[i].p.x + rects[i].w
+                        && rects[i].p.y < rects[j].p.y + rects[j].h && rects[j].p.y < rects[i].p.y + rects[i].h )
+                    overlap = true;
+            }
+        }
+
+        if ( !rects.empty() && !overlap && packer.getUsedWidth() <= 256 && packer.getUsedHeight() <= 256 )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - %u rectangles packed without overlap, occupancy: %f",
+                              static_cast<unsigned int>( rects.size() ), packer.getOccupancy() );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - the packed rectangles overlap" );
+
+        if ( !packer.insert( 512, 16, r ) )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - a rectangle wider than the bin is rejected" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - a rectangle wider than the bin was placed" );
+    }
+
+    try
+    {
+        const std::vector<ImgRect> FRAMES{ ImgRect{0, 0, 424, 448}, ImgRect{424, 0, 424, 448},
+                                           ImgRect{848, 0, 424, 448}, ImgRect{1272, 0, 424, 448} };
+        lx::Graphics::TextureAtlas atlas( *win );
+        atlas.add( name );
+        atlas.add( sp_str );
+        atlas.add( "bullet-copy", BufferedImage( name ) );
+        atlas.build();
+
+        lx::Log::logInfo( lx::Log::APPLICATION, "Atlas: %u page(s)",
+                          static_cast<unsigned int>( atlas.numberOfPages() ) );
+
+        if ( atlas.contains( name ) && atlas.contains( "bullet-copy" ) && !atlas.contains( "nothing" ) )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - the images are in the atlas" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - the images should be in the atlas" );
+
+        const ImgRect A = atlas.getArea( name );
+        const ImgRect B = atlas.getArea( "bullet-copy" );
+
+        if ( A.w == B.w && A.h == B.h && !( A.p.x == B.p.x && A.p.y == B.p.y ) )
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - two images, two areas" );
+        else
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - the areas are not valid" );
+
+        try
+        {
+            atlas.getArea( "nothing" );
+            lx::Log::logInfo( lx::Log::TEST, "FAILURE - no area expected for an unknown image" );
+        }
+        catch ( lx::Graphics::ImageException& )
+        {
+            lx::Log::logInfo( lx::Log::TEST, "SUCCESS - exception occured: unknown image" );
+        }
+
+        std::unique_ptr<Sprite> s1( atlas.generateSprite( name ) );
+        std::unique_ptr<Sprite> s2( atlas.generateSprite( "bullet-copy", ImgRect{0, 0, 24, 24} ) );
+        std::unique_ptr<AnimatedSprite> s3( atlas.generateAnimatedSprite( sp_str, FRAMES, 125, true ) );
+        lx::Graphics::SpriteBatch batch;
+
+        for ( int k = 0; k < 64; k++ )
+        {
+            win->clearWindow();
+
+            for ( int i = 0; i < 16; i++ )
+            {
+                const ImgRect BOX{ ( i % 8 ) * 120 + k, ( i / 8 ) * 140, 128, 64 };
+                batch.add( i % 2 == 0 ? *s1 : *s2, BOX );
+            }
+
+            batch.flush();
+            s3->draw( ImgRect{ 512, 320 + k, 64, 64 } );
+            win->update();
+            lx::Time::delay( 16 );
+        }
+
+        lx::Log::logInfo( lx::Log::TEST, "SUCCESS - sprites of the atlas drawn" );
+    }
+    catch ( lx::Graphics::ImageException& ie )
+    {
+        lx::Log::logInfo( lx::Log::TEST, "FAILURE - atlas: the images should be packed" );
+        lx::Log::log( "%s", ie.what() );
+    }
+
     lx::Log::log( "||> Streaming" );
     lx::Log::logInfo( lx::Log::APPLICATION, "create a streaming image" );
 